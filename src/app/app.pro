@@ -7,4 +7,5 @@ SUBDIRS =\
     qbs-setup-qt \
     config
 
+linux:SUBDIRS += qbs-watch
 !isEmpty(QT.widgets.name):SUBDIRS += config-ui
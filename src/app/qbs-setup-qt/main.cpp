@@ -43,6 +43,7 @@
 #include <qtprofilesetup.h>
 #include <logging/translator.h>
 #include <tools/settings.h>
+#include <tools/tooloutputcache.h>
 
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qfileinfo.h>
@@ -69,10 +70,13 @@ int main(int argc, char *argv[])
 
         Settings settings(clParser.settingsDir());
         settings.setScopeForWriting(clParser.settingsScope());
+        Internal::ToolOutputCache cache(Internal::ToolOutputCache::filePathForSettings(&settings));
 
         if (clParser.autoDetectionMode()) {
             // search all Qt's in path and dump their settings
-            const std::vector<EnhancedQtEnvironment> qtEnvironments = SetupQt::fetchEnvironments();
+            const std::vector<EnhancedQtEnvironment> qtEnvironments
+                    = SetupQt::fetchEnvironments(&cache);
+            cache.save();
             if (qtEnvironments.empty()) {
                 std::cout << qPrintable(Tr::tr("No Qt installations detected. "
                                                "No profiles created."))
@@ -97,7 +101,9 @@ int main(int argc, char *argv[])
             return EXIT_FAILURE;
         }
 
-        EnhancedQtEnvironment qtEnvironment = SetupQt::fetchEnvironment(clParser.qmakePath());
+        EnhancedQtEnvironment qtEnvironment = SetupQt::fetchEnvironment(clParser.qmakePath(),
+                                                                        &cache);
+        cache.save();
         QString profileName = clParser.profileName();
         profileName.replace(QLatin1Char('.'), QLatin1Char('-'));
         SetupQt::saveToQbsSettings(profileName, qtEnvironment, &settings);
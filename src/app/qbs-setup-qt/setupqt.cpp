@@ -49,6 +49,7 @@
 #include <tools/set.h>
 #include <tools/settings.h>
 #include <tools/stlutils.h>
+#include <tools/tooloutputcache.h>
 #include <tools/version.h>
 
 #include <QtCore/qbytearraymatcher.h>
@@ -60,6 +61,7 @@
 #include <QtCore/qstringlist.h>
 
 #include <algorithm>
+#include <memory>
 
 namespace qbs {
 using Internal::none_of;
@@ -105,13 +107,20 @@ bool SetupQt::isQMakePathValid(const QString &qmakePath)
     return qmakeFileInfo.exists() && qmakeFileInfo.isFile() && qmakeFileInfo.isExecutable();
 }
 
-std::vector<EnhancedQtEnvironment> SetupQt::fetchEnvironments()
+typedef QMap<QByteArray, QByteArray> QueryMap;
+
+static std::vector<QueryMap> qmakeQueryOutputs(const QStringList &qmakePaths,
+                                               Internal::ToolOutputCache *cache);
+static EnhancedQtEnvironment environmentFromQueryOutput(const QueryMap &queryOutput);
+
+std::vector<EnhancedQtEnvironment> SetupQt::fetchEnvironments(Internal::ToolOutputCache *cache)
 {
     std::vector<EnhancedQtEnvironment> qtEnvironments;
 
-    const auto qmakePaths = collectQmakePaths();
-    for (const QString &qmakePath : qmakePaths) {
-        const EnhancedQtEnvironment env = fetchEnvironment(qmakePath);
+    const QStringList qmakePaths = collectQmakePaths();
+    const std::vector<QueryMap> queryOutputs = qmakeQueryOutputs(qmakePaths, cache);
+    for (const QueryMap &queryOutput : queryOutputs) {
+        const EnhancedQtEnvironment env = environmentFromQueryOutput(queryOutput);
         if (none_of(qtEnvironments, [&env](const EnhancedQtEnvironment &otherEnv) {
                         return env.includePath == otherEnv.includePath;
                     })) {
@@ -128,16 +137,9 @@ void SetupQt::addQtBuildVariant(QtEnvironment *env, const QString &buildVariantN
         env->buildVariant << buildVariantName;
 }
 
-static QMap<QByteArray, QByteArray> qmakeQueryOutput(const QString &qmakePath)
+static QueryMap parseQueryOutput(const QByteArray &output)
 {
-    QProcess qmakeProcess;
-    qmakeProcess.start(qmakePath, QStringList() << QLatin1String("-query"));
-    if (!qmakeProcess.waitForStarted())
-        throw ErrorInfo(SetupQt::tr("%1 cannot be started.").arg(qmakePath));
-    qmakeProcess.waitForFinished();
-    const QByteArray output = qmakeProcess.readAllStandardOutput();
-
-    QMap<QByteArray, QByteArray> ret;
+    QueryMap ret;
     const auto lines = output.split('\n');
     for (const QByteArray &line : lines) {
         int idx = line.indexOf(':');
@@ -147,6 +149,51 @@ static QMap<QByteArray, QByteArray> qmakeQueryOutput(const QString &qmakePath)
     return ret;
 }
 
+// The output of qmake also depends on a qt.conf file next to it, which the cache does not
+// track, so such installations are always queried. The same goes for qtchooser, which picks
+// the actual qmake based on the environment and its own configuration files.
+static bool canCacheQueryOutput(const QString &qmakePath)
+{
+    const QFileInfo qmakeInfo(qmakePath);
+    if (QFileInfo(qmakeInfo.canonicalFilePath()).fileName() == QLatin1String("qtchooser"))
+        return false;
+    return !QFileInfo(qmakeInfo.absolutePath() + QLatin1String("/qt.conf")).exists();
+}
+
+// The qmake processes run concurrently, so that detecting many Qt installations does not
+// take much longer than detecting one.
+static std::vector<QueryMap> qmakeQueryOutputs(const QStringList &qmakePaths,
+                                               Internal::ToolOutputCache *cache)
+{
+    const QStringList arguments(QLatin1String("-query"));
+    std::vector<QByteArray> outputs(qmakePaths.size());
+    std::vector<std::unique_ptr<QProcess>> processes(qmakePaths.size());
+    for (int i = 0; i < qmakePaths.size(); ++i) {
+        const QString &qmakePath = qmakePaths.at(i);
+        if (canCacheQueryOutput(qmakePath) && cache->lookup(qmakePath, arguments, &outputs[i]))
+            continue;
+        processes[i].reset(new QProcess);
+        processes[i]->start(qmakePath, arguments);
+    }
+
+    std::vector<QueryMap> queryOutputs;
+    for (int i = 0; i < qmakePaths.size(); ++i) {
+        const QString &qmakePath = qmakePaths.at(i);
+        if (QProcess * const qmakeProcess = processes[i].get()) {
+            if (!qmakeProcess->waitForStarted())
+                throw ErrorInfo(SetupQt::tr("%1 cannot be started.").arg(qmakePath));
+            const bool finished = qmakeProcess->waitForFinished();
+            outputs[i] = qmakeProcess->readAllStandardOutput();
+            const bool succeeded = finished && qmakeProcess->exitStatus() == QProcess::NormalExit
+                    && qmakeProcess->exitCode() == 0 && !outputs[i].isEmpty();
+            if (succeeded && canCacheQueryOutput(qmakePath))
+                cache->insert(qmakePath, arguments, outputs[i]);
+        }
+        queryOutputs.push_back(parseQueryOutput(outputs[i]));
+    }
+    return queryOutputs;
+}
+
 static QByteArray readFileContent(const QString &filePath)
 {
     QFile file(filePath);
@@ -182,17 +229,20 @@ static QStringList configVariableItems(const QByteArray &configContent, const QS
     return configVariable(configContent, key).split(QLatin1Char(' '), QString::SkipEmptyParts);
 }
 
-typedef QMap<QByteArray, QByteArray> QueryMap;
-
 static QString pathQueryValue(const QueryMap &queryMap, const QByteArray &key)
 {
     return QDir::fromNativeSeparators(QString::fromLocal8Bit(queryMap.value(key)));
 }
 
-EnhancedQtEnvironment SetupQt::fetchEnvironment(const QString &qmakePath)
+EnhancedQtEnvironment SetupQt::fetchEnvironment(const QString &qmakePath,
+                                                Internal::ToolOutputCache *cache)
+{
+    return environmentFromQueryOutput(qmakeQueryOutputs(QStringList(qmakePath), cache).front());
+}
+
+static EnhancedQtEnvironment environmentFromQueryOutput(const QueryMap &queryOutput)
 {
     EnhancedQtEnvironment qtEnvironment;
-    QueryMap queryOutput = qmakeQueryOutput(qmakePath);
 
     qtEnvironment.installPrefixPath = pathQueryValue(queryOutput, "QT_INSTALL_PREFIX");
     qtEnvironment.documentationPath = pathQueryValue(queryOutput, "QT_INSTALL_DOCS");
@@ -221,7 +271,7 @@ EnhancedQtEnvironment SetupQt::fetchEnvironment(const QString &qmakePath)
     }
 
     if (!QFile::exists(qtEnvironment.mkspecBasePath))
-        throw ErrorInfo(tr("Cannot extract the mkspecs directory."));
+        throw ErrorInfo(SetupQt::tr("Cannot extract the mkspecs directory."));
 
     const QByteArray qconfigContent = readFileContent(qtEnvironment.mkspecBasePath
                                                       + QLatin1String("/qconfig.pri"));
@@ -302,11 +352,11 @@ EnhancedQtEnvironment SetupQt::fetchEnvironment(const QString &qmakePath)
             && qtEnvironment.configItems.contains(QLatin1String("qt_framework"));
 
     // determine whether Qt is built with debug, release or both
-    addQtBuildVariant(&qtEnvironment, QLatin1String("debug"));
-    addQtBuildVariant(&qtEnvironment, QLatin1String("release"));
+    SetupQt::addQtBuildVariant(&qtEnvironment, QLatin1String("debug"));
+    SetupQt::addQtBuildVariant(&qtEnvironment, QLatin1String("release"));
 
     if (!QFileInfo(qtEnvironment.mkspecPath).exists())
-        throw ErrorInfo(tr("mkspec '%1' does not exist").arg(qtEnvironment.mkspecPath));
+        throw ErrorInfo(SetupQt::tr("mkspec '%1' does not exist").arg(qtEnvironment.mkspecPath));
 
     return qtEnvironment;
 }
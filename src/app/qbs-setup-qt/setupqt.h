@@ -49,6 +49,7 @@
 #include <vector>
 
 namespace qbs {
+namespace Internal { class ToolOutputCache; }
 
 class EnhancedQtEnvironment : public QtEnvironment
 {
@@ -63,9 +64,10 @@ class SetupQt
     Q_DECLARE_TR_FUNCTIONS(SetupQt)
 public:
     static bool isQMakePathValid(const QString &qmakePath);
-    static std::vector<EnhancedQtEnvironment> fetchEnvironments();
+    static std::vector<EnhancedQtEnvironment> fetchEnvironments(Internal::ToolOutputCache *cache);
     static void addQtBuildVariant(QtEnvironment *env, const QString &buildVariantName);
-    static EnhancedQtEnvironment fetchEnvironment(const QString &qmakePath);
+    static EnhancedQtEnvironment fetchEnvironment(const QString &qmakePath,
+                                                  Internal::ToolOutputCache *cache);
     static void saveToQbsSettings(const QString &qtVersionName,
                                   const EnhancedQtEnvironment &qtEnvironment,
                                   Settings *settings);
@@ -49,6 +49,7 @@
 #include <tools/qttools.h>
 #include <tools/settings.h>
 #include <tools/toolchains.h>
+#include <tools/tooloutputcache.h>
 #include <tools/stlutils.h>
 
 #include <QtCore/qdir.h>
@@ -58,9 +59,12 @@
 #include <QtCore/qtextstream.h>
 
 #include <cstdio>
+#include <memory>
+#include <vector>
 
 using namespace qbs;
 using Internal::HostOsInfo;
+using Internal::ToolOutputCache;
 using Internal::Tr;
 
 static QTextStream qStdout(stdout);
@@ -83,18 +87,23 @@ static QString findExecutable(const QString &fileName)
     return QString();
 }
 
-static QString qsystem(const QString &exe, const QStringList &args = QStringList())
+static std::unique_ptr<QProcess> startCompiler(const QString &exe, const QStringList &args)
+{
+    std::unique_ptr<QProcess> p(new QProcess);
+    p->setProcessChannelMode(QProcess::MergedChannels);
+    p->start(exe, args);
+    return p;
+}
+
+static QByteArray compilerOutput(QProcess &p, const QString &exe)
 {
-    QProcess p;
-    p.setProcessChannelMode(QProcess::MergedChannels);
-    p.start(exe, args);
     if (!p.waitForStarted()) {
         throw qbs::ErrorInfo(Tr::tr("Failed to start compiler '%1': %2")
                              .arg(exe, p.errorString()));
     }
     if (!p.waitForFinished(-1) || p.exitCode() != 0)
         throw qbs::ErrorInfo(Tr::tr("Failed to run compiler '%1': %2").arg(exe, p.errorString()));
-    return QString::fromLocal8Bit(p.readAll());
+    return p.readAll();
 }
 
 static QStringList validMinGWMachines()
@@ -123,9 +132,27 @@ static QStringList toolchainTypeFromCompilerName(const QString &compilerName)
     return QStringList();
 }
 
-static QString gccMachineName(const QString &compilerFilePath)
+// Runs the compilers concurrently, as that is what takes time, and remembers the results.
+static QStringList gccMachineNames(const QStringList &compilerFilePaths,
+                                   ToolOutputCache *cache)
 {
-    return qsystem(compilerFilePath, QStringList() << QLatin1String("-dumpmachine")).trimmed();
+    const QStringList arguments(QLatin1String("-dumpmachine"));
+    std::vector<QByteArray> outputs(compilerFilePaths.size());
+    std::vector<std::unique_ptr<QProcess>> processes(compilerFilePaths.size());
+    for (int i = 0; i < compilerFilePaths.size(); ++i) {
+        if (!cache->lookup(compilerFilePaths.at(i), arguments, &outputs[i]))
+            processes[i] = startCompiler(compilerFilePaths.at(i), arguments);
+    }
+    QStringList machineNames;
+    for (int i = 0; i < compilerFilePaths.size(); ++i) {
+        if (processes[i]) {
+            outputs[i] = compilerOutput(*processes[i], compilerFilePaths.at(i));
+            cache->insert(compilerFilePaths.at(i), arguments, outputs[i]);
+        }
+        machineNames << QString::fromLocal8Bit(outputs[i]).trimmed();
+    }
+    cache->save();
+    return machineNames;
 }
 
 static QStringList standardCompilerFileNames()
@@ -200,12 +227,10 @@ static bool doesProfileTargetOS(const Profile &profile, const QString &os)
     return Internal::contains(HostOsInfo::hostOSIdentifiers(), os.toStdString());
 }
 
-static Profile createGccProfile(const QString &compilerFilePath, Settings *settings,
-                                const QStringList &toolchainTypes,
+static Profile createGccProfile(const QString &compilerFilePath, const QString &machineName,
+                                Settings *settings, const QStringList &toolchainTypes,
                                 const QString &profileName = QString())
 {
-    const QString machineName = gccMachineName(compilerFilePath);
-
     if (toolchainTypes.contains(QLatin1String("mingw"))) {
         if (!validMinGWMachines().contains(machineName)) {
             throw ErrorInfo(Tr::tr("Detected gcc platform '%1' is not supported.")
@@ -237,7 +262,15 @@ static Profile createGccProfile(const QString &compilerFilePath, Settings *setti
     return profile;
 }
 
-static void gccProbe(Settings *settings, QList<Profile> &profiles, const QString &compilerName)
+class GccCandidate
+{
+public:
+    QString compilerFilePath;
+    QStringList toolchainTypes;
+    QString profileName;
+};
+
+static void gccProbe(std::vector<GccCandidate> &candidates, const QString &compilerName)
 {
     qStdout << Tr::tr("Trying to detect %1...").arg(compilerName) << endl;
 
@@ -248,12 +281,14 @@ static void gccProbe(Settings *settings, QList<Profile> &profiles, const QString
         qStderr << Tr::tr("%1 not found.").arg(compilerName) << endl;
         return;
     }
-    const QString profileName = cfi.completeBaseName();
-    const QStringList toolchainTypes = toolchainTypeFromCompilerName(compilerName);
-    profiles.push_back(createGccProfile(compilerFilePath, settings, toolchainTypes, profileName));
+    GccCandidate candidate;
+    candidate.compilerFilePath = compilerFilePath;
+    candidate.toolchainTypes = toolchainTypeFromCompilerName(compilerName);
+    candidate.profileName = cfi.completeBaseName();
+    candidates.push_back(candidate);
 }
 
-static void mingwProbe(Settings *settings, QList<Profile> &profiles)
+static void mingwProbe(std::vector<GccCandidate> &candidates)
 {
     // List of possible compiler binary names for this platform
     QStringList compilerNames;
@@ -269,27 +304,46 @@ static void mingwProbe(Settings *settings, QList<Profile> &profiles)
     for (const QString &compilerName : qAsConst(compilerNames)) {
         const QString gccPath
                 = findExecutable(HostOsInfo::appendExecutableSuffix(compilerName));
-        if (!gccPath.isEmpty())
-            profiles.push_back(createGccProfile(gccPath, settings,
-                                                canonicalToolchain(QLatin1String("mingw"))));
+        if (!gccPath.isEmpty()) {
+            GccCandidate candidate;
+            candidate.compilerFilePath = gccPath;
+            candidate.toolchainTypes = canonicalToolchain(QLatin1String("mingw"));
+            candidates.push_back(candidate);
+        }
+    }
+}
+
+static void createGccProfiles(Settings *settings, const std::vector<GccCandidate> &candidates,
+                              QList<Profile> &profiles)
+{
+    QStringList compilerFilePaths;
+    for (const GccCandidate &candidate : candidates)
+        compilerFilePaths << candidate.compilerFilePath;
+    ToolOutputCache cache(ToolOutputCache::filePathForSettings(settings));
+    const QStringList machineNames = gccMachineNames(compilerFilePaths, &cache);
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        const GccCandidate &candidate = candidates.at(i);
+        profiles.push_back(createGccProfile(candidate.compilerFilePath, machineNames.at(int(i)),
+                                            settings, candidate.toolchainTypes,
+                                            candidate.profileName));
     }
 }
 
 void probe(Settings *settings)
 {
     QList<Profile> profiles;
+    std::vector<GccCandidate> gccCandidates;
     if (HostOsInfo::isWindowsHost()) {
         msvcProbe(settings, profiles);
     } else {
-        gccProbe(settings, profiles, QLatin1String("gcc"));
-        gccProbe(settings, profiles, QLatin1String("clang"));
-
-        if (HostOsInfo::isMacosHost()) {
-            xcodeProbe(settings, profiles);
-        }
+        gccProbe(gccCandidates, QLatin1String("gcc"));
+        gccProbe(gccCandidates, QLatin1String("clang"));
     }
+    mingwProbe(gccCandidates);
+    createGccProfiles(settings, gccCandidates, profiles);
 
-    mingwProbe(settings, profiles);
+    if (HostOsInfo::isMacosHost())
+        xcodeProbe(settings, profiles);
 
     if (profiles.empty()) {
         qStderr << Tr::tr("Could not detect any toolchains. No profile created.") << endl;
@@ -318,10 +372,14 @@ void createProfile(const QString &profileName, const QString &toolchainType,
     else
         toolchainTypes = canonicalToolchain(toolchainType);
 
-    if (toolchainTypes.contains(QLatin1String("msvc")))
+    if (toolchainTypes.contains(QLatin1String("msvc"))) {
         createMsvcProfile(profileName, compiler.absoluteFilePath(), settings);
-    else if (toolchainTypes.contains(QLatin1String("gcc")))
-        createGccProfile(compiler.absoluteFilePath(), settings, toolchainTypes, profileName);
-    else
+    } else if (toolchainTypes.contains(QLatin1String("gcc"))) {
+        ToolOutputCache cache(ToolOutputCache::filePathForSettings(settings));
+        const QString compilerFilePath = compiler.absoluteFilePath();
+        const QString machineName = gccMachineNames(QStringList(compilerFilePath), &cache).front();
+        createGccProfile(compilerFilePath, machineName, settings, toolchainTypes, profileName);
+    } else {
         throw qbs::ErrorInfo(Tr::tr("Cannot create profile: Unknown toolchain type."));
+    }
 }
@@ -0,0 +1,265 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "filesystemwatcher.h"
+
+#include <logging/translator.h>
+#include <tools/error.h>
+#include <tools/filesystemjournal.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/quuid.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using qbs::ErrorInfo;
+using qbs::Internal::FileSystemJournal;
+using qbs::Internal::Tr;
+
+static const uint32_t watchMask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE
+        | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+static bool isSameOrBelow(const QString &filePath, const QString &dirPath)
+{
+    return filePath.startsWith(dirPath)
+            && (filePath.size() == dirPath.size() || filePath.at(dirPath.size()) == QLatin1Char('/'));
+}
+
+FileSystemWatcher::FileSystemWatcher(const QString &rootDir, const QStringList &excludedDirs,
+                                     const QString &journalFilePath, qint64 maxJournalSize)
+    : m_rootDir(rootDir)
+    , m_excludedDirs(excludedDirs)
+    , m_journalFilePath(journalFilePath)
+    , m_maxJournalSize(maxJournalSize)
+    , m_journal(journalFilePath)
+{
+}
+
+FileSystemWatcher::~FileSystemWatcher()
+{
+    m_notifier.reset();
+    if (m_inotifyFd != -1)
+        ::close(m_inotifyFd);
+}
+
+void FileSystemWatcher::start()
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd == -1) {
+        throw ErrorInfo(Tr::tr("Cannot initialize inotify: %1")
+                        .arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+
+    // Watches must be in place before the session starts, so that no change can slip through
+    // between the header being written and the watches being set up.
+    addWatchesRecursively(m_rootDir);
+    m_changedPaths.clear();
+    m_changedTrees.clear();
+    startSession();
+
+    m_notifier.reset(new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read));
+    QObject::connect(m_notifier.get(), &QSocketNotifier::activated, [this] {
+        try {
+            readEvents();
+        } catch (const ErrorInfo &e) {
+            std::cerr << qPrintable(e.toString()) << std::endl;
+            QCoreApplication::exit(EXIT_FAILURE);
+        }
+    });
+}
+
+// Starts a new journal file. Readers will notice the new session and check all files once.
+void FileSystemWatcher::startSession()
+{
+    m_journal.close();
+    const QString tmpFilePath = m_journalFilePath + QLatin1String(".tmp");
+    QFile tmpFile(tmpFilePath);
+    const QByteArray header = FileSystemJournal::header(
+                QUuid::createUuid().toString(), m_rootDir, m_excludedDirs);
+    if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || tmpFile.write(header) != header.size() || !tmpFile.flush()) {
+        throw ErrorInfo(Tr::tr("Cannot write journal file '%1': %2")
+                        .arg(tmpFilePath, tmpFile.errorString()));
+    }
+    tmpFile.close();
+    if (std::rename(QFile::encodeName(tmpFilePath).constData(),
+                    QFile::encodeName(m_journalFilePath).constData()) != 0) {
+        throw ErrorInfo(Tr::tr("Cannot rename '%1' to '%2': %3")
+                        .arg(tmpFilePath, m_journalFilePath,
+                             QString::fromLocal8Bit(std::strerror(errno))));
+    }
+    if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        throw ErrorInfo(Tr::tr("Cannot open journal file '%1': %2")
+                        .arg(m_journalFilePath, m_journal.errorString()));
+    }
+    m_overflow = false;
+}
+
+void FileSystemWatcher::readEvents()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+    while (true) {
+        const ssize_t length = ::read(m_inotifyFd, buffer, sizeof buffer);
+        if (length <= 0)
+            break;
+        for (const char *p = buffer; p < buffer + length; ) {
+            const auto event = reinterpret_cast<const inotify_event *>(p);
+            handleEvent(*event);
+            p += sizeof(inotify_event) + event->len;
+        }
+    }
+    writePendingEntries();
+}
+
+void FileSystemWatcher::handleEvent(const inotify_event &event)
+{
+    if (event.mask & IN_Q_OVERFLOW) {
+        m_overflow = true;
+        return;
+    }
+    if (event.mask & IN_IGNORED) {
+        m_dirsByWatch.remove(event.wd);
+        return;
+    }
+    const QString dirPath = m_dirsByWatch.value(event.wd);
+    if (dirPath.isEmpty() || event.len == 0)
+        return;
+    const QString filePath = dirPath + QLatin1Char('/') + QFile::decodeName(event.name);
+    if (isIgnored(filePath))
+        return;
+
+    m_changedPaths.insert(filePath);
+    if (event.mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO))
+        m_changedPaths.insert(dirPath); // The directory's list of entries changed.
+    if (!(event.mask & IN_ISDIR))
+        return;
+
+    // Files inside directories that appear, disappear or move around do not get reported
+    // individually, so we record the whole tree.
+    if (event.mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO))
+        m_changedTrees.insert(filePath);
+    if (event.mask & IN_MOVED_FROM)
+        removeWatchesRecursively(filePath);
+    if (event.mask & (IN_CREATE | IN_MOVED_TO))
+        addWatchesRecursively(filePath);
+}
+
+void FileSystemWatcher::addWatchesRecursively(const QString &dirPath)
+{
+    QStringList dirPaths(dirPath);
+    QDirIterator it(dirPath, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString subDirPath = it.next();
+        if (!isIgnored(subDirPath))
+            dirPaths << subDirPath;
+    }
+    for (const QString &path : qAsConst(dirPaths)) {
+        const int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(path).constData(),
+                                         watchMask);
+        if (wd == -1) {
+            if (errno == ENOENT) // Vanished in the meantime.
+                continue;
+            std::cerr << qPrintable(Tr::tr("Cannot watch directory '%1': %2")
+                                    .arg(path, QString::fromLocal8Bit(std::strerror(errno))))
+                      << std::endl;
+            m_overflow = true;
+            continue;
+        }
+        m_dirsByWatch.insert(wd, path);
+    }
+}
+
+void FileSystemWatcher::removeWatchesRecursively(const QString &dirPath)
+{
+    for (auto it = m_dirsByWatch.begin(); it != m_dirsByWatch.end();) {
+        if (isSameOrBelow(it.value(), dirPath)) {
+            inotify_rm_watch(m_inotifyFd, it.key());
+            it = m_dirsByWatch.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FileSystemWatcher::writePendingEntries()
+{
+    QByteArray entries;
+    for (const QString &filePath : qAsConst(m_changedPaths))
+        entries += FileSystemJournal::changedPathEntry(filePath);
+    for (const QString &dirPath : qAsConst(m_changedTrees))
+        entries += FileSystemJournal::changedTreeEntry(dirPath);
+    if (m_overflow)
+        entries += FileSystemJournal::overflowEntry();
+    m_changedPaths.clear();
+    m_changedTrees.clear();
+    m_overflow = false;
+    if (entries.isEmpty())
+        return;
+
+    if (m_journal.size() + entries.size() > m_maxJournalSize) {
+        startSession();
+        return;
+    }
+    if (m_journal.write(entries) != entries.size() || !m_journal.flush()) {
+        throw ErrorInfo(Tr::tr("Cannot write to journal file '%1': %2")
+                        .arg(m_journalFilePath, m_journal.errorString()));
+    }
+}
+
+bool FileSystemWatcher::isIgnored(const QString &filePath) const
+{
+    if (filePath == m_journalFilePath || filePath.startsWith(m_journalFilePath + QLatin1Char('.')))
+        return true;
+    for (const QString &excludedDir : m_excludedDirs) {
+        if (isSameOrBelow(filePath, excludedDir))
+            return true;
+    }
+    return false;
+}
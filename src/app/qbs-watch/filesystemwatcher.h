@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBS_FILESYSTEMWATCHER_H
+#define QBS_FILESYSTEMWATCHER_H
+
+#include <tools/set.h>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+struct inotify_event;
+
+// Watches a directory tree via inotify and records all changes in a qbs file system journal.
+class FileSystemWatcher
+{
+public:
+    FileSystemWatcher(const QString &rootDir, const QStringList &excludedDirs,
+                      const QString &journalFilePath, qint64 maxJournalSize);
+    ~FileSystemWatcher();
+
+    void start();
+
+private:
+    void startSession();
+    void readEvents();
+    void handleEvent(const inotify_event &event);
+    void addWatchesRecursively(const QString &dirPath);
+    void removeWatchesRecursively(const QString &dirPath);
+    void writePendingEntries();
+    bool isIgnored(const QString &filePath) const;
+
+    const QString m_rootDir;
+    const QStringList m_excludedDirs;
+    const QString m_journalFilePath;
+    const qint64 m_maxJournalSize;
+    int m_inotifyFd = -1;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+    QHash<int, QString> m_dirsByWatch;
+    QFile m_journal;
+
+    qbs::Internal::Set<QString> m_changedPaths;
+    qbs::Internal::Set<QString> m_changedTrees;
+    bool m_overflow = false;
+};
+
+#endif // QBS_FILESYSTEMWATCHER_H
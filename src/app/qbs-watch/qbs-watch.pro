@@ -0,0 +1,9 @@
+include(../app.pri)
+
+TARGET = qbs-watch
+
+HEADERS += \
+    filesystemwatcher.h
+SOURCES += \
+    filesystemwatcher.cpp \
+    watch-main.cpp
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "filesystemwatcher.h"
+
+#include <logging/translator.h>
+#include <tools/error.h>
+
+#include <QtCore/qcommandlineoption.h>
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qstringlist.h>
+
+#include <iostream>
+
+static QString absoluteCleanPath(const QString &path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+int main(int argc, char *argv[])
+{
+    using qbs::ErrorInfo;
+    using qbs::Internal::Tr;
+
+    QCoreApplication app(argc, argv);
+    const QCommandLineOption journalOpt(QLatin1String("journal"),
+            Tr::tr("The file to record changes in. Pass the same file to qbs via the "
+                   "--fs-journal option."), QLatin1String("file"));
+    const QCommandLineOption excludeOpt(QLatin1String("exclude"),
+            Tr::tr("Do not watch this directory. Typically used for the build directory. "
+                   "Can be given several times."), QLatin1String("directory"));
+    const QCommandLineOption maxSizeOpt(QLatin1String("max-journal-size"),
+            Tr::tr("Start a new journal once the current one grows beyond this size in MB. "
+                   "The default is 16."), QLatin1String("size"), QLatin1String("16"));
+    QCommandLineParser parser;
+    parser.setApplicationDescription(Tr::tr("This tool watches a source tree and records all "
+                                            "changes in a journal, so that qbs does not have to "
+                                            "check every file when re-resolving or building."));
+    parser.addOption(journalOpt);
+    parser.addOption(excludeOpt);
+    parser.addOption(maxSizeOpt);
+    parser.addPositionalArgument(QLatin1String("directory"),
+                                 Tr::tr("The directory to watch. The default is the current "
+                                        "directory."), QLatin1String("[directory]"));
+    parser.addHelpOption();
+    parser.process(app);
+
+    if (!parser.isSet(journalOpt)) {
+        std::cerr << qPrintable(Tr::tr("The --journal option is required.")) << std::endl;
+        return 1;
+    }
+    if (parser.positionalArguments().size() > 1) {
+        std::cerr << qPrintable(Tr::tr("Only one directory can be watched.")) << std::endl;
+        return 1;
+    }
+    bool ok;
+    const qint64 maxJournalSize = parser.value(maxSizeOpt).toLongLong(&ok) * 1024 * 1024;
+    if (!ok || maxJournalSize <= 0) {
+        std::cerr << qPrintable(Tr::tr("Invalid journal size '%1'.")
+                                .arg(parser.value(maxSizeOpt))) << std::endl;
+        return 1;
+    }
+    const QString rootDir = absoluteCleanPath(parser.positionalArguments().isEmpty()
+                                              ? QDir::currentPath()
+                                              : parser.positionalArguments().front());
+    QStringList excludedDirs;
+    for (const QString &dir : parser.values(excludeOpt))
+        excludedDirs << absoluteCleanPath(dir);
+
+    FileSystemWatcher watcher(rootDir, excludedDirs, absoluteCleanPath(parser.value(journalOpt)),
+                              maxJournalSize);
+    try {
+        watcher.start();
+    } catch (const ErrorInfo &e) {
+        std::cerr << qPrintable(Tr::tr("Error watching directory: %1").arg(e.toString()))
+                  << std::endl;
+        return 1;
+    }
+    return app.exec();
+}
@@ -0,0 +1,505 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "buildserver.h"
+
+#include "parser/commandlineparser.h"
+#include "../shared/logging/consolelogger.h"
+
+#include <logging/translator.h>
+#include <tools/error.h>
+#include <tools/settings.h>
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qtimer.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace qbs {
+using namespace Internal;
+
+static const quint32 protocolVersion = 1;
+static const quint32 maxRequestSize = 64 * 1024 * 1024;
+static const QDataStream::Version dataStreamVersion = QDataStream::Qt_5_6;
+
+#ifdef Q_OS_UNIX
+
+static QString errnoString()
+{
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+static bool setupAddress(const QString &socketFilePath, sockaddr_un &address)
+{
+    const QByteArray encodedPath = QFile::encodeName(socketFilePath);
+    if (encodedPath.size() >= int(sizeof address.sun_path))
+        return false;
+    std::memset(&address, 0, sizeof address);
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, encodedPath.constData(), encodedPath.size());
+    return true;
+}
+
+static int connectToServer(const QString &socketFilePath)
+{
+    sockaddr_un address;
+    if (!setupAddress(socketFilePath, address))
+        return -1;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+        return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof address) == -1) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool readAll(int fd, char *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t bytesRead = ::read(fd, data, size);
+        if (bytesRead == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (bytesRead == 0)
+            return false;
+        data += bytesRead;
+        size -= bytesRead;
+    }
+    return true;
+}
+
+// Whoever can talk to the server can make it run arbitrary commands, so we only accept
+// connections from our own user.
+static bool isConnectedToSameUser(int fd)
+{
+#ifdef SO_PEERCRED
+    ucred credentials;
+    socklen_t length = sizeof credentials;
+    return ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0
+            && credentials.uid == ::geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    return ::getpeereid(fd, &uid, &gid) == 0 && uid == ::geteuid();
+#endif
+}
+
+static int clientSocketFd = -1;
+
+// Called from the signal handler in the client. The server cancels the current command.
+static void forwardInterrupt(int sig)
+{
+    Q_UNUSED(sig);
+    const char c = 'c';
+    const ssize_t written = ::write(clientSocketFd, &c, 1);
+    Q_UNUSED(written);
+}
+
+#endif // Q_OS_UNIX
+
+static ErrorInfo invalidRequestError()
+{
+    return ErrorInfo(Tr::tr("Invalid request to the build server."));
+}
+
+BuildServer::BuildServer(const QString &socketFilePath, QObject *parent)
+    : QObject(parent), m_socketFilePath(socketFilePath)
+{
+}
+
+BuildServer::~BuildServer()
+{
+#ifdef Q_OS_UNIX
+    m_frontend.reset();
+    m_listenNotifier.reset();
+    m_clientNotifier.reset();
+    if (m_clientFd != -1)
+        ::close(m_clientFd);
+    if (m_listenFd != -1) {
+        ::close(m_listenFd);
+        QFile::remove(m_socketFilePath);
+    }
+    for (const int fd : m_savedStdFds) {
+        if (fd != -1)
+            ::close(fd);
+    }
+#endif
+}
+
+void BuildServer::start()
+{
+#ifdef Q_OS_UNIX
+    sockaddr_un address;
+    if (!setupAddress(m_socketFilePath, address))
+        throw ErrorInfo(Tr::tr("The socket file path '%1' is too long.").arg(m_socketFilePath));
+    const int otherServerFd = connectToServer(m_socketFilePath);
+    if (otherServerFd != -1) {
+        ::close(otherServerFd);
+        throw ErrorInfo(Tr::tr("There already is a build server listening on '%1'.")
+                        .arg(m_socketFilePath));
+    }
+    QFile::remove(m_socketFilePath); // Left over from a server that did not shut down properly.
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || ::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1
+            || ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof address) == -1) {
+        const QString reason = errnoString();
+        if (fd != -1)
+            ::close(fd);
+        throw ErrorInfo(Tr::tr("Cannot create socket '%1': %2").arg(m_socketFilePath, reason));
+    }
+    m_listenFd = fd;
+    if (::chmod(QFile::encodeName(m_socketFilePath).constData(), S_IRUSR | S_IWUSR) == -1
+            || ::listen(m_listenFd, 16) == -1) {
+        throw ErrorInfo(Tr::tr("Cannot listen on socket '%1': %2")
+                        .arg(m_socketFilePath, errnoString()));
+    }
+
+    // The standard file descriptors get replaced by the client's ones while a request
+    // is being handled.
+    for (int i = 0; i < 3; ++i)
+        m_savedStdFds[i] = ::fcntl(i, F_DUPFD_CLOEXEC, 3);
+
+    // Requests set their own log level.
+    m_serverLogLevel = ConsoleLogger::instance().logSink()->logLevel();
+
+    // Clients can go away at any time.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    m_listenNotifier.reset(new QSocketNotifier(m_listenFd, QSocketNotifier::Read));
+    connect(m_listenNotifier.get(), &QSocketNotifier::activated,
+            this, &BuildServer::acceptConnection);
+    qbsInfo() << Tr::tr("Build server listening on '%1'.").arg(m_socketFilePath);
+#else
+    throw ErrorInfo(Tr::tr("The build server is not supported on this platform."));
+#endif
+}
+
+bool BuildServer::sendRequest(const QString &socketFilePath, const QStringList &arguments,
+                              int *exitCode)
+{
+#ifdef Q_OS_UNIX
+    const int fd = connectToServer(socketFilePath);
+    if (fd == -1)
+        return false;
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(dataStreamVersion);
+    stream << protocolVersion << QDir::currentPath() << arguments
+           << QProcessEnvironment::systemEnvironment().toStringList();
+
+    // The size of the payload goes first, together with our standard file descriptors.
+    quint32 size = payload.size();
+    int fds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    iovec iov;
+    iov.iov_base = &size;
+    iov.iov_len = sizeof size;
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof fds)];
+    } control;
+    std::memset(&control, 0, sizeof control);
+    msghdr message;
+    std::memset(&message, 0, sizeof message);
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof control.buffer;
+    cmsghdr * const cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof fds);
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof fds);
+    if (::sendmsg(fd, &message, 0) != ssize_t(sizeof size)
+            || !writeAll(fd, payload.constData(), payload.size())) {
+        ::close(fd);
+        return false;
+    }
+
+    clientSocketFd = fd;
+    const auto oldSigIntHandler = std::signal(SIGINT, forwardInterrupt);
+    qint32 result;
+    const bool resultReceived = readAll(fd, reinterpret_cast<char *>(&result), sizeof result);
+    std::signal(SIGINT, oldSigIntHandler);
+    clientSocketFd = -1;
+    ::close(fd);
+    if (!resultReceived) {
+        qbsError() << Tr::tr("Lost connection to the build server.");
+        result = EXIT_FAILURE;
+    }
+    *exitCode = result;
+    return true;
+#else
+    Q_UNUSED(socketFilePath);
+    Q_UNUSED(arguments);
+    Q_UNUSED(exitCode);
+    return false;
+#endif
+}
+
+void BuildServer::acceptConnection()
+{
+#ifdef Q_OS_UNIX
+    const int fd = ::accept(m_listenFd, nullptr, nullptr);
+    if (fd == -1)
+        return;
+    if (::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1 || !isConnectedToSameUser(fd)) {
+        ::close(fd);
+        return;
+    }
+    m_clientFd = fd;
+    m_listenNotifier->setEnabled(false);
+    try {
+        handleRequest();
+    } catch (const ErrorInfo &error) {
+        qbsError() << error.toString();
+        finishRequest(EXIT_FAILURE);
+    } catch (const std::exception &e) {
+        qbsError() << QString::fromLocal8Bit(e.what());
+        finishRequest(EXIT_FAILURE);
+    }
+#endif
+}
+
+void BuildServer::handleRequest()
+{
+#ifdef Q_OS_UNIX
+    quint32 size = 0;
+    iovec iov;
+    iov.iov_base = &size;
+    iov.iov_len = sizeof size;
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(3 * sizeof(int))];
+    } control;
+    msghdr message;
+    std::memset(&message, 0, sizeof message);
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof control.buffer;
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::recvmsg(m_clientFd, &message, 0);
+    } while (bytesRead == -1 && errno == EINTR);
+
+    // We own whatever descriptors came along, so they must be closed even if the request
+    // turns out to be invalid.
+    std::vector<int> receivedFds;
+    if (bytesRead != -1) {
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg;
+             cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+                continue;
+            const size_t fdCount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const unsigned char * const data = CMSG_DATA(cmsg);
+            for (size_t i = 0; i < fdCount; ++i) {
+                int fd;
+                std::memcpy(&fd, data + i * sizeof fd, sizeof fd);
+                receivedFds.push_back(fd);
+            }
+        }
+    }
+    const bool isValid = bytesRead == ssize_t(sizeof size) && size <= maxRequestSize
+            && !(message.msg_flags & MSG_CTRUNC) && receivedFds.size() == 3;
+    if (!isValid) {
+        for (const int fd : receivedFds)
+            ::close(fd);
+        throw invalidRequestError();
+    }
+
+    // From here on, all output goes to the client. Our own descriptors get restored
+    // by finishRequest(), which is also called if the request fails.
+    std::fflush(stdout);
+    std::fflush(stderr);
+    for (int i = 0; i < 3; ++i) {
+        ::dup2(receivedFds.at(i), i);
+        ::close(receivedFds.at(i));
+    }
+
+    QByteArray payload(int(size), Qt::Uninitialized);
+    if (!readAll(m_clientFd, payload.data(), size))
+        throw invalidRequestError();
+    QDataStream stream(payload);
+    stream.setVersion(dataStreamVersion);
+    quint32 clientProtocolVersion;
+    stream >> clientProtocolVersion;
+    if (clientProtocolVersion != protocolVersion) {
+        throw ErrorInfo(Tr::tr("The build server was started by a different version of qbs. "
+                               "Please restart it."));
+    }
+    QString workingDirectory;
+    QStringList arguments;
+    QStringList environment;
+    stream >> workingDirectory >> arguments >> environment;
+    if (stream.status() != QDataStream::Ok)
+        throw invalidRequestError();
+
+    // We are the only thread at this point, so it is safe to replace the environment.
+    QProcessEnvironment clientEnvironment;
+    for (const QString &entry : qAsConst(environment)) {
+        const int sepPos = entry.indexOf(QLatin1Char('='));
+        if (sepPos > 0)
+            clientEnvironment.insert(entry.left(sepPos), entry.mid(sepPos + 1));
+    }
+    const QStringList serverVariables = QProcessEnvironment::systemEnvironment().keys();
+    for (const QString &key : serverVariables) {
+        if (!clientEnvironment.contains(key))
+            qunsetenv(key.toLocal8Bit().constData());
+    }
+    const QStringList clientVariables = clientEnvironment.keys();
+    for (const QString &key : clientVariables)
+        qputenv(key.toLocal8Bit().constData(), clientEnvironment.value(key).toLocal8Bit());
+    if (!QDir::setCurrent(workingDirectory))
+        throw ErrorInfo(Tr::tr("Cannot change into directory '%1'.").arg(workingDirectory));
+
+    m_parser.reset(new CommandLineParser);
+    if (!m_parser->parseCommandLine(arguments)) {
+        finishRequest(EXIT_FAILURE);
+        return;
+    }
+    if (m_parser->command() == HelpCommandType || m_parser->command() == ServeCommandType) {
+        throw ErrorInfo(Tr::tr("The '%1' command cannot be run by the build server.")
+                        .arg(m_parser->commandName()));
+    }
+    m_settings.reset(new Settings(m_parser->settingsDir()));
+    ConsoleLogger::instance().setSettings(m_settings.get());
+    m_frontend.reset(new CommandLineFrontend(*m_parser, m_settings.get()));
+    m_frontend->setProjectCache(&m_projects);
+    connect(m_frontend.get(), &CommandLineFrontend::finished, this, &BuildServer::finishRequest,
+            Qt::QueuedConnection);
+    m_clientNotifier.reset(new QSocketNotifier(m_clientFd, QSocketNotifier::Read));
+    connect(m_clientNotifier.get(), &QSocketNotifier::activated,
+            this, &BuildServer::handleClientInput);
+    QTimer::singleShot(0, m_frontend.get(), &CommandLineFrontend::start);
+#endif
+}
+
+void BuildServer::handleClientInput()
+{
+#ifdef Q_OS_UNIX
+    char c;
+    const ssize_t bytesRead = ::read(m_clientFd, &c, 1);
+    if (bytesRead == -1 && errno == EINTR)
+        return;
+    if (bytesRead <= 0) // The client went away.
+        m_clientNotifier->setEnabled(false);
+    if (m_frontend)
+        m_frontend->cancel();
+#endif
+}
+
+void BuildServer::finishRequest(int exitCode)
+{
+#ifdef Q_OS_UNIX
+    if (m_clientFd == -1)
+        return;
+    m_clientNotifier.reset();
+    ConsoleLogger::instance().logSink()->setAsynchronous(false);
+    std::fflush(stdout);
+    std::fflush(stderr);
+    const qint32 result = exitCode;
+    writeAll(m_clientFd, reinterpret_cast<const char *>(&result), sizeof result);
+    ::close(m_clientFd);
+    m_clientFd = -1;
+    for (int i = 0; i < 3; ++i) {
+        if (m_savedStdFds[i] != -1)
+            ::dup2(m_savedStdFds[i], i);
+    }
+
+    m_frontend.reset();
+    m_parser.reset();
+    m_settings.reset();
+    ConsoleLogger::instance().logSink()->setLogLevel(m_serverLogLevel);
+
+    // Projects whose setup failed after their build data was taken over are of no use anymore.
+    for (auto it = m_projects.begin(); it != m_projects.end();) {
+        if (it->isValid())
+            ++it;
+        else
+            it = m_projects.erase(it);
+    }
+
+    m_listenNotifier->setEnabled(true);
+#else
+    Q_UNUSED(exitCode);
+#endif
+}
+
+} // namespace qbs
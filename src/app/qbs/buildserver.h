@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBS_BUILDSERVER_H
+#define QBS_BUILDSERVER_H
+
+#include "commandlinefrontend.h"
+
+#include <logging/ilogsink.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+namespace qbs {
+class CommandLineParser;
+class Settings;
+
+/*
+ * Runs command lines sent by other qbs processes, keeping the projects they set up in memory.
+ * The client passes its standard file descriptors along with the request, so all output goes
+ * directly to the client's terminal. Requests are handled one at a time.
+ * Only supported on Unix.
+ */
+class BuildServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit BuildServer(const QString &socketFilePath, QObject *parent = nullptr);
+    ~BuildServer();
+
+    void start();
+
+    // Returns false if no server is listening on the socket.
+    static bool sendRequest(const QString &socketFilePath, const QStringList &arguments,
+                            int *exitCode);
+
+private:
+    void acceptConnection();
+    void handleRequest();
+    void handleClientInput();
+    void finishRequest(int exitCode);
+
+    const QString m_socketFilePath;
+    int m_listenFd = -1;
+    int m_clientFd = -1;
+    int m_savedStdFds[3] = { -1, -1, -1 };
+    std::unique_ptr<QSocketNotifier> m_listenNotifier;
+    std::unique_ptr<QSocketNotifier> m_clientNotifier;
+    std::unique_ptr<CommandLineParser> m_parser;
+    std::unique_ptr<Settings> m_settings;
+    std::unique_ptr<CommandLineFrontend> m_frontend;
+    CommandLineFrontend::ProjectCache m_projects;
+    LoggerLevel m_serverLogLevel = defaultLogLevel();
+};
+
+} // namespace qbs
+
+#endif // QBS_BUILDSERVER_H
@@ -47,6 +47,7 @@
 #include <qbs.h>
 #include <api/runenvironment.h>
 #include <logging/translator.h>
+#include <tools/metrics.h>
 #include <tools/qbsassert.h>
 #include <tools/projectgeneratormanager.h>
 #include <tools/qttools.h>
@@ -72,6 +73,7 @@ CommandLineFrontend::CommandLineFrontend(const CommandLineParser &parser, Settin
     , m_cancelStatus(CancelStatusNone)
     , m_cancelTimer(new QTimer(this))
 {
+    connect(this, &CommandLineFrontend::finished, this, &CommandLineFrontend::writeMetrics);
 }
 
 CommandLineFrontend::~CommandLineFrontend()
@@ -93,8 +95,10 @@ void CommandLineFrontend::checkCancelStatus()
     case CancelStatusRequested:
         m_cancelStatus = CancelStatusCanceling;
         m_cancelTimer->stop();
-        if (m_resolveJobs.empty() && m_buildJobs.empty())
-            std::exit(EXIT_FAILURE);
+        if (m_resolveJobs.empty() && m_buildJobs.empty()) {
+            emit finished(EXIT_FAILURE);
+            return;
+        }
         for (AbstractJob * const job : qAsConst(m_resolveJobs))
             job->cancel();
         for (AbstractJob * const job : qAsConst(m_buildJobs))
@@ -135,17 +139,26 @@ void CommandLineFrontend::start()
 
         if (m_parser.showVersion()) {
             puts(QBS_VERSION);
-            qApp->exit(EXIT_SUCCESS);
+            emit finished(EXIT_SUCCESS);
             return;
         }
+        // The progress bar is written directly to stdout, so it must not overtake log messages
+        // that are still queued.
         if (m_parser.showProgress())
             m_observer = new ConsoleProgressObserver;
+        else
+            ConsoleLogger::instance().logSink()->setAsynchronous(true);
+        if (!m_parser.metricsFilePath().isEmpty()) {
+            Metrics::reset();
+            Metrics::setEnabled(true);
+        }
         SetupProjectParameters params;
         params.setEnvironment(QProcessEnvironment::systemEnvironment());
         params.setProjectFilePath(m_parser.projectFilePath());
         params.setDryRun(m_parser.dryRun());
         params.setForceProbeExecution(m_parser.forceProbesExecution());
         params.setWaitLockBuildGraph(m_parser.waitLockBuildGraph());
+        params.setFileSystemJournalFilePath(m_parser.fileSystemJournalFilePath());
         params.setLogElapsedTime(m_parser.logTime());
         params.setSettingsDirectory(m_settings->baseDirectory());
         params.setOverrideBuildGraphData(m_parser.command() == ResolveCommandType);
@@ -176,10 +189,16 @@ void CommandLineFrontend::start()
             params.setConfigurationName(configurationName);
             params.setBuildRoot(buildDirectory(profileName));
             params.setOverriddenValues(userConfig);
-            SetupProjectJob * const job = Project().setupProject(params,
+            const QString projectCacheKey = params.projectFilePath() + QLatin1Char('\n')
+                    + params.buildRoot() + QLatin1Char('\n') + configurationName;
+            Project existingProject;
+            if (m_projectCache)
+                existingProject = m_projectCache->value(projectCacheKey);
+            SetupProjectJob * const job = existingProject.setupProject(params,
                     ConsoleLogger::instance().logSink(), this);
             connectJob(job);
             m_resolveJobs.push_back(job);
+            m_projectCacheKeys.insert(job, projectCacheKey);
         }
 
         /*
@@ -202,7 +221,7 @@ void CommandLineFrontend::start()
     } catch (const ErrorInfo &error) {
         qbsError() << error.toString();
         if (m_buildJobs.empty() && m_resolveJobs.empty()) {
-            qApp->exit(EXIT_FAILURE);
+            emit finished(EXIT_FAILURE);
         } else {
             cancel();
             checkCancelStatus();
@@ -225,22 +244,24 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
             m_resolveJobs.removeOne(job);
             m_buildJobs.removeOne(job);
             if (m_resolveJobs.empty() && m_buildJobs.empty()) {
-                qApp->exit(EXIT_FAILURE);
+                emit finished(EXIT_FAILURE);
                 return;
             }
             cancel();
         } else if (SetupProjectJob * const setupJob = qobject_cast<SetupProjectJob *>(job)) {
             m_resolveJobs.removeOne(job);
             m_projects.push_back(setupJob->project());
+            if (m_projectCache)
+                m_projectCache->insert(m_projectCacheKeys.value(job), setupJob->project());
             if (m_observer && resolvingMultipleProjects())
                 m_observer->incrementProgressValue();
             if (m_resolveJobs.empty())
                 handleProjectsResolved();
         } else if (qobject_cast<InstallJob *>(job)) {
             if (m_parser.command() == RunCommandType)
-                qApp->exit(runTarget());
+                emit finished(runTarget());
             else
-                qApp->quit();
+                emit finished(EXIT_SUCCESS);
         } else { // Build or clean.
             m_buildJobs.removeOne(job);
             if (m_buildJobs.empty()) {
@@ -254,7 +275,7 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
                     // fall through
                 case BuildCommandType:
                 case CleanCommandType:
-                    qApp->exit(m_cancelStatus == CancelStatusNone ? EXIT_SUCCESS : EXIT_FAILURE);
+                    emit finished(m_cancelStatus == CancelStatusNone ? EXIT_SUCCESS : EXIT_FAILURE);
                     break;
                 default:
                     Q_ASSERT_X(false, Q_FUNC_INFO, "Missing case in switch statement");
@@ -263,7 +284,7 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
         }
     } catch (const ErrorInfo &error) {
         qbsError() << error.toString();
-        qApp->exit(EXIT_FAILURE);
+        emit finished(EXIT_FAILURE);
     }
 }
 
@@ -379,16 +400,16 @@ void CommandLineFrontend::handleProjectsResolved()
         throw ErrorInfo(Tr::tr("Execution canceled."));
     switch (m_parser.command()) {
     case ResolveCommandType:
-        qApp->quit();
+        emit finished(EXIT_SUCCESS);
         break;
     case CleanCommandType:
         makeClean();
         break;
     case ShellCommandType:
-        qApp->exit(runShell());
+        emit finished(runShell());
         break;
     case StatusCommandType:
-        qApp->exit(printStatus(m_projects.front().projectData()));
+        emit finished(printStatus(m_projects.front().projectData()));
         break;
     case GenerateCommandType:
         checkGeneratorName();
@@ -405,18 +426,19 @@ void CommandLineFrontend::handleProjectsResolved()
         break;
     case UpdateTimestampsCommandType:
         updateTimestamps();
-        qApp->quit();
+        emit finished(EXIT_SUCCESS);
         break;
     case DumpNodesTreeCommandType:
         dumpNodesTree();
-        qApp->quit();
+        emit finished(EXIT_SUCCESS);
         break;
     case ListProductsCommandType:
         listProducts();
-        qApp->quit();
+        emit finished(EXIT_SUCCESS);
         break;
     case HelpCommandType:
     case VersionCommandType:
+    case ServeCommandType:
         Q_ASSERT_X(false, Q_FUNC_INFO, "Impossible.");
     }
 }
@@ -451,6 +473,8 @@ int CommandLineFrontend::runShell()
     default:
         throw ErrorInfo(Tr::tr("The command '%1' cannot take more than one product."));
     }
+    m_projects.front().waitForPendingStore(); // Might still log.
+    ConsoleLogger::instance().logSink()->setAsynchronous(false); // The shell shares our stdout.
     RunEnvironment runEnvironment = m_projects.front().getRunEnvironment(productToRun,
             m_parser.installOptions(m_projects.front().profile()),
             QProcessEnvironment::systemEnvironment(), QStringList(), m_settings);
@@ -559,6 +583,8 @@ int CommandLineFrontend::runTarget()
         throw ErrorInfo(Tr::tr("Cannot run: Product '%1' is not an application.")
                     .arg(productToRun.name()));
     }
+    m_projects.front().waitForPendingStore(); // Might still log.
+    ConsoleLogger::instance().logSink()->setAsynchronous(false); // The target shares our stdout.
     RunEnvironment runEnvironment = m_projects.front().getRunEnvironment(productToRun,
             m_parser.installOptions(m_projects.front().profile()),
             QProcessEnvironment::systemEnvironment(), m_parser.runEnvConfig(), m_settings);
@@ -576,6 +602,7 @@ void CommandLineFrontend::updateTimestamps()
 
 void CommandLineFrontend::dumpNodesTree()
 {
+    ConsoleLogger::instance().logSink()->flush();
     QFile stdOut;
     stdOut.open(stdout, QIODevice::WriteOnly);
     const ErrorInfo error = m_projects.front().dumpNodesTree(stdOut, productsToUse()
@@ -696,4 +723,17 @@ void CommandLineFrontend::install()
     connectJob(installJob);
 }
 
+void CommandLineFrontend::writeMetrics()
+{
+    const QString filePath = m_parser.metricsFilePath();
+    if (filePath.isEmpty() || !Metrics::isEnabled())
+        return;
+    Metrics::setEnabled(false);
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(Metrics::toJson()) == -1) {
+        qbsWarning() << Tr::tr("Failed to write metrics to '%1': %2")
+                        .arg(QDir::toNativeSeparators(filePath), file.errorString());
+    }
+}
+
 } // namespace qbs
@@ -69,9 +69,17 @@ public:
                                  QObject *parent = nullptr);
     ~CommandLineFrontend();
 
+    // Projects that were set up by earlier frontends, keyed by project file, build root and
+    // configuration name. Newly set up projects get added.
+    typedef QHash<QString, Project> ProjectCache;
+    void setProjectCache(ProjectCache *projectCache) { m_projectCache = projectCache; }
+
     void cancel();
     void start();
 
+signals:
+    void finished(int exitCode);
+
 private:
     void handleCommandDescriptionReport(const QString &highlight, const QString &message);
     void handleJobFinished(bool success, qbs::AbstractJob *job);
@@ -102,6 +110,7 @@ private:
     void connectJob(AbstractJob *job);
     ProductData getTheOneRunnableProduct();
     void install();
+    void writeMetrics();
     BuildOptions buildOptions(const Project &project) const;
     QString buildDirectory(const QString &profileName) const;
 
@@ -110,6 +119,8 @@ private:
     QList<AbstractJob *> m_resolveJobs;
     QList<AbstractJob *> m_buildJobs;
     QList<Project> m_projects;
+    ProjectCache *m_projectCache = nullptr;
+    QHash<AbstractJob *, QString> m_projectCacheKeys;
 
     ConsoleProgressObserver *m_observer;
 
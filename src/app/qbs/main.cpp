@@ -38,17 +38,20 @@
 ****************************************************************************/
 
 #include "application.h"
+#include "buildserver.h"
 #include "commandlinefrontend.h"
 #include "qbstool.h"
 #include "parser/commandlineparser.h"
 #include "../shared/logging/consolelogger.h"
 
 #include <qbs.h>
+#include <logging/translator.h>
 
 #include <QtCore/qtimer.h>
 #include <cstdlib>
 
 using namespace qbs;
+using Internal::Tr;
 
 static bool tryToRunTool(const QStringList &arguments, int &exitCode)
 {
@@ -83,9 +86,24 @@ int main(int argc, char *argv[])
             return 0;
         }
 
+        if (parser.command() == ServeCommandType) {
+            BuildServer server(parser.serverSocketFilePath());
+            server.start();
+            return app.exec();
+        }
+
+        if (!parser.serverSocketFilePath().isEmpty()) {
+            int exitCode;
+            if (BuildServer::sendRequest(parser.serverSocketFilePath(), arguments, &exitCode))
+                return exitCode;
+            qbsWarning() << Tr::tr("No build server is listening on '%1', running the command "
+                                   "locally.").arg(parser.serverSocketFilePath());
+        }
+
         Settings settings(parser.settingsDir());
         ConsoleLogger::instance().setSettings(&settings);
         CommandLineFrontend clFrontend(parser, &settings);
+        QObject::connect(&clFrontend, &CommandLineFrontend::finished, &QCoreApplication::exit);
         app.setCommandLineFrontend(&clFrontend);
         QTimer::singleShot(0, &clFrontend, &CommandLineFrontend::start);
         return app.exec();
@@ -44,6 +44,8 @@
 #include <tools/installoptions.h>
 #include <tools/qttools.h>
 
+#include <QtCore/qfileinfo.h>
+
 namespace qbs {
 using namespace Internal;
 
@@ -616,6 +618,41 @@ void CommandEchoModeOption::doParse(const QString &representation, QStringList &
     m_echoMode = commandEchoModeFromName(mode);
 }
 
+QString InstallModeOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <mode>\n"
+                  "\tHow to put files into the install root.\n"
+                  "\tPossible values are '%2'.\n"
+                  "\tThe 'reflink' and 'hardlink' modes fall back to copying if the\n"
+                  "\tfile system does not support them.\n"
+                  "\tThe default is '%3'.\n")
+            .arg(longRepresentation(), allInstallModeStrings().join(QLatin1String("', '")),
+                 installModeName(defaultInstallMode()));
+}
+
+QString InstallModeOption::longRepresentation() const
+{
+    return QLatin1String("--install-mode");
+}
+
+void InstallModeOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString mode = getArgument(representation, input);
+    if (mode.isEmpty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': No install mode given.\nUsage: %2")
+                    .arg(representation, description(command())));
+    }
+
+    if (!allInstallModeStrings().contains(mode)) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': "
+                               "Invalid install mode '%2' given.\nUsage: %3")
+                        .arg(representation, mode, description(command())));
+    }
+
+    m_installMode = installModeFromName(mode);
+}
+
 QString WaitLockOption::description(CommandType command) const
 {
     Q_UNUSED(command);
@@ -640,4 +677,105 @@ QString RunEnvConfigOption::longRepresentation() const
     return QLatin1String("--setup-run-env-config");
 }
 
+QString FileSystemJournalOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <file>\n"
+                  "\tOnly check those files for changes that are listed in the given journal,\n"
+                  "\twhich must have been written by the qbs-watch tool.\n"
+                  "\tIf the journal is incomplete, all files are checked.\n")
+            .arg(longRepresentation());
+}
+
+QString FileSystemJournalOption::longRepresentation() const
+{
+    return QLatin1String("--fs-journal");
+}
+
+void FileSystemJournalOption::doParse(const QString &representation, QStringList &input)
+{
+    if (input.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1: Argument expected.\n"
+                           "Usage: %2").arg(representation, description(command())));
+    }
+    m_journalFilePath = QFileInfo(input.takeFirst()).absoluteFilePath();
+}
+
+QString ServerSocketOption::description(CommandType command) const
+{
+    if (command == ServeCommandType) {
+        return Tr::tr("%1 <file>\n"
+                      "\tListen for requests on the given local socket.\n")
+                .arg(longRepresentation());
+    }
+    return Tr::tr("%1 <file>\n"
+                  "\tLet the build server listening on the given local socket do the work.\n"
+                  "\tIf there is no such server, the command is run locally.\n")
+            .arg(longRepresentation());
+}
+
+QString ServerSocketOption::longRepresentation() const
+{
+    return QLatin1String("--server-socket");
+}
+
+void ServerSocketOption::doParse(const QString &representation, QStringList &input)
+{
+    if (input.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1: Argument expected.\n"
+                           "Usage: %2").arg(representation, description(command())));
+    }
+    m_socketFilePath = QFileInfo(input.takeFirst()).absoluteFilePath();
+}
+
+QString MetricsFileOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <file>\n"
+                  "\tCollect internal metrics such as the number of stat calls, script evaluations\n"
+                  "\tand spawned processes, as well as the time spent in each phase, and write\n"
+                  "\tthem to the given file in JSON format when the command has finished.\n")
+            .arg(longRepresentation());
+}
+
+QString MetricsFileOption::longRepresentation() const
+{
+    return QLatin1String("--metrics-file");
+}
+
+void MetricsFileOption::doParse(const QString &representation, QStringList &input)
+{
+    if (input.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1: Argument expected.\n"
+                           "Usage: %2").arg(representation, description(command())));
+    }
+    m_metricsFilePath = QFileInfo(input.takeFirst()).absoluteFilePath();
+}
+
+QString StreamOutputOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tPrint the output of commands while they are running, rather than\n"
+                  "\twhen they have finished. The output of concurrent commands will be\n"
+                  "\tinterleaved.\n").arg(longRepresentation());
+}
+
+QString StreamOutputOption::longRepresentation() const
+{
+    return QLatin1String("--stream-output");
+}
+
+QString RemoveInBackgroundOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tMove the build directories of the products out of the way and remove\n"
+                  "\tthem in the background, so that the command can finish sooner.\n")
+            .arg(longRepresentation());
+}
+
+QString RemoveInBackgroundOption::longRepresentation() const
+{
+    return QLatin1String("--remove-in-background");
+}
+
 } // namespace qbs
@@ -42,6 +42,7 @@
 #include "commandtype.h"
 
 #include <tools/commandechomode.h>
+#include <tools/installmode.h>
 
 #include <QtCore/qstringlist.h>
 
@@ -72,6 +73,12 @@ public:
         GeneratorOptionType,
         WaitLockOptionType,
         RunEnvConfigOptionType,
+        FileSystemJournalOptionType,
+        ServerSocketOptionType,
+        InstallModeOptionType,
+        MetricsFileOptionType,
+        StreamOutputOptionType,
+        RemoveInBackgroundOptionType,
     };
 
     virtual ~CommandLineOption();
@@ -363,6 +370,20 @@ private:
     CommandEchoMode m_echoMode = CommandEchoModeInvalid;
 };
 
+class InstallModeOption : public CommandLineOption
+{
+public:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+    InstallMode installMode() const { return m_installMode; }
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    InstallMode m_installMode = defaultInstallMode();
+};
+
 class SettingsDirOption : public CommandLineOption
 {
 public:
@@ -388,6 +409,65 @@ public:
     QString longRepresentation() const override;
 };
 
+class FileSystemJournalOption : public CommandLineOption
+{
+public:
+    QString journalFilePath() const { return m_journalFilePath; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QString m_journalFilePath;
+};
+
+class ServerSocketOption : public CommandLineOption
+{
+public:
+    QString socketFilePath() const { return m_socketFilePath; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QString m_socketFilePath;
+};
+
+class MetricsFileOption : public CommandLineOption
+{
+public:
+    QString metricsFilePath() const { return m_metricsFilePath; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QString m_metricsFilePath;
+};
+
+class StreamOutputOption : public OnOffOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+};
+
+class RemoveInBackgroundOption : public OnOffOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+};
+
 } // namespace qbs
 
 #endif // QBS_COMMANDLINEOPTION_H
@@ -125,6 +125,24 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::RunEnvConfigOptionType:
             option = new RunEnvConfigOption;
             break;
+        case CommandLineOption::FileSystemJournalOptionType:
+            option = new FileSystemJournalOption;
+            break;
+        case CommandLineOption::ServerSocketOptionType:
+            option = new ServerSocketOption;
+            break;
+        case CommandLineOption::InstallModeOptionType:
+            option = new InstallModeOption;
+            break;
+        case CommandLineOption::MetricsFileOptionType:
+            option = new MetricsFileOption;
+            break;
+        case CommandLineOption::StreamOutputOptionType:
+            option = new StreamOutputOption;
+            break;
+        case CommandLineOption::RemoveInBackgroundOptionType:
+            option = new RemoveInBackgroundOption;
+            break;
         default:
             qFatal("Unknown option type %d", type);
         }
@@ -261,4 +279,37 @@ RunEnvConfigOption *CommandLineOptionPool::runEnvConfigOption() const
     return static_cast<RunEnvConfigOption *>(getOption(CommandLineOption::RunEnvConfigOptionType));
 }
 
+FileSystemJournalOption *CommandLineOptionPool::fileSystemJournalOption() const
+{
+    return static_cast<FileSystemJournalOption *>(
+                getOption(CommandLineOption::FileSystemJournalOptionType));
+}
+
+ServerSocketOption *CommandLineOptionPool::serverSocketOption() const
+{
+    return static_cast<ServerSocketOption *>(getOption(CommandLineOption::ServerSocketOptionType));
+}
+
+InstallModeOption *CommandLineOptionPool::installModeOption() const
+{
+    return static_cast<InstallModeOption *>(getOption(CommandLineOption::InstallModeOptionType));
+}
+
+MetricsFileOption *CommandLineOptionPool::metricsFileOption() const
+{
+    return static_cast<MetricsFileOption *>(getOption(CommandLineOption::MetricsFileOptionType));
+}
+
+StreamOutputOption *CommandLineOptionPool::streamOutputOption() const
+{
+    return static_cast<StreamOutputOption *>(
+                getOption(CommandLineOption::StreamOutputOptionType));
+}
+
+RemoveInBackgroundOption *CommandLineOptionPool::removeInBackgroundOption() const
+{
+    return static_cast<RemoveInBackgroundOption *>(
+                getOption(CommandLineOption::RemoveInBackgroundOptionType));
+}
+
 } // namespace qbs
@@ -76,6 +76,12 @@ public:
     GeneratorOption *generatorOption() const;
     WaitLockOption *waitLockOption() const;
     RunEnvConfigOption *runEnvConfigOption() const;
+    FileSystemJournalOption *fileSystemJournalOption() const;
+    ServerSocketOption *serverSocketOption() const;
+    InstallModeOption *installModeOption() const;
+    MetricsFileOption *metricsFileOption() const;
+    StreamOutputOption *streamOutputOption() const;
+    RemoveInBackgroundOption *removeInBackgroundOption() const;
 
 private:
     mutable QHash<CommandLineOption::Type, CommandLineOption *> m_options;
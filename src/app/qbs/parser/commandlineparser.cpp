@@ -179,6 +179,7 @@ CleanOptions CommandLineParser::cleanOptions(const QString &profile) const
     options.setDryRun(buildOptions(profile).dryRun());
     options.setKeepGoing(buildOptions(profile).keepGoing());
     options.setLogElapsedTime(logTime());
+    options.setRemoveInBackground(d->optionPool.removeInBackgroundOption()->enabled());
     return options;
 }
 
@@ -202,6 +203,8 @@ InstallOptions CommandLineParser::installOptions(const QString &profile) const
     }
     options.setDryRun(buildOptions(profile).dryRun());
     options.setKeepGoing(buildOptions(profile).keepGoing());
+    options.setInstallMode(buildOptions(profile).installMode());
+    options.setMaxJobCount(buildOptions(profile).maxJobCount());
     options.setLogElapsedTime(logTime());
     return options;
 }
@@ -231,6 +234,21 @@ bool CommandLineParser::waitLockBuildGraph() const
     return d->optionPool.waitLockOption()->enabled();
 }
 
+QString CommandLineParser::fileSystemJournalFilePath() const
+{
+    return d->optionPool.fileSystemJournalOption()->journalFilePath();
+}
+
+QString CommandLineParser::metricsFilePath() const
+{
+    return d->optionPool.metricsFileOption()->metricsFilePath();
+}
+
+QString CommandLineParser::serverSocketFilePath() const
+{
+    return d->optionPool.serverSocketOption()->socketFilePath();
+}
+
 bool CommandLineParser::logTime() const
 {
     return d->logTime;
@@ -348,6 +366,12 @@ void CommandLineParser::CommandLineParserPrivate::doParse()
 
     if (command->type() == HelpCommandType || command->type() == VersionCommandType)
         return;
+    if (command->type() == ServeCommandType
+            && optionPool.serverSocketOption()->socketFilePath().isEmpty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of command '%1': The %2 option is required.")
+                        .arg(command->representation(),
+                             optionPool.serverSocketOption()->longRepresentation()));
+    }
 
     setupBuildDirectory();
     setupBuildConfigurations();
@@ -381,6 +405,7 @@ QList<Command *> CommandLineParser::CommandLineParserPrivate::allCommands() cons
             << commandPool.getCommand(InstallCommandType)
             << commandPool.getCommand(DumpNodesTreeCommandType)
             << commandPool.getCommand(ListProductsCommandType)
+            << commandPool.getCommand(ServeCommandType)
             << commandPool.getCommand(VersionCommandType)
             << commandPool.getCommand(HelpCommandType);
 }
@@ -462,6 +487,8 @@ void CommandLineParser::CommandLineParserPrivate::setupBuildOptions()
     buildOptions.setEchoMode(echoMode());
     buildOptions.setInstall(!optionPool.noInstallOption()->enabled());
     buildOptions.setRemoveExistingInstallation(optionPool.removeFirstoption()->enabled());
+    buildOptions.setInstallMode(optionPool.installModeOption()->installMode());
+    buildOptions.setStreamCommandOutput(optionPool.streamOutputOption()->enabled());
 }
 
 void CommandLineParser::CommandLineParserPrivate::setupBuildConfigurations()
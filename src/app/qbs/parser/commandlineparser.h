@@ -76,6 +76,9 @@ public:
     bool dryRun() const;
     bool forceProbesExecution() const;
     bool waitLockBuildGraph() const;
+    QString fileSystemJournalFilePath() const;
+    QString serverSocketFilePath() const;
+    QString metricsFilePath() const;
     bool logTime() const;
     bool withNonDefaultProducts() const;
     bool buildBeforeInstalling() const;
@@ -212,7 +212,10 @@ static QList<CommandLineOption::Type> resolveOptions()
             << CommandLineOption::ShowProgressOptionType
             << CommandLineOption::DryRunOptionType
             << CommandLineOption::ForceProbesOptionType
-            << CommandLineOption::LogTimeOptionType;
+            << CommandLineOption::LogTimeOptionType
+            << CommandLineOption::MetricsFileOptionType
+            << CommandLineOption::FileSystemJournalOptionType
+            << CommandLineOption::ServerSocketOptionType;
 }
 
 QList<CommandLineOption::Type> ResolveCommand::supportedOptions() const
@@ -250,6 +253,7 @@ QList<CommandLineOption::Type> GenerateCommand::supportedOptions() const
             << CommandLineOption::ShowProgressOptionType
             << CommandLineOption::InstallRootOptionType
             << CommandLineOption::LogTimeOptionType
+            << CommandLineOption::MetricsFileOptionType
             << CommandLineOption::GeneratorOptionType;
 }
 
@@ -286,7 +290,9 @@ static QList<CommandLineOption::Type> buildOptions()
             << CommandLineOption::JobsOptionType
             << CommandLineOption::CommandEchoModeOptionType
             << CommandLineOption::NoInstallOptionType
+            << CommandLineOption::InstallModeOptionType
             << CommandLineOption::RemoveFirstOptionType
+            << CommandLineOption::StreamOutputOptionType
             << CommandLineOption::WaitLockOptionType;
 }
 
@@ -321,8 +327,11 @@ QList<CommandLineOption::Type> CleanCommand::supportedOptions() const
         CommandLineOption::DryRunOptionType,
         CommandLineOption::KeepGoingOptionType,
         CommandLineOption::LogTimeOptionType,
+        CommandLineOption::MetricsFileOptionType,
         CommandLineOption::ProductsOptionType,
         CommandLineOption::QuietOptionType,
+        CommandLineOption::RemoveInBackgroundOptionType,
+        CommandLineOption::ServerSocketOptionType,
         CommandLineOption::SettingsDirOptionType,
         CommandLineOption::ShowProgressOptionType,
         CommandLineOption::VerboseOptionType,
@@ -600,4 +609,44 @@ void VersionCommand::parseNext(QStringList &input)
     throwError(Tr::tr("This command takes no arguments."));
 }
 
+QString ServeCommand::shortDescription() const
+{
+    return Tr::tr("Run a build server that keeps projects in memory between commands.");
+}
+
+QString ServeCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 --server-socket <file> [options]\n")
+            .arg(representation());
+    description += Tr::tr("Runs a build server that listens for commands on the given socket.\n"
+                          "Commands that are given the same socket via the --server-socket option\n"
+                          "are then run by the server, which keeps the resolved projects and\n"
+                          "their build graphs in memory, so they do not have to be loaded\n"
+                          "from disk again.\n"
+                          "The server keeps the build graphs locked while it is running.\n");
+    return description += supportedOptionsDescription();
+}
+
+QString ServeCommand::representation() const
+{
+    return QLatin1String("serve");
+}
+
+QList<CommandLineOption::Type> ServeCommand::supportedOptions() const
+{
+    return QList<CommandLineOption::Type>()
+            << CommandLineOption::ServerSocketOptionType
+            << CommandLineOption::LogLevelOptionType
+            << CommandLineOption::VerboseOptionType
+            << CommandLineOption::QuietOptionType;
+}
+
+void ServeCommand::parseNext(QStringList &input)
+{
+    QBS_CHECK(!input.empty());
+    if (!input.front().startsWith(QLatin1Char('-')))
+        throwError(Tr::tr("Unexpected command line parameter '%1'.").arg(input.front()));
+    Command::parseNext(input);
+}
+
 } // namespace qbs
@@ -261,6 +261,20 @@ private:
     void parseNext(QStringList &input) override;
 };
 
+class ServeCommand : public Command
+{
+public:
+    ServeCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+
+private:
+    CommandType type() const override { return ServeCommandType; }
+    QString shortDescription() const override;
+    QString longDescription() const override;
+    QString representation() const override;
+    QList<CommandLineOption::Type> supportedOptions() const override;
+    void parseNext(QStringList &input) override;
+};
+
 } // namespace qbs
 
 #endif // QBS_PARSER_COMMAND_H
@@ -6,6 +6,7 @@ TARGET = qbs
 SOURCES += main.cpp \
     ctrlchandler.cpp \
     application.cpp \
+    buildserver.cpp \
     status.cpp \
     consoleprogressobserver.cpp \
     commandlinefrontend.cpp \
@@ -14,6 +15,7 @@ SOURCES += main.cpp \
 HEADERS += \
     ctrlchandler.h \
     application.h \
+    buildserver.h \
     status.h \
     consoleprogressobserver.h \
     commandlinefrontend.h \
@@ -58,6 +58,11 @@ ConsoleLogSink::ConsoleLogSink() : m_coloredOutputEnabled(true), m_enabled(true)
 {
 }
 
+ConsoleLogSink::~ConsoleLogSink()
+{
+    setAsynchronous(false);
+}
+
 void ConsoleLogSink::doPrintMessage(qbs::LoggerLevel level, const QString &message,
                                     const QString &tag)
 {
@@ -84,7 +89,12 @@ void ConsoleLogSink::doPrintMessage(qbs::LoggerLevel level, const QString &messa
     static QHash<QString, TextColor> colorTable = setupColorTable();
     fprintfWrapper(colorTable.value(tag, TextColorDefault), file, "%s\n",
                    message.toLocal8Bit().constData());
-    fflush(file);
+}
+
+void ConsoleLogSink::doFlush()
+{
+    fflush(stdout);
+    fflush(stderr);
 }
 
 void ConsoleLogSink::fprintfWrapper(TextColor color, FILE *file, const char *str, ...)
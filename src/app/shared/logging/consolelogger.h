@@ -50,12 +50,14 @@ class ConsoleLogSink : public qbs::ILogSink
 {
 public:
     ConsoleLogSink();
+    ~ConsoleLogSink();
 
     void setColoredOutputEnabled(bool enabled) { m_coloredOutputEnabled = enabled; }
     void setEnabled(bool enabled) { m_enabled = enabled; }
 
 private:
     void doPrintMessage(qbs::LoggerLevel level, const QString &message, const QString &tag);
+    void doFlush();
     void fprintfWrapper(TextColor color, FILE *file, const char *str, ...);
 
 private:
@@ -54,6 +54,7 @@
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
 #include <tools/error.h>
+#include <tools/metrics.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
 #include <tools/preferences.h>
@@ -62,6 +63,7 @@
 #include <QtCore/qeventloop.h>
 #include <QtCore/qtimer.h>
 
+#include <future>
 #include <mutex>
 
 namespace qbs {
@@ -83,8 +85,8 @@ private:
     void initialize(const QString &task, int maximum) override
     {
         QBS_ASSERT(!m_timedLogger, delete m_timedLogger);
-        if (m_job->timed())
-            m_timedLogger = new TimedActivityLogger(m_job->logger(), task, true);
+        if (m_job->timed() || Metrics::isEnabled())
+            m_timedLogger = new TimedActivityLogger(m_job->logger(), task, m_job->timed());
         m_value = 0;
         m_maximum = maximum;
         emit m_job->newTaskStarted(task, maximum, m_job);
@@ -154,15 +156,48 @@ void InternalJob::shareObserverWith(InternalJob *otherJob)
     m_observer = otherJob->m_observer;
 }
 
+ErrorInfo InternalJob::error() const
+{
+    ErrorInfo error = m_error;
+    appendError(error, m_storeError);
+    return error;
+}
+
 void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project)
 {
     try {
         doSanityChecks(project, logger());
-        TimedActivityLogger storeTimer(m_logger, Tr::tr("Storing build graph"), timed());
-        project->store(logger());
     } catch (const ErrorInfo &error) {
         logger().printWarning(error);
+        return;
+    }
+    const ErrorInfo error = storeBuildGraph(project.get(), logger(), timed());
+    if (error.hasError())
+        logger().printWarning(error);
+    project->storeError = ErrorInfo();
+}
+
+ErrorInfo InternalJob::storeBuildGraph(TopLevelProject *project, const Logger &logger, bool timed)
+{
+    try {
+        TimedActivityLogger storeTimer(logger, Tr::tr("Storing build graph"), timed);
+        project->store(logger);
+    } catch (const ErrorInfo &error) {
+        return error;
     }
+    return ErrorInfo();
+}
+
+// A failure to store the build graph in the background cannot be reported by the job
+// that started the operation anymore, so it becomes an error of the next one.
+void InternalJob::waitForPendingStore(TopLevelProject *project)
+{
+    project->waitForPendingStore();
+    if (!project->storeError.hasError())
+        return;
+    m_storeError = project->storeError;
+    m_storeError.prepend(Tr::tr("Storing the build graph after the previous job failed."));
+    project->storeError = ErrorInfo();
 }
 
 
@@ -246,6 +281,10 @@ TopLevelProjectPtr InternalSetupProjectJob::project() const
 
 void InternalSetupProjectJob::start()
 {
+    // An error from storing the existing project in the background does not concern us,
+    // as the project gets stored anew below.
+    if (m_existingProject)
+        m_existingProject->waitForPendingStore();
     BuildGraphLocker *bgLocker = m_existingProject ? m_existingProject->bgLocker : 0;
     bool deleteLocker = false;
     try {
@@ -308,6 +347,13 @@ void InternalSetupProjectJob::execute()
     }
     }
 
+    // Change tracking carries the generations over; a project resolved from scratch has to
+    // continue counting from the one it replaces.
+    if (m_existingProject && m_newProject != m_existingProject
+            && m_newProject->generation <= m_existingProject->generation) {
+        m_newProject->continueGenerationsFrom(*m_existingProject);
+    }
+
     if (!m_parameters.dryRun())
         storeBuildGraph(m_newProject);
 
@@ -350,6 +396,7 @@ BuildGraphTouchingJob::~BuildGraphTouchingJob()
 void BuildGraphTouchingJob::setup(const TopLevelProjectPtr &project,
                                   const QList<ResolvedProductPtr> &products, bool dryRun)
 {
+    waitForPendingStore(project.get());
     m_project = project;
     m_products = products;
     m_dryRun = dryRun;
@@ -357,8 +404,25 @@ void BuildGraphTouchingJob::setup(const TopLevelProjectPtr &project,
 
 void BuildGraphTouchingJob::storeBuildGraph()
 {
-    if (!m_dryRun && !error().isInternalError())
-        InternalJob::storeBuildGraph(m_project);
+    if (m_dryRun || error().isInternalError())
+        return;
+    try {
+        doSanityChecks(m_project, logger());
+    } catch (const ErrorInfo &error) {
+        logger().printWarning(error);
+        return;
+    }
+
+    // Serializing a large build graph takes a while. We do it in a separate thread, so the
+    // job can finish and the client can go on with reporting results.
+    // Everything that modifies the project waits for the operation to finish first.
+    TopLevelProject * const project = m_project.get();
+    const Logger logger = this->logger();
+    const bool timed = this->timed();
+    project->waitForPendingStore();
+    project->pendingStore = std::async(std::launch::async, [project, logger, timed] {
+        return InternalJob::storeBuildGraph(project, logger, timed);
+    });
 }
 
 InternalBuildJob::InternalBuildJob(const Logger &logger, QObject *parent)
@@ -443,6 +507,7 @@ InternalInstallJob::~InternalInstallJob()
 void InternalInstallJob::init(const TopLevelProjectPtr &project,
         const std::vector<ResolvedProductPtr> &products, const InstallOptions &options)
 {
+    waitForPendingStore(project.get());
     m_project = project;
     m_products = products;
     m_options = options;
@@ -72,7 +72,7 @@ public:
 
     void cancel();
     virtual void start() {}
-    ErrorInfo error() const { return m_error; }
+    ErrorInfo error() const;
     void setError(const ErrorInfo &error) { m_error = error; }
 
     Logger logger() const { return m_logger; }
@@ -85,6 +85,8 @@ protected:
     JobObserver *observer() const { return m_observer; }
     void setTimed(bool timed) { m_timed = timed; }
     void storeBuildGraph(const TopLevelProjectPtr &project);
+    static ErrorInfo storeBuildGraph(TopLevelProject *project, const Logger &logger, bool timed);
+    void waitForPendingStore(TopLevelProject *project);
 
 signals:
     void finished(Internal::InternalJob *job);
@@ -94,6 +96,7 @@ signals:
 
 private:
     ErrorInfo m_error;
+    ErrorInfo m_storeError; // From a build graph store operation started by an earlier job.
     JobObserver *m_observer;
     bool m_ownsObserver;
     Logger m_logger;
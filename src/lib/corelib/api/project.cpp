@@ -125,12 +125,44 @@ static void loadPlugins(const QStringList &_pluginPaths, const Logger &logger)
 
 ProjectData ProjectPrivate::projectData()
 {
+    internalProject->waitForPendingStore();
     m_projectData = ProjectData();
     retrieveProjectData(m_projectData, internalProject);
     m_projectData.d->buildDir = internalProject->buildDirectory;
     return m_projectData;
 }
 
+QList<ProductData> ProjectPrivate::changedProducts(quint64 sinceGeneration,
+                                                   QStringList *removedProducts)
+{
+    if (internalProject->locked)
+        throw ErrorInfo(Tr::tr("A job is currently in process."));
+    internalProject->waitForPendingStore();
+    QList<ProductData> products;
+    collectChangedProducts(internalProject, sinceGeneration, products);
+    qSort(products);
+    if (removedProducts) {
+        for (const auto &removedProduct : internalProject->removedProducts) {
+            if (removedProduct.first > sinceGeneration)
+                removedProducts->push_back(removedProduct.second);
+        }
+    }
+    return products;
+}
+
+void ProjectPrivate::collectChangedProducts(const ResolvedProjectConstPtr &project,
+                                            quint64 sinceGeneration, QList<ProductData> &products)
+{
+    for (const ResolvedProductConstPtr &product : project->products) {
+        if (product->generation > sinceGeneration)
+            products << createProductData(product);
+    }
+    for (const ResolvedProjectConstPtr &subProject : qAsConst(project->subProjects)) {
+        if (subProject->enabled)
+            collectChangedProducts(subProject, sinceGeneration, products);
+    }
+}
+
 static void addDependencies(QList<ResolvedProductPtr> &products)
 {
     for (int i = 0; i < products.size(); ++i) {
@@ -150,6 +182,7 @@ BuildJob *ProjectPrivate::buildProducts(const QList<ResolvedProductPtr> &product
     if (needsDepencencyResolving)
         addDependencies(productsToBuild);
 
+    m_projectData = ProjectData(); // Will be outdated after the job; retrieved anew on demand.
     auto job = new BuildJob(logger, jobOwner);
     job->build(internalProject, productsToBuild, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -159,6 +192,7 @@ BuildJob *ProjectPrivate::buildProducts(const QList<ResolvedProductPtr> &product
 CleanJob *ProjectPrivate::cleanProducts(const QList<ResolvedProductPtr> &products,
         const CleanOptions &options, QObject *jobOwner)
 {
+    m_projectData = ProjectData();
     auto job = new CleanJob(logger, jobOwner);
     job->clean(internalProject, products, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -171,6 +205,7 @@ InstallJob *ProjectPrivate::installProducts(const QList<ResolvedProductPtr> &pro
     QList<ResolvedProductPtr> productsToInstall = products;
     if (needsDepencencyResolving)
         addDependencies(productsToInstall);
+    m_projectData = ProjectData();
     auto job = new InstallJob(logger, jobOwner);
     job->install(internalProject, productsToInstall, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -202,6 +237,7 @@ static QList<ResolvedProductPtr> enabledInternalProducts(const ResolvedProjectCo
 
 QList<ResolvedProductPtr> ProjectPrivate::allEnabledInternalProducts(bool includingNonDefault) const
 {
+    internalProject->waitForPendingStore();
     return enabledInternalProducts(internalProject, includingNonDefault);
 }
 
@@ -228,6 +264,7 @@ static ResolvedProductPtr internalProductForProject(const ResolvedProjectConstPt
 
 ResolvedProductPtr ProjectPrivate::internalProduct(const ProductData &product) const
 {
+    internalProject->waitForPendingStore();
     return internalProductForProject(internalProject, product);
 }
 
@@ -380,6 +417,7 @@ void ProjectPrivate::addGroup(const ProductData &product, const QString &groupNa
         resolvedGroup->properties = resolvedProducts[i]->moduleProperties;
         resolvedGroup->overrideTags = false;
         resolvedProducts.at(i)->groups << resolvedGroup;
+        internalProject->markProductChanged(resolvedProducts.at(i).get());
         products.at(i).d->groups << createGroupDataFromGroup(resolvedGroup, resolvedProducts.at(i));
         qSort(products.at(i).d->groups);
     }
@@ -519,6 +557,7 @@ void ProjectPrivate::addFiles(const ProductData &product, const GroupData &group
     for (int i = 0; i < groupContext.resolvedGroups.size(); ++i) {
         const ResolvedProductPtr &resolvedProduct = groupContext.resolvedProducts.at(i);
         const GroupPtr &resolvedGroup = groupContext.resolvedGroups.at(i);
+        internalProject->markProductChanged(resolvedProduct.get());
         for (const QString &file : qAsConst(filesContext.absoluteFilePaths)) {
             const SourceArtifactPtr sa = createSourceArtifact(file, resolvedProduct, resolvedGroup,
                                                               false);
@@ -590,6 +629,7 @@ void ProjectPrivate::removeFiles(const ProductData &product, const GroupData &gr
     remover.apply();
 
     for (int i = 0; i < groupContext.resolvedProducts.size(); ++i) {
+        internalProject->markProductChanged(groupContext.resolvedProducts.at(i).get());
         removeFilesFromBuildGraph(groupContext.resolvedProducts.at(i), sourceArtifacts);
         for (const SourceArtifactPtr &sa : sourceArtifacts)
             removeOne(groupContext.resolvedGroups.at(i)->files, sa);
@@ -617,6 +657,7 @@ void ProjectPrivate::removeGroup(const ProductData &product, const GroupData &gr
     for (int i = 0; i < context.resolvedProducts.size(); ++i) {
         const ResolvedProductPtr &product = context.resolvedProducts.at(i);
         const GroupPtr &group = context.resolvedGroups.at(i);
+        internalProject->markProductChanged(product.get());
         removeFilesFromBuildGraph(product, group->allFiles());
         const bool removed = removeOne(product->groups, group);
         QBS_CHECK(removed);
@@ -645,10 +686,11 @@ void ProjectPrivate::removeFilesFromBuildGraph(const ResolvedProductConstPtr &pr
         Artifact * const artifact = lookupArtifact(product, sa->absoluteFilePath);
         if (artifact) { // Can be null if the executor has not yet applied the respective rule.
             internalProject->buildData->removeArtifactAndExclusiveDependents(artifact, logger,
-                    true, &removedArtifacts);
+                    true, &removedArtifacts, false);
         }
         allRemovedArtifacts.unite(removedArtifacts);
     }
+    removeGeneratedArtifactsFromDisk(allRemovedArtifacts, logger);
     EmptyDirectoriesRemover(product->topLevelProject(), logger)
             .removeEmptyParentDirectories(allRemovedArtifacts);
     qDeleteAll(allRemovedArtifacts);
@@ -717,6 +759,7 @@ void ProjectPrivate::prepareChangeToProject()
 {
     if (internalProject->locked)
         throw ErrorInfo(Tr::tr("A job is currently in process."));
+    internalProject->waitForPendingStore();
     if (!m_projectData.isValid())
         retrieveProjectData(m_projectData, internalProject);
 }
@@ -744,6 +787,11 @@ RuleCommandList ProjectPrivate::ruleCommandListForTransformer(const Transformer
             externalCommand.d->arguments = procCmd->arguments();
             externalCommand.d->workingDir = procCmd->workingDir();
             externalCommand.d->environment = procCmd->environment();
+            externalCommand.d->stdoutFilePath = procCmd->stdoutFilePath();
+            externalCommand.d->stderrFilePath = procCmd->stderrFilePath();
+            externalCommand.d->stdoutFilterFunction = procCmd->stdoutFilterFunction();
+            externalCommand.d->stderrFilterFunction = procCmd->stderrFilterFunction();
+            externalCommand.d->maxExitCode = procCmd->maxExitCode();
             break;
         }
         }
@@ -779,8 +827,11 @@ RuleCommandList ProjectPrivate::ruleCommands(const ProductData &product,
                            "from input file '%2'.").arg(outputFileTag, inputFilePath));
 }
 
-ProjectTransformerData ProjectPrivate::transformerData()
+ProjectTransformerData ProjectPrivate::transformerData(const FileTags &outputFileTags)
 {
+    if (internalProject->locked)
+        throw ErrorInfo(Tr::tr("A job is currently in process."));
+    internalProject->waitForPendingStore();
     if (!m_projectData.isValid())
         retrieveProjectData(m_projectData, internalProject);
     ProjectTransformerData projectTransformerData;
@@ -790,14 +841,25 @@ ProjectTransformerData ProjectPrivate::transformerData()
         const ResolvedProductConstPtr product = internalProduct(productData);
         QBS_ASSERT(!!product, continue);
         QBS_ASSERT(!!product->buildData, continue);
-        const ArtifactSet targetArtifacts = product->targetArtifacts();
         Set<const Transformer *> allTransformers;
-        for (const Artifact * const a : TypeFilter<Artifact>(product->buildData->allNodes())) {
-            if (a->artifactType == Artifact::Generated)
-                allTransformers.insert(a->transformer.get());
+        if (outputFileTags.empty()) {
+            for (const Artifact * const a : TypeFilter<Artifact>(product->buildData->allNodes())) {
+                if (a->artifactType == Artifact::Generated)
+                    allTransformers.insert(a->transformer.get());
+            }
+        } else {
+            const ArtifactSetByFileTag artifactsByFileTag
+                    = product->buildData->artifactsByFileTag();
+            for (const FileTag &tag : outputFileTags) {
+                for (const Artifact * const a : artifactsByFileTag.value(tag)) {
+                    if (a->artifactType == Artifact::Generated && a->transformer)
+                        allTransformers.insert(a->transformer.get());
+                }
+            }
         }
         if (allTransformers.empty())
             continue;
+        const ArtifactSet targetArtifacts = product->targetArtifacts();
         ProductTransformerData productTransformerData;
         for (const Transformer * const t : allTransformers) {
             TransformerData tData;
@@ -829,65 +891,77 @@ static bool productIsMultiplexed(const ResolvedProductConstPtr &product)
     return product->productProperties.value(StringConstants::multiplexedProperty()).toBool();
 }
 
+ProductData ProjectPrivate::createProductData(const ResolvedProductConstPtr &resolvedProduct)
+{
+    ProductData product;
+    product.d->type = resolvedProduct->fileTags.toStringList();
+    product.d->name = resolvedProduct->name;
+    product.d->targetName = resolvedProduct->targetName;
+    product.d->version = resolvedProduct
+            ->productProperties.value(StringConstants::versionProperty()).toString();
+    product.d->multiplexConfigurationId = resolvedProduct->multiplexConfigurationId;
+    product.d->location = resolvedProduct->location;
+    product.d->buildDirectory = resolvedProduct->buildDirectory();
+    product.d->isEnabled = resolvedProduct->enabled;
+    product.d->isRunnable = productIsRunnable(resolvedProduct);
+    product.d->isMultiplexed = productIsMultiplexed(resolvedProduct);
+    product.d->properties = resolvedProduct->productProperties;
+    product.d->moduleProperties.d->m_map = resolvedProduct->moduleProperties;
+    if (resolvedProduct->enabled)
+        QBS_CHECK(resolvedProduct->buildData);
+    for (const ResolvedProductPtr &resolvedDependentProduct
+         : qAsConst(resolvedProduct->dependencies)) {
+        product.d->dependencies << resolvedDependentProduct->name;
+    }
+    qSort(product.d->type);
+
+    retrieveProductDetails(resolvedProduct, product.d->groups, product.d->generatedArtifacts);
+    product.d->isValid = true;
+    return product;
+}
+
+void ProjectPrivate::retrieveProductDetails(const ResolvedProductConstPtr &resolvedProduct,
+                                            QList<GroupData> &groups,
+                                            QList<ArtifactData> &generatedArtifacts)
+{
+    for (const GroupPtr &resolvedGroup : resolvedProduct->groups) {
+        if (resolvedGroup->targetOfModule.isEmpty())
+            groups << createGroupDataFromGroup(resolvedGroup, resolvedProduct);
+    }
+    if (resolvedProduct->enabled && resolvedProduct->buildData) {
+        const ArtifactSet targetArtifacts = resolvedProduct->targetArtifacts();
+        for (Artifact * const a
+             : filterByType<Artifact>(resolvedProduct->buildData->allNodes())) {
+            if (a->artifactType != Artifact::Generated)
+                continue;
+            generatedArtifacts << createArtifactData(a, resolvedProduct, targetArtifacts);
+        }
+        const AllRescuableArtifactData &rad
+                = resolvedProduct->buildData->rescuableArtifactData();
+        for (auto it = rad.begin(); it != rad.end(); ++it) {
+            ArtifactData ta;
+            ta.d->filePath = it.key();
+            ta.d->fileTags = it.value().fileTags.toStringList();
+            ta.d->properties.d->m_map = it.value().properties;
+            ta.d->isGenerated = true;
+            ta.d->isTargetArtifact = resolvedProduct->fileTags.intersects(it.value().fileTags);
+            ta.d->isValid = true;
+            setupInstallData(ta, resolvedProduct);
+            generatedArtifacts << ta;
+        }
+    }
+    qSort(groups);
+    qSort(generatedArtifacts);
+}
+
 void ProjectPrivate::retrieveProjectData(ProjectData &projectData,
                                          const ResolvedProjectConstPtr &internalProject)
 {
     projectData.d->name = internalProject->name;
     projectData.d->location = internalProject->location;
     projectData.d->enabled = internalProject->enabled;
-    for (const ResolvedProductConstPtr &resolvedProduct : internalProject->products) {
-        ProductData product;
-        product.d->type = resolvedProduct->fileTags.toStringList();
-        product.d->name = resolvedProduct->name;
-        product.d->targetName = resolvedProduct->targetName;
-        product.d->version = resolvedProduct
-                ->productProperties.value(StringConstants::versionProperty()).toString();
-        product.d->multiplexConfigurationId = resolvedProduct->multiplexConfigurationId;
-        product.d->location = resolvedProduct->location;
-        product.d->buildDirectory = resolvedProduct->buildDirectory();
-        product.d->isEnabled = resolvedProduct->enabled;
-        product.d->isRunnable = productIsRunnable(resolvedProduct);
-        product.d->isMultiplexed = productIsMultiplexed(resolvedProduct);
-        product.d->properties = resolvedProduct->productProperties;
-        product.d->moduleProperties.d->m_map = resolvedProduct->moduleProperties;
-        for (const GroupPtr &resolvedGroup : resolvedProduct->groups) {
-            if (resolvedGroup->targetOfModule.isEmpty())
-                product.d->groups << createGroupDataFromGroup(resolvedGroup, resolvedProduct);
-        }
-        if (resolvedProduct->enabled) {
-            QBS_CHECK(resolvedProduct->buildData);
-            const ArtifactSet targetArtifacts = resolvedProduct->targetArtifacts();
-            for (Artifact * const a
-                 : filterByType<Artifact>(resolvedProduct->buildData->allNodes())) {
-                if (a->artifactType != Artifact::Generated)
-                    continue;
-                product.d->generatedArtifacts << createArtifactData(a, resolvedProduct,
-                                                                    targetArtifacts);
-            }
-            const AllRescuableArtifactData &rad
-                    = resolvedProduct->buildData->rescuableArtifactData();
-            for (auto it = rad.begin(); it != rad.end(); ++it) {
-                ArtifactData ta;
-                ta.d->filePath = it.key();
-                ta.d->fileTags = it.value().fileTags.toStringList();
-                ta.d->properties.d->m_map = it.value().properties;
-                ta.d->isGenerated = true;
-                ta.d->isTargetArtifact = resolvedProduct->fileTags.intersects(it.value().fileTags);
-                ta.d->isValid = true;
-                setupInstallData(ta, resolvedProduct);
-                product.d->generatedArtifacts << ta;
-            }
-        }
-        for (const ResolvedProductPtr &resolvedDependentProduct
-             : qAsConst(resolvedProduct->dependencies)) {
-            product.d->dependencies << resolvedDependentProduct->name;
-        }
-        qSort(product.d->type);
-        qSort(product.d->groups);
-        qSort(product.d->generatedArtifacts);
-        product.d->isValid = true;
-        projectData.d->products << product;
-    }
+    for (const ResolvedProductConstPtr &resolvedProduct : internalProject->products)
+        projectData.d->products << createProductData(resolvedProduct);
     for (const ResolvedProjectConstPtr &internalSubProject
          : qAsConst(internalProject->subProjects)) {
         if (!internalSubProject->enabled)
@@ -938,6 +1012,7 @@ bool Project::isValid() const
 QString Project::profile() const
 {
     QBS_ASSERT(isValid(), return QString());
+    d->internalProject->waitForPendingStore();
     return d->internalProject->profile();
 }
 
@@ -996,6 +1071,42 @@ ProjectData Project::projectData() const
     return d->projectData();
 }
 
+/*!
+ * \brief The current generation of this project's build graph.
+ * The generation increases whenever the data of a product as reported by \c projectData()
+ * changes, e.g. because the product was re-resolved or because building it created or removed
+ * artifacts. Pass the value to \c changedProducts() later to find out what has changed since.
+ * Generations are counted per session, i.e. they start anew when the build graph is loaded
+ * from disk.
+ */
+quint64 Project::buildGraphGeneration() const
+{
+    QBS_ASSERT(isValid(), return 0);
+    d->internalProject->waitForPendingStore();
+    return d->internalProject->generation;
+}
+
+/*!
+ * \brief Returns the products that changed after build graph generation \a sinceGeneration.
+ * This allows IDEs to update their view of a large project without retrieving all of it.
+ * If \a removedProducts is not null, the full display names of products that have been removed
+ * from the project since then are stored there.
+ * Fails if a job is currently running on the project.
+ * \sa buildGraphGeneration()
+ */
+QList<ProductData> Project::changedProducts(quint64 sinceGeneration,
+                                            QStringList *removedProducts, ErrorInfo *error) const
+{
+    QBS_ASSERT(isValid(), return QList<ProductData>());
+    try {
+        return d->changedProducts(sinceGeneration, removedProducts);
+    } catch (const ErrorInfo &e) {
+        if (error)
+            *error = e;
+        return QList<ProductData>();
+    }
+}
+
 RunEnvironment Project::getRunEnvironment(const ProductData &product,
         const InstallOptions &installOptions,
         const QProcessEnvironment &environment,
@@ -1130,10 +1241,22 @@ InstallJob *Project::installOneProduct(const ProductData &product, const Install
 void Project::updateTimestamps(const QList<ProductData> &products)
 {
     QBS_ASSERT(isValid(), return);
+    d->internalProject->waitForPendingStore();
     TimestampsUpdater().updateTimestamps(d->internalProject, d->internalProducts(products),
                                          d->logger);
 }
 
+/*!
+ * \brief Waits until the build graph has been written to disk.
+ * Build and clean jobs finish before their changes to the build graph are stored, which
+ * then happens in a different thread that might still produce log output.
+ */
+void Project::waitForPendingStore() const
+{
+    QBS_ASSERT(isValid(), return);
+    d->internalProject->waitForPendingStore();
+}
+
 /*!
  * \brief Finds files generated from the given file in the given product.
  * If \a recursive is \c false, only files generated directly from \a file will be considered,
@@ -1152,12 +1275,14 @@ QStringList Project::generatedFiles(const ProductData &product, const QString &f
 QVariantMap Project::projectConfiguration() const
 {
     QBS_ASSERT(isValid(), return QVariantMap());
+    d->internalProject->waitForPendingStore();
     return d->internalProject->buildConfiguration();
 }
 
 std::set<QString> Project::buildSystemFiles() const
 {
     QBS_ASSERT(isValid(), return std::set<QString>());
+    d->internalProject->waitForPendingStore();
     return d->internalProject->buildSystemFiles.toStdSet();
 }
 
@@ -1188,6 +1313,25 @@ ProjectTransformerData Project::transformerData(ErrorInfo *error) const
     }
 }
 
+/*!
+ * \brief Returns the transformers of all enabled products that create artifacts tagged with
+ *        at least one of \a outputFileTags, along with their inputs, outputs and commands.
+ * Prefer this function over calling \c ruleCommands() for every single input file, as the
+ * latter has to look up the transformer anew for each call.
+ */
+ProjectTransformerData Project::transformerData(const QStringList &outputFileTags,
+                                                ErrorInfo *error) const
+{
+    QBS_ASSERT(isValid(), return ProjectTransformerData());
+    try {
+        return d->transformerData(FileTags::fromStringList(outputFileTags));
+    } catch (const ErrorInfo &e) {
+        if (error)
+            *error = e;
+        return ProjectTransformerData();
+    }
+}
+
 ErrorInfo Project::dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products)
 {
     try {
@@ -96,6 +96,10 @@ public:
     bool isValid() const;
     QString profile() const;
     ProjectData projectData() const;
+    quint64 buildGraphGeneration() const;
+    QList<ProductData> changedProducts(quint64 sinceGeneration,
+                                       QStringList *removedProducts = nullptr,
+                                       ErrorInfo *error = nullptr) const;
     RunEnvironment getRunEnvironment(const ProductData &product,
             const InstallOptions &installOptions,
             const QProcessEnvironment &environment,
@@ -125,6 +129,7 @@ public:
                                   QObject *jobOwner = 0) const;
 
     void updateTimestamps(const QList<ProductData> &products);
+    void waitForPendingStore() const;
 
     bool operator==(const Project &other) const { return d.data() == other.d.data(); }
 
@@ -138,6 +143,8 @@ public:
     RuleCommandList ruleCommands(const ProductData &product, const QString &inputFilePath,
                                  const QString &outputFileTag, ErrorInfo *error = 0) const;
     ProjectTransformerData transformerData(ErrorInfo *error = nullptr) const;
+    ProjectTransformerData transformerData(const QStringList &outputFileTags,
+                                           ErrorInfo *error = nullptr) const;
 
     ErrorInfo dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products);
 
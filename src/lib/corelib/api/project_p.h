@@ -68,6 +68,7 @@ public:
     }
 
     ProjectData projectData();
+    QList<ProductData> changedProducts(quint64 sinceGeneration, QStringList *removedProducts);
     BuildJob *buildProducts(const QList<ResolvedProductPtr> &products, const BuildOptions &options,
                             bool needsDepencencyResolving,
                             QObject *jobOwner);
@@ -125,7 +126,7 @@ public:
     RuleCommandList ruleCommandListForTransformer(const Transformer *transformer);
     RuleCommandList ruleCommands(const ProductData &product,
             const QString &inputFilePath, const QString &outputFileTag);
-    ProjectTransformerData transformerData();
+    ProjectTransformerData transformerData(const FileTags &outputFileTags = FileTags());
 
     TopLevelProjectPtr internalProject;
     Logger logger;
@@ -133,6 +134,12 @@ public:
 private:
     void retrieveProjectData(ProjectData &projectData,
                              const ResolvedProjectConstPtr &internalProject);
+    ProductData createProductData(const ResolvedProductConstPtr &resolvedProduct);
+    void retrieveProductDetails(const ResolvedProductConstPtr &resolvedProduct,
+                                QList<GroupData> &groups,
+                                QList<ArtifactData> &generatedArtifacts);
+    void collectChangedProducts(const ResolvedProjectConstPtr &project, quint64 sinceGeneration,
+                                QList<ProductData> &products);
 
     ProjectData m_projectData;
 };
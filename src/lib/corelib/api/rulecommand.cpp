@@ -157,4 +157,61 @@ QProcessEnvironment RuleCommand::environment() const
     return d->environment;
 }
 
+/*!
+ * Returns the file that the standard output of the executable will be written to when the
+ * corresponding \c ProcessCommand is executed, or an empty string if it is not redirected.
+ * If \c type() is not \c ProcessCommandType, the behavior of this function is undefined.
+ */
+QString RuleCommand::stdoutFilePath() const
+{
+    QBS_ASSERT(type() == ProcessCommandType, return QString());
+    return d->stdoutFilePath;
+}
+
+/*!
+ * Returns the file that the standard error output of the executable will be written to when
+ * the corresponding \c ProcessCommand is executed, or an empty string if it is not redirected.
+ * If \c type() is not \c ProcessCommandType, the behavior of this function is undefined.
+ */
+QString RuleCommand::stderrFilePath() const
+{
+    QBS_ASSERT(type() == ProcessCommandType, return QString());
+    return d->stderrFilePath;
+}
+
+/*!
+ * Returns the source code of the function that the standard output of the executable is passed
+ * through when the corresponding \c ProcessCommand is executed, or an empty string if there
+ * is none.
+ * If \c type() is not \c ProcessCommandType, the behavior of this function is undefined.
+ */
+QString RuleCommand::stdoutFilterFunction() const
+{
+    QBS_ASSERT(type() == ProcessCommandType, return QString());
+    return d->stdoutFilterFunction;
+}
+
+/*!
+ * Returns the source code of the function that the standard error output of the executable is
+ * passed through when the corresponding \c ProcessCommand is executed, or an empty string if
+ * there is none.
+ * If \c type() is not \c ProcessCommandType, the behavior of this function is undefined.
+ */
+QString RuleCommand::stderrFilterFunction() const
+{
+    QBS_ASSERT(type() == ProcessCommandType, return QString());
+    return d->stderrFilterFunction;
+}
+
+/*!
+ * Returns the highest exit code of the executable that is not considered a failure when the
+ * corresponding \c ProcessCommand is executed.
+ * If \c type() is not \c ProcessCommandType, the behavior of this function is undefined.
+ */
+int RuleCommand::maxExitCode() const
+{
+    QBS_ASSERT(type() == ProcessCommandType, return 0);
+    return d->maxExitCode;
+}
+
 } // namespace qbs
@@ -77,6 +77,11 @@ public:
     QStringList arguments() const;
     QString workingDirectory() const;
     QProcessEnvironment environment() const;
+    QString stdoutFilePath() const;
+    QString stderrFilePath() const;
+    QString stdoutFilterFunction() const;
+    QString stderrFilterFunction() const;
+    int maxExitCode() const;
 
 private:
     QExplicitlySharedDataPointer<Internal::RuleCommandPrivate> d;
@@ -61,6 +61,11 @@ public:
     QStringList arguments;
     QString workingDir;
     QProcessEnvironment environment;
+    QString stdoutFilePath;
+    QString stderrFilePath;
+    QString stdoutFilterFunction;
+    QString stderrFilterFunction;
+    int maxExitCode = 0;
 };
 
 } // namespace Internal
@@ -50,7 +50,7 @@
 namespace qbs {
 namespace Internal {
 
-Artifact::Artifact()
+Artifact::Artifact() : BuildGraphNode(ArtifactNodeType)
 {
     initialize();
 }
@@ -130,16 +130,11 @@ void Artifact::load(PersistentPool &pool)
 {
     FileResourceBase::load(pool);
     BuildGraphNode::load(pool);
-    children.load(pool);
-
-    // restore parents of the loaded children
-    for (NodeSet::const_iterator it = children.constBegin(); it != children.constEnd(); ++it)
-        (*it)->parents.insert(this);
-
     pool.load(childrenAddedByScanner);
     pool.load(fileDependencies);
     pool.load(properties);
     pool.load(targetOfModule);
+    pool.load(upToDateSince);
     pool.load(transformer);
     pool.load(m_fileTags);
     artifactType = static_cast<ArtifactType>(pool.load<quint8>());
@@ -151,12 +146,11 @@ void Artifact::store(PersistentPool &pool)
 {
     FileResourceBase::store(pool);
     BuildGraphNode::store(pool);
-    // Do not store parents to avoid recursion.
-    children.store(pool);
     pool.store(childrenAddedByScanner);
     pool.store(fileDependencies);
     pool.store(properties);
     pool.store(targetOfModule);
+    pool.store(upToDateSince);
     pool.store(transformer);
     pool.store(m_fileTags);
     pool.store(static_cast<quint8>(artifactType));
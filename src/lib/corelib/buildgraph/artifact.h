@@ -71,7 +71,6 @@ public:
     Artifact();
     ~Artifact();
 
-    Type type() const override { return ArtifactNodeType; }
     FileType fileType() const override { return FileTypeArtifact; }
     void accept(BuildGraphVisitor *visitor) override;
     QString toString() const override;
@@ -87,6 +86,11 @@ public:
     PropertyMapPtr properties;
     QString targetOfModule;
 
+    // Set if the last run of the transformer left the file untouched, because its contents
+    // did not change. The artifact is then up to date with respect to all children that are
+    // older than the time of that run, even though the file itself is older than them.
+    FileTime upToDateSince;
+
     enum ArtifactType
     {
         Unknown = 1,
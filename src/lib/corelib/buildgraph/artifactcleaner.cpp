@@ -49,6 +49,7 @@
 #include <tools/cleanoptions.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/hostosinfo.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 #include <tools/stringconstants.h>
@@ -57,6 +58,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qprocess.h>
 #include <QtCore/qstring.h>
 
 namespace qbs {
@@ -78,33 +80,61 @@ static void invalidateArtifactTimestamp(Artifact *artifact)
     }
 }
 
-static void removeArtifactFromDisk(Artifact *artifact, bool dryRun, const Logger &logger)
+static QString trashDirectory(const TopLevelProject *project)
 {
-    QFileInfo fileInfo(artifact->filePath());
-    if (!FileInfo::fileExists(fileInfo)) {
-        if (!dryRun)
-            invalidateArtifactTimestamp(artifact);
-        return;
+    return project->buildDirectory + QLatin1String("/.trash");
+}
+
+// Moves the product's build directory into the "trash" directory, from where it gets removed
+// in the background. Returns false if the directory could not be moved.
+static bool moveBuildDirectoryToTrash(const ResolvedProduct *product, const Logger &logger)
+{
+    const QString buildDir = product->buildDirectory();
+    const QString projectBuildDir = product->topLevelProject()->buildDirectory;
+    const QFileInfo buildDirInfo(buildDir);
+    if (!buildDir.startsWith(projectBuildDir + QLatin1Char('/')) || buildDirInfo.isSymLink()
+            || !buildDirInfo.isDir()) {
+        return false;
     }
-    printRemovalMessage(fileInfo.filePath(), dryRun, logger);
-    if (dryRun)
+    const QString trashDir = trashDirectory(product->topLevelProject());
+    if (!QDir::root().mkpath(trashDir))
+        return false;
+    QString targetPath;
+    for (int i = 0; targetPath.isEmpty() || FileInfo::exists(targetPath); ++i)
+        targetPath = trashDir + QLatin1Char('/') + buildDirInfo.fileName() + QLatin1Char('.')
+                + QString::number(i);
+    if (!QDir::root().rename(buildDir, targetPath))
+        return false;
+    logger.qbsDebug() << "Moved '" << buildDir << "' to '" << targetPath << "' for removal.";
+    return true;
+}
+
+// The trash directory is removed by a detached process, so that we do not have to wait for it,
+// not even when exiting. If that process does not get to finish, the next one takes over.
+static void removeTrashInBackground(const QString &trashDir, const Logger &logger)
+{
+    const bool started = HostOsInfo::isWindowsHost()
+            ? QProcess::startDetached(QStringLiteral("cmd"),
+                                      QStringList{QStringLiteral("/c"), QStringLiteral("rd"),
+                                                  QStringLiteral("/s"), QStringLiteral("/q"),
+                                                  QDir::toNativeSeparators(trashDir)})
+            : QProcess::startDetached(QStringLiteral("rm"),
+                                      QStringList{QStringLiteral("-rf"), QStringLiteral("--"),
+                                                  trashDir});
+    if (started)
         return;
-    invalidateArtifactTimestamp(artifact);
+    logger.qbsDebug() << "Failed to start background removal of '" << trashDir
+                      << "', removing it now.";
     QString errorMessage;
-    if (!removeFileRecursion(fileInfo, &errorMessage))
-        throw ErrorInfo(errorMessage);
+    removeFileRecursion(QFileInfo(trashDir), &errorMessage);
 }
 
 class CleanupVisitor : public ArtifactVisitor
 {
 public:
-    CleanupVisitor(const CleanOptions &options, const ProgressObserver *observer,
-                   const Logger &logger)
+    CleanupVisitor(const ProgressObserver *observer)
         : ArtifactVisitor(Artifact::Generated)
-        , m_options(options)
         , m_observer(observer)
-        , m_logger(logger)
-        , m_hasError(false)
     {
     }
 
@@ -112,20 +142,10 @@ public:
     {
         m_product = product;
         ArtifactVisitor::visitProduct(product);
-        const AllRescuableArtifactData rescuableArtifactData
-                = product->buildData->rescuableArtifactData();
-        for (auto it = rescuableArtifactData.begin(); it != rescuableArtifactData.end(); ++it) {
-            Artifact tmp;
-            tmp.product = product;
-            tmp.setFilePath(it.key());
-            tmp.setTimestamp(it.value().timeStamp);
-            removeArtifactFromDisk(&tmp, m_options.dryRun(), m_logger);
-            product->buildData->removeFromRescuableArtifactData(it.key());
-        }
     }
 
+    const std::vector<Artifact *> &artifacts() const { return m_artifacts; }
     const Set<QString> &directories() const { return m_directories; }
-    bool hasError() const { return m_hasError; }
 
 private:
     void doVisit(Artifact *artifact) override
@@ -135,22 +155,13 @@ private:
 
         if (artifact->product != m_product)
             return;
-        try {
-            removeArtifactFromDisk(artifact, m_options.dryRun(), m_logger);
-        } catch (const ErrorInfo &error) {
-            if (!m_options.keepGoing())
-                throw;
-            m_logger.printWarning(error);
-            m_hasError = true;
-        }
+        m_artifacts.push_back(artifact);
         m_directories << artifact->dirPath();
     }
 
-    const CleanOptions m_options;
     const ProgressObserver * const m_observer;
-    Logger m_logger;
-    bool m_hasError;
     ResolvedProductConstPtr m_product;
+    std::vector<Artifact *> m_artifacts;
     Set<QString> m_directories;
 };
 
@@ -169,11 +180,10 @@ void ArtifactCleaner::cleanup(const TopLevelProjectPtr &project,
 
     Set<QString> directories;
     for (const ResolvedProductPtr &product : products) {
-        CleanupVisitor visitor(options, m_observer, m_logger);
+        CleanupVisitor visitor(m_observer);
         visitor.visitProduct(product);
+        removeArtifactsFromDisk(product, visitor.artifacts(), options);
         directories.unite(visitor.directories());
-        if (visitor.hasError())
-            m_hasError = true;
         m_observer->incrementProgressValue();
     }
 
@@ -194,11 +204,84 @@ void ArtifactCleaner::cleanup(const TopLevelProjectPtr &project,
     }
     m_observer->incrementProgressValue();
 
+    // This also takes care of leftovers from earlier runs.
+    if (options.removeInBackground() && !options.dryRun()) {
+        const QString trashDir = trashDirectory(project.get());
+        if (FileInfo(trashDir).exists())
+            removeTrashInBackground(trashDir, m_logger);
+    }
+
     if (m_hasError)
         throw ErrorInfo(Tr::tr("Failed to remove some files."));
     m_observer->setFinished();
 }
 
+// The files are removed concurrently. Afterwards, we report the results in the original order.
+void ArtifactCleaner::removeArtifactsFromDisk(const ResolvedProductPtr &product,
+                                              const std::vector<Artifact *> &artifacts,
+                                              const CleanOptions &options)
+{
+    QString movedBuildDir;
+    if (options.removeInBackground() && !options.dryRun()
+            && moveBuildDirectoryToTrash(product.get(), m_logger)) {
+        movedBuildDir = product->buildDirectory() + QLatin1Char('/');
+    }
+
+    const AllRescuableArtifactData rescuableArtifactData
+            = product->buildData->rescuableArtifactData();
+    QStringList filePaths;
+    for (const Artifact * const artifact : artifacts)
+        filePaths << artifact->filePath();
+    filePaths += rescuableArtifactData.keys();
+
+    // There is no need to look for files in the build directory we just moved away.
+    QStringList filePathsOnDisk;
+    std::vector<int> indexesOnDisk;
+    for (int i = 0; i < filePaths.size(); ++i) {
+        if (movedBuildDir.isEmpty() || !filePaths.at(i).startsWith(movedBuildDir)) {
+            filePathsOnDisk << filePaths.at(i);
+            indexesOnDisk.push_back(i);
+        }
+    }
+    FileRemovalFlags removalFlags = RemoveRecursively;
+    if (options.dryRun())
+        removalFlags |= DryRunRemoval;
+    if (!options.keepGoing())
+        removalFlags |= StopAtFirstRemovalError;
+    std::vector<FileRemovalResult> results(filePaths.size());
+    const std::vector<FileRemovalResult> resultsOnDisk
+            = removeFilesConcurrently(filePathsOnDisk, removalFlags);
+    for (std::size_t i = 0; i < resultsOnDisk.size(); ++i)
+        results[indexesOnDisk.at(i)] = resultsOnDisk.at(i);
+
+    // The timestamps must be invalidated even if we bail out because of an error below,
+    // as the files might be gone.
+    if (!options.dryRun()) {
+        for (Artifact * const artifact : artifacts)
+            invalidateArtifactTimestamp(artifact);
+        for (auto it = rescuableArtifactData.cbegin(); it != rescuableArtifactData.cend(); ++it) {
+            if (it.value().timeStamp.isValid())
+                product->topLevelProject()->buildData->setDirty();
+        }
+    }
+    for (auto it = rescuableArtifactData.cbegin(); it != rescuableArtifactData.cend(); ++it)
+        product->buildData->removeFromRescuableArtifactData(it.key());
+
+    for (int i = 0; i < filePaths.size(); ++i) {
+        const FileRemovalResult &result = results.at(i);
+        if (!result.existed)
+            continue;
+        printRemovalMessage(filePaths.at(i), options.dryRun(), m_logger);
+        if (result.errorMessage.isEmpty())
+            continue;
+        const ErrorInfo error(result.errorMessage);
+        if (!options.keepGoing())
+            throw error;
+        m_logger.printWarning(error);
+        m_hasError = true;
+    }
+}
+
 void ArtifactCleaner::removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
                                              bool *isEmpty)
 {
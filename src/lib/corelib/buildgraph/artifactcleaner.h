@@ -44,10 +44,13 @@
 #include <language/forward_decls.h>
 #include <logging/logger.h>
 
+#include <vector>
+
 namespace qbs {
 class CleanOptions;
 
 namespace Internal {
+class Artifact;
 class ProgressObserver;
 
 class ArtifactCleaner
@@ -58,6 +61,9 @@ public:
                  const CleanOptions &options);
 
 private:
+    void removeArtifactsFromDisk(const ResolvedProductPtr &product,
+                                 const std::vector<Artifact *> &artifacts,
+                                 const CleanOptions &options);
     void removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
                                 bool *isEmpty = 0);
 
@@ -539,6 +539,28 @@ void removeGeneratedArtifactFromDisk(const QString &filePath, const Logger &logg
         logger.qbsWarning() << QString::fromLatin1("Cannot remove '%1'.").arg(filePath);
 }
 
+void removeGeneratedArtifactsFromDisk(const ArtifactSet &artifacts, const Logger &logger)
+{
+    QStringList filePaths;
+    for (const Artifact * const artifact : artifacts) {
+        if (artifact->artifactType == Artifact::Generated)
+            filePaths << artifact->filePath();
+    }
+    removeGeneratedArtifactsFromDisk(filePaths, logger);
+}
+
+void removeGeneratedArtifactsFromDisk(const QStringList &filePaths, const Logger &logger)
+{
+    const std::vector<FileRemovalResult> results = removeFilesConcurrently(filePaths);
+    for (int i = 0; i < filePaths.size(); ++i) {
+        if (!results.at(i).existed)
+            continue;
+        logger.qbsDebug() << "removing " << filePaths.at(i);
+        if (!results.at(i).errorMessage.isEmpty())
+            logger.qbsWarning() << QString::fromLatin1("Cannot remove '%1'.").arg(filePaths.at(i));
+    }
+}
+
 QString relativeArtifactFileName(const Artifact *artifact)
 {
     const QString &buildDir = artifact->product->topLevelProject()->buildDirectory;
@@ -78,6 +78,8 @@ void QBS_AUTOTEST_EXPORT connect(BuildGraphNode *p, BuildGraphNode *c);
 bool safeConnect(Artifact *u, Artifact *v);
 void removeGeneratedArtifactFromDisk(Artifact *artifact, const Logger &logger);
 void removeGeneratedArtifactFromDisk(const QString &filePath, const Logger &logger);
+void removeGeneratedArtifactsFromDisk(const ArtifactSet &artifacts, const Logger &logger);
+void removeGeneratedArtifactsFromDisk(const QStringList &filePaths, const Logger &logger);
 
 void disconnect(BuildGraphNode *u, BuildGraphNode *v);
 
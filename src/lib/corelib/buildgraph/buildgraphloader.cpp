@@ -58,6 +58,7 @@
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/persistence.h>
 #include <tools/profile.h>
 #include <tools/profiling.h>
@@ -92,6 +93,7 @@ static void restoreBackPointers(const ResolvedProjectPtr &project)
         product->project = project;
         if (!product->buildData)
             continue;
+        Metrics::add(MetricsCounter::GraphNodesLoaded, product->buildData->allNodes().size());
         for (BuildGraphNode * const n : qAsConst(product->buildData->allNodes())) {
             if (n->type() == BuildGraphNode::ArtifactNodeType) {
                 project->topLevelProject()->buildData
@@ -112,6 +114,7 @@ BuildGraphLoadResult BuildGraphLoader::load(const TopLevelProjectPtr &existingPr
 {
     m_parameters = parameters;
     m_result = BuildGraphLoadResult();
+    m_fileSystemJournal.reset();
     m_evalContext = evalContext;
 
     if (existingProject) {
@@ -132,6 +135,7 @@ BuildGraphLoadResult BuildGraphLoader::load(const TopLevelProjectPtr &existingPr
     }
     QBS_CHECK(parameters.restoreBehavior() == SetupProjectParameters::RestoreAndTrackChanges);
 
+    readFileSystemJournal();
     if (m_parameters.logElapsedTime()) {
         m_wildcardExpansionEffort = 0;
         m_propertyComparisonEffort = 0;
@@ -296,6 +300,34 @@ static void updateProductAndRulePointers(const ResolvedProductPtr &newProduct)
     }
 }
 
+void BuildGraphLoader::readFileSystemJournal()
+{
+    const TopLevelProjectPtr &project = m_result.loadedProject;
+    project->fileSystemJournal.reset();
+    const QString journalFilePath = m_parameters.fileSystemJournalFilePath();
+    if (journalFilePath.isEmpty())
+        return;
+    const auto journal = std::make_shared<FileSystemJournal>(
+                FileSystemJournal::read(journalFilePath, project->fileSystemJournalState));
+    if (journal->isComplete()) {
+        qCDebug(lcBuildGraph) << "file system journal" << journalFilePath
+                              << "is complete, checking only files listed there";
+    } else {
+        qCDebug(lcBuildGraph) << "file system journal" << journalFilePath
+                              << "is not usable, checking all files";
+    }
+
+    // The stored journal state is advanced by the executor, once the changes have been
+    // applied to all products.
+    project->fileSystemJournal = journal;
+    m_fileSystemJournal = journal;
+}
+
+bool BuildGraphLoader::fileMayHaveChanged(const QString &filePath) const
+{
+    return !m_fileSystemJournal || m_fileSystemJournal->mayHaveChanged(filePath);
+}
+
 void BuildGraphLoader::trackProjectChanges()
 {
     TimedActivityLogger trackingTimer(m_logger, Tr::tr("Change tracking"),
@@ -395,6 +427,16 @@ void BuildGraphLoader::trackProjectChanges()
     m_result.newlyResolvedProject->buildData.swap(restoredProject->buildData);
     QBS_CHECK(m_result.newlyResolvedProject->buildData);
     m_result.newlyResolvedProject->buildData->setDirty();
+    m_result.newlyResolvedProject->fileSystemJournalState
+            = restoredProject->fileSystemJournalState;
+    m_result.newlyResolvedProject->fileSystemJournal = restoredProject->fileSystemJournal;
+
+    // Products are considered changed unless they turn out to be unchanged below.
+    const quint64 generation = restoredProject->generation + 1;
+    m_result.newlyResolvedProject->generation = generation;
+    m_result.newlyResolvedProject->removedProducts = restoredProject->removedProducts;
+    for (const ResolvedProductPtr &product : qAsConst(allNewlyResolvedProducts))
+        product->generation = generation;
 
     for (auto it = allNewlyResolvedProducts.begin(); it != allNewlyResolvedProducts.end();) {
         const ResolvedProductPtr &newlyResolvedProduct = *it;
@@ -406,6 +448,8 @@ void BuildGraphLoader::trackProjectChanges()
             ++it;
         } else {
             const ResolvedProductPtr &restoredProduct = *k;
+            if (newlyResolvedProduct->enabled == restoredProduct->enabled)
+                newlyResolvedProduct->generation = restoredProduct->generation;
             if (newlyResolvedProduct->enabled)
                 newlyResolvedProduct->buildData.swap(restoredProduct->buildData);
             if (newlyResolvedProduct->buildData)
@@ -421,9 +465,12 @@ void BuildGraphLoader::trackProjectChanges()
 
     // Products still left in the list do not exist anymore.
     for (const ResolvedProductPtr &removedProduct : qAsConst(allRestoredProducts)) {
+        m_result.newlyResolvedProject->removedProducts.emplace_back(
+                    generation, removedProduct->fullDisplayName());
         removeOne(changedProducts, removedProduct);
         onProductRemoved(removedProduct, m_result.newlyResolvedProject->buildData.get());
     }
+    removeGeneratedArtifactsFromDisk(m_artifactsRemovedFromDisk, m_logger);
 
     // Products still left in the list need resolving, either because they are new
     // or because they are newly enabled.
@@ -507,7 +554,7 @@ bool BuildGraphLoader::hasFileExistsResultChanged(const TopLevelProjectConstPtr
 {
     for (QHash<QString, bool>::ConstIterator it = restoredProject->fileExistsResults.constBegin();
          it != restoredProject->fileExistsResults.constEnd(); ++it) {
-        if (FileInfo(it.key()).exists() != it.value()) {
+        if (fileMayHaveChanged(it.key()) && FileInfo(it.key()).exists() != it.value()) {
             qCDebug(lcBuildGraph) << "Existence check for file" << it.key()
                                   << "changed, must re-resolve project.";
             return true;
@@ -521,6 +568,8 @@ bool BuildGraphLoader::hasDirectoryEntriesResultChanged(const TopLevelProjectCon
 {
     for (auto it = restoredProject->directoryEntriesResults.constBegin();
          it != restoredProject->directoryEntriesResults.constEnd(); ++it) {
+        if (!fileMayHaveChanged(it.key().first))
+            continue;
         if (QDir(it.key().first).entryList(static_cast<QDir::Filters>(it.key().second), QDir::Name)
                 != it.value()) {
             qCDebug(lcBuildGraph) << "Entry list for directory" << it.key().first
@@ -538,7 +587,7 @@ bool BuildGraphLoader::hasFileLastModifiedResultChanged(const TopLevelProjectCon
     for (QHash<QString, FileTime>::ConstIterator it
          = restoredProject->fileLastModifiedResults.constBegin();
          it != restoredProject->fileLastModifiedResults.constEnd(); ++it) {
-        if (FileInfo(it.key()).lastModified() != it.value()) {
+        if (fileMayHaveChanged(it.key()) && FileInfo(it.key()).lastModified() != it.value()) {
             qCDebug(lcBuildGraph) << "Timestamp for file" << it.key()
                                   << "changed, must re-resolve project.";
             return true;
@@ -555,18 +604,24 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
     bool hasChanged = false;
     for (const ResolvedProductPtr &product : restoredProducts) {
         const QString filePath = product->location.filePath();
-        const FileInfo pfi(filePath);
         remainingBuildSystemFiles.remove(filePath);
-        if (!pfi.exists()) {
-            qCDebug(lcBuildGraph) << "A product was removed, must re-resolve project";
-            hasChanged = true;
-        } else if (referenceTime < pfi.lastModified()) {
-            qCDebug(lcBuildGraph) << "A product was changed, must re-resolve project";
-            hasChanged = true;
-        } else if (!contains(changedProducts, product)) {
+        if (fileMayHaveChanged(filePath)) {
+            const FileInfo pfi(filePath);
+            if (!pfi.exists()) {
+                qCDebug(lcBuildGraph) << "A product was removed, must re-resolve project";
+                hasChanged = true;
+                continue;
+            }
+            if (referenceTime < pfi.lastModified()) {
+                qCDebug(lcBuildGraph) << "A product was changed, must re-resolve project";
+                hasChanged = true;
+                continue;
+            }
+        }
+        if (!contains(changedProducts, product)) {
             bool foundMissingSourceFile = false;
             for (const QString &file : qAsConst(product->missingSourceFiles)) {
-                if (FileInfo(file).exists()) {
+                if (fileMayHaveChanged(file) && FileInfo(file).exists()) {
                     qCDebug(lcBuildGraph) << "Formerly missing file" << file << "in product"
                                           << product->name << "exists now, must re-resolve project";
                     foundMissingSourceFile = true;
@@ -587,8 +642,9 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
                 const bool reExpansionRequired = std::any_of(
                             group->wildcards->dirTimeStamps.cbegin(),
                             group->wildcards->dirTimeStamps.cend(),
-                            [](const std::pair<QString, FileTime> &pair) {
-                                return FileInfo(pair.first).lastModified() > pair.second;
+                            [this](const std::pair<QString, FileTime> &pair) {
+                                return fileMayHaveChanged(pair.first)
+                                        && FileInfo(pair.first).lastModified() > pair.second;
                 });
                 if (!reExpansionRequired)
                     continue;
@@ -614,6 +670,8 @@ bool BuildGraphLoader::hasBuildSystemFileChanged(const Set<QString> &buildSystem
                                                  const FileTime &referenceTime)
 {
     for (const QString &file : buildSystemFiles) {
+        if (!fileMayHaveChanged(file))
+            continue;
         const FileInfo fi(file);
         if (!fi.exists() || referenceTime < fi.lastModified()) {
             qCDebug(lcBuildGraph) << "A qbs or js file changed, must re-resolve project.";
@@ -757,8 +815,7 @@ void BuildGraphLoader::onProductRemoved(const ResolvedProductPtr &product,
         for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes())) {
             if (node->type() == BuildGraphNode::ArtifactNodeType) {
                 const auto artifact = static_cast<Artifact *>(node);
-                projectBuildData->removeArtifact(artifact, m_logger, removeArtifactsFromDisk,
-                                                 false);
+                projectBuildData->removeArtifact(artifact, m_logger, false, false);
                 if (removeArtifactsFromDisk && artifact->artifactType == Artifact::Generated)
                     m_artifactsRemovedFromDisk << artifact->filePath();
             } else {
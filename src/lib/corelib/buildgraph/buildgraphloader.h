@@ -46,11 +46,14 @@
 
 #include <language/forward_decls.h>
 #include <logging/logger.h>
+#include <tools/filesystemjournal.h>
 #include <tools/setupprojectparameters.h>
 
 #include <QtCore/qprocess.h>
 #include <QtCore/qvariant.h>
 
+#include <memory>
+
 namespace qbs {
 
 namespace Internal {
@@ -82,6 +85,8 @@ public:
 private:
     void loadBuildGraphFromDisk();
     bool checkBuildGraphCompatibility(const TopLevelProjectConstPtr &project);
+    void readFileSystemJournal();
+    bool fileMayHaveChanged(const QString &filePath) const;
     void trackProjectChanges();
     bool probeExecutionForced(const TopLevelProjectConstPtr &restoredProject,
                               const std::vector<ResolvedProductPtr> &restoredProducts) const;
@@ -133,6 +138,7 @@ private:
     RulesEvaluationContextPtr m_evalContext;
     SetupProjectParameters m_parameters;
     BuildGraphLoadResult m_result;
+    std::shared_ptr<const FileSystemJournal> m_fileSystemJournal;
     Logger m_logger;
     QStringList m_artifactsRemovedFromDisk;
     qint64 m_wildcardExpansionEffort;
@@ -50,7 +50,7 @@
 namespace qbs {
 namespace Internal {
 
-BuildGraphNode::BuildGraphNode() : buildState(Untouched)
+BuildGraphNode::BuildGraphNode(Type type) : buildState(Untouched), m_type(type)
 {
 }
 
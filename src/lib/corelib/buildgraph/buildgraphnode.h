@@ -76,7 +76,7 @@ public:
         RuleNodeType
     };
 
-    virtual Type type() const = 0;
+    Type type() const { return m_type; }
     virtual void accept(BuildGraphVisitor *visitor) = 0;
     virtual QString toString() const = 0;
     virtual void onChildDisconnected(BuildGraphNode *child);
@@ -87,7 +87,7 @@ public:
     virtual void store(PersistentPool &pool);
 
 protected:
-    explicit BuildGraphNode();
+    explicit BuildGraphNode(Type type);
     void acceptChildren(BuildGraphVisitor *visitor);
 
     // Do not store parents to avoid recursion.
@@ -96,6 +96,11 @@ protected:
     {
         pool.serializationOp<opType>(children);
     }
+
+private:
+    // Kept as a plain member rather than a virtual function, because type filtering happens
+    // for every edge visited when traversing the build graph.
+    const Type m_type;
 };
 
 } // namespace Internal
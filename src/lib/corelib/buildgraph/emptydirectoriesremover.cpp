@@ -41,10 +41,14 @@
 #include "artifact.h"
 
 #include <language/language.h>
+#include <tools/fileinfo.h>
+#include <tools/parallelfor.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -61,7 +65,7 @@ void EmptyDirectoriesRemover::removeEmptyParentDirectories(const QStringList &ar
     for (const QString &filePath : artifactFilePaths)
         insertSorted(QFileInfo(filePath).absolutePath());
     while (!m_dirsToRemove.empty())
-        removeDirIfEmpty();
+        removeDirsIfEmpty();
 }
 
 void EmptyDirectoriesRemover::removeEmptyParentDirectories(const ArtifactSet &artifacts)
@@ -88,28 +92,52 @@ void EmptyDirectoriesRemover::insertSorted(const QString &dirPath)
     m_dirsToRemove.insert(i, dirPath);
 }
 
-void EmptyDirectoriesRemover::removeDirIfEmpty()
+// Handles all directories of the deepest level. They cannot contain each other, so they
+// can be checked and removed concurrently.
+void EmptyDirectoriesRemover::removeDirsIfEmpty()
+{
+    const int depth = m_dirsToRemove.first().count(QLatin1Char('/'));
+    QStringList dirPaths;
+    while (!m_dirsToRemove.empty() && m_dirsToRemove.first().count(QLatin1Char('/')) == depth)
+        dirPaths << m_dirsToRemove.takeFirst();
+
+    std::vector<QString> parentDirs(dirPaths.size());
+    std::vector<int> failures(dirPaths.size());
+    parallelFor(dirPaths.size(), fileOperationThreadCount(dirPaths.size()), [&](std::size_t i) {
+        failures[i] = !removeDirIfEmpty(dirPaths.at(int(i)), &parentDirs[i]);
+    });
+
+    for (int i = 0; i < dirPaths.size(); ++i) {
+        m_handledDirs.insert(dirPaths.at(i));
+        if (failures.at(i)) {
+            m_logger.qbsWarning() << QString::fromLatin1("Cannot remove empty directory '%1'.")
+                                     .arg(dirPaths.at(i));
+        }
+    }
+    for (const QString &parentDir : parentDirs) {
+        if (!parentDir.isEmpty() && !m_handledDirs.contains(parentDir))
+            insertSorted(parentDir);
+    }
+}
+
+// Returns false if the directory is empty but could not be removed. If it was removed,
+// parentDir is set to the directory containing it.
+bool EmptyDirectoriesRemover::removeDirIfEmpty(const QString &dirPath, QString *parentDir) const
 {
-    const QString dirPath = m_dirsToRemove.takeFirst();
-    m_handledDirs.insert(dirPath);
     QFileInfo fi(dirPath);
     if (fi.isSymLink() || !fi.exists() || !dirPath.startsWith(m_project->buildDirectory)
             || fi.filePath() == m_project->buildDirectory) {
-        return;
+        return true;
     }
     QDir dir(dirPath);
     dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
     if (dir.count() != 0)
-        return;
+        return true;
     dir.cdUp();
-    if (!dir.rmdir(fi.fileName())) {
-        m_logger.qbsWarning() << QString::fromLatin1("Cannot remove empty directory '%1'.")
-                                 .arg(dirPath);
-        return;
-    }
-    const QString parentDir = dir.path();
-    if (!m_handledDirs.contains(parentDir))
-        insertSorted(parentDir);
+    if (!dir.rmdir(fi.fileName()))
+        return false;
+    *parentDir = dir.path();
+    return true;
 }
 
 } // namespace Internal
@@ -59,7 +59,8 @@ public:
 
 private:
     void insertSorted(const QString &dirPath);
-    void removeDirIfEmpty();
+    void removeDirsIfEmpty();
+    bool removeDirIfEmpty(const QString &dirPath, QString *parentDir) const;
 
     const TopLevelProject * const m_project;
     Logger m_logger;
@@ -61,6 +61,8 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/parallelfor.h>
+#include <tools/processresult.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
@@ -134,14 +136,34 @@ FileTime Executor::recursiveFileTime(const QString &filePath) const
 void Executor::retrieveSourceFileTimestamp(Artifact *artifact) const
 {
     QBS_CHECK(artifact->artifactType == Artifact::SourceFile);
+    setSourceFileTimestamp(artifact, sourceFileTimestamp(artifact));
+}
 
-    if (m_buildOptions.changedFiles().empty())
-        artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
-    else if (m_buildOptions.changedFiles().contains(artifact->filePath()))
-        artifact->setTimestamp(FileTime::currentTime());
-    else if (!artifact->timestamp().isValid())
-        artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
+// Does not modify the artifact, so it can be called from several threads at once.
+FileTime Executor::sourceFileTimestamp(const Artifact *artifact) const
+{
+    if (m_buildOptions.changedFiles().empty()) {
+        if (artifact->timestamp().isValid() && !fileMayHaveChanged(artifact->filePath()))
+            return artifact->timestamp();
+        return recursiveFileTime(artifact->filePath());
+    }
+    if (m_buildOptions.changedFiles().contains(artifact->filePath()))
+        return FileTime::currentTime();
+    if (!artifact->timestamp().isValid())
+        return recursiveFileTime(artifact->filePath());
+    return artifact->timestamp();
+}
 
+// Consults the file system journal, if there is one.
+bool Executor::fileMayHaveChanged(const QString &filePath) const
+{
+    const std::shared_ptr<const FileSystemJournal> &journal = m_project->fileSystemJournal;
+    return !journal || journal->mayHaveChanged(filePath);
+}
+
+void Executor::setSourceFileTimestamp(Artifact *artifact, const FileTime &timestamp) const
+{
+    artifact->setTimestamp(timestamp);
     artifact->timestampRetrieved = true;
     if (!artifact->timestamp().isValid())
         throw ErrorInfo(Tr::tr("Source file '%1' has disappeared.").arg(artifact->filePath()));
@@ -267,6 +289,8 @@ void Executor::doBuild()
     m_evalContext = m_project->buildData->evaluationContext;
 
     m_elapsedTimeRules = m_elapsedTimeScanners = m_elapsedTimeInstalling = 0;
+    m_resourceUsagePerProduct.clear();
+    m_resourceUsagePerRule.clear();
     m_evalContext->engine()->enableProfiling(m_buildOptions.logElapsedTime());
 
     InstallOptions installOptions;
@@ -274,14 +298,16 @@ void Executor::doBuild()
     installOptions.setInstallRoot(m_productsToBuild.front()->moduleProperties
             ->qbsPropertyValue(StringConstants::installRootProperty()).toString());
     installOptions.setKeepGoing(m_buildOptions.keepGoing());
+    installOptions.setInstallMode(m_buildOptions.installMode());
+    installOptions.setMaxJobCount(m_buildOptions.maxJobCount());
     m_productInstaller = new ProductInstaller(m_project, m_productsToBuild, installOptions,
                                               m_progressObserver, m_logger);
     if (m_buildOptions.removeExistingInstallation())
         m_productInstaller->removeInstallRoot();
 
     addExecutorJobs();
-    syncFileDependencies();
     prepareAllNodes();
+    syncFileDependencies();
     prepareProducts();
     setupRootNodes();
     prepareReachableNodes();
@@ -381,7 +407,11 @@ bool Executor::isUpToDate(Artifact *artifact) const
                              << artifact->timestamp().toString();
 
     if (m_buildOptions.forceTimestampCheck()) {
-        artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
+        // Usually done in bulk by retrieveTimestamps().
+        if (!artifact->timestampRetrieved) {
+            artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
+            artifact->timestampRetrieved = true;
+        }
         qCDebug(lcUpToDateCheck) << "timestamp retrieved from filesystem:"
                                  << artifact->timestamp().toString();
     }
@@ -391,12 +421,19 @@ bool Executor::isUpToDate(Artifact *artifact) const
         return false;
     }
 
+    FileTime referenceTime = artifact->timestamp();
+    if (referenceTime < artifact->upToDateSince) {
+        qCDebug(lcUpToDateCheck) << "kept unchanged by run at"
+                                 << artifact->upToDateSince.toString();
+        referenceTime = artifact->upToDateSince;
+    }
+
     for (Artifact *childArtifact : filterByType<Artifact>(artifact->children)) {
         QBS_CHECK(childArtifact->timestamp().isValid());
         qCDebug(lcUpToDateCheck) << "child timestamp"
                                  << childArtifact->timestamp().toString()
                                  << childArtifact->filePath();
-        if (artifact->timestamp() < childArtifact->timestamp())
+        if (referenceTime < childArtifact->timestamp())
             return false;
     }
 
@@ -413,7 +450,7 @@ bool Executor::isUpToDate(Artifact *artifact) const
         qCDebug(lcUpToDateCheck) << "file dependency timestamp"
                                  << fileDependency->timestamp().toString()
                                  << fileDependency->filePath();
-        if (artifact->timestamp() < fileDependency->timestamp())
+        if (referenceTime < fileDependency->timestamp())
             return false;
     }
 
@@ -523,6 +560,7 @@ void Executor::executeRuleNode(RuleNode *ruleNode)
     } else {
         qCDebug(lcExec) << ruleNode->toString();
         const WeakPointer<ResolvedProduct> &product = ruleNode->product;
+        m_project->markProductChanged(product.get()); // The set of generated artifacts may differ.
         Set<RuleNode *> parentRules;
         if (!result.createdNodes.empty()) {
             for (BuildGraphNode *parent : qAsConst(ruleNode->parents)) {
@@ -566,6 +604,16 @@ void Executor::finishJob(ExecutorJob *job, bool success)
     if (success) {
         m_project->buildData->setDirty();
         for (Artifact * const artifact : qAsConst(transformer->outputs)) {
+            if (transformer->outputsKeptUnchanged.contains(artifact->filePath())) {
+                // The file still has the contents it had before, so there is no reason
+                // to rebuild the artifacts depending on it.
+                qCDebug(lcExec) << "output kept unchanged:" << artifact->filePath();
+                if (!artifact->timestamp().isValid())
+                    artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
+                artifact->upToDateSince = transformer->lastCommandExecutionTime;
+                continue;
+            }
+            artifact->upToDateSince = FileTime();
             if (artifact->alwaysUpdated) {
                 artifact->setTimestamp(FileTime::currentTime());
                 for (Artifact * const parent : artifact->parentArtifacts())
@@ -743,10 +791,16 @@ void Executor::addExecutorJobs()
         job->setObjectName(QString::fromLatin1("J%1").arg(i));
         job->setDryRun(m_buildOptions.dryRun());
         job->setEchoMode(m_buildOptions.echoMode());
+        job->setCommandOutputHandling(m_buildOptions.commandOutputBufferSize(),
+                                      m_buildOptions.streamCommandOutput());
         m_availableJobs.push_back(job);
         connect(job, &ExecutorJob::reportCommandDescription,
                 this, &Executor::reportCommandDescription);
-        connect(job, &ExecutorJob::reportProcessResult, this, &Executor::reportProcessResult);
+        connect(job, &ExecutorJob::reportProcessResult, this,
+                [this, job](const ProcessResult &result) {
+            accountResourceUsage(job, result);
+            emit reportProcessResult(result);
+        });
         connect(job, &ExecutorJob::finished,
                 this, &Executor::onJobFinished, Qt::QueuedConnection);
     }
@@ -1055,11 +1109,11 @@ void Executor::checkForUnbuiltProducts()
             // Any element still left after a successful build has not been re-created
             // by any rule and therefore does not exist anymore as an artifact.
             const AllRescuableArtifactData rad = product->buildData->rescuableArtifactData();
-            for (auto it = rad.cbegin(); it != rad.cend(); ++it) {
-                removeGeneratedArtifactFromDisk(it.key(), m_logger);
-                product->buildData->removeFromRescuableArtifactData(it.key());
-                m_artifactsRemovedFromDisk << it.key();
-            }
+            const QStringList filePaths = rad.keys();
+            removeGeneratedArtifactsFromDisk(filePaths, m_logger);
+            for (const QString &filePath : filePaths)
+                product->buildData->removeFromRescuableArtifactData(filePath);
+            m_artifactsRemovedFromDisk << filePaths;
         }
     }
 
@@ -1117,11 +1171,62 @@ void Executor::finish()
                                              .arg(elapsedTimeString(m_elapsedTimeScanners));
         m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Installing artifacts took %1.")
                                              .arg(elapsedTimeString(m_elapsedTimeInstalling));
+        printResourceUsageSummary();
     }
 
     emit finished();
 }
 
+void Executor::accountResourceUsage(ExecutorJob *job, const ProcessResult &result)
+{
+    if (!m_buildOptions.logElapsedTime() || result.elapsedTime() == -1)
+        return;
+    const TransformerConstPtr transformer = m_processingJobs.value(job);
+    QBS_ASSERT(transformer, return);
+    const QString ruleName = transformer->rule->name.isEmpty()
+            ? transformer->rule->toString() : transformer->rule->name;
+    for (ResourceUsageTotals *totals
+         : {&m_resourceUsagePerProduct[transformer->product()->fullDisplayName()],
+            &m_resourceUsagePerRule[ruleName]}) {
+        ++totals->commandCount;
+        totals->wallTime += result.elapsedTime();
+        totals->cpuTime += std::max<qint64>(result.userCpuTime(), 0)
+                + std::max<qint64>(result.systemCpuTime(), 0);
+        totals->peakResidentSetSize = std::max(totals->peakResidentSetSize,
+                                               result.peakResidentSetSize());
+    }
+}
+
+void Executor::printResourceUsageSummary() const
+{
+    const auto printTotals = [this](const QString &title,
+                                    const QHash<QString, ResourceUsageTotals> &totalsPerName) {
+        if (totalsPerName.empty())
+            return;
+        using Entry = std::pair<QString, ResourceUsageTotals>;
+        std::vector<Entry> entries;
+        for (auto it = totalsPerName.cbegin(); it != totalsPerName.cend(); ++it)
+            entries.emplace_back(it.key(), it.value());
+        std::sort(entries.begin(), entries.end(), [](const Entry &e1, const Entry &e2) {
+            return e1.second.cpuTime > e2.second.cpuTime;
+        });
+        m_logger.qbsLog(LoggerInfo, true) << "\t" << title;
+        for (const Entry &e : entries) {
+            const QString peakMemoryString = e.second.peakResidentSetSize > 0
+                    ? Tr::tr("%1 MB").arg(e.second.peakResidentSetSize / (1024.0 * 1024.0), 0,
+                                          'f', 1)
+                    : Tr::tr("unknown");
+            m_logger.qbsLog(LoggerInfo, true) << "\t\t"
+                    << Tr::tr("%1: %2 commands, wall time %3, CPU time %4, peak memory %5.")
+                       .arg(e.first, QString::number(e.second.commandCount),
+                            elapsedTimeString(e.second.wallTime),
+                            elapsedTimeString(e.second.cpuTime), peakMemoryString);
+        }
+    };
+    printTotals(Tr::tr("Resource usage of commands per product:"), m_resourceUsagePerProduct);
+    printTotals(Tr::tr("Resource usage of commands per rule:"), m_resourceUsagePerRule);
+}
+
 void Executor::checkForCancellation()
 {
     QBS_ASSERT(m_progressObserver, return);
@@ -1150,7 +1255,7 @@ bool Executor::visit(RuleNode *ruleNode)
   * Sets the state of all artifacts in the graph to "untouched".
   * This must be done before doing a build.
   *
-  * Retrieves the timestamps of source artifacts.
+  * Retrieves the timestamps of source artifacts and file dependencies.
   *
   * This function also fills the list of changed source files.
   */
@@ -1163,11 +1268,110 @@ void Executor::prepareAllNodes()
                 node->buildState = BuildGraphNode::Untouched;
         }
     }
+    std::vector<Artifact *> sourceArtifacts;
+    std::vector<Artifact *> generatedArtifacts;
     for (const ResolvedProductPtr &product : m_productsToBuild) {
         QBS_CHECK(product->buildData);
-        for (Artifact * const artifact : filterByType<Artifact>(product->buildData->allNodes()))
+        for (Artifact * const artifact : filterByType<Artifact>(product->buildData->allNodes())) {
             prepareArtifact(artifact);
+            if (artifact->artifactType == Artifact::SourceFile)
+                sourceArtifacts.push_back(artifact);
+            else if (artifact->artifactType == Artifact::Generated
+                     && m_buildOptions.forceTimestampCheck())
+                generatedArtifacts.push_back(artifact);
+        }
+    }
+    retrieveTimestamps(sourceArtifacts, generatedArtifacts);
+    applyFileSystemJournal();
+
+    for (const Artifact * const artifact : sourceArtifacts)
+        possiblyInstallArtifact(artifact);
+}
+
+/*!
+  * Records that the changes listed in the file system journal have been taken into account.
+  *
+  * The products we build have just had their timestamps refreshed. In all other products,
+  * the timestamps of source files that might have changed are invalidated, so they get
+  * re-checked once these products are built. Only then is it safe to store the new journal
+  * position, because the next build will not see these changes again.
+  */
+void Executor::applyFileSystemJournal()
+{
+    const std::shared_ptr<const FileSystemJournal> &journal = m_project->fileSystemJournal;
+    if (!journal)
+        return;
+
+    // The journal was not consulted for source files, so their changes are still pending.
+    if (!m_buildOptions.changedFiles().empty())
+        return;
+
+    for (const ResolvedProductPtr &product : m_allProducts) {
+        if (!product->buildData || contains(m_productsToBuild, product))
+            continue;
+        for (Artifact * const artifact : filterByType<Artifact>(product->buildData->allNodes())) {
+            if (artifact->artifactType == Artifact::SourceFile && artifact->timestamp().isValid()
+                    && journal->mayHaveChanged(artifact->filePath())) {
+                artifact->clearTimestamp();
+                m_project->buildData->setDirty();
+            }
+        }
+    }
+
+    // If the watcher session changed, make sure the new one gets recorded even on a null build.
+    // Otherwise, we would never be able to make use of the journal.
+    if (journal->state().session != m_project->fileSystemJournalState.session)
+        m_project->buildData->setDirty();
+    m_project->fileSystemJournalState = journal->state();
+}
+
+/*!
+  * Gathers the file system timestamps of the given artifacts and of all file dependencies.
+  *
+  * On a null build, this is where nearly all the time is spent, so the file system is
+  * queried from several threads in parallel. The results are written back into the
+  * artifacts on the calling thread.
+  */
+void Executor::retrieveTimestamps(const std::vector<Artifact *> &sourceArtifacts,
+                                  const std::vector<Artifact *> &generatedArtifacts)
+{
+    const Set<FileDependency *> &fileDependencies = m_project->buildData->fileDependencies;
+    const std::size_t sourceCount = sourceArtifacts.size();
+    const std::size_t generatedCount = generatedArtifacts.size();
+    const std::size_t totalCount = sourceCount + generatedCount + fileDependencies.size();
+    std::vector<FileTime> timestamps(totalCount);
+    parallelFor(totalCount, m_buildOptions.maxJobCount(),
+                [&](std::size_t i) {
+        if (i < sourceCount) {
+            timestamps[i] = sourceFileTimestamp(sourceArtifacts[i]);
+        } else if (i < sourceCount + generatedCount) {
+            timestamps[i] = FileInfo(generatedArtifacts[i - sourceCount]->filePath())
+                    .lastModified();
+        } else {
+            const FileDependency * const fileDependency
+                    = *(fileDependencies.cbegin() + (i - sourceCount - generatedCount));
+            timestamps[i] = fileDependency->timestamp().isValid()
+                    && !fileMayHaveChanged(fileDependency->filePath())
+                    ? fileDependency->timestamp()
+                    : FileInfo(fileDependency->filePath()).lastModified();
+        }
+    });
+
+    for (std::size_t i = 0; i < sourceCount; ++i) {
+        Artifact * const artifact = sourceArtifacts[i];
+        const FileTime oldTimestamp = artifact->timestamp();
+        setSourceFileTimestamp(artifact, timestamps[i]);
+        if (oldTimestamp != artifact->timestamp())
+            m_changedSourceArtifacts.push_back(artifact);
+    }
+    for (std::size_t i = 0; i < generatedCount; ++i) {
+        Artifact * const artifact = generatedArtifacts[i];
+        artifact->setTimestamp(timestamps[sourceCount + i]);
+        artifact->timestampRetrieved = true;
     }
+    auto timestampIt = timestamps.cbegin() + sourceCount + generatedCount;
+    for (FileDependency * const fileDependency : fileDependencies)
+        fileDependency->setTimestamp(*timestampIt++);
 }
 
 void Executor::syncFileDependencies()
@@ -1175,7 +1379,9 @@ void Executor::syncFileDependencies()
     Set<FileDependency *> &globalFileDepList = m_project->buildData->fileDependencies;
     for (auto it = globalFileDepList.begin(); it != globalFileDepList.end(); ) {
         FileDependency * const dep = *it;
-        if (FileInfo(dep->filePath()).exists()) {
+
+        // The timestamp was retrieved in prepareAllNodes().
+        if (dep->timestamp().isValid()) {
             ++it;
             continue;
         }
@@ -1210,20 +1416,16 @@ void Executor::prepareArtifact(Artifact *artifact)
     artifact->inputsScanned = false;
     artifact->timestampRetrieved = false;
 
-    if (artifact->artifactType == Artifact::SourceFile) {
-        const FileTime oldTimestamp = artifact->timestamp();
-        retrieveSourceFileTimestamp(artifact);
-        if (oldTimestamp != artifact->timestamp())
-            m_changedSourceArtifacts.push_back(artifact);
-        possiblyInstallArtifact(artifact);
-    }
-
-    // Timestamps of file dependencies must be invalid for every build.
-    // TODO: These should be a subset of ProjectBuildData::fileDependencies, so clear the
-    // timestamps in syncFileDepencencies() instead.
+    // Timestamps of file dependencies must be invalid for every build, unless the file system
+    // journal tells us they are still valid.
+    // The ones in ProjectBuildData::fileDependencies get refreshed in retrieveTimestamps().
+    // TODO: These should be a subset of ProjectBuildData::fileDependencies, so don't
+    // clear them here.
     // TODO: Verify this assumption in the sanity checks.
-    for (FileDependency * const fileDependency : qAsConst(artifact->fileDependencies))
-        fileDependency->clearTimestamp();
+    for (FileDependency * const fileDependency : qAsConst(artifact->fileDependencies)) {
+        if (fileMayHaveChanged(fileDependency->filePath()))
+            fileDependency->clearTimestamp();
+    }
 }
 
 void Executor::setupForBuildingSelectedFiles(const BuildGraphNode *node)
@@ -116,6 +116,9 @@ private:
     void prepareAllNodes();
     void syncFileDependencies();
     void prepareArtifact(Artifact *artifact);
+    void retrieveTimestamps(const std::vector<Artifact *> &sourceArtifacts,
+                            const std::vector<Artifact *> &generatedArtifacts);
+    void applyFileSystemJournal();
     void setupForBuildingSelectedFiles(const BuildGraphNode *node);
     void prepareReachableNodes();
     void prepareReachableNodes_impl(BuildGraphNode *node);
@@ -136,6 +139,8 @@ private:
     void setupProgressObserver();
     void doSanityChecks();
     void handleError(const ErrorInfo &error);
+    void accountResourceUsage(ExecutorJob *job, const ProcessResult &result);
+    void printResourceUsageSummary() const;
     void rescueOldBuildData(Artifact *artifact, bool *childrenAdded);
     bool checkForUnbuiltDependencies(Artifact *artifact);
     void potentiallyRunTransformer(const TransformerPtr &transformer);
@@ -148,7 +153,10 @@ private:
     bool mustExecuteTransformer(const TransformerPtr &transformer) const;
     bool isUpToDate(Artifact *artifact) const;
     void retrieveSourceFileTimestamp(Artifact *artifact) const;
+    FileTime sourceFileTimestamp(const Artifact *artifact) const;
+    void setSourceFileTimestamp(Artifact *artifact, const FileTime &timestamp) const;
     FileTime recursiveFileTime(const QString &filePath) const;
+    bool fileMayHaveChanged(const QString &filePath) const;
     QString configString() const;
     bool transformerHasMatchingOutputTags(const TransformerConstPtr &transformer) const;
     bool artifactHasMatchingOutputTags(const Artifact *artifact) const;
@@ -185,6 +193,16 @@ private:
     qint64 m_elapsedTimeRules;
     qint64 m_elapsedTimeScanners;
     qint64 m_elapsedTimeInstalling;
+
+    struct ResourceUsageTotals
+    {
+        int commandCount = 0;
+        qint64 wallTime = 0;
+        qint64 cpuTime = 0;
+        qint64 peakResidentSetSize = 0;
+    };
+    QHash<QString, ResourceUsageTotals> m_resourceUsagePerProduct;
+    QHash<QString, ResourceUsageTotals> m_resourceUsagePerRule;
 };
 
 } // namespace Internal
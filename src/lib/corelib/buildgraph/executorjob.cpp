@@ -93,6 +93,12 @@ void ExecutorJob::setEchoMode(CommandEchoMode echoMode)
     m_jsCommandExecutor->setEchoMode(echoMode);
 }
 
+void ExecutorJob::setCommandOutputHandling(qint64 bufferSize, bool stream)
+{
+    m_processCommandExecutor->setOutputBufferSize(bufferSize);
+    m_processCommandExecutor->setStreamOutput(stream);
+}
+
 void ExecutorJob::run(Transformer *t)
 {
     QBS_ASSERT(m_currentCommandIdx == -1, return);
@@ -133,6 +139,9 @@ void ExecutorJob::runNextCommand()
         return;
     }
 
+    // Any command may write any of the outputs, so only what the last command reports counts.
+    m_transformer->outputsKeptUnchanged.clear();
+
     const AbstractCommandPtr &command = m_transformer->commands.commandAt(m_currentCommandIdx);
     switch (command->type()) {
     case AbstractCommand::ProcessCommandType:
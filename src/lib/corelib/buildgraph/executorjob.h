@@ -69,6 +69,7 @@ public:
     void setMainThreadScriptEngine(ScriptEngine *engine);
     void setDryRun(bool enabled);
     void setEchoMode(CommandEchoMode echoMode);
+    void setCommandOutputHandling(qint64 bufferSize, bool stream);
     void run(Transformer *t);
     void cancel();
 
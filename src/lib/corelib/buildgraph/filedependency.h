@@ -42,11 +42,12 @@
 
 #include <tools/filetime.h>
 #include <tools/persistence.h>
+#include <tools/qbs_export.h>
 
 namespace qbs {
 namespace Internal {
 
-class FileResourceBase
+class QBS_AUTOTEST_EXPORT FileResourceBase
 {
 protected:
     FileResourceBase();
@@ -50,6 +50,7 @@
 #include <language/language.h>
 #include <logging/categories.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/scannerpluginmanager.h>
 #include <tools/qbsassert.h>
 #include <tools/error.h>
@@ -226,12 +227,15 @@ void InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *sca
     if (scanData.lastScanTime < fileToBeScanned->timestamp()) {
         try {
             qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned);
+            Metrics::add(MetricsCounter::ScannerInvocations);
             scanWithScannerPlugin(scanner, fileToBeScanned, &scanData.rawScanResult);
             scanData.lastScanTime = FileTime::currentTime();
         } catch (const ErrorInfo &error) {
             m_logger.printWarning(error);
             return;
         }
+    } else {
+        Metrics::add(MetricsCounter::ScannerCacheHits);
     }
 
     resolveScanResultDependencies(inputArtifact, scanData.rawScanResult, filesToScan, cache);
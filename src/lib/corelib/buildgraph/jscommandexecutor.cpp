@@ -114,6 +114,7 @@ private:
         QScriptValue scope = scriptEngine->newObject();
         scope.setPrototype(scriptEngine->globalObject());
         m_scriptEngine->clearRequestedProperties();
+        m_scriptEngine->clearFilesKeptUnchanged();
         setupScriptEngineForFile(scriptEngine,
                                  transformer->rule->prepareScript.fileContext(), scope,
                                  ObserveMode::Enabled);
@@ -157,6 +158,9 @@ private:
                         std::make_pair(p->uniqueName(), p->exportedModule));
         }
         scriptEngine->clearRequestedProperties();
+        for (const QString &filePath : scriptEngine->filesKeptUnchanged())
+            transformer->outputsKeptUnchanged.insert(filePath);
+        scriptEngine->clearFilesKeptUnchanged();
         if (scriptEngine->hasUncaughtException()) {
             // ### We don't know the line number of the command's sourceCode property assignment.
             setError(scriptEngine->uncaughtException().toString(), cmd->codeLocation());
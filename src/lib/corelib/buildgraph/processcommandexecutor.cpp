@@ -52,6 +52,7 @@
 #include <tools/error.h>
 #include <tools/executablefinder.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/hostosinfo.h>
 #include <tools/processresult.h>
 #include <tools/processresult_p.h>
@@ -74,6 +75,10 @@ ProcessCommandExecutor::ProcessCommandExecutor(const Logger &logger, QObject *pa
 {
     connect(&m_process, static_cast<void (QbsProcess::*)(QProcess::ProcessError)>(&QbsProcess::error),
             this, &ProcessCommandExecutor::onProcessError);
+    connect(&m_process, &QbsProcess::readyReadStandardOutput,
+            this, [this] { onProcessOutput(true); });
+    connect(&m_process, &QbsProcess::readyReadStandardError,
+            this, [this] { onProcessOutput(false); });
     connect(&m_process, static_cast<void (QbsProcess::*)(int)>(&QbsProcess::finished),
             this, &ProcessCommandExecutor::onProcessFinished);
 }
@@ -191,6 +196,15 @@ void ProcessCommandExecutor::doStart()
     const QProcessEnvironment &additionalVariables = cmd->environment();
     qCDebug(lcExec) << "Additional environment:" << additionalVariables.toStringList();
     m_process.setWorkingDirectory(workingDir);
+    m_stdoutBuffer.reset(m_outputBufferSize);
+    m_stderrBuffer.reset(m_outputBufferSize);
+    m_pendingStdoutLine.clear();
+    m_pendingStderrLine.clear();
+    Metrics::add(MetricsCounter::CommandsSpawned);
+    if (Metrics::isEnabled()) {
+        Metrics::changeGauge(MetricsGauge::RunningCommands, 1);
+        m_metricsTimer.start();
+    }
     m_process.start(m_program, arguments);
 }
 
@@ -239,6 +253,53 @@ QString ProcessCommandExecutor::filterProcessOutput(const QByteArray &_output,
     return filteredOutput.toString();
 }
 
+void ProcessCommandExecutor::onProcessOutput(bool stdOut)
+{
+    const QByteArray data = stdOut ? m_process.readAllStandardOutput()
+                                   : m_process.readAllStandardError();
+    if (data.isEmpty())
+        return;
+    Metrics::add(MetricsCounter::CommandOutputBytes, data.size());
+    if (isStreamingOutput(stdOut)) {
+        (stdOut ? m_pendingStdoutLine : m_pendingStderrLine).append(data);
+        streamOutput(stdOut, false);
+    } else {
+        (stdOut ? m_stdoutBuffer : m_stderrBuffer).append(data);
+    }
+}
+
+// Output that needs to be post-processed as a whole cannot be streamed.
+bool ProcessCommandExecutor::isStreamingOutput(bool stdOut) const
+{
+    if (!m_streamOutput)
+        return false;
+    const ProcessCommand * const cmd = processCommand();
+    return stdOut
+            ? cmd->stdoutFilterFunction().isEmpty() && cmd->stdoutFilePath().isEmpty()
+            : cmd->stderrFilterFunction().isEmpty() && cmd->stderrFilePath().isEmpty();
+}
+
+void ProcessCommandExecutor::streamOutput(bool stdOut, bool flush)
+{
+    QByteArray &pending = stdOut ? m_pendingStdoutLine : m_pendingStderrLine;
+    // Do not let a single huge line eat up the memory.
+    const bool flushAll = flush
+            || (m_outputBufferSize > 0 && pending.size() > m_outputBufferSize);
+    const int end = flushAll ? pending.size() : pending.lastIndexOf('\n') + 1;
+    if (end <= 0)
+        return;
+    QString lines = QString::fromLocal8Bit(pending.constData(), end);
+    pending.remove(0, end);
+    if (lines.endsWith(QLatin1Char('\n')))
+        lines.chop(1);
+    if (lines.isEmpty())
+        return;
+    if (stdOut)
+        logger().qbsInfo() << lines;
+    else
+        logger().qbsInfo() << lines << MessageTag(QStringLiteral("stdErr"));
+}
+
 static QProcess::ProcessError saveToFile(const QString &filePath, const QByteArray &content)
 {
     QBS_ASSERT(!filePath.isEmpty(), return QProcess::WriteError);
@@ -253,37 +314,75 @@ static QProcess::ProcessError saveToFile(const QString &filePath, const QByteArr
     return f.error() == QFileDevice::NoError ? QProcess::UnknownError : QProcess::WriteError;
 }
 
-void ProcessCommandExecutor::getProcessOutput(bool stdOut, ProcessResult &result)
+void ProcessCommandExecutor::getProcessOutput(bool stdOut, ProcessResult &result,
+                                              QString &errorString)
 {
-    QByteArray content;
+    onProcessOutput(stdOut); // Whatever came with the "finished" notification.
+    if (isStreamingOutput(stdOut)) {
+        streamOutput(stdOut, true);
+        return;
+    }
+
+    CommandOutputBuffer &buffer = stdOut ? m_stdoutBuffer : m_stderrBuffer;
     QString filterFunction;
     QString redirectPath;
     QStringList *target;
     if (stdOut) {
-        content = m_process.readAllStandardOutput();
         filterFunction = processCommand()->stdoutFilterFunction();
         redirectPath = processCommand()->stdoutFilePath();
         target = &result.d->stdOut;
     } else {
-        content = m_process.readAllStandardError();
         filterFunction = processCommand()->stderrFilterFunction();
         redirectPath = processCommand()->stderrFilePath();
         target = &result.d->stdErr;
     }
-    QString contentString = filterProcessOutput(content, filterFunction);
+
+    // Redirected output ends up in an artifact, so it must be written in full.
     if (!redirectPath.isEmpty()) {
-        const QProcess::ProcessError error = saveToFile(redirectPath, contentString.toLocal8Bit());
-        if (result.error() == QProcess::UnknownError && error != QProcess::UnknownError)
+        QProcess::ProcessError error = QProcess::UnknownError;
+        if (!buffer.isComplete()) {
+            error = QProcess::WriteError;
+        } else if (filterFunction.isEmpty()) {
+            if (!buffer.saveToFile(redirectPath))
+                error = QProcess::WriteError;
+        } else {
+            const QByteArray content = buffer.readAll();
+            if (content.size() != buffer.size()) {
+                error = QProcess::WriteError;
+            } else {
+                error = saveToFile(redirectPath,
+                                   filterProcessOutput(content, filterFunction).toLocal8Bit());
+            }
+        }
+        if (error != QProcess::UnknownError && result.error() == QProcess::UnknownError) {
             result.d->error = error;
-    } else {
-        if (!contentString.isEmpty() && contentString.endsWith(QLatin1Char('\n')))
-            contentString.chop(1);
-        *target = contentString.split(QLatin1Char('\n'), QString::SkipEmptyParts);
+            errorString = Tr::tr("The complete output of the process could not be written "
+                                 "to '%1'.").arg(QDir::toNativeSeparators(redirectPath));
+        }
+        return;
     }
+
+    // We report just the last part of the output, starting at a line boundary. That also
+    // goes for the input of the filter function, which would otherwise make us hold the
+    // complete output in memory several times over.
+    QByteArray content = buffer.tail();
+    qint64 omittedBytes = buffer.size() - content.size();
+    if (omittedBytes > 0) {
+        const int lineEnd = content.indexOf('\n') + 1;
+        content.remove(0, lineEnd);
+        omittedBytes += lineEnd;
+    }
+    QString contentString = filterProcessOutput(content, filterFunction);
+    if (!contentString.isEmpty() && contentString.endsWith(QLatin1Char('\n')))
+        contentString.chop(1);
+    *target = contentString.split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    if (omittedBytes > 0)
+        target->prepend(Tr::tr("[%1 bytes of output omitted]").arg(QString::number(omittedBytes)));
 }
 
 void ProcessCommandExecutor::sendProcessOutput()
 {
+    recordProcessEnd();
     ProcessResult result;
     result.d->executableFilePath = m_program;
     result.d->arguments = m_arguments;
@@ -293,9 +392,18 @@ void ProcessCommandExecutor::sendProcessOutput()
     result.d->exitCode = m_process.exitCode();
     result.d->error = m_process.error();
     QString errorString = m_process.errorString();
+    const ProcessResourceUsage resourceUsage = m_process.resourceUsage();
+    result.d->elapsedTime = resourceUsage.wallTime;
+    result.d->userCpuTime = resourceUsage.userTime;
+    result.d->systemCpuTime = resourceUsage.systemTime;
+    result.d->peakResidentSetSize = resourceUsage.peakResidentSetSize;
+    if (resourceUsage.userTime != -1) {
+        Metrics::add(MetricsCounter::CommandUserCpuTime, resourceUsage.userTime);
+        Metrics::add(MetricsCounter::CommandSystemCpuTime, resourceUsage.systemTime);
+    }
 
-    getProcessOutput(true, result);
-    getProcessOutput(false, result);
+    getProcessOutput(true, result, errorString);
+    getProcessOutput(false, result, errorString);
 
     const bool processError = result.error() != QProcess::UnknownError;
     const bool failureExit = quint32(m_process.exitCode())
@@ -323,6 +431,7 @@ void ProcessCommandExecutor::onProcessError()
     }
     switch (m_process.error()) {
     case QProcess::FailedToStart: {
+        recordProcessEnd();
         removeResponseFile();
         const QString binary = QDir::toNativeSeparators(processCommand()->program());
         QString errorPrefixString;
@@ -359,6 +468,15 @@ void ProcessCommandExecutor::onProcessFinished()
     sendProcessOutput();
 }
 
+void ProcessCommandExecutor::recordProcessEnd()
+{
+    if (!m_metricsTimer.isValid())
+        return;
+    Metrics::changeGauge(MetricsGauge::RunningCommands, -1);
+    Metrics::record(MetricsHistogram::CommandDuration, m_metricsTimer.nsecsElapsed() / 1000);
+    m_metricsTimer.invalidate();
+}
+
 static QString environmentVariableString(const QString &key, const QString &value)
 {
     QString str;
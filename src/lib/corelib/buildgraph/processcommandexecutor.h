@@ -42,8 +42,10 @@
 
 #include "abstractcommandexecutor.h"
 
+#include <tools/commandoutputbuffer.h>
 #include <tools/qbsprocess.h>
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qstring.h>
 
 namespace qbs {
@@ -61,12 +63,15 @@ public:
     void setProcessEnvironment(const QProcessEnvironment &processEnvironment) {
         m_buildEnvironment = processEnvironment;
     }
+    void setOutputBufferSize(qint64 size) { m_outputBufferSize = size; }
+    void setStreamOutput(bool stream) { m_streamOutput = stream; }
 
 signals:
     void reportProcessResult(const qbs::ProcessResult &result);
 
 private:
     void onProcessError();
+    void onProcessOutput(bool stdOut);
     void onProcessFinished();
 
     void doSetup();
@@ -76,9 +81,12 @@ private:
 
     void startProcessCommand();
     QString filterProcessOutput(const QByteArray &output, const QString &filterFunctionSource);
-    void getProcessOutput(bool stdOut, ProcessResult &result);
+    bool isStreamingOutput(bool stdOut) const;
+    void streamOutput(bool stdOut, bool flush);
+    void getProcessOutput(bool stdOut, ProcessResult &result, QString &errorString);
 
     void sendProcessOutput();
+    void recordProcessEnd();
     void removeResponseFile();
     ProcessCommand *processCommand() const;
 
@@ -91,6 +99,13 @@ private:
     QProcessEnvironment m_buildEnvironment;
     QProcessEnvironment m_commandEnvironment;
     QString m_responseFileName;
+    QElapsedTimer m_metricsTimer;
+    CommandOutputBuffer m_stdoutBuffer;
+    CommandOutputBuffer m_stderrBuffer;
+    QByteArray m_pendingStdoutLine;
+    QByteArray m_pendingStderrLine;
+    qint64 m_outputBufferSize = 0;
+    bool m_streamOutput = false;
 };
 
 } // namespace Internal
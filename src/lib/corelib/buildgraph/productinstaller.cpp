@@ -45,9 +45,11 @@
 #include <language/propertymapinternal.h>
 #include <logging/translator.h>
 #include <tools/qbsassert.h>
+#include <tools/buildoptions.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
+#include <tools/parallelfor.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
@@ -56,6 +58,9 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 
+#include <utility>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -105,10 +110,33 @@ void ProductInstaller::install()
     }
     m_observer->initialize(Tr::tr("Installing"), artifactsToInstall.size());
 
+    // Target paths are determined sequentially, as that involves the install options
+    // and the detection of conflicts. The actual file system operations are then
+    // distributed over several threads, in batches so that progress and cancellation
+    // are still handled regularly.
+    static const int batchSize = 256;
+    std::vector<std::pair<const Artifact *, QString>> batch;
+    batch.reserve(batchSize);
+    const auto installBatch = [this, &batch] {
+        parallelFor(batch.size(), m_options.maxJobCount() > 0
+                    ? m_options.maxJobCount() : BuildOptions::defaultMaxJobCount(),
+                    [this, &batch](std::size_t i) {
+            copyFileToTarget(batch.at(i).first, batch.at(i).second);
+        });
+        m_observer->incrementProgressValue(int(batch.size()));
+        batch.clear();
+    };
     for (const Artifact * const a : qAsConst(artifactsToInstall)) {
-        copyFile(a);
-        m_observer->incrementProgressValue();
+        const QString targetFilePath = prepareCopy(a);
+        if (targetFilePath.isEmpty()) {
+            m_observer->incrementProgressValue();
+            continue;
+        }
+        batch.emplace_back(a, targetFilePath);
+        if (batch.size() == batchSize)
+            installBatch();
     }
+    installBatch();
 }
 
 QString ProductInstaller::targetFilePath(const TopLevelProject *project,
@@ -181,6 +209,7 @@ void ProductInstaller::removeInstallRoot()
     m_logger.qbsDebug() << QString::fromLatin1("Removing install root '%1'.")
             .arg(nativeInstallRoot);
 
+    m_createdTargetDirs.clear();
     QString errorMessage;
     if (!removeDirectoryWithContents(m_options.installRoot(), &errorMessage)) {
         const QString fullErrorMessage = Tr::tr("Cannot remove install root '%1': %2")
@@ -190,6 +219,13 @@ void ProductInstaller::removeInstallRoot()
 }
 
 void ProductInstaller::copyFile(const Artifact *artifact)
+{
+    const QString targetFilePath = prepareCopy(artifact);
+    if (!targetFilePath.isEmpty())
+        copyFileToTarget(artifact, targetFilePath);
+}
+
+QString ProductInstaller::prepareCopy(const Artifact *artifact)
 {
     if (m_observer->canceled()) {
         throw ErrorInfo(Tr::tr("Installation canceled for configuration '%1'.")
@@ -205,21 +241,17 @@ void ProductInstaller::copyFile(const Artifact *artifact)
     if (m_options.dryRun()) {
         m_logger.qbsDebug() << Tr::tr("Would copy file '%1' into target directory '%2'.")
                                .arg(nativeFilePath, nativeTargetDir);
-        return;
+        return QString();
     }
     m_logger.qbsDebug() << QString::fromLatin1("Copying file '%1' into target directory '%2'.")
                            .arg(nativeFilePath, nativeTargetDir);
 
-    if (!QDir::root().mkpath(targetDir)) {
-        handleError(Tr::tr("Directory '%1' could not be created.").arg(nativeTargetDir));
-        return;
-    }
-    QFileInfo fi(artifact->filePath());
-    if (fi.isDir() && !(HostOsInfo::isAnyUnixHost() && fi.isSymLink())) {
-        m_logger.qbsWarning() << Tr::tr("Not recursively copying directory '%1' into target "
-                                        "directory '%2'. Install the individual file artifacts "
-                                        "instead.")
-                                 .arg(nativeFilePath, nativeTargetDir);
+    if (!m_createdTargetDirs.contains(targetDir)) {
+        if (!QDir::root().mkpath(targetDir)) {
+            handleError(Tr::tr("Directory '%1' could not be created.").arg(nativeTargetDir));
+            return QString();
+        }
+        m_createdTargetDirs.insert(targetDir);
     }
 
     if (m_targetFilePathsMap.contains(targetFilePath)) {
@@ -235,12 +267,40 @@ void ProductInstaller::copyFile(const Artifact *artifact)
                         .arg(artifact->filePath(), m_targetFilePathsMap[targetFilePath],
                              targetFilePath));
         }
+        return QString();
     }
     m_targetFilePathsMap.insert(targetFilePath, artifact->filePath());
+    return targetFilePath;
+}
+
+// Called concurrently for different target files by install().
+void ProductInstaller::copyFileToTarget(const Artifact *artifact, const QString &targetFilePath)
+{
+    // The timestamps of generated artifacts are up to date in the build graph, so for those
+    // we only need to look at the target to find out whether there is anything to do.
+    if (artifact->artifactType == Artifact::Generated && artifact->timestamp().isValid()) {
+        const FileInfo targetFileInfo(targetFilePath);
+        if (targetFileInfo.exists() && !targetFileInfo.isDir()
+                && artifact->timestamp() <= targetFileInfo.lastModified()) {
+            return;
+        }
+    }
+
+    QFileInfo fi(artifact->filePath());
+    if (fi.isDir() && !(HostOsInfo::isAnyUnixHost() && fi.isSymLink())) {
+        m_logger.qbsWarning() << Tr::tr("Not recursively copying directory '%1' into target "
+                                        "directory '%2'. Install the individual file artifacts "
+                                        "instead.")
+                                 .arg(QDir::toNativeSeparators(artifact->filePath()),
+                                      QDir::toNativeSeparators(FileInfo::path(targetFilePath)));
+    }
 
     QString errorMessage;
-    if (!copyFileRecursion(artifact->filePath(), targetFilePath, true, false, &errorMessage))
+    // The target directory was created in prepareCopy().
+    if (!copyFileRecursion(artifact->filePath(), targetFilePath, true, false, &errorMessage,
+                           m_options.installMode(), true)) {
         handleError(Tr::tr("Installation error: %1").arg(errorMessage));
+    }
 }
 
 void ProductInstaller::handleError(const QString &message)
@@ -44,6 +44,7 @@
 #include <language/forward_decls.h>
 #include <logging/logger.h>
 #include <tools/installoptions.h>
+#include <tools/set.h>
 
 #include <QtCore/qhash.h>
 #include <QtCore/qlist.h>
@@ -69,6 +70,8 @@ public:
     void copyFile(const Artifact *artifact);
 
 private:
+    QString prepareCopy(const Artifact *artifact);
+    void copyFileToTarget(const Artifact *artifact, const QString &targetFilePath);
     void handleError(const QString &message);
 
     const TopLevelProjectConstPtr m_project;
@@ -77,6 +80,7 @@ private:
     ProgressObserver * const m_observer;
     Logger m_logger;
     QHash<QString, QString> m_targetFilePathsMap;
+    Set<QString> m_createdTargetDirs;
 };
 
 } // namespace Internal
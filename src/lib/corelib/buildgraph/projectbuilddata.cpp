@@ -187,10 +187,12 @@ static void disconnectArtifact(Artifact *artifact)
   * Removes the artifact and all the artifacts that depend exclusively on it.
   * Example: if you remove a cpp artifact then the obj artifact is removed but
   * not the resulting application (if there's more then one cpp artifact).
+  * If removeFromDisk is false, the caller is responsible for removing the files of
+  * the generated artifacts in removedArtifacts, which is more efficient for many files.
   */
 void ProjectBuildData::removeArtifactAndExclusiveDependents(Artifact *artifact,
         const Logger &logger, bool removeFromProduct,
-        ArtifactSet *removedArtifacts)
+        ArtifactSet *removedArtifacts, bool removeFromDisk)
 {
     if (removedArtifacts)
         removedArtifacts->insert(artifact);
@@ -209,13 +211,14 @@ void ProjectBuildData::removeArtifactAndExclusiveDependents(Artifact *artifact,
         }
         if (removeParent) {
             removeArtifactAndExclusiveDependents(parent, logger, removeFromProduct,
-                                                 removedArtifacts);
+                                                 removedArtifacts, removeFromDisk);
         } else {
             parent->clearTimestamp();
         }
     }
-    const bool removeFromDisk = artifact->artifactType == Artifact::Generated;
-    removeArtifact(artifact, logger, removeFromDisk, removeFromProduct);
+    removeArtifact(artifact, logger,
+                   removeFromDisk && artifact->artifactType == Artifact::Generated,
+                   removeFromProduct);
 }
 
 static void removeFromRuleNodes(Artifact *artifact)
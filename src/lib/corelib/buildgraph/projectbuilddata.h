@@ -75,7 +75,8 @@ public:
     QList<FileResourceBase *> lookupFiles(const Artifact *artifact) const;
     void insertFileDependency(FileDependency *dependency);
     void removeArtifactAndExclusiveDependents(Artifact *artifact, const Logger &logger,
-            bool removeFromProduct = true, ArtifactSet *removedArtifacts = 0);
+            bool removeFromProduct = true, ArtifactSet *removedArtifacts = 0,
+            bool removeFromDisk = true);
     void removeArtifact(Artifact *artifact, const Logger &logger, bool removeFromDisk = true,
                         bool removeFromProduct = true);
 
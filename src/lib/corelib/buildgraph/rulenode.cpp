@@ -56,7 +56,7 @@
 namespace qbs {
 namespace Internal {
 
-RuleNode::RuleNode()
+RuleNode::RuleNode() : BuildGraphNode(RuleNodeType)
 {
 }
 
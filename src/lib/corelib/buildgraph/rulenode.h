@@ -63,7 +63,6 @@ public:
     void setRule(const RuleConstPtr &rule) { m_rule = rule; }
     const RuleConstPtr &rule() const { return m_rule; }
 
-    Type type() const { return RuleNodeType; }
     void accept(BuildGraphVisitor *visitor);
     QString toString() const;
 
@@ -60,6 +60,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/scripttools.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
@@ -98,6 +99,8 @@ void RulesApplicator::applyRule(const RuleConstPtr &rule, const ArtifactSet &inp
     if (inputArtifacts.empty() && rule->declaresInputs() && rule->requiresInputs)
         return;
 
+    Metrics::add(MetricsCounter::RuleApplications);
+    const MetricsTimer applicationTimer(MetricsHistogram::RuleApplicationDuration);
     m_product->topLevelProject()->buildData->setDirty();
     m_createdArtifacts.clear();
     m_invalidatedArtifacts.clear();
@@ -138,8 +141,9 @@ void RulesApplicator::handleRemovedRuleOutputs(const ArtifactSet &inputArtifacts
         if (!project)
             project = removedArtifact->product->topLevelProject();
         project->buildData->removeArtifactAndExclusiveDependents(removedArtifact, logger, true,
-                                                                 &artifactsToRemove);
+                                                                 &artifactsToRemove, false);
     }
+    removeGeneratedArtifactsFromDisk(artifactsToRemove, logger);
     EmptyDirectoriesRemover(project, logger).removeEmptyParentDirectories(artifactsToRemove);
     for (Artifact * const artifact : qAsConst(artifactsToRemove)) {
         QBS_CHECK(!inputArtifacts.contains(artifact));
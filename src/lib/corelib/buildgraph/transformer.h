@@ -90,6 +90,7 @@ public:
     bool prepareScriptNeedsChangeTracking = false;
     bool commandsNeedChangeTracking = false;
     bool markedForRerun = false;
+    Set<QString> outputsKeptUnchanged; // Do not serialize. Set by the last command of a run.
 
     static QScriptValue translateFileConfig(ScriptEngine *scriptEngine,
                                             const Artifact *artifact,
@@ -41,8 +41,12 @@
 
 #include <language/scriptengine.h>
 #include <logging/translator.h>
+#include <tools/digest.h>
+#include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
 
+#include <QtCore/qbuffer.h>
+#include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qobject.h>
@@ -52,9 +56,43 @@
 #include <QtScript/qscriptengine.h>
 #include <QtScript/qscriptvalue.h>
 
+#include <algorithm>
+#include <climits>
+
 namespace qbs {
 namespace Internal {
 
+// Wraps a QByteArray, so that rules can process binary data without converting every
+// single byte from and to a script value.
+class ByteBuffer : public QObject, public QScriptable
+{
+    Q_OBJECT
+    Q_PROPERTY(int length READ length)
+public:
+    static QScriptValue ctor(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue create(QScriptEngine *engine, const QByteArray &data);
+
+    // Accepts ByteBuffer objects, arrays of numbers and strings (as Latin-1).
+    static bool toByteArray(const QScriptValue &value, QByteArray *data);
+
+    int length() const { return m_data.size(); }
+
+    Q_INVOKABLE int at(int index) const;
+    Q_INVOKABLE void setAt(int index, int value);
+    Q_INVOKABLE QScriptValue slice(int begin, int end = INT_MAX) const;
+    Q_INVOKABLE int indexOf(const QScriptValue &value, int from = 0) const;
+    Q_INVOKABLE int lastIndexOf(const QScriptValue &value, int from = -1) const;
+    Q_INVOKABLE QString hash(const QString &algorithm) const;
+    Q_INVOKABLE QVariantList toArray() const;
+
+private:
+    explicit ByteBuffer(const QByteArray &data) : m_data(data) {}
+
+    bool checkIndex(int index) const;
+
+    QByteArray m_data;
+};
+
 class BinaryFile : public QObject, public QScriptable, public ResourceAcquiringScriptObject
 {
     Q_OBJECT
@@ -63,7 +101,8 @@ public:
     enum OpenMode {
         ReadOnly = 1,
         WriteOnly = 2,
-        ReadWrite = ReadOnly | WriteOnly
+        ReadWrite = ReadOnly | WriteOnly,
+        SkipUnchanged = 8
     };
 
     static QScriptValue ctor(QScriptContext *context, QScriptEngine *engine);
@@ -77,17 +116,22 @@ public:
     Q_INVOKABLE qint64 pos() const;
     Q_INVOKABLE void seek(qint64 pos);
     Q_INVOKABLE QVariantList read(qint64 size);
-    Q_INVOKABLE void write(const QVariantList &data);
+    Q_INVOKABLE QScriptValue readAll();
+    Q_INVOKABLE void write(const QScriptValue &data);
 
 private:
     explicit BinaryFile(QScriptContext *context, const QString &filePath, OpenMode mode = ReadOnly);
 
     bool checkForClosed() const;
+    QIODevice *device() const;
+    void writeBufferIfChanged();
 
     // ResourceAcquiringScriptObject implementation
     void releaseResources() override;
 
+    ScriptEngine * const m_engine;
     QFile *m_file = nullptr;
+    QBuffer *m_buffer = nullptr; // Collects the data in SkipUnchanged mode.
 };
 
 QScriptValue BinaryFile::ctor(QScriptContext *context, QScriptEngine *engine)
@@ -121,15 +165,17 @@ QScriptValue BinaryFile::ctor(QScriptContext *context, QScriptEngine *engine)
 
 BinaryFile::~BinaryFile()
 {
+    delete m_buffer;
     delete m_file;
 }
 
 BinaryFile::BinaryFile(QScriptContext *context, const QString &filePath, OpenMode mode)
+    : m_engine(static_cast<ScriptEngine *>(context->engine()))
 {
     Q_ASSERT(thisObject().engine() == engine());
 
     QIODevice::OpenMode m = QIODevice::NotOpen;
-    switch (mode) {
+    switch (mode & ~SkipUnchanged) {
     case ReadWrite:
         m = QIODevice::ReadWrite;
         break;
@@ -146,6 +192,24 @@ BinaryFile::BinaryFile(QScriptContext *context, const QString &filePath, OpenMod
     }
 
     m_file = new QFile(filePath);
+    if (mode & SkipUnchanged) {
+        if (Q_UNLIKELY(!(m & QIODevice::WriteOnly))) {
+            context->throwError(Tr::tr("Unable to open file '%1': SkipUnchanged requires "
+                                       "write access.").arg(filePath));
+            delete m_file;
+            m_file = nullptr;
+            return;
+        }
+
+        // Write into memory and only touch the file on close, if the contents differ.
+        m_buffer = new QBuffer;
+        if ((m & QIODevice::ReadOnly) && m_file->open(QIODevice::ReadOnly)) {
+            m_buffer->setData(m_file->readAll());
+            m_file->close();
+        }
+        m_buffer->open(m);
+        return;
+    }
     if (Q_UNLIKELY(!m_file->open(m))) {
         context->throwError(Tr::tr("Unable to open file '%1': %2")
                             .arg(filePath, m_file->errorString()));
@@ -158,6 +222,11 @@ void BinaryFile::close()
 {
     if (checkForClosed())
         return;
+    if (m_buffer) {
+        writeBufferIfChanged();
+        delete m_buffer;
+        m_buffer = nullptr;
+    }
     m_file->close();
     delete m_file;
     m_file = nullptr;
@@ -174,20 +243,35 @@ bool BinaryFile::atEof() const
 {
     if (checkForClosed())
         return true;
-    return m_file->atEnd();
+    return device()->atEnd();
 }
 
 qint64 BinaryFile::size() const
 {
     if (checkForClosed())
         return -1;
-    return m_file->size();
+    return device()->size();
 }
 
 void BinaryFile::resize(qint64 size)
 {
     if (checkForClosed())
         return;
+    if (m_buffer) {
+        if (Q_UNLIKELY(size < 0 || size > INT_MAX)) {
+            context()->throwError(Tr::tr("Could not resize '%1': Invalid size %2.")
+                                  .arg(m_file->fileName()).arg(size));
+            return;
+        }
+        QByteArray &data = m_buffer->buffer();
+        const int oldSize = data.size();
+        data.resize(int(size));
+        if (data.size() > oldSize) // Like QFile::resize().
+            std::fill(data.begin() + oldSize, data.end(), '\0');
+        if (m_buffer->pos() > size)
+            m_buffer->seek(size);
+        return;
+    }
     if (Q_UNLIKELY(!m_file->resize(size))) {
         context()->throwError(Tr::tr("Could not resize '%1': %2")
                               .arg(m_file->fileName(), m_file->errorString()));
@@ -198,16 +282,16 @@ qint64 BinaryFile::pos() const
 {
     if (checkForClosed())
         return -1;
-    return m_file->pos();
+    return device()->pos();
 }
 
 void BinaryFile::seek(qint64 pos)
 {
     if (checkForClosed())
         return;
-    if (Q_UNLIKELY(!m_file->seek(pos))) {
+    if (Q_UNLIKELY(!device()->seek(pos))) {
         context()->throwError(Tr::tr("Could not seek '%1': %2")
-                              .arg(m_file->fileName(), m_file->errorString()));
+                              .arg(m_file->fileName(), device()->errorString()));
     }
 }
 
@@ -215,7 +299,7 @@ QVariantList BinaryFile::read(qint64 size)
 {
     if (checkForClosed())
         return QVariantList();
-    const QByteArray bytes = m_file->read(size);
+    const QByteArray bytes = device()->read(size);
     if (Q_UNLIKELY(bytes.size() == 0 && m_file->error() != QFile::NoError)) {
         context()->throwError(Tr::tr("Could not read from '%1': %2")
                               .arg(m_file->fileName(), m_file->errorString()));
@@ -227,19 +311,35 @@ QVariantList BinaryFile::read(qint64 size)
     return data;
 }
 
-void BinaryFile::write(const QVariantList &data)
+QScriptValue BinaryFile::readAll()
+{
+    if (checkForClosed())
+        return QScriptValue();
+    const QByteArray bytes = device()->readAll();
+    if (Q_UNLIKELY(bytes.size() == 0 && m_file->error() != QFile::NoError)) {
+        context()->throwError(Tr::tr("Could not read from '%1': %2")
+                              .arg(m_file->fileName(), m_file->errorString()));
+    }
+    return ByteBuffer::create(engine(), bytes);
+}
+
+void BinaryFile::write(const QScriptValue &data)
 {
     if (checkForClosed())
         return;
 
     QByteArray bytes;
-    std::for_each(data.constBegin(), data.constEnd(), [&bytes](const QVariant &v) {
-        bytes.append(v.toUInt() & 0xFF); });
+    if (Q_UNLIKELY(!ByteBuffer::toByteArray(data, &bytes))) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("BinaryFile.write() expects a ByteBuffer, an array "
+                                     "or a string."));
+        return;
+    }
 
-    const qint64 size = m_file->write(bytes);
+    const qint64 size = device()->write(bytes);
     if (Q_UNLIKELY(size == -1)) {
         context()->throwError(Tr::tr("Could not write to '%1': %2")
-                              .arg(m_file->fileName(), m_file->errorString()));
+                              .arg(m_file->fileName(), device()->errorString()));
     }
 }
 
@@ -252,12 +352,165 @@ bool BinaryFile::checkForClosed() const
     return true;
 }
 
+QIODevice *BinaryFile::device() const
+{
+    if (m_buffer)
+        return m_buffer;
+    return m_file;
+}
+
+void BinaryFile::writeBufferIfChanged()
+{
+    const QString filePath = QDir::cleanPath(QFileInfo(*m_file).absoluteFilePath());
+    bool changed;
+    QString errorMessage;
+    if (writeFileIfChanged(filePath, m_buffer->data(), &changed, &errorMessage)) {
+        m_engine->setFileKeptUnchanged(filePath, !changed);
+        return;
+    }
+    if (QScriptContext * const ctx = context())
+        ctx->throwError(errorMessage);
+    else
+        m_engine->logger().printWarning(ErrorInfo(errorMessage));
+}
+
 void BinaryFile::releaseResources()
 {
     close();
     deleteLater();
 }
 
+QScriptValue ByteBuffer::ctor(QScriptContext *context, QScriptEngine *engine)
+{
+    QByteArray data;
+    switch (context->argumentCount()) {
+    case 0:
+        break;
+    case 1: {
+        const QScriptValue arg = context->argument(0);
+        if (arg.isNumber()) {
+            const qint32 size = arg.toInt32();
+            if (size < 0) {
+                return context->throwError(QScriptContext::RangeError,
+                                           Tr::tr("Invalid ByteBuffer size %1.").arg(size));
+            }
+            data.fill(0, size);
+        } else if (!toByteArray(arg, &data)) {
+            return context->throwError(QScriptContext::TypeError,
+                                       Tr::tr("ByteBuffer constructor expects a size, "
+                                              "a ByteBuffer, an array or a string."));
+        }
+        break;
+    }
+    default:
+        return context->throwError(Tr::tr("ByteBuffer constructor takes at most one parameter."));
+    }
+    return create(engine, data);
+}
+
+QScriptValue ByteBuffer::create(QScriptEngine *engine, const QByteArray &data)
+{
+    return engine->newQObject(new ByteBuffer(data), QScriptEngine::ScriptOwnership);
+}
+
+bool ByteBuffer::toByteArray(const QScriptValue &value, QByteArray *data)
+{
+    if (const ByteBuffer * const buffer = qobject_cast<ByteBuffer *>(value.toQObject())) {
+        *data = buffer->m_data;
+        return true;
+    }
+    if (value.isString()) {
+        *data = value.toString().toLatin1();
+        return true;
+    }
+    if (value.isArray()) {
+        const QVariantList list = value.toVariant().toList();
+        data->clear();
+        data->reserve(list.size());
+        std::for_each(list.constBegin(), list.constEnd(), [data](const QVariant &v) {
+            data->append(v.toUInt() & 0xFF); });
+        return true;
+    }
+    return false;
+}
+
+int ByteBuffer::at(int index) const
+{
+    if (!checkIndex(index))
+        return 0;
+    return static_cast<unsigned char>(m_data.at(index));
+}
+
+void ByteBuffer::setAt(int index, int value)
+{
+    if (checkIndex(index))
+        m_data[index] = static_cast<char>(value & 0xFF);
+}
+
+// Negative indexes count from the end, as for Array.prototype.slice().
+QScriptValue ByteBuffer::slice(int begin, int end) const
+{
+    const auto normalized = [this](int index) {
+        return index < 0 ? std::max(0, m_data.size() + index) : std::min(index, m_data.size());
+    };
+    const int from = normalized(begin);
+    const int to = normalized(end);
+    return create(engine(), to > from ? m_data.mid(from, to - from) : QByteArray());
+}
+
+int ByteBuffer::indexOf(const QScriptValue &value, int from) const
+{
+    QByteArray needle;
+    if (!toByteArray(value, &needle)) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("ByteBuffer.indexOf() expects a ByteBuffer, "
+                                     "an array or a string."));
+        return -1;
+    }
+    return m_data.indexOf(needle, from);
+}
+
+int ByteBuffer::lastIndexOf(const QScriptValue &value, int from) const
+{
+    QByteArray needle;
+    if (!toByteArray(value, &needle)) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("ByteBuffer.lastIndexOf() expects a ByteBuffer, "
+                                     "an array or a string."));
+        return -1;
+    }
+    return m_data.lastIndexOf(needle, from);
+}
+
+QString ByteBuffer::hash(const QString &algorithm) const
+{
+    if (!Digest::isSupportedAlgorithm(algorithm)) {
+        context()->throwError(Tr::tr("Unknown hash algorithm '%1'.").arg(algorithm));
+        return QString();
+    }
+    return QString::fromLatin1(Digest::dataDigest(m_data, algorithm));
+}
+
+QVariantList ByteBuffer::toArray() const
+{
+    QVariantList data;
+    data.reserve(m_data.size());
+    std::for_each(m_data.constBegin(), m_data.constEnd(), [&data](const char &c) {
+        data.append(static_cast<unsigned char>(c)); });
+    return data;
+}
+
+bool ByteBuffer::checkIndex(int index) const
+{
+    if (index >= 0 && index < m_data.size())
+        return true;
+    if (QScriptContext *ctx = context()) {
+        ctx->throwError(QScriptContext::RangeError,
+                        Tr::tr("ByteBuffer index %1 is out of range.").arg(index));
+    }
+    return false;
+}
+
 } // namespace Internal
 } // namespace qbs
 
@@ -265,11 +518,15 @@ void initializeJsExtensionBinaryFile(QScriptValue extensionObject)
 {
     using namespace qbs::Internal;
     QScriptEngine *engine = extensionObject.engine();
-    const QScriptValue obj = engine->newQMetaObject(&BinaryFile::staticMetaObject,
-                                                    engine->newFunction(&BinaryFile::ctor));
+    QScriptValue obj = engine->newQMetaObject(&BinaryFile::staticMetaObject,
+                                              engine->newFunction(&BinaryFile::ctor));
+    obj.setProperty(QLatin1String("ByteBuffer"),
+                    engine->newQMetaObject(&ByteBuffer::staticMetaObject,
+                                           engine->newFunction(&ByteBuffer::ctor)));
     extensionObject.setProperty(QLatin1String("BinaryFile"), obj);
 }
 
 Q_DECLARE_METATYPE(qbs::Internal::BinaryFile *)
+Q_DECLARE_METATYPE(qbs::Internal::ByteBuffer *)
 
 #include "binaryfile.moc"
@@ -39,11 +39,15 @@
 
 #include <language/scriptengine.h>
 #include <logging/translator.h>
+#include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
 
+#include <QtCore/qbuffer.h>
+#include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qregularexpression.h>
 #include <QtCore/qtextstream.h>
 #include <QtCore/qvariant.h>
 
@@ -64,7 +68,8 @@ public:
         ReadOnly = 1,
         WriteOnly = 2,
         ReadWrite = ReadOnly | WriteOnly,
-        Append = 4
+        Append = 4,
+        SkipUnchanged = 8
     };
 
     static QScriptValue ctor(QScriptContext *context, QScriptEngine *engine);
@@ -75,22 +80,30 @@ public:
     Q_INVOKABLE void setCodec(const QString &codec);
     Q_INVOKABLE QString readLine();
     Q_INVOKABLE QString readAll();
+    Q_INVOKABLE QStringList readLines();
     Q_INVOKABLE bool atEof() const;
     Q_INVOKABLE void truncate();
     Q_INVOKABLE void write(const QString &str);
     Q_INVOKABLE void writeLine(const QString &str);
+    Q_INVOKABLE void writeLines(const QStringList &lines);
+    Q_INVOKABLE void writeReplaced(const QString &str, const QString &pattern,
+                                   const QScriptValue &replacement);
 
 private:
     TextFile(QScriptContext *context, const QString &filePath, OpenMode mode = ReadOnly,
              const QString &codec = QLatin1String("UTF8"));
 
     bool checkForClosed() const;
+    static QString lineEnding();
+    void writeBufferIfChanged();
 
     // ResourceAcquiringScriptObject implementation
     void releaseResources() override;
 
+    ScriptEngine * const m_engine;
     QFile *m_file;
-    QTextStream *m_stream;
+    QBuffer *m_buffer = nullptr; // Collects the data in SkipUnchanged mode.
+    QTextStream *m_stream = nullptr;
 };
 
 QScriptValue TextFile::ctor(QScriptContext *context, QScriptEngine *engine)
@@ -132,17 +145,18 @@ QScriptValue TextFile::ctor(QScriptContext *context, QScriptEngine *engine)
 TextFile::~TextFile()
 {
     delete m_stream;
+    delete m_buffer;
     delete m_file;
 }
 
 TextFile::TextFile(QScriptContext *context, const QString &filePath, OpenMode mode,
                    const QString &codec)
+    : m_engine(static_cast<ScriptEngine *>(context->engine()))
 {
     Q_UNUSED(codec)
     Q_ASSERT(thisObject().engine() == engine());
 
     m_file = new QFile(filePath);
-    m_stream = new QTextStream(m_file);
     QIODevice::OpenMode m = QIODevice::NotOpen;
     if (mode & ReadOnly)
         m |= QIODevice::ReadOnly;
@@ -150,6 +164,26 @@ TextFile::TextFile(QScriptContext *context, const QString &filePath, OpenMode mo
         m |= QIODevice::WriteOnly;
     if (mode & Append)
         m |= QIODevice::Append;
+    if (mode & SkipUnchanged) {
+        if (Q_UNLIKELY(!(m & (QIODevice::WriteOnly | QIODevice::Append)))) {
+            context->throwError(Tr::tr("Unable to open file '%1': SkipUnchanged requires "
+                                       "write access.").arg(filePath));
+            delete m_file;
+            m_file = nullptr;
+            return;
+        }
+
+        // Write into memory and only touch the file on close, if the contents differ.
+        m_buffer = new QBuffer;
+        if ((m & (QIODevice::ReadOnly | QIODevice::Append)) && m_file->open(QIODevice::ReadOnly)) {
+            m_buffer->setData(m_file->readAll());
+            m_file->close();
+        }
+        m_buffer->open(m);
+        m_stream = new QTextStream(m_buffer);
+        return;
+    }
+    m_stream = new QTextStream(m_file);
     if (Q_UNLIKELY(!m_file->open(m))) {
         context->throwError(Tr::tr("Unable to open file '%1': %2")
                             .arg(filePath, m_file->errorString()));
@@ -162,6 +196,12 @@ void TextFile::close()
 {
     if (checkForClosed())
         return;
+    if (m_buffer) {
+        m_stream->flush();
+        writeBufferIfChanged();
+        delete m_buffer;
+        m_buffer = nullptr;
+    }
     delete m_stream;
     m_stream = nullptr;
     m_file->close();
@@ -197,6 +237,17 @@ QString TextFile::readAll()
     return m_stream->readAll();
 }
 
+QStringList TextFile::readLines()
+{
+    if (checkForClosed())
+        return QStringList();
+    QStringList lines;
+    QString line;
+    while (m_stream->readLineInto(&line))
+        lines << line;
+    return lines;
+}
+
 bool TextFile::atEof() const
 {
     if (checkForClosed())
@@ -208,7 +259,13 @@ void TextFile::truncate()
 {
     if (checkForClosed())
         return;
-    m_file->resize(0);
+    if (m_buffer) {
+        m_stream->flush();
+        m_buffer->buffer().clear();
+        m_buffer->seek(0);
+    } else {
+        m_file->resize(0);
+    }
     m_stream->reset();
 }
 
@@ -223,10 +280,54 @@ void TextFile::writeLine(const QString &str)
 {
     if (checkForClosed())
         return;
-    (*m_stream) << str;
-    if (HostOsInfo::isWindowsHost())
-        (*m_stream) << '\r';
-    (*m_stream) << '\n';
+    (*m_stream) << str << lineEnding();
+}
+
+void TextFile::writeLines(const QStringList &lines)
+{
+    if (checkForClosed())
+        return;
+    const QString eol = lineEnding();
+    for (const QString &line : lines)
+        (*m_stream) << line << eol;
+}
+
+// The replacement is either a string, which may contain back references in the form of
+// \1, \2 and so on, or an object mapping keys to values, in which case the text captured by the
+// first group (or the whole match, if there is no group) is looked up as a key.
+// Matches whose key is not an own property of the object are written unchanged, so that
+// e.g. "toString" does not pick up a function from the prototype chain.
+void TextFile::writeReplaced(const QString &str, const QString &pattern,
+                             const QScriptValue &replacement)
+{
+    if (checkForClosed())
+        return;
+    const QRegularExpression regexp(pattern);
+    if (Q_UNLIKELY(!regexp.isValid())) {
+        context()->throwError(Tr::tr("Invalid regular expression '%1': %2")
+                              .arg(pattern, regexp.errorString()));
+        return;
+    }
+    if (!replacement.isObject()) {
+        QString result = str;
+        (*m_stream) << result.replace(regexp, replacement.toString());
+        return;
+    }
+    const int keyGroup = regexp.captureCount() > 0 ? 1 : 0;
+    int lastEnd = 0;
+    QRegularExpressionMatchIterator it = regexp.globalMatch(str);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        (*m_stream) << str.midRef(lastEnd, match.capturedStart() - lastEnd);
+        const QScriptValue value = replacement.property(match.captured(keyGroup),
+                                                        QScriptValue::ResolveLocal);
+        if (value.isValid() && !value.isUndefined())
+            (*m_stream) << value.toString();
+        else
+            (*m_stream) << match.capturedRef();
+        lastEnd = match.capturedEnd();
+    }
+    (*m_stream) << str.midRef(lastEnd);
 }
 
 bool TextFile::checkForClosed() const
@@ -239,6 +340,26 @@ bool TextFile::checkForClosed() const
     return true;
 }
 
+void TextFile::writeBufferIfChanged()
+{
+    const QString filePath = QDir::cleanPath(QFileInfo(*m_file).absoluteFilePath());
+    bool changed;
+    QString errorMessage;
+    if (writeFileIfChanged(filePath, m_buffer->data(), &changed, &errorMessage)) {
+        m_engine->setFileKeptUnchanged(filePath, !changed);
+        return;
+    }
+    if (QScriptContext * const ctx = context())
+        ctx->throwError(errorMessage);
+    else
+        m_engine->logger().printWarning(ErrorInfo(errorMessage));
+}
+
+QString TextFile::lineEnding()
+{
+    return HostOsInfo::isWindowsHost() ? QStringLiteral("\r\n") : QStringLiteral("\n");
+}
+
 void TextFile::releaseResources()
 {
     close();
@@ -42,7 +42,9 @@
 #include <language/scriptengine.h>
 #include <logging/translator.h>
 #include <tools/architectures.h>
+#include <tools/digest.h>
 #include <tools/hostosinfo.h>
+#include <tools/parallelfor.h>
 #include <tools/stringconstants.h>
 #include <tools/toolchains.h>
 #include <tools/version.h>
@@ -58,10 +60,13 @@
 
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qthread.h>
 
 #include <QtScript/qscriptable.h>
 #include <QtScript/qscriptengine.h>
 
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -76,6 +81,8 @@ public:
                                                        QScriptEngine *engine);
     static QScriptValue js_canonicalToolchain(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_cStringQuote(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_fileDigest(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_fileDigests(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_getHash(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_getNativeSetting(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_kernelVersion(QScriptContext *context, QScriptEngine *engine);
@@ -305,6 +312,65 @@ QScriptValue UtilitiesExtension::js_cStringQuote(QScriptContext *context, QScrip
     return engine->toScriptValue(escapedString(reinterpret_cast<const ushort *>(value.constData()), value.size()));
 }
 
+static bool getDigestAlgorithm(QScriptContext *context, const QString &functionName,
+                               QString *algorithm)
+{
+    *algorithm = context->argumentCount() > 1 ? context->argument(1).toString()
+                                              : QStringLiteral("xxhash64");
+    if (Digest::isSupportedAlgorithm(*algorithm))
+        return true;
+    context->throwError(QScriptContext::TypeError,
+                        QStringLiteral("%1: Unknown algorithm '%2'. Possible values are '%3'.")
+                        .arg(functionName, *algorithm,
+                             Digest::supportedAlgorithms().join(QStringLiteral("', '"))));
+    return false;
+}
+
+QScriptValue UtilitiesExtension::js_fileDigest(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 1 || context->argumentCount() > 2)) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   QStringLiteral("fileDigest expects 1 or 2 arguments"));
+    }
+    QString algorithm;
+    if (!getDigestAlgorithm(context, QStringLiteral("fileDigest"), &algorithm))
+        return QScriptValue();
+    QString errorMessage;
+    const QByteArray digest = Digest::fileDigest(context->argument(0).toString(), algorithm,
+                                                 &errorMessage);
+    if (digest.isNull())
+        return context->throwError(errorMessage);
+    return engine->toScriptValue(QString::fromLatin1(digest));
+}
+
+// Files are independent of each other, so we digest them in parallel.
+QScriptValue UtilitiesExtension::js_fileDigests(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 1 || context->argumentCount() > 2
+                   || !context->argument(0).isArray())) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   QStringLiteral("fileDigests expects an array of file paths "
+                                                  "and an optional algorithm"));
+    }
+    QString algorithm;
+    if (!getDigestAlgorithm(context, QStringLiteral("fileDigests"), &algorithm))
+        return QScriptValue();
+    const QStringList filePaths = context->argument(0).toVariant().toStringList();
+    std::vector<QByteArray> digests(filePaths.size());
+    std::vector<QString> errorMessages(filePaths.size());
+    parallelFor(filePaths.size(), QThread::idealThreadCount(), [&](std::size_t i) {
+        digests[i] = Digest::fileDigest(filePaths.at(int(i)), algorithm, &errorMessages[i]);
+    });
+    QStringList result;
+    result.reserve(filePaths.size());
+    for (std::size_t i = 0; i < digests.size(); ++i) {
+        if (digests[i].isNull())
+            return context->throwError(errorMessages[i]);
+        result << QString::fromLatin1(digests[i]);
+    }
+    return engine->toScriptValue(result);
+}
+
 QScriptValue UtilitiesExtension::js_getHash(QScriptContext *context, QScriptEngine *engine)
 {
     if (Q_UNLIKELY(context->argumentCount() < 1)) {
@@ -524,6 +590,10 @@ void initializeJsExtensionUtilities(QScriptValue extensionObject)
                                engine->newFunction(UtilitiesExtension::js_canonicalToolchain));
     environmentObj.setProperty(QStringLiteral("cStringQuote"),
                                engine->newFunction(UtilitiesExtension::js_cStringQuote, 1));
+    environmentObj.setProperty(QStringLiteral("fileDigest"),
+                               engine->newFunction(UtilitiesExtension::js_fileDigest, 2));
+    environmentObj.setProperty(QStringLiteral("fileDigests"),
+                               engine->newFunction(UtilitiesExtension::js_fileDigests, 2));
     environmentObj.setProperty(QStringLiteral("getHash"),
                                engine->newFunction(UtilitiesExtension::js_getHash, 1));
     environmentObj.setProperty(QStringLiteral("getNativeSetting"),
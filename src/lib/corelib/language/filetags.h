@@ -78,7 +78,7 @@ public:
 template<> inline bool Set<FileTag>::sortAfterLoadRequired() const { return true; }
 QDebug operator<<(QDebug debug, const FileTag &tag);
 
-class FileTags : public Set<FileTag>
+class QBS_AUTOTEST_EXPORT FileTags : public Set<FileTag>
 {
 public:
     FileTags() : Set<FileTag>() {}
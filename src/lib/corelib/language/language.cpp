@@ -72,6 +72,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace qbs {
 namespace Internal {
@@ -572,18 +573,29 @@ std::vector<ResolvedProductPtr> ResolvedProject::allProducts() const
 void ResolvedProject::load(PersistentPool &pool)
 {
     serializationOp<PersistentPool::Load>(pool);
-    std::for_each(products.cbegin(), products.cend(),
-                  [](const ResolvedProductPtr &p) {
+
+    // Parent links are not stored. Collect them all first and then assign them in one go,
+    // as inserting them one by one into the sorted parent sets is quadratic for nodes
+    // with many parents.
+    std::vector<std::pair<BuildGraphNode *, BuildGraphNode *>> childParentPairs;
+    for (const ResolvedProductPtr &p : products) {
         if (!p->buildData)
-            return;
+            continue;
         for (BuildGraphNode * const node : qAsConst(p->buildData->allNodes())) {
             node->product = p;
-
-            // restore parent links
             for (BuildGraphNode * const child : qAsConst(node->children))
-                child->parents.insert(node);
+                childParentPairs.emplace_back(child, node);
         }
-    });
+    }
+    std::sort(childParentPairs.begin(), childParentPairs.end());
+    std::vector<BuildGraphNode *> parents;
+    for (auto it = childParentPairs.cbegin(); it != childParentPairs.cend();) {
+        BuildGraphNode * const child = it->first;
+        parents.clear();
+        for (; it != childParentPairs.cend() && it->first == child; ++it)
+            parents.push_back(it->second);
+        child->parents.unite(NodeSet::fromSortedStdVector(parents));
+    }
 }
 
 void ResolvedProject::store(PersistentPool &pool)
@@ -599,6 +611,7 @@ TopLevelProject::TopLevelProject()
 
 TopLevelProject::~TopLevelProject()
 {
+    waitForPendingStore();
     delete bgLocker;
 }
 
@@ -653,6 +666,30 @@ void TopLevelProject::store(Logger logger)
     buildData->setClean();
 }
 
+void TopLevelProject::waitForPendingStore()
+{
+    if (!pendingStore.valid())
+        return;
+    storeError = pendingStore.get();
+}
+
+// For a project that was resolved from scratch in place of previousProject: All products count
+// as changed, and the ones that no longer exist count as removed.
+void TopLevelProject::continueGenerationsFrom(const TopLevelProject &previousProject)
+{
+    generation = previousProject.generation + 1;
+    removedProducts = previousProject.removedProducts;
+    Set<QString> productNames;
+    for (const ResolvedProductPtr &product : allProducts()) {
+        product->generation = generation;
+        productNames.insert(product->uniqueName());
+    }
+    for (const ResolvedProductPtr &product : previousProject.allProducts()) {
+        if (!productNames.contains(product->uniqueName()))
+            removedProducts.emplace_back(generation, product->fullDisplayName());
+    }
+}
+
 void TopLevelProject::load(PersistentPool &pool)
 {
     ResolvedProject::load(pool);
@@ -48,6 +48,8 @@
 
 #include <buildgraph/forward_decls.h>
 #include <tools/codelocation.h>
+#include <tools/error.h>
+#include <tools/filesystemjournal.h>
 #include <tools/filetime.h>
 #include <tools/persistence.h>
 #include <tools/set.h>
@@ -63,6 +65,7 @@
 
 #include <QtScript/qscriptvalue.h>
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -588,6 +591,7 @@ public:
 
     QProcessEnvironment buildEnvironment; // must not be saved
     QProcessEnvironment runEnvironment; // must not be saved
+    quint64 generation = 0; // must not be saved. See TopLevelProject::generation.
 
     void accept(BuildGraphVisitor *visitor) const;
     std::vector<SourceArtifactPtr> allFiles() const;
@@ -704,6 +708,8 @@ public:
     Set<QString> buildSystemFiles;
     FileTime lastResolveTime;
     QList<ErrorInfo> warningsEncountered;
+    FileSystemJournal::State fileSystemJournalState; // Position up to which the journal was read.
+    std::shared_ptr<const FileSystemJournal> fileSystemJournal; // Not saved
 
     void setBuildConfiguration(const QVariantMap &config);
     const QVariantMap &buildConfiguration() const { return m_buildConfiguration; }
@@ -715,6 +721,21 @@ public:
     QString buildGraphFilePath() const;
     void store(Logger logger);
 
+    // A build graph serialization running in a different thread. No one must access the project
+    // while it is in progress. Its error, if any, ends up in storeError, from where the next
+    // build, clean or install job picks it up.
+    std::future<ErrorInfo> pendingStore; // Not saved
+    ErrorInfo storeError; // Not saved
+    void waitForPendingStore();
+
+    // Incremented whenever a product's API-visible data changes, so clients can ask for the
+    // products that changed since they last looked. Products record the generation of their
+    // last change. Not saved, i.e. counting starts anew with every session.
+    quint64 generation = 0;
+    std::vector<std::pair<quint64, QString>> removedProducts; // Full display names. Not saved
+    void markProductChanged(ResolvedProduct *product) { product->generation = ++generation; }
+    void continueGenerationsFrom(const TopLevelProject &previousProject);
+
 private:
     TopLevelProject();
 
@@ -723,7 +744,8 @@ private:
         pool.serializationOp<opType>(m_id, canonicalFilePathResults, fileExistsResults,
                                      directoryEntriesResults, fileLastModifiedResults, environment,
                                      probes, profileConfigs, overriddenValues, buildSystemFiles,
-                                     lastResolveTime, warningsEncountered, buildData);
+                                     lastResolveTime, warningsEncountered,
+                                     fileSystemJournalState, buildData);
     }
     void load(PersistentPool &pool) override;
     void store(PersistentPool &pool) override;
@@ -57,6 +57,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/preferences.h>
 #include <tools/profile.h>
 #include <tools/profiling.h>
@@ -3406,6 +3407,7 @@ void ModuleLoader::resolveProbe(ProductContext *productContext, Item *parent, It
 {
     qCDebug(lcModuleLoader) << "Resolving Probe at " << probe->location().toString();
     ++m_probesEncountered;
+    Metrics::add(MetricsCounter::ProbesEncountered);
     const QString &probeId = probeGlobalId(probe);
     if (Q_UNLIKELY(probeId.isEmpty()))
         throw ErrorInfo(Tr::tr("Probe.id must be set."), probe->location());
@@ -3447,16 +3449,19 @@ void ModuleLoader::resolveProbe(ProductContext *productContext, Item *parent, It
         if (resolvedProbe) {
             qCDebug(lcModuleLoader) << "probe results cached from current run";
             ++m_probesCachedCurrent;
+            Metrics::add(MetricsCounter::ProbesCachedCurrent);
         }
     } else {
         qCDebug(lcModuleLoader) << "probe results cached from earlier run";
         ++m_probesCachedOld;
+        Metrics::add(MetricsCounter::ProbesCachedOld);
     }
     std::vector<QString> importedFilesUsedInConfigure;
     if (!condition) {
         qCDebug(lcModuleLoader) << "Probe disabled; skipping";
     } else if (!resolvedProbe) {
         ++m_probesRun;
+        Metrics::add(MetricsCounter::ProbesRun);
         qCDebug(lcModuleLoader) << "configure script needs to run";
         const Evaluator::FileContextScopes fileCtxScopes
                 = m_evaluator->fileContextScopes(configureScript->file());
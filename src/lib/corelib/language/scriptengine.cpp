@@ -50,6 +50,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/metrics.h>
 #include <tools/profiling.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
@@ -214,6 +215,13 @@ void ScriptEngine::clearImportsCache()
     m_jsImportCache.clear();
 }
 
+QScriptValue ScriptEngine::evaluate(const QString &program, const QString &fileName,
+                                    int lineNumber)
+{
+    Metrics::add(MetricsCounter::ScriptEvaluations);
+    return QScriptEngine::evaluate(program, fileName, lineNumber);
+}
+
 void ScriptEngine::checkContext(const QString &operation,
                                 const DubiousContextList &dubiousContexts)
 {
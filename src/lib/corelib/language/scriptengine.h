@@ -109,6 +109,13 @@ public:
                 ObserveMode observeMode);
     void clearImportsCache();
 
+    // Hides the QScriptEngine function of the same signature to keep track of the number
+    // of evaluations. As the base class function is not virtual, this only works if the
+    // caller's static type is ScriptEngine, which is the case for all of our call sites.
+    // For the same reason, the QScriptProgram overload is not made available here.
+    QScriptValue evaluate(const QString &program, const QString &fileName = QString(),
+                          int lineNumber = 1);
+
     void setEvalContext(EvalContext c) { m_evalContext = c; }
     EvalContext evalContext() const { return m_evalContext; }
     void checkContext(const QString &operation, const DubiousContextList &dubiousContexts);
@@ -187,6 +194,18 @@ public:
     }
 
     QHash<QString, FileTime> fileLastModifiedResults() const { return m_fileLastModifiedResult; }
+
+    // Files that were written in "skip unchanged" mode and found to be up to date.
+    void setFileKeptUnchanged(const QString &filePath, bool unchanged)
+    {
+        if (unchanged)
+            m_filesKeptUnchanged.insert(filePath);
+        else
+            m_filesKeptUnchanged.remove(filePath);
+    }
+    const Set<QString> &filesKeptUnchanged() const { return m_filesKeptUnchanged; }
+    void clearFilesKeptUnchanged() { m_filesKeptUnchanged.clear(); }
+
     Set<QString> imports() const;
     static QScriptValueList argumentList(const QStringList &argumentNames,
             const QScriptValue &context);
@@ -313,6 +332,7 @@ private:
     QHash<QString, bool> m_fileExistsResult;
     QHash<std::pair<QString, quint32>, QStringList> m_directoryEntriesResult;
     QHash<QString, FileTime> m_fileLastModifiedResult;
+    Set<QString> m_filesKeptUnchanged;
     std::stack<QString> m_currentDirPathStack;
     std::stack<QStringList> m_extensionSearchPathsStack;
     QScriptValue m_loadFileFunction;
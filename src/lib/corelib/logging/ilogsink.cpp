@@ -42,7 +42,11 @@
 
 #include <QtCore/qbytearray.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 namespace qbs {
 
@@ -75,13 +79,180 @@ QString logLevelName(LoggerLevel level)
     return QString();
 }
 
+namespace {
+
+class QueuedMessage
+{
+public:
+    std::atomic<QueuedMessage *> next{nullptr};
+    LoggerLevel level = LoggerInfo;
+    QString message;
+    QString tag;
+    ErrorInfo warning;
+    bool isWarning = false;
+};
+
+// Intrusive multiple-producer single-consumer queue after Dmitry Vyukov.
+// Pushing is wait-free, popping is done by the writer thread only.
+class MessageQueue
+{
+public:
+    MessageQueue() : m_head(&m_stub), m_tail(&m_stub) { }
+
+    ~MessageQueue()
+    {
+        while (QueuedMessage * const message = pop())
+            delete message;
+    }
+
+    void push(QueuedMessage *message)
+    {
+        message->next.store(nullptr, std::memory_order_relaxed);
+        QueuedMessage * const previous = m_head.exchange(message, std::memory_order_acq_rel);
+        previous->next.store(message, std::memory_order_release);
+    }
+
+    // Returns null if the queue is empty or a producer is in the middle of a push.
+    QueuedMessage *pop()
+    {
+        QueuedMessage *tail = m_tail;
+        QueuedMessage *next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub) {
+            if (!next)
+                return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != m_head.load(std::memory_order_acquire))
+            return nullptr;
+        push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    std::atomic<QueuedMessage *> m_head;
+    QueuedMessage *m_tail;
+    QueuedMessage m_stub;
+};
+
+} // namespace
+
 class ILogSink::ILogSinkPrivate
 {
 public:
+    void enqueue(QueuedMessage *message);
+    void waitForWrittenMessages(quint64 count);
+    void startWriter(ILogSink *sink);
+    void stopWriter();
+    void writerLoop(ILogSink *sink);
+
     LoggerLevel logLevel;
     std::mutex mutex;
+
+    std::unique_ptr<MessageQueue> queue;
+    std::thread writerThread;
+    std::atomic<quint64> enqueuedCount{0};
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> discardMessages{false};
+    std::mutex writerMutex;
+    std::condition_variable writerCondition;
+    quint64 writtenCount = 0;
+    std::condition_variable writtenCondition;
 };
 
+void ILogSink::ILogSinkPrivate::enqueue(QueuedMessage *message)
+{
+    queue->push(message);
+    enqueuedCount.fetch_add(1);
+    if (writerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writerCondition.notify_one();
+    }
+}
+
+void ILogSink::ILogSinkPrivate::waitForWrittenMessages(quint64 count)
+{
+    if (std::this_thread::get_id() == writerThread.get_id())
+        return;
+    std::unique_lock<std::mutex> lock(writerMutex);
+    writtenCondition.wait(lock, [this, count] { return writtenCount >= count; });
+}
+
+void ILogSink::ILogSinkPrivate::startWriter(ILogSink *sink)
+{
+    queue.reset(new MessageQueue);
+    enqueuedCount = 0;
+    writtenCount = 0;
+    stopRequested = false;
+    discardMessages = false;
+    writerThread = std::thread([this, sink] { writerLoop(sink); });
+}
+
+void ILogSink::ILogSinkPrivate::stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopRequested = true;
+        writerCondition.notify_one();
+    }
+    writerThread.join();
+    queue.reset();
+}
+
+void ILogSink::ILogSinkPrivate::writerLoop(ILogSink *sink)
+{
+    quint64 dequeuedCount = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerSleeping = true;
+            writerCondition.wait(lock, [this, dequeuedCount] {
+                return enqueuedCount.load() != dequeuedCount || stopRequested;
+            });
+            writerSleeping = false;
+            if (enqueuedCount.load() == dequeuedCount)
+                return; // Stop was requested and everything has been written.
+        }
+
+        // Write everything that is available as one batch.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (dequeuedCount != enqueuedCount.load()) {
+                QueuedMessage * const message = queue->pop();
+                if (!message) {
+                    std::this_thread::yield(); // A producer has not finished linking its node.
+                    continue;
+                }
+                if (!discardMessages) {
+                    if (message->isWarning)
+                        sink->doPrintWarning(message->warning);
+                    else
+                        sink->doPrintMessage(message->level, message->message, message->tag);
+                }
+                delete message;
+                ++dequeuedCount;
+            }
+            if (!discardMessages)
+                sink->doFlush();
+        }
+
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writtenCount = dequeuedCount;
+        writtenCondition.notify_all();
+    }
+}
+
 ILogSink::ILogSink() : d(new ILogSinkPrivate)
 {
     d->logLevel = defaultLogLevel();
@@ -89,6 +260,11 @@ ILogSink::ILogSink() : d(new ILogSinkPrivate)
 
 ILogSink::~ILogSink()
 {
+    // Too late to write pending messages: The subclass part of the object is gone already.
+    if (isAsynchronous()) {
+        d->discardMessages = true;
+        d->stopWriter();
+    }
     delete d;
 }
 
@@ -102,23 +278,62 @@ LoggerLevel ILogSink::logLevel() const
     return d->logLevel;
 }
 
+void ILogSink::setAsynchronous(bool asynchronous)
+{
+    if (asynchronous == isAsynchronous())
+        return;
+    if (asynchronous)
+        d->startWriter(this);
+    else
+        d->stopWriter();
+}
+
+bool ILogSink::isAsynchronous() const
+{
+    return d->writerThread.joinable();
+}
+
+void ILogSink::flush()
+{
+    if (isAsynchronous())
+        d->waitForWrittenMessages(d->enqueuedCount.load());
+}
+
 void ILogSink::printWarning(const ErrorInfo &warning)
 {
-    if (willPrint(LoggerWarning)) {
-        d->mutex.lock();
-        doPrintWarning(warning);
-        d->mutex.unlock();
+    if (!willPrint(LoggerWarning))
+        return;
+    if (isAsynchronous()) {
+        const auto message = new QueuedMessage;
+        message->level = LoggerWarning;
+        message->warning = warning;
+        message->isWarning = true;
+        d->enqueue(message);
+        return;
     }
+    std::lock_guard<std::mutex> lock(d->mutex);
+    doPrintWarning(warning);
+    doFlush();
 }
 
 void ILogSink::printMessage(LoggerLevel level, const QString &message, const QString &tag,
                             bool force)
 {
-    if (force || willPrint(level)) {
-        d->mutex.lock();
-        doPrintMessage(level, message, tag);
-        d->mutex.unlock();
+    if (!force && !willPrint(level))
+        return;
+    if (isAsynchronous()) {
+        const auto queuedMessage = new QueuedMessage;
+        queuedMessage->level = level;
+        queuedMessage->message = message;
+        queuedMessage->tag = tag;
+        d->enqueue(queuedMessage);
+        if (level == LoggerError)
+            flush();
+        return;
     }
+    std::lock_guard<std::mutex> lock(d->mutex);
+    doPrintMessage(level, message, tag);
+    doFlush();
 }
 
 void ILogSink::doPrintWarning(const ErrorInfo &warning)
@@ -77,11 +77,25 @@ public:
     void printMessage(LoggerLevel level, const QString &message,
                       const QString &tag = QString(), bool force = false);
 
+    // In asynchronous mode, messages are put into a queue and written by a dedicated thread
+    // in batches, so that the printing threads do not have to wait for each other.
+    // The order of the messages is preserved, and the queue is flushed after every error.
+    // Must not be called while other threads are printing. Subclasses that are used in
+    // asynchronous mode must switch it off in their destructor.
+    void setAsynchronous(bool asynchronous);
+    bool isAsynchronous() const;
+
+    // Returns after all messages printed so far have been written.
+    void flush();
+
 private:
     virtual void doPrintWarning(const ErrorInfo &warning);
     virtual void doPrintMessage(LoggerLevel level, const QString &message,
                                 const QString &tag) = 0;
 
+    // Called after a message or a batch of messages has been printed.
+    virtual void doFlush() { }
+
     class ILogSinkPrivate;
     ILogSinkPrivate * const d;
 };
@@ -51,7 +51,10 @@ public:
         : maxJobCount(0), dryRun(false), keepGoing(false), forceTimestampCheck(false),
           forceOutputCheck(false),
           logElapsedTime(false), echoMode(defaultCommandEchoMode()), install(true),
-          removeExistingInstallation(false), onlyExecuteRules(false)
+          removeExistingInstallation(false), installMode(defaultInstallMode()),
+          onlyExecuteRules(false),
+          commandOutputBufferSize(BuildOptions::defaultCommandOutputBufferSize()),
+          streamCommandOutput(false)
     {
     }
 
@@ -67,7 +70,10 @@ public:
     CommandEchoMode echoMode;
     bool install;
     bool removeExistingInstallation;
+    InstallMode installMode;
     bool onlyExecuteRules;
+    qint64 commandOutputBufferSize;
+    bool streamCommandOutput;
 };
 
 } // namespace Internal
@@ -339,6 +345,24 @@ void BuildOptions::setRemoveExistingInstallation(bool removeExisting)
     d->removeExistingInstallation = removeExisting;
 }
 
+/*!
+ * \brief Returns how files are put into the install root when installing during the build.
+ * The default is \c InstallModeCopy.
+ * \sa InstallOptions::installMode()
+ */
+InstallMode BuildOptions::installMode() const
+{
+    return d->installMode;
+}
+
+/*!
+ * \brief Controls how files are put into the install root when installing during the build.
+ */
+void BuildOptions::setInstallMode(InstallMode installMode)
+{
+    d->installMode = installMode;
+}
+
 /*!
  * \brief Returns true iff instead of a full build, only the rules of the project will be run.
  * The default is false.
@@ -359,6 +383,57 @@ void BuildOptions::setExecuteRulesOnly(bool onlyRules)
     d->onlyExecuteRules = onlyRules;
 }
 
+/*!
+ * \brief Returns the default value for \c commandOutputBufferSize(), which is 16 MiB.
+ */
+qint64 BuildOptions::defaultCommandOutputBufferSize()
+{
+    return 16 * 1024 * 1024;
+}
+
+/*!
+ * \brief Returns the number of bytes per output channel of a command that are kept in memory.
+ * Output beyond that is written to a temporary file, which is read back only if the output
+ * gets redirected to a file, in which case it is written there in full.
+ * Otherwise, only the last part of the output is reported or passed to the filter function,
+ * preceded by a line stating the number of omitted bytes.
+ * The default is \c defaultCommandOutputBufferSize().
+ */
+qint64 BuildOptions::commandOutputBufferSize() const
+{
+    return d->commandOutputBufferSize;
+}
+
+/*!
+ * \brief Controls how much output of a command is kept in memory.
+ * A value of zero or less means that there is no limit.
+ */
+void BuildOptions::setCommandOutputBufferSize(qint64 size)
+{
+    d->commandOutputBufferSize = size;
+}
+
+/*!
+ * \brief Returns true iff the output of commands is forwarded to the log sink while the
+ * commands are running, rather than being reported via \c ProcessResult when they finish.
+ * Output that gets redirected to a file or passed to a filter function is never streamed.
+ * The default is false.
+ */
+bool BuildOptions::streamCommandOutput() const
+{
+    return d->streamCommandOutput;
+}
+
+/*!
+ * \brief Controls whether the output of commands is forwarded to the log sink line by line
+ * while the commands are running.
+ * \note The output of commands that run in parallel will be interleaved.
+ */
+void BuildOptions::setStreamCommandOutput(bool stream)
+{
+    d->streamCommandOutput = stream;
+}
+
 
 bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
 {
@@ -369,7 +444,10 @@ bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
             && bo1.echoMode() == bo2.echoMode()
             && bo1.maxJobCount() == bo2.maxJobCount()
             && bo1.install() == bo2.install()
-            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation();
+            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation()
+            && bo1.installMode() == bo2.installMode()
+            && bo1.commandOutputBufferSize() == bo2.commandOutputBufferSize()
+            && bo1.streamCommandOutput() == bo2.streamCommandOutput();
 }
 
 } // namespace qbs
@@ -42,6 +42,7 @@
 #include "qbs_export.h"
 
 #include "commandechomode.h"
+#include "installmode.h"
 
 #include <QtCore/qshareddata.h>
 
@@ -97,9 +98,19 @@ public:
     bool removeExistingInstallation() const;
     void setRemoveExistingInstallation(bool removeExisting);
 
+    InstallMode installMode() const;
+    void setInstallMode(InstallMode installMode);
+
     bool executeRulesOnly() const;
     void setExecuteRulesOnly(bool onlyRules);
 
+    static qint64 defaultCommandOutputBufferSize();
+    qint64 commandOutputBufferSize() const;
+    void setCommandOutputBufferSize(qint64 size);
+
+    bool streamCommandOutput() const;
+    void setStreamCommandOutput(bool stream);
+
 private:
     QSharedDataPointer<Internal::BuildOptionsPrivate> d;
 };
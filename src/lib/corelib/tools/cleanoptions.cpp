@@ -48,12 +48,13 @@ class CleanOptionsPrivate : public QSharedData
 public:
     CleanOptionsPrivate()
         : dryRun(false),
-          keepGoing(false), logElapsedTime(false)
+          keepGoing(false), logElapsedTime(false), removeInBackground(false)
     { }
 
     bool dryRun;
     bool keepGoing;
     bool logElapsedTime;
+    bool removeInBackground;
 };
 
 }
@@ -147,4 +148,25 @@ void CleanOptions::setLogElapsedTime(bool log)
     d->logElapsedTime = log;
 }
 
+/*!
+ * \brief Returns true iff product build directories are removed in the background.
+ * The default is false.
+ */
+bool CleanOptions::removeInBackground() const
+{
+    return d->removeInBackground;
+}
+
+/*!
+ * \brief Controls whether to remove product build directories in the background.
+ * If the argument is true, then the build directory of each product is moved out of the way
+ * and removed as a whole by a detached process, including files that are not artifacts.
+ * Neither the clean-up nor the application waits for the removal. Leftovers of removals that
+ * did not finish are picked up the next time this option is used.
+ */
+void CleanOptions::setRemoveInBackground(bool removeInBackground)
+{
+    d->removeInBackground = removeInBackground;
+}
+
 } // namespace qbs
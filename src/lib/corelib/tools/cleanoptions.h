@@ -63,6 +63,9 @@ public:
     bool logElapsedTime() const;
     void setLogElapsedTime(bool log);
 
+    bool removeInBackground() const;
+    void setRemoveInBackground(bool removeInBackground);
+
 private:
     QSharedDataPointer<Internal::CleanOptionsPrivate> d;
 };
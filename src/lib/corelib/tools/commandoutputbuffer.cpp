@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "commandoutputbuffer.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporaryfile.h>
+
+namespace qbs {
+namespace Internal {
+
+CommandOutputBuffer::CommandOutputBuffer(qint64 memoryLimit) : m_memoryLimit(memoryLimit)
+{
+}
+
+CommandOutputBuffer::~CommandOutputBuffer() = default;
+
+void CommandOutputBuffer::reset(qint64 memoryLimit)
+{
+    m_memoryLimit = memoryLimit;
+    m_size = 0;
+    m_data.clear();
+    m_spillFile.reset();
+    m_spillFailed = false;
+}
+
+void CommandOutputBuffer::append(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+    m_size += data.size();
+    const bool exceedsLimit = m_memoryLimit > 0 && m_size > m_memoryLimit;
+    if (!exceedsLimit) {
+        m_data.append(data);
+        return;
+    }
+
+    if (!m_spillFile && !m_spillFailed) {
+        m_spillFile.reset(new QTemporaryFile(QDir::tempPath()
+                                             + QLatin1String("/qbs-output-XXXXXX")));
+        if (!m_spillFile->open() || m_spillFile->write(m_data) != m_data.size()) {
+            m_spillFile.reset();
+            m_spillFailed = true;
+        }
+    }
+    if (m_spillFile && m_spillFile->write(data) != data.size()) {
+        m_spillFile.reset();
+        m_spillFailed = true;
+    }
+
+    m_data.append(data);
+    if (m_data.size() > 2 * m_memoryLimit)
+        m_data.remove(0, int(m_data.size() - m_memoryLimit));
+}
+
+QByteArray CommandOutputBuffer::readAll()
+{
+    if (!m_spillFile)
+        return m_spillFailed ? tail() : m_data;
+    if (!m_spillFile->flush() || !m_spillFile->seek(0))
+        return tail();
+    const QByteArray content = m_spillFile->readAll();
+    m_spillFile->seek(m_spillFile->size());
+    return content.size() == m_size ? content : tail();
+}
+
+QByteArray CommandOutputBuffer::tail() const
+{
+    if (m_memoryLimit <= 0 || m_data.size() <= m_memoryLimit)
+        return m_data;
+    return m_data.right(int(m_memoryLimit));
+}
+
+bool CommandOutputBuffer::saveToFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (!m_spillFile) {
+        if (file.write(m_data) != m_data.size())
+            return false;
+    } else {
+        if (!m_spillFile->flush() || !m_spillFile->seek(0))
+            return false;
+        while (!m_spillFile->atEnd()) {
+            const QByteArray chunk = m_spillFile->read(1024 * 1024);
+            if (chunk.isEmpty() || file.write(chunk) != chunk.size())
+                return false;
+        }
+        m_spillFile->seek(m_spillFile->size());
+    }
+    file.close();
+    return file.error() == QFileDevice::NoError && isComplete();
+}
+
+} // namespace Internal
+} // namespace qbs
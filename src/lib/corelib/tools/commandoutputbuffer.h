@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_COMMANDOUTPUTBUFFER_H
+#define QBS_COMMANDOUTPUTBUFFER_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qbytearray.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QTemporaryFile;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// Collects the output of a command without letting memory usage grow with the output size.
+// Up to the memory limit, the output is kept in memory. Once it gets larger, all of it goes into
+// a temporary file, and only the most recent part stays in memory (in a buffer of up to twice
+// the limit, so that we do not have to shift data around on every append).
+class QBS_AUTOTEST_EXPORT CommandOutputBuffer
+{
+public:
+    explicit CommandOutputBuffer(qint64 memoryLimit = 0);
+    ~CommandOutputBuffer();
+
+    void reset(qint64 memoryLimit); // A limit of zero or less means no limit.
+    void append(const QByteArray &data);
+
+    qint64 size() const { return m_size; }
+
+    // False if the output did not fit into memory and could not be written to disk either.
+    bool isComplete() const { return !m_spillFailed; }
+
+    // The complete output, if available. Otherwise, the same as tail().
+    QByteArray readAll();
+
+    // At most memoryLimit bytes from the end of the output.
+    QByteArray tail() const;
+
+    bool saveToFile(const QString &filePath);
+
+private:
+    qint64 m_memoryLimit = 0;
+    qint64 m_size = 0;
+    QByteArray m_data;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    bool m_spillFailed = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
@@ -0,0 +1,246 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "digest.h"
+
+#include <logging/translator.h>
+
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+static const QHash<QString, QCryptographicHash::Algorithm> &cryptographicAlgorithms()
+{
+    static const QHash<QString, QCryptographicHash::Algorithm> algorithms {
+        { QStringLiteral("md5"), QCryptographicHash::Md5 },
+        { QStringLiteral("sha1"), QCryptographicHash::Sha1 },
+        { QStringLiteral("sha224"), QCryptographicHash::Sha224 },
+        { QStringLiteral("sha256"), QCryptographicHash::Sha256 },
+        { QStringLiteral("sha384"), QCryptographicHash::Sha384 },
+        { QStringLiteral("sha512"), QCryptographicHash::Sha512 },
+        { QStringLiteral("sha3-256"), QCryptographicHash::Sha3_256 },
+        { QStringLiteral("sha3-512"), QCryptographicHash::Sha3_512 },
+    };
+    return algorithms;
+}
+
+static QString xxh64AlgorithmName() { return QStringLiteral("xxhash64"); }
+
+// See https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+static const quint64 xxh64Prime1 = 11400714785074694791ULL;
+static const quint64 xxh64Prime2 = 14029467366897019727ULL;
+static const quint64 xxh64Prime3 = 1609587929392839161ULL;
+static const quint64 xxh64Prime4 = 9650029242287828579ULL;
+static const quint64 xxh64Prime5 = 2870177450012600261ULL;
+
+static quint64 rotateLeft(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static quint64 xxh64Round(quint64 accumulator, quint64 input)
+{
+    accumulator += input * xxh64Prime2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * xxh64Prime1;
+}
+
+static quint64 xxh64MergeRound(quint64 accumulator, quint64 value)
+{
+    accumulator ^= xxh64Round(0, value);
+    return accumulator * xxh64Prime1 + xxh64Prime4;
+}
+
+QStringList Digest::supportedAlgorithms()
+{
+    QStringList algorithms = cryptographicAlgorithms().keys();
+    algorithms << xxh64AlgorithmName();
+    std::sort(algorithms.begin(), algorithms.end());
+    return algorithms;
+}
+
+bool Digest::isSupportedAlgorithm(const QString &algorithm)
+{
+    return algorithm == xxh64AlgorithmName() || cryptographicAlgorithms().contains(algorithm);
+}
+
+Digest::Digest(const QString &algorithm)
+{
+    if (algorithm != xxh64AlgorithmName()) {
+        m_cryptographicHash.reset(new QCryptographicHash(
+                                      cryptographicAlgorithms().value(algorithm)));
+        return;
+    }
+    m_xxh64Accumulators[0] = xxh64Prime1 + xxh64Prime2;
+    m_xxh64Accumulators[1] = xxh64Prime2;
+    m_xxh64Accumulators[2] = 0;
+    m_xxh64Accumulators[3] = 0 - xxh64Prime1;
+}
+
+Digest::~Digest()
+{
+}
+
+void Digest::addData(const char *data, qint64 length)
+{
+    if (m_cryptographicHash) {
+        static const qint64 maxChunkSize = 1 << 30;
+        for (qint64 offset = 0; offset < length; offset += maxChunkSize) {
+            m_cryptographicHash->addData(data + offset,
+                                         int(std::min(maxChunkSize, length - offset)));
+        }
+        return;
+    }
+
+    auto input = reinterpret_cast<const uchar *>(data);
+    const uchar * const end = input + length;
+    m_xxh64TotalLength += quint64(length);
+    if (m_xxh64BufferSize > 0) {
+        const int bytesToCopy = int(std::min<qint64>(32 - m_xxh64BufferSize, length));
+        std::copy(input, input + bytesToCopy, m_xxh64Buffer + m_xxh64BufferSize);
+        m_xxh64BufferSize += bytesToCopy;
+        input += bytesToCopy;
+        if (m_xxh64BufferSize < 32)
+            return;
+        addXxh64Stripe(m_xxh64Buffer);
+        m_xxh64BufferSize = 0;
+    }
+    for (; end - input >= 32; input += 32)
+        addXxh64Stripe(input);
+    std::copy(input, end, m_xxh64Buffer);
+    m_xxh64BufferSize = int(end - input);
+}
+
+void Digest::addXxh64Stripe(const uchar *stripe)
+{
+    for (int i = 0; i < 4; ++i) {
+        m_xxh64Accumulators[i] = xxh64Round(m_xxh64Accumulators[i],
+                                            qFromLittleEndian<quint64>(stripe + 8 * i));
+    }
+}
+
+QByteArray Digest::result() const
+{
+    if (m_cryptographicHash)
+        return m_cryptographicHash->result().toHex();
+
+    quint64 hash;
+    if (m_xxh64TotalLength >= 32) {
+        const quint64 * const acc = m_xxh64Accumulators;
+        hash = rotateLeft(acc[0], 1) + rotateLeft(acc[1], 7) + rotateLeft(acc[2], 12)
+                + rotateLeft(acc[3], 18);
+        for (int i = 0; i < 4; ++i)
+            hash = xxh64MergeRound(hash, acc[i]);
+    } else {
+        hash = xxh64Prime5;
+    }
+    hash += m_xxh64TotalLength;
+
+    const uchar *input = m_xxh64Buffer;
+    const uchar * const end = input + m_xxh64BufferSize;
+    for (; end - input >= 8; input += 8) {
+        hash ^= xxh64Round(0, qFromLittleEndian<quint64>(input));
+        hash = rotateLeft(hash, 27) * xxh64Prime1 + xxh64Prime4;
+    }
+    if (end - input >= 4) {
+        hash ^= quint64(qFromLittleEndian<quint32>(input)) * xxh64Prime1;
+        hash = rotateLeft(hash, 23) * xxh64Prime2 + xxh64Prime3;
+        input += 4;
+    }
+    for (; input < end; ++input) {
+        hash ^= *input * xxh64Prime5;
+        hash = rotateLeft(hash, 11) * xxh64Prime1;
+    }
+    hash ^= hash >> 33;
+    hash *= xxh64Prime2;
+    hash ^= hash >> 29;
+    hash *= xxh64Prime3;
+    hash ^= hash >> 32;
+
+    uchar bigEndianHash[8];
+    qToBigEndian(hash, bigEndianHash);
+    return QByteArray(reinterpret_cast<const char *>(bigEndianHash), 8).toHex();
+}
+
+QByteArray Digest::dataDigest(const QByteArray &data, const QString &algorithm)
+{
+    Digest digest(algorithm);
+    digest.addData(data);
+    return digest.result();
+}
+
+QByteArray Digest::fileDigest(const QString &filePath, const QString &algorithm,
+                              QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorMessage = Tr::tr("Cannot open '%1' for reading: %2")
+                .arg(filePath, file.errorString());
+        return QByteArray();
+    }
+    Digest digest(algorithm);
+    const qint64 size = file.size();
+    if (uchar * const data = size > 0 ? file.map(0, size) : nullptr) {
+        digest.addData(reinterpret_cast<const char *>(data), size);
+        file.unmap(data);
+        return digest.result();
+    }
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    while (true) {
+        const qint64 bytesRead = file.read(buffer.data(), buffer.size());
+        if (bytesRead == -1) {
+            *errorMessage = Tr::tr("Cannot read from '%1': %2")
+                    .arg(filePath, file.errorString());
+            return QByteArray();
+        }
+        if (bytesRead == 0)
+            break;
+        digest.addData(buffer.constData(), bytesRead);
+    }
+    return digest.result();
+}
+
+} // namespace Internal
+} // namespace qbs
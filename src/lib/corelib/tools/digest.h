@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBS_DIGEST_H
+#define QBS_DIGEST_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+namespace qbs {
+namespace Internal {
+
+// Computes digests with one of the algorithms from supportedAlgorithms(). Apart from the
+// ones offered by QCryptographicHash, there is "xxhash64", which is a lot faster,
+// but not suitable for cryptographic purposes.
+class QBS_AUTOTEST_EXPORT Digest
+{
+public:
+    static QStringList supportedAlgorithms();
+    static bool isSupportedAlgorithm(const QString &algorithm);
+
+    // The algorithm must be supported.
+    explicit Digest(const QString &algorithm);
+    ~Digest();
+
+    void addData(const char *data, qint64 length);
+    void addData(const QByteArray &data) { addData(data.constData(), data.size()); }
+
+    // Returns the digest in hexadecimal notation.
+    QByteArray result() const;
+
+    static QByteArray dataDigest(const QByteArray &data, const QString &algorithm);
+
+    // Reads the file piece by piece, or maps it into memory if possible.
+    // Returns a null QByteArray if the file cannot be read.
+    static QByteArray fileDigest(const QString &filePath, const QString &algorithm,
+                                 QString *errorMessage);
+
+private:
+    void addXxh64Stripe(const uchar *stripe);
+
+    std::unique_ptr<QCryptographicHash> m_cryptographicHash;
+    quint64 m_xxh64Accumulators[4];
+    quint64 m_xxh64TotalLength = 0;
+    uchar m_xxh64Buffer[32];
+    int m_xxh64BufferSize = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_DIGEST_H
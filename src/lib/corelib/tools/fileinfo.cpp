@@ -40,6 +40,8 @@
 #include "fileinfo.h"
 
 #include <logging/translator.h>
+#include <tools/metrics.h>
+#include <tools/parallelfor.h>
 #include <tools/qbsassert.h>
 #include <tools/stringconstants.h>
 
@@ -48,11 +50,21 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qregexp.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qthread.h>
+
+#include <atomic>
 
 #if defined(Q_OS_UNIX)
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 #elif defined(Q_OS_WIN)
 #include <QtCore/qt_windows.h>
 #endif
@@ -312,6 +324,7 @@ FileInfo::FileInfo(const QString &fileName)
         filePath = QDir::currentPath() + QDir::separator() + filePath;
 
     filePath = prependLongPathPrefix(QDir::cleanPath(filePath));
+    Metrics::add(MetricsCounter::StatCalls);
     if (!GetFileAttributesEx(reinterpret_cast<const WCHAR*>(filePath.utf16()),
                              GetFileExInfoStandard, &m_stat))
     {
@@ -360,6 +373,7 @@ QString applicationDirPath()
 
 FileInfo::FileInfo(const QString &fileName)
 {
+    Metrics::add(MetricsCounter::StatCalls);
     if (stat(fileName.toLocal8Bit(), &m_stat) == -1) {
         m_stat.st_mtime = 0;
         m_stat.st_mode = 0;
@@ -432,6 +446,43 @@ bool removeFileRecursion(const QFileInfo &f, QString *errorMessage)
     return true;
 }
 
+int fileOperationThreadCount(int operationCount)
+{
+    // Starting threads does not pay off for a handful of operations. Otherwise, the threads
+    // mostly wait for the file system, so we use more of them than there are cores.
+    return operationCount < 32 ? 1 : 2 * QThread::idealThreadCount();
+}
+
+std::vector<FileRemovalResult> removeFilesConcurrently(const QStringList &filePaths,
+                                                       FileRemovalFlags flags)
+{
+    std::vector<FileRemovalResult> results(filePaths.size());
+    std::atomic<bool> hasError(false);
+    parallelFor(results.size(), fileOperationThreadCount(filePaths.size()), [&](std::size_t i) {
+        if (hasError && flags.testFlag(StopAtFirstRemovalError))
+            return;
+        const QFileInfo fileInfo(filePaths.at(int(i)));
+        FileRemovalResult &result = results[i];
+        result.existed = FileInfo::fileExists(fileInfo);
+        if (!result.existed || flags.testFlag(DryRunRemoval))
+            return;
+        if (flags.testFlag(RemoveRecursively)) {
+            QString errorMessage;
+            if (!removeFileRecursion(fileInfo, &errorMessage))
+                result.errorMessage = errorMessage;
+        } else {
+            QFile file(fileInfo.filePath());
+            if (!file.remove()) {
+                result.errorMessage = Tr::tr("The file %1 could not be removed: %2")
+                        .arg(QDir::toNativeSeparators(file.fileName()), file.errorString());
+            }
+        }
+        if (!result.errorMessage.isEmpty())
+            hasError = true;
+    });
+    return results;
+}
+
 bool removeDirectoryWithContents(const QString &path, QString *errorMessage)
 {
     QFileInfo f(path);
@@ -496,6 +547,78 @@ static bool createSymLink(const QByteArray &path1, const QString &path2)
 #endif // Q_OS_UNIX
 }
 
+static bool createHardLink(const QString &srcFilePath, const QString &tgtFilePath)
+{
+#if defined(Q_OS_UNIX)
+    return link(QFile::encodeName(srcFilePath).constData(),
+                QFile::encodeName(tgtFilePath).constData()) == 0;
+#elif defined(Q_OS_WIN)
+    return CreateHardLink(reinterpret_cast<const WCHAR *>(
+                              QDir::toNativeSeparators(tgtFilePath).utf16()),
+                          reinterpret_cast<const WCHAR *>(
+                              QDir::toNativeSeparators(srcFilePath).utf16()),
+                          nullptr);
+#else
+    Q_UNUSED(srcFilePath);
+    Q_UNUSED(tgtFilePath);
+    return false;
+#endif
+}
+
+/*!
+ * Creates \a tgtFilePath as a clone of \a srcFilePath that shares the data blocks of the
+ * original file. If the file system cannot do that, the kernel is asked to copy the data
+ * without a round-trip through user space. Returns false if neither is possible,
+ * in which case the caller should fall back to a normal copy.
+ */
+static bool cloneFile(const QString &srcFilePath, const QString &tgtFilePath)
+{
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    const int srcFd = open(QFile::encodeName(srcFilePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (srcFd == -1)
+        return false;
+    struct stat srcStat;
+    if (fstat(srcFd, &srcStat) == -1) {
+        close(srcFd);
+        return false;
+    }
+    const QByteArray nativeTgtFilePath = QFile::encodeName(tgtFilePath);
+    const mode_t permissions = srcStat.st_mode & 07777;
+    const int tgtFd = open(nativeTgtFilePath.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                           permissions);
+    if (tgtFd == -1) {
+        close(srcFd);
+        return false;
+    }
+    bool success = ioctl(tgtFd, FICLONE, srcFd) == 0;
+#ifdef SYS_copy_file_range
+    if (!success) {
+        success = true;
+        for (off_t remaining = srcStat.st_size; remaining > 0;) {
+            const ssize_t copied = syscall(SYS_copy_file_range, srcFd, nullptr, tgtFd, nullptr,
+                                           static_cast<size_t>(remaining), 0);
+            if (copied <= 0) {
+                success = false;
+                break;
+            }
+            remaining -= copied;
+        }
+    }
+#endif
+    if (success)
+        success = fchmod(tgtFd, permissions) == 0; // Not subject to the umask, like QFile::copy().
+    close(tgtFd);
+    close(srcFd);
+    if (!success)
+        unlink(nativeTgtFilePath.constData());
+    return success;
+#else
+    Q_UNUSED(srcFilePath);
+    Q_UNUSED(tgtFilePath);
+    return false;
+#endif
+}
+
 /*!
   Copies the directory specified by \a srcFilePath recursively to \a tgtFilePath.
   \a tgtFilePath will contain the target directory, which will be created. Example usage:
@@ -510,20 +633,29 @@ static bool createSymLink(const QByteArray &path1, const QString &path2)
   This will copy the contents of /foo/bar into to the baz directory under /foo,
   which will be created in the process.
 
+  Regular files are hard-linked or cloned instead of copied if \a mode says so
+  and the file system supports it.
+
+  If \a targetDirExists is true, the caller guarantees that the directory containing
+  \a tgtFilePath exists already, so we do not need to try to create it.
+
   \return Whether the operation succeeded.
   \note Function was adapted from qtc/src/libs/fileutils.cpp
 */
 
 bool copyFileRecursion(const QString &srcFilePath, const QString &tgtFilePath,
-        bool preserveSymLinks, bool copyDirectoryContents, QString *errorMessage)
+        bool preserveSymLinks, bool copyDirectoryContents, QString *errorMessage,
+        InstallMode mode, bool targetDirExists)
 {
     QFileInfo srcFileInfo(srcFilePath);
     QFileInfo tgtFileInfo(tgtFilePath);
-    const QString targetDirPath = tgtFileInfo.absoluteDir().path();
-    if (!QDir::root().mkpath(targetDirPath)) {
-        *errorMessage = Tr::tr("The directory '%1' could not be created.")
-                .arg(QDir::toNativeSeparators(targetDirPath));
-        return false;
+    if (!targetDirExists) {
+        const QString targetDirPath = tgtFileInfo.absoluteDir().path();
+        if (!QDir::root().mkpath(targetDirPath)) {
+            *errorMessage = Tr::tr("The directory '%1' could not be created.")
+                    .arg(QDir::toNativeSeparators(targetDirPath));
+            return false;
+        }
     }
     if (HostOsInfo::isAnyUnixHost() && preserveSymLinks && srcFileInfo.isSymLink()) {
         // For now, disable symlink preserving copying on Windows.
@@ -538,12 +670,14 @@ bool copyFileRecursion(const QString &srcFilePath, const QString &tgtFilePath,
             QDir sourceDir(srcFilePath);
             const QStringList fileNames = sourceDir.entryList(QDir::Files | QDir::Dirs
                     | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+            bool tgtDirExists = false;
             for (const QString &fileName : fileNames) {
                 const QString newSrcFilePath = srcFilePath + QLatin1Char('/') + fileName;
                 const QString newTgtFilePath = tgtFilePath + QLatin1Char('/') + fileName;
                 if (!copyFileRecursion(newSrcFilePath, newTgtFilePath, preserveSymLinks,
-                                       copyDirectoryContents, errorMessage))
+                                       copyDirectoryContents, errorMessage, mode, tgtDirExists))
                     return false;
+                tgtDirExists = true;
             }
         } else {
             if (tgtFileInfo.exists() && srcFileInfo.lastModified() <= tgtFileInfo.lastModified())
@@ -562,6 +696,10 @@ bool copyFileRecursion(const QString &srcFilePath, const QString &tgtFilePath,
                         .arg(QDir::toNativeSeparators(tgtFilePath), targetFile.errorString());
             }
         }
+        if (mode == InstallModeHardLink && createHardLink(srcFilePath, tgtFilePath))
+            return true;
+        if (mode == InstallModeReflink && cloneFile(srcFilePath, tgtFilePath))
+            return true;
         if (!file.copy(tgtFilePath)) {
             *errorMessage = Tr::tr("Could not copy file '%1' to '%2'. %3")
                 .arg(QDir::toNativeSeparators(srcFilePath), QDir::toNativeSeparators(tgtFilePath),
@@ -572,5 +710,47 @@ bool copyFileRecursion(const QString &srcFilePath, const QString &tgtFilePath,
     return true;
 }
 
+static bool fileHasContents(const QString &filePath, const QByteArray &contents)
+{
+    QFile file(filePath);
+    if (file.size() != contents.size() || !file.open(QIODevice::ReadOnly))
+        return false;
+    static const qint64 chunkSize = 1024 * 1024;
+    for (qint64 offset = 0; offset < contents.size(); offset += chunkSize) {
+        const QByteArray chunk = file.read(chunkSize);
+        if (chunk.isEmpty() || chunk != QByteArray::fromRawData(contents.constData() + offset,
+                                                                chunk.size())) {
+            return false;
+        }
+    }
+    return file.atEnd();
+}
+
+/*!
+  Writes \a contents to the file at \a filePath, unless the file already has exactly
+  these contents, in which case neither the file nor its timestamp are touched.
+  The file is compared by size first, so that its contents only need to be read
+  if the size matches.
+
+  \a changed is set to whether the file was written.
+  \return Whether the operation succeeded.
+*/
+bool writeFileIfChanged(const QString &filePath, const QByteArray &contents, bool *changed,
+                        QString *errorMessage)
+{
+    *changed = false;
+    if (fileHasContents(filePath, contents))
+        return true;
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size()
+            || !file.commit()) {
+        *errorMessage = Tr::tr("Could not write file '%1': %2")
+                .arg(QDir::toNativeSeparators(filePath), file.errorString());
+        return false;
+    }
+    *changed = true;
+    return true;
+}
+
 } // namespace Internal
 } // namespace qbs
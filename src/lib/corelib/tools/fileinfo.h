@@ -42,15 +42,20 @@
 
 #include "filetime.h"
 #include "hostosinfo.h"
+#include "installmode.h"
 #include "qbs_export.h"
 
 #if defined(Q_OS_UNIX)
 #include <sys/stat.h>
 #endif
 
+#include <QtCore/qflags.h>
 #include <QtCore/qstring.h>
 
+#include <vector>
+
 QT_FORWARD_DECLARE_CLASS(QFileInfo)
+QT_FORWARD_DECLARE_CLASS(QStringList)
 
 namespace qbs {
 namespace Internal {
@@ -101,10 +106,38 @@ private:
 
 bool removeFileRecursion(const QFileInfo &f, QString *errorMessage);
 
+class FileRemovalResult
+{
+public:
+    bool existed = false;
+    QString errorMessage; // Empty if the file was removed.
+};
+
+// The number of threads to use for the given number of independent file system operations.
+int fileOperationThreadCount(int operationCount);
+
+enum FileRemovalFlag {
+    RemoveRecursively = 0x1,        // Remove directories including their contents.
+    DryRunRemoval = 0x2,            // Only determine which of the files exist.
+    StopAtFirstRemovalError = 0x4   // Leave the remaining files alone after an error.
+};
+Q_DECLARE_FLAGS(FileRemovalFlags, FileRemovalFlag)
+Q_DECLARE_OPERATORS_FOR_FLAGS(FileRemovalFlags)
+
+// Removes the given files, distributing the work over several threads.
+// The results are in the same order as the file paths. Files that were not looked at
+// because of an earlier error are reported as non-existing.
+std::vector<FileRemovalResult> QBS_AUTOTEST_EXPORT removeFilesConcurrently(
+        const QStringList &filePaths, FileRemovalFlags flags = FileRemovalFlags());
+
 // FIXME: Used by tests.
 bool QBS_EXPORT removeDirectoryWithContents(const QString &path, QString *errorMessage);
 bool QBS_EXPORT copyFileRecursion(const QString &sourcePath, const QString &targetPath,
-                                  bool preserveSymLinks, bool copyDirectoryContents, QString *errorMessage);
+                                  bool preserveSymLinks, bool copyDirectoryContents, QString *errorMessage,
+                                  InstallMode mode = InstallModeCopy,
+                                  bool targetDirExists = false);
+bool QBS_AUTOTEST_EXPORT writeFileIfChanged(const QString &filePath, const QByteArray &contents,
+                                            bool *changed, QString *errorMessage);
 
 } // namespace Internal
 } // namespace qbs
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "filesystemjournal.h"
+
+#include <QtCore/qfile.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+static QByteArray magicString() { return QByteArrayLiteral("qbs-fs-journal 1 "); }
+static QByteArray rootPrefix() { return QByteArrayLiteral("root "); }
+static QByteArray excludePrefix() { return QByteArrayLiteral("exclude "); }
+static QByteArray eventsMarker() { return QByteArrayLiteral("events\n"); }
+static QByteArray changedPathPrefix() { return QByteArrayLiteral("c "); }
+static QByteArray changedTreePrefix() { return QByteArrayLiteral("t "); }
+
+static bool isSameOrBelow(const QString &filePath, const QString &dirPath)
+{
+    return filePath.startsWith(dirPath)
+            && (filePath.size() == dirPath.size() || filePath.at(dirPath.size()) == QLatin1Char('/'));
+}
+
+static QString pathFromLine(const QByteArray &line, int prefixLength)
+{
+    return QString::fromUtf8(line.mid(prefixLength, line.size() - prefixLength - 1));
+}
+
+static Set<QString> toSet(std::vector<QString> &paths)
+{
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return Set<QString>::fromSortedStdVector(paths);
+}
+
+FileSystemJournal FileSystemJournal::read(const QString &filePath, const State &lastState)
+{
+    FileSystemJournal journal;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || !journal.readHeader(file))
+        return journal;
+
+    journal.m_state.offset = file.pos();
+    journal.m_complete = journal.m_state.session == lastState.session
+            && lastState.offset >= journal.m_state.offset && lastState.offset <= file.size();
+    if (journal.m_complete && !file.seek(lastState.offset))
+        journal.m_complete = false;
+
+    // Even if the journal is of no use this time, we need to find out where it ends,
+    // so that the next reader can start there.
+    std::vector<QString> changedPaths;
+    std::vector<QString> changedTrees;
+    while (true) {
+        const QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) // EOF or a line that is still being written.
+            break;
+        journal.m_state.offset = file.pos();
+        if (!journal.m_complete)
+            continue;
+        if (line.startsWith(changedPathPrefix()))
+            changedPaths.push_back(pathFromLine(line, changedPathPrefix().size()));
+        else if (line.startsWith(changedTreePrefix()))
+            changedTrees.push_back(pathFromLine(line, changedTreePrefix().size()));
+        else
+            journal.m_complete = false; // Overflow or something we don't understand.
+    }
+    if (journal.m_complete) {
+        journal.m_changedPaths = toSet(changedPaths);
+        journal.m_changedTrees = toSet(changedTrees);
+    }
+    return journal;
+}
+
+bool FileSystemJournal::mayHaveChanged(const QString &filePath) const
+{
+    if (!m_complete || !isSameOrBelow(filePath, m_rootDir) || isExcluded(filePath))
+        return true;
+    if (m_changedPaths.contains(filePath))
+        return true;
+
+    // Something below filePath, in case it is a directory.
+    const QString dirPrefix = filePath + QLatin1Char('/');
+    const auto it = std::lower_bound(m_changedPaths.cbegin(), m_changedPaths.cend(), dirPrefix);
+    if (it != m_changedPaths.cend() && it->startsWith(dirPrefix))
+        return true;
+
+    // The directory containing filePath, or one of its parents, was moved around.
+    for (QString dirPath = filePath; dirPath.size() >= m_rootDir.size();
+         dirPath.truncate(dirPath.lastIndexOf(QLatin1Char('/')))) {
+        if (m_changedTrees.contains(dirPath))
+            return true;
+        if (dirPath.lastIndexOf(QLatin1Char('/')) < 0)
+            break;
+    }
+    return false;
+}
+
+QByteArray FileSystemJournal::header(const QString &session, const QString &rootDir,
+                                     const QStringList &excludedDirs)
+{
+    QByteArray data = magicString() + session.toUtf8() + '\n';
+    data += rootPrefix() + rootDir.toUtf8() + '\n';
+    for (const QString &dir : excludedDirs)
+        data += excludePrefix() + dir.toUtf8() + '\n';
+    return data + eventsMarker();
+}
+
+QByteArray FileSystemJournal::changedPathEntry(const QString &filePath)
+{
+    return changedPathPrefix() + filePath.toUtf8() + '\n';
+}
+
+QByteArray FileSystemJournal::changedTreeEntry(const QString &dirPath)
+{
+    return changedTreePrefix() + dirPath.toUtf8() + '\n';
+}
+
+QByteArray FileSystemJournal::overflowEntry()
+{
+    return QByteArrayLiteral("overflow\n");
+}
+
+bool FileSystemJournal::readHeader(QIODevice &device)
+{
+    QByteArray line = device.readLine();
+    if (!line.startsWith(magicString()) || !line.endsWith('\n'))
+        return false;
+    m_state.session = pathFromLine(line, magicString().size());
+    line = device.readLine();
+    if (!line.startsWith(rootPrefix()) || !line.endsWith('\n'))
+        return false;
+    m_rootDir = pathFromLine(line, rootPrefix().size());
+    while (true) {
+        line = device.readLine();
+        if (line == eventsMarker())
+            return !m_state.session.isEmpty() && !m_rootDir.isEmpty();
+        if (!line.startsWith(excludePrefix()) || !line.endsWith('\n'))
+            return false;
+        m_excludedDirs << pathFromLine(line, excludePrefix().size());
+    }
+}
+
+bool FileSystemJournal::isExcluded(const QString &filePath) const
+{
+    return std::any_of(m_excludedDirs.cbegin(), m_excludedDirs.cend(),
+                       [&filePath](const QString &dir) { return isSameOrBelow(filePath, dir); });
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBS_FILESYSTEMJOURNAL_H
+#define QBS_FILESYSTEMJOURNAL_H
+
+#include "persistence.h"
+#include "qbs_export.h"
+#include "set.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+/*
+ * A journal of file system changes below a directory, as written by the qbs-watch tool.
+ *
+ * The file starts with a header identifying the watcher session and the watched directory,
+ * followed by one line per change. The watcher only ever appends to the file; a new session
+ * starts with a new file. Readers remember the session and the position up to which they
+ * have consumed the journal, so they can later ask for the changes that happened since then.
+ */
+class QBS_EXPORT FileSystemJournal
+{
+public:
+    class State
+    {
+    public:
+        QString session;
+        qint64 offset = 0;
+
+        template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
+        {
+            pool.serializationOp<opType>(session, offset);
+        }
+    };
+
+    // Reads all changes that were recorded after lastState.
+    static FileSystemJournal read(const QString &filePath, const State &lastState);
+
+    // True if the journal has a record of every change since the last state.
+    // If not, callers must check the file system themselves.
+    bool isComplete() const { return m_complete; }
+
+    // The state to pass to read() next time.
+    const State &state() const { return m_state; }
+
+    // Returns false only if the journal guarantees that neither the file or directory
+    // nor anything below it has changed.
+    bool mayHaveChanged(const QString &filePath) const;
+
+    // Used by the writer.
+    static QByteArray header(const QString &session, const QString &rootDir,
+                             const QStringList &excludedDirs);
+    static QByteArray changedPathEntry(const QString &filePath);
+    static QByteArray changedTreeEntry(const QString &dirPath);
+    static QByteArray overflowEntry();
+
+private:
+    bool readHeader(QIODevice &device);
+    bool isExcluded(const QString &filePath) const;
+
+    State m_state;
+    QString m_rootDir;
+    QStringList m_excludedDirs;
+    Set<QString> m_changedPaths;
+    Set<QString> m_changedTrees;
+    bool m_complete = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_FILESYSTEMJOURNAL_H
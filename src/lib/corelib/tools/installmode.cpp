@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "installmode.h"
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+/*!
+ * \enum InstallMode
+ * This enum type specifies how files are put into the install root.
+ * \value InstallModeCopy Indicates that files will be copied.
+ * \value InstallModeReflink Indicates that files will be cloned, so that the copy shares its
+ * data with the original until one of them is modified. This falls back to a normal copy
+ * if the file system does not support it.
+ * \value InstallModeHardLink Indicates that hard links to the original files will be created.
+ * This falls back to a normal copy if the file system does not support it, for instance
+ * because the install root is on a different device.
+ */
+
+namespace qbs {
+
+InstallMode defaultInstallMode()
+{
+    return InstallModeCopy;
+}
+
+QString installModeName(InstallMode mode)
+{
+    switch (mode) {
+    case InstallModeCopy:
+        return QLatin1String("copy");
+    case InstallModeReflink:
+        return QLatin1String("reflink");
+    case InstallModeHardLink:
+        return QLatin1String("hardlink");
+    default:
+        break;
+    }
+    return QString();
+}
+
+InstallMode installModeFromName(const QString &name)
+{
+    InstallMode mode = defaultInstallMode();
+    for (int i = 0; i < InstallModeInvalid; ++i) {
+        if (installModeName(static_cast<InstallMode>(i)) == name) {
+            mode = static_cast<InstallMode>(i);
+            break;
+        }
+    }
+
+    return mode;
+}
+
+QStringList allInstallModeStrings()
+{
+    QStringList result;
+    for (int i = 0; i < InstallModeInvalid; ++i)
+        result << installModeName(static_cast<InstallMode>(i));
+    return result;
+}
+
+} // namespace qbs
@@ -51,7 +51,8 @@ class InstallOptionsPrivate : public QSharedData
 public:
     InstallOptionsPrivate()
         : useSysroot(false), removeExisting(false), dryRun(false),
-          keepGoing(false), logElapsedTime(false)
+          keepGoing(false), logElapsedTime(false), installMode(defaultInstallMode()),
+          maxJobCount(0)
     {}
 
     QString installRoot;
@@ -60,6 +61,8 @@ public:
     bool dryRun;
     bool keepGoing;
     bool logElapsedTime;
+    InstallMode installMode;
+    int maxJobCount;
 };
 
 QString effectiveInstallRoot(const InstallOptions &options, const TopLevelProject *project)
@@ -226,4 +229,42 @@ void InstallOptions::setLogElapsedTime(bool logElapsedTime)
     d->logElapsedTime = logElapsedTime;
 }
 
+/*!
+ * \brief Returns how files are put into the install root.
+ * The default is \c InstallModeCopy.
+ */
+InstallMode InstallOptions::installMode() const
+{
+    return d->installMode;
+}
+
+/*!
+ * \brief Controls how files are put into the install root.
+ * \note With \c InstallModeHardLink, modifying an installed file in place also modifies the
+ *       corresponding file in the build directory, and vice versa.
+ */
+void InstallOptions::setInstallMode(InstallMode installMode)
+{
+    d->installMode = installMode;
+}
+
+/*!
+ * \brief Returns the maximum number of files to install concurrently.
+ * If the value is not valid (i.e. <= 0), \c BuildOptions::defaultMaxJobCount() is used.
+ * The default is 0.
+ */
+int InstallOptions::maxJobCount() const
+{
+    return d->maxJobCount;
+}
+
+/*!
+ * \brief Controls how many files can be installed in parallel.
+ * A value <= 0 leaves the decision to qbs.
+ */
+void InstallOptions::setMaxJobCount(int jobCount)
+{
+    d->maxJobCount = jobCount;
+}
+
 } // namespace qbs
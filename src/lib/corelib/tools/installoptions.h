@@ -41,6 +41,8 @@
 
 #include "qbs_export.h"
 
+#include "installmode.h"
+
 #include <QtCore/qshareddata.h>
 
 QT_BEGIN_NAMESPACE
@@ -82,6 +84,12 @@ public:
     bool logElapsedTime() const;
     void setLogElapsedTime(bool logElapsedTime);
 
+    InstallMode installMode() const;
+    void setInstallMode(InstallMode installMode);
+
+    int maxJobCount() const;
+    void setMaxJobCount(int jobCount);
+
 private:
     QSharedDataPointer<Internal::InstallOptionsPrivate> d;
 };
@@ -116,6 +116,22 @@ void ProcessErrorPacket::doDeserialize(QDataStream &stream)
 }
 
 
+ProcessOutputPacket::ProcessOutputPacket(quintptr token)
+    : LauncherPacket(LauncherPacketType::ProcessOutput, token)
+{
+}
+
+void ProcessOutputPacket::doSerialize(QDataStream &stream) const
+{
+    stream << stdOut << stdErr;
+}
+
+void ProcessOutputPacket::doDeserialize(QDataStream &stream)
+{
+    stream >> stdOut >> stdErr;
+}
+
+
 ProcessFinishedPacket::ProcessFinishedPacket(quintptr token)
     : LauncherPacket(LauncherPacketType::ProcessFinished, token)
 {
@@ -125,7 +141,8 @@ void ProcessFinishedPacket::doSerialize(QDataStream &stream) const
 {
     stream << errorString << stdOut << stdErr
            << static_cast<quint8>(exitStatus) << static_cast<quint8>(error)
-           << exitCode;
+           << exitCode << resourceUsage.wallTime << resourceUsage.userTime
+           << resourceUsage.systemTime << resourceUsage.peakResidentSetSize;
 }
 
 void ProcessFinishedPacket::doDeserialize(QDataStream &stream)
@@ -136,7 +153,8 @@ void ProcessFinishedPacket::doDeserialize(QDataStream &stream)
     exitStatus = static_cast<QProcess::ExitStatus>(val);
     stream >> val;
     error = static_cast<QProcess::ProcessError>(val);
-    stream >> exitCode;
+    stream >> exitCode >> resourceUsage.wallTime >> resourceUsage.userTime
+           >> resourceUsage.systemTime >> resourceUsage.peakResidentSetSize;
 }
 
 ShutdownPacket::ShutdownPacket() : LauncherPacket(LauncherPacketType::Shutdown, 0) { }
@@ -52,7 +52,18 @@ namespace qbs {
 namespace Internal {
 
 enum class LauncherPacketType {
-    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished
+    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished, ProcessOutput
+};
+
+// Times are in milliseconds, the peak resident set size is in bytes.
+// A value of -1 means that the information is not available.
+class ProcessResourceUsage
+{
+public:
+    qint64 wallTime = -1;
+    qint64 userTime = -1;
+    qint64 systemTime = -1;
+    qint64 peakResidentSetSize = -1;
 };
 
 class PacketParser
@@ -153,6 +164,22 @@ private:
     void doDeserialize(QDataStream &stream) override;
 };
 
+// Output that a process produced while running. Sent repeatedly, so that the launcher
+// does not have to accumulate all of it.
+class ProcessOutputPacket : public LauncherPacket
+{
+public:
+    ProcessOutputPacket(quintptr token);
+
+    QByteArray stdOut;
+    QByteArray stdErr;
+
+private:
+    void doSerialize(QDataStream &stream) const override;
+    void doDeserialize(QDataStream &stream) override;
+};
+
+// The output fields contain only what was not sent via ProcessOutputPacket before.
 class ProcessFinishedPacket : public LauncherPacket
 {
 public:
@@ -164,6 +191,7 @@ public:
     QProcess::ExitStatus exitStatus;
     QProcess::ProcessError error;
     int exitCode;
+    ProcessResourceUsage resourceUsage;
 
 private:
     void doSerialize(QDataStream &stream) const override;
@@ -0,0 +1,310 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "metrics.h"
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qstring.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace qbs {
+namespace Internal {
+
+std::atomic<bool> Metrics::m_enabled{false};
+
+namespace {
+
+// Bucket i holds the values in (2^(i-1), 2^i]; the last one also takes everything larger.
+const int histogramBucketCount = 32;
+
+struct GaugeData
+{
+    std::atomic<qint64> value{0};
+    std::atomic<qint64> peak{0};
+};
+
+struct HistogramData
+{
+    HistogramData() { clear(); }
+
+    void clear()
+    {
+        count = 0;
+        sum = 0;
+        min = std::numeric_limits<qint64>::max();
+        max = 0;
+        for (std::atomic<qint64> &bucket : buckets)
+            bucket = 0;
+    }
+
+    std::atomic<qint64> count;
+    std::atomic<qint64> sum;
+    std::atomic<qint64> min;
+    std::atomic<qint64> max;
+    std::atomic<qint64> buckets[histogramBucketCount];
+};
+
+struct PhaseData
+{
+    qint64 count = 0;
+    qint64 elapsedTime = 0;
+};
+
+const int counterCount = static_cast<int>(MetricsCounter::Count);
+const int gaugeCount = static_cast<int>(MetricsGauge::Count);
+const int histogramCount = static_cast<int>(MetricsHistogram::Count);
+
+std::atomic<qint64> counters[counterCount];
+GaugeData gauges[gaugeCount];
+HistogramData histograms[histogramCount];
+std::mutex phasesMutex;
+QHash<QString, PhaseData> phases;
+
+} // namespace
+
+static QString counterName(MetricsCounter counter)
+{
+    switch (counter) {
+    case MetricsCounter::StatCalls: return QStringLiteral("stat-calls");
+    case MetricsCounter::ScannerInvocations: return QStringLiteral("scanner-invocations");
+    case MetricsCounter::ScannerCacheHits: return QStringLiteral("scanner-cache-hits");
+    case MetricsCounter::ScriptEvaluations: return QStringLiteral("script-evaluations");
+    case MetricsCounter::RuleApplications: return QStringLiteral("rule-applications");
+    case MetricsCounter::CommandsSpawned: return QStringLiteral("commands-spawned");
+    case MetricsCounter::CommandOutputBytes: return QStringLiteral("command-output-bytes");
+    case MetricsCounter::CommandUserCpuTime: return QStringLiteral("command-user-cpu-time-ms");
+    case MetricsCounter::CommandSystemCpuTime:
+        return QStringLiteral("command-system-cpu-time-ms");
+    case MetricsCounter::GraphNodesLoaded: return QStringLiteral("graph-nodes-loaded");
+    case MetricsCounter::ProbesEncountered: return QStringLiteral("probes-encountered");
+    case MetricsCounter::ProbesRun: return QStringLiteral("probes-run");
+    case MetricsCounter::ProbesCachedCurrent: return QStringLiteral("probes-cached-current");
+    case MetricsCounter::ProbesCachedOld: return QStringLiteral("probes-cached-old");
+    case MetricsCounter::Count: break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+static QString gaugeName(MetricsGauge gauge)
+{
+    switch (gauge) {
+    case MetricsGauge::RunningCommands: return QStringLiteral("running-commands");
+    case MetricsGauge::Count: break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+static QString histogramName(MetricsHistogram histogram)
+{
+    switch (histogram) {
+    case MetricsHistogram::CommandDuration: return QStringLiteral("command-duration");
+    case MetricsHistogram::RuleApplicationDuration:
+        return QStringLiteral("rule-application-duration");
+    case MetricsHistogram::Count: break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+static int bucketIndex(qint64 value)
+{
+    if (value <= 1)
+        return 0;
+    const int index = 64 - int(qCountLeadingZeroBits(quint64(value - 1)));
+    return std::min(index, histogramBucketCount - 1);
+}
+
+static void updateMinimum(std::atomic<qint64> &target, qint64 value)
+{
+    qint64 current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value,
+                                                            std::memory_order_relaxed)) {
+    }
+}
+
+static void updateMaximum(std::atomic<qint64> &target, qint64 value)
+{
+    qint64 current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value,
+                                                            std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Metrics::reset()
+{
+    for (std::atomic<qint64> &counter : counters)
+        counter = 0;
+    for (GaugeData &gauge : gauges) {
+        gauge.value = 0;
+        gauge.peak = 0;
+    }
+    for (HistogramData &histogram : histograms)
+        histogram.clear();
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    phases.clear();
+}
+
+void Metrics::recordPhase(const QString &phase, qint64 elapsedTimeInMs)
+{
+    if (!isEnabled())
+        return;
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    PhaseData &data = phases[phase];
+    ++data.count;
+    data.elapsedTime += elapsedTimeInMs;
+}
+
+qint64 Metrics::counterValue(MetricsCounter counter)
+{
+    return counters[static_cast<int>(counter)].load(std::memory_order_relaxed);
+}
+
+qint64 Metrics::gaugeValue(MetricsGauge gauge)
+{
+    return gauges[static_cast<int>(gauge)].value.load(std::memory_order_relaxed);
+}
+
+qint64 Metrics::gaugePeakValue(MetricsGauge gauge)
+{
+    return gauges[static_cast<int>(gauge)].peak.load(std::memory_order_relaxed);
+}
+
+qint64 Metrics::histogramCount(MetricsHistogram histogram)
+{
+    return histograms[static_cast<int>(histogram)].count.load(std::memory_order_relaxed);
+}
+
+void Metrics::doAdd(MetricsCounter counter, qint64 value)
+{
+    counters[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Metrics::doChangeGauge(MetricsGauge gauge, qint64 delta)
+{
+    GaugeData &data = gauges[static_cast<int>(gauge)];
+    const qint64 newValue = data.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+    updateMaximum(data.peak, newValue);
+}
+
+void Metrics::doRecord(MetricsHistogram histogram, qint64 value)
+{
+    HistogramData &data = histograms[static_cast<int>(histogram)];
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.sum.fetch_add(value, std::memory_order_relaxed);
+    updateMinimum(data.min, value);
+    updateMaximum(data.max, value);
+    data.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+QByteArray Metrics::toJson()
+{
+    QJsonObject countersObject;
+    for (int i = 0; i < counterCount; ++i)
+        countersObject.insert(counterName(MetricsCounter(i)), counters[i].load());
+
+    QJsonObject gaugesObject;
+    for (int i = 0; i < gaugeCount; ++i) {
+        QJsonObject gaugeObject;
+        gaugeObject.insert(QStringLiteral("current"), gauges[i].value.load());
+        gaugeObject.insert(QStringLiteral("peak"), gauges[i].peak.load());
+        gaugesObject.insert(gaugeName(MetricsGauge(i)), gaugeObject);
+    }
+
+    QJsonObject histogramsObject;
+    for (int i = 0; i < histogramCount; ++i) {
+        const HistogramData &data = histograms[i];
+        const qint64 count = data.count.load();
+        QJsonObject histogramObject;
+        histogramObject.insert(QStringLiteral("unit"), QStringLiteral("us"));
+        histogramObject.insert(QStringLiteral("count"), count);
+        histogramObject.insert(QStringLiteral("sum"), data.sum.load());
+        histogramObject.insert(QStringLiteral("min"), count > 0 ? data.min.load() : 0);
+        histogramObject.insert(QStringLiteral("max"), data.max.load());
+        QJsonArray buckets;
+        for (int b = 0; b < histogramBucketCount; ++b) {
+            const qint64 bucketCount = data.buckets[b].load();
+            if (bucketCount == 0)
+                continue;
+            QJsonObject bucket;
+            if (b == histogramBucketCount - 1)
+                bucket.insert(QStringLiteral("upper-bound"), QStringLiteral("inf"));
+            else
+                bucket.insert(QStringLiteral("upper-bound"), qint64(1) << b);
+            bucket.insert(QStringLiteral("count"), bucketCount);
+            buckets.append(bucket);
+        }
+        histogramObject.insert(QStringLiteral("buckets"), buckets);
+        histogramsObject.insert(histogramName(MetricsHistogram(i)), histogramObject);
+    }
+
+    QJsonObject phasesObject;
+    {
+        std::lock_guard<std::mutex> lock(phasesMutex);
+        for (auto it = phases.cbegin(); it != phases.cend(); ++it) {
+            QJsonObject phaseObject;
+            phaseObject.insert(QStringLiteral("count"), it.value().count);
+            phaseObject.insert(QStringLiteral("elapsed-ms"), it.value().elapsedTime);
+            phasesObject.insert(it.key(), phaseObject);
+        }
+    }
+
+    QJsonObject metrics;
+    metrics.insert(QStringLiteral("counters"), countersObject);
+    metrics.insert(QStringLiteral("gauges"), gaugesObject);
+    metrics.insert(QStringLiteral("histograms"), histogramsObject);
+    metrics.insert(QStringLiteral("phases"), phasesObject);
+    return QJsonDocument(metrics).toJson();
+}
+
+} // namespace Internal
+} // namespace qbs
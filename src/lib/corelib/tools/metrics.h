@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_METRICS_H
+#define QBS_METRICS_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qglobal.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+class QString;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+enum class MetricsCounter
+{
+    StatCalls,
+    ScannerInvocations,
+    ScannerCacheHits,
+    ScriptEvaluations, // Only source code passed to ScriptEngine::evaluate(), not function calls.
+    RuleApplications,
+    CommandsSpawned,
+    CommandOutputBytes,
+    CommandUserCpuTime,
+    CommandSystemCpuTime,
+    GraphNodesLoaded,
+    ProbesEncountered,
+    ProbesRun,
+    ProbesCachedCurrent,
+    ProbesCachedOld,
+    Count
+};
+
+enum class MetricsGauge
+{
+    RunningCommands,
+    Count
+};
+
+// Histogram values are durations in microseconds.
+enum class MetricsHistogram
+{
+    CommandDuration,
+    RuleApplicationDuration,
+    Count
+};
+
+// Process-wide registry of counters, gauges and histograms. All recording functions are
+// thread-safe and reduce to a single relaxed atomic load while the registry is disabled,
+// so they can be called from hot paths unconditionally.
+class QBS_EXPORT Metrics
+{
+public:
+    static bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    static void reset();
+
+    static void add(MetricsCounter counter, qint64 value = 1)
+    {
+        if (isEnabled())
+            doAdd(counter, value);
+    }
+    static void changeGauge(MetricsGauge gauge, qint64 delta)
+    {
+        if (isEnabled())
+            doChangeGauge(gauge, delta);
+    }
+    static void record(MetricsHistogram histogram, qint64 value)
+    {
+        if (isEnabled())
+            doRecord(histogram, value);
+    }
+    static void recordPhase(const QString &phase, qint64 elapsedTimeInMs);
+
+    static qint64 counterValue(MetricsCounter counter);
+    static qint64 gaugeValue(MetricsGauge gauge);
+    static qint64 gaugePeakValue(MetricsGauge gauge);
+    static qint64 histogramCount(MetricsHistogram histogram);
+
+    static QByteArray toJson();
+
+private:
+    static void doAdd(MetricsCounter counter, qint64 value);
+    static void doChangeGauge(MetricsGauge gauge, qint64 delta);
+    static void doRecord(MetricsHistogram histogram, qint64 value);
+
+    static std::atomic<bool> m_enabled;
+};
+
+// Records the time between construction and destruction into a histogram.
+// Does not even start the timer if metrics are disabled.
+class MetricsTimer
+{
+public:
+    explicit MetricsTimer(MetricsHistogram histogram) : m_histogram(histogram)
+    {
+        if (Metrics::isEnabled())
+            m_timer.start();
+    }
+    ~MetricsTimer()
+    {
+        if (m_timer.isValid())
+            Metrics::record(m_histogram, m_timer.nsecsElapsed() / 1000);
+    }
+
+private:
+    const MetricsHistogram m_histogram;
+    QElapsedTimer m_timer;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_METRICS_H
@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBS_PARALLELFOR_H
+#define QBS_PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// Calls function(i) for every i in [0, count), distributing the calls over up to
+// maxThreadCount threads, one of which is the calling thread.
+// The function must be safe to call concurrently for different indexes.
+// If it throws, no further indexes are processed and the first exception is rethrown
+// in the calling thread after all other threads have finished.
+template<typename Function>
+void parallelFor(std::size_t count, int maxThreadCount, const Function &function)
+{
+    const std::size_t threadCount
+            = std::min(count, static_cast<std::size_t>(std::max(maxThreadCount, 1)));
+    if (threadCount <= 1) {
+        for (std::size_t i = 0; i < count; ++i)
+            function(i);
+        return;
+    }
+
+    std::atomic<std::size_t> nextIndex(0);
+    std::exception_ptr firstException;
+    std::mutex exceptionMutex;
+    const auto worker = [&] {
+        for (std::size_t i = nextIndex++; i < count; i = nextIndex++) {
+            try {
+                function(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!firstException)
+                    firstException = std::current_exception();
+                nextIndex = count;
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+    if (firstException)
+        std::rethrow_exception(firstException);
+}
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PARALLELFOR_H
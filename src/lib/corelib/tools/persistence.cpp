@@ -44,11 +44,12 @@
 #include <tools/error.h>
 
 #include <QtCore/qdir.h>
+#include <QtCore/qsavefile.h>
 
 namespace qbs {
 namespace Internal {
 
-static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-120";
+static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-123";
 
 NoBuildGraphError::NoBuildGraphError(const QString &filePath)
     : ErrorInfo(Tr::tr("Build graph not found for configuration '%1'. Expected location was '%2'.")
@@ -105,12 +106,9 @@ void PersistentPool::setupWriteStream(const QString &filePath)
                         .arg(dirPath));
     }
 
-    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
-        throw ErrorInfo(Tr::tr("Failure storing build graph: Cannot remove old file '%1'")
-                        .arg(filePath));
-    }
-    QBS_CHECK(!QFile::exists(filePath));
-    std::unique_ptr<QFile> file(new QFile(filePath));
+    // The old file gets replaced only once the new one has been written completely, so there
+    // is always a consistent build graph on disk, even if we crash or get killed in between.
+    std::unique_ptr<QSaveFile> file(new QSaveFile(filePath));
     if (!file->open(QFile::WriteOnly)) {
         throw ErrorInfo(Tr::tr("Failure storing build graph: "
                 "Cannot open file '%1' for writing: %2").arg(filePath, file->errorString()));
@@ -132,12 +130,9 @@ void PersistentPool::finalizeWriteStream()
     m_stream << QByteArray(QBS_PERSISTENCE_MAGIC);
     if (m_stream.status() != QDataStream::Ok)
         throw ErrorInfo(Tr::tr("Failure serializing build graph."));
-    const auto file = static_cast<QFile *>(m_stream.device());
-    if (!file->flush()) {
-        file->close();
-        file->remove();
+    const auto file = static_cast<QSaveFile *>(m_stream.device());
+    if (!file->commit())
         throw ErrorInfo(Tr::tr("Failure serializing build graph: %1").arg(file->errorString()));
-    }
 }
 
 void PersistentPool::closeStream()
@@ -41,6 +41,7 @@
 #define QBS_PERSISTENCE
 
 #include "error.h"
+#include "qbs_export.h"
 #include <logging/logger.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
@@ -70,7 +71,7 @@ public:
 template<typename T, typename Enable = void>
 struct PPHelper;
 
-class PersistentPool
+class QBS_AUTOTEST_EXPORT PersistentPool
 {
 public:
     PersistentPool(Logger &logger);
@@ -129,4 +129,40 @@ QStringList ProcessResult::stdErr() const
     return d->stdErr;
 }
 
+/*!
+ * \brief Returns the wall-clock time in milliseconds that the command took to run,
+ *        or -1 if it is not known.
+ */
+qint64 ProcessResult::elapsedTime() const
+{
+    return d->elapsedTime;
+}
+
+/*!
+ * \brief Returns the CPU time in milliseconds that the command spent in user mode,
+ *        or -1 if it is not known.
+ */
+qint64 ProcessResult::userCpuTime() const
+{
+    return d->userCpuTime;
+}
+
+/*!
+ * \brief Returns the CPU time in milliseconds that the command spent in kernel mode,
+ *        or -1 if it is not known.
+ */
+qint64 ProcessResult::systemCpuTime() const
+{
+    return d->systemCpuTime;
+}
+
+/*!
+ * \brief Returns the maximum amount of physical memory in bytes that the command used,
+ *        or -1 if it is not known.
+ */
+qint64 ProcessResult::peakResidentSetSize() const
+{
+    return d->peakResidentSetSize;
+}
+
 } // namespace qbs
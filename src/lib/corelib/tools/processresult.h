@@ -74,6 +74,11 @@ public:
     QStringList stdOut() const;
     QStringList stdErr() const;
 
+    qint64 elapsedTime() const;
+    qint64 userCpuTime() const;
+    qint64 systemCpuTime() const;
+    qint64 peakResidentSetSize() const;
+
 private:
     QExplicitlySharedDataPointer<Internal::ProcessResultPrivate> d;
 };
@@ -58,6 +58,11 @@ public:
     int exitCode;
     QStringList stdOut;
     QStringList stdErr;
+
+    qint64 elapsedTime = -1;
+    qint64 userCpuTime = -1;
+    qint64 systemCpuTime = -1;
+    qint64 peakResidentSetSize = -1;
 };
 
 } // namespace Internal
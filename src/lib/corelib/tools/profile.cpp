@@ -39,6 +39,7 @@
 #include "profile.h"
 #include "qbsassert.h"
 #include "settings.h"
+#include "settingssnapshot.h"
 #include "stringconstants.h"
 
 #include <logging/translator.h>
@@ -83,6 +84,12 @@ bool Profile::exists() const
  */
 QVariant Profile::value(const QString &key, const QVariant &defaultValue, ErrorInfo *error) const
 {
+    if (m_profiles.empty()) {
+        const Internal::SettingsSnapshot * const snapshot = m_settings->snapshot();
+        const QVariantMap * const values = snapshot ? snapshot->flattenedProfile(m_name) : nullptr;
+        if (values)
+            return values->value(key, defaultValue);
+    }
     try {
         return possiblyInheritedValue(key, defaultValue, QStringList());
     } catch (const ErrorInfo &e) {
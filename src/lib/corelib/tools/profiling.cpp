@@ -39,6 +39,8 @@
 
 #include "profiling.h"
 
+#include "metrics.h"
+
 #include <logging/logger.h>
 #include <logging/translator.h>
 
@@ -53,18 +55,21 @@ public:
     Logger logger;
     QString activity;
     QElapsedTimer timer;
+    bool logging = false;
 };
 
 TimedActivityLogger::TimedActivityLogger(const Logger &logger, const QString &activity,
         bool enabled)
     : d(nullptr)
 {
-    if (!enabled)
+    if (!enabled && !Metrics::isEnabled())
         return;
     d = new TimedActivityLoggerPrivate;
     d->logger = logger;
     d->activity = activity;
-    d->logger.qbsLog(LoggerInfo, true) << Tr::tr("Starting activity '%2'.").arg(activity);
+    d->logging = enabled;
+    if (enabled)
+        d->logger.qbsLog(LoggerInfo, true) << Tr::tr("Starting activity '%2'.").arg(activity);
     d->timer.start();
 }
 
@@ -72,9 +77,12 @@ void TimedActivityLogger::finishActivity()
 {
     if (!d)
         return;
-    const QString timeString = elapsedTimeString(d->timer.elapsed());
-    d->logger.qbsLog(LoggerInfo, true)
-            << Tr::tr("Activity '%2' took %3.").arg(d->activity, timeString);
+    const qint64 elapsedTime = d->timer.elapsed();
+    Metrics::recordPhase(d->activity, elapsedTime);
+    if (d->logging) {
+        d->logger.qbsLog(LoggerInfo, true) << Tr::tr("Activity '%2' took %3.")
+                                              .arg(d->activity, elapsedTimeString(elapsedTime));
+    }
     delete d;
     d = nullptr;
 }
@@ -70,6 +70,9 @@ void QbsProcess::start(const QString &command, const QStringList &arguments)
     }
     m_command = command;
     m_arguments = arguments;
+    m_resourceUsage = ProcessResourceUsage();
+    m_stdout.clear();
+    m_stderr.clear();
     m_state = QProcess::Starting;
     if (LauncherInterface::socket()->isReady())
         doStart();
@@ -133,6 +136,9 @@ void QbsProcess::handlePacket(LauncherPacketType type, quintptr token, const QBy
     case LauncherPacketType::ProcessError:
         handleErrorPacket(payload);
         break;
+    case LauncherPacketType::ProcessOutput:
+        handleOutputPacket(payload);
+        break;
     case LauncherPacketType::ProcessFinished:
         handleFinishedPacket(payload);
         break;
@@ -169,15 +175,30 @@ void QbsProcess::handleErrorPacket(const QByteArray &packetData)
     emit error(m_error);
 }
 
+void QbsProcess::handleOutputPacket(const QByteArray &packetData)
+{
+    QBS_ASSERT(m_state == QProcess::Running, return);
+    const auto packet = LauncherPacket::extractPacket<ProcessOutputPacket>(token(), packetData);
+    if (!packet.stdOut.isEmpty()) {
+        m_stdout.append(packet.stdOut);
+        emit readyReadStandardOutput();
+    }
+    if (!packet.stdErr.isEmpty()) {
+        m_stderr.append(packet.stdErr);
+        emit readyReadStandardError();
+    }
+}
+
 void QbsProcess::handleFinishedPacket(const QByteArray &packetData)
 {
     QBS_ASSERT(m_state == QProcess::Running, return);
     m_state = QProcess::NotRunning;
     const auto packet = LauncherPacket::extractPacket<ProcessFinishedPacket>(token(), packetData);
     m_exitCode = packet.exitCode;
-    m_stdout = packet.stdOut;
-    m_stderr = packet.stdErr;
+    m_stdout.append(packet.stdOut);
+    m_stderr.append(packet.stdErr);
     m_errorString = packet.errorString;
+    m_resourceUsage = packet.resourceUsage;
     emit finished(m_exitCode);
 }
 
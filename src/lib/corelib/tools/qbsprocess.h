@@ -67,9 +67,12 @@ public:
     int exitCode() const { return m_exitCode; }
     QProcess::ProcessError error() const { return m_error; }
     QString errorString() const { return m_errorString; }
+    ProcessResourceUsage resourceUsage() const { return m_resourceUsage; }
 
 signals:
     void error(QProcess::ProcessError error);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
     void finished(int exitCode);
 
 private:
@@ -81,6 +84,7 @@ private:
     void handlePacket(qbs::Internal::LauncherPacketType type, quintptr token,
                       const QByteArray &payload);
     void handleErrorPacket(const QByteArray &packetData);
+    void handleOutputPacket(const QByteArray &packetData);
     void handleFinishedPacket(const QByteArray &packetData);
     void handleSocketReady();
 
@@ -93,6 +97,7 @@ private:
     QByteArray m_stdout;
     QByteArray m_stderr;
     QString m_errorString;
+    ProcessResourceUsage m_resourceUsage;
     QProcess::ProcessError m_error = QProcess::UnknownError;
     QProcess::ProcessState m_state = QProcess::NotRunning;
     int m_exitCode;
@@ -149,6 +149,7 @@ public:
 #endif
 
     static Set<T> fromStdVector(const std::vector<T> &vector);
+    static Set<T> fromSortedStdVector(const std::vector<T> &vector);
     static Set<T> fromStdSet(const std::set<T> &set);
     std::set<T> toStdSet() const;
 
@@ -325,6 +326,14 @@ template<typename T> Set<T> Set<T>::fromStdVector(const std::vector<T> &vector)
     return s;
 }
 
+// The vector must be sorted and free of duplicates.
+template<typename T> Set<T> Set<T>::fromSortedStdVector(const std::vector<T> &vector)
+{
+    Set<T> s;
+    s.m_data = vector;
+    return s;
+}
+
 template<typename T> Set<T> Set<T>::fromStdSet(const std::set<T> &set)
 {
     Set<T> s;
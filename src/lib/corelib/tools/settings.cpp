@@ -42,11 +42,14 @@
 #include "error.h"
 #include "profile.h"
 #include "settingscreator.h"
+#include "settingssnapshot.h"
 
 #include <logging/translator.h>
 #include <tools/hostosinfo.h>
 #include <tools/stringconstants.h>
 
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qsettings.h>
 
 #include <algorithm>
@@ -87,33 +90,39 @@ static QString systemSettingsBaseDir()
 #endif
 }
 
+static QString useSettingsCacheKey() { return QStringLiteral("preferences.useSettingsCache"); }
+
 Settings::Settings(const QString &baseDir) : Settings(baseDir, systemSettingsBaseDir()) { }
 
 Settings::Settings(const QString &baseDir, const QString &systemBaseDir)
-    : m_settings(SettingsCreator(baseDir).getQSettings()),
-      m_systemSettings(new QSettings(systemBaseDir + QStringLiteral("/qbs.conf"),
-                                     QSettings::IniFormat)),
+    : m_settingsFilePath(QFileInfo(SettingsCreator(baseDir).settingsFilePath())
+                         .absoluteFilePath()),
+      m_systemSettingsFilePath(QFileInfo(systemBaseDir + QStringLiteral("/qbs.conf"))
+                               .absoluteFilePath()),
       m_baseDir(baseDir)
 {
-    // Actual qbs settings are stored transparently within a group, because QSettings
-    // can see non-qbs fallback settings e.g. from QtProject that we're not interested in.
-    m_settings->beginGroup(QStringLiteral("org/qt-project/qbs"));
+    // Without a snapshot file, the cache is most likely disabled, and there is no point
+    // in hashing the settings files.
+    if (QFile::exists(snapshotFilePath())) {
+        m_snapshot = SettingsSnapshot::load(snapshotFilePath(), snapshotSourceState());
+        if (m_snapshot)
+            return;
+    }
+    updateSnapshot();
 }
 
 Settings::~Settings()
 {
-    delete m_settings;
-    delete m_systemSettings;
 }
 
 QVariant Settings::value(const QString &key, Scopes scopes, const QVariant &defaultValue) const
 {
     QVariant userValue;
     if (scopes & UserScope)
-        userValue = m_settings->value(internalRepresentation(key));
+        userValue = valueInScope(internalRepresentation(key), UserScope);
     QVariant systemValue;
     if (scopes & SystemScope)
-        systemValue = m_systemSettings->value(internalRepresentation(key));
+        systemValue = valueInScope(internalRepresentation(key), SystemScope);
     if (!userValue.isValid()) {
         if (systemValue.isValid())
             return systemValue;
@@ -132,20 +141,25 @@ QStringList Settings::allKeys(Scopes scopes) const
 {
     QStringList keys;
     if (scopes & UserScope)
-        keys = m_settings->allKeys();
+        keys = allKeysInScope(QString(), UserScope);
     if (scopes & SystemScope)
-        keys += m_systemSettings->allKeys();
+        keys += allKeysInScope(QString(), SystemScope);
     fixupKeys(keys);
     return keys;
 }
 
 QStringList Settings::directChildren(const QString &parentGroup, Scope scope) const
 {
-    QSettings * const settings = settingsForScope(scope);
-    settings->beginGroup(internalRepresentation(parentGroup));
-    QStringList children = settings->childGroups();
-    children << settings->childKeys();
-    settings->endGroup();
+    QStringList children;
+    if (m_snapshot) {
+        children = m_snapshot->directChildren(internalRepresentation(parentGroup), scope);
+    } else {
+        QSettings * const settings = settingsForScope(scope);
+        settings->beginGroup(internalRepresentation(parentGroup));
+        children = settings->childGroups();
+        children << settings->childKeys();
+        settings->endGroup();
+    }
     fixupKeys(children);
     return children;
 }
@@ -153,16 +167,10 @@ QStringList Settings::directChildren(const QString &parentGroup, Scope scope) co
 QStringList Settings::allKeysWithPrefix(const QString &group, Scopes scopes) const
 {
     QStringList keys;
-    if (scopes & UserScope) {
-        m_settings->beginGroup(internalRepresentation(group));
-        keys = m_settings->allKeys();
-        m_settings->endGroup();
-    }
-    if (scopes & SystemScope) {
-        m_systemSettings->beginGroup(internalRepresentation(group));
-        keys += m_systemSettings->allKeys();
-        m_systemSettings->endGroup();
-    }
+    if (scopes & UserScope)
+        keys = allKeysInScope(internalRepresentation(group), UserScope);
+    if (scopes & SystemScope)
+        keys += allKeysInScope(internalRepresentation(group), SystemScope);
     fixupKeys(keys);
     return keys;
 }
@@ -174,24 +182,25 @@ void Settings::setValue(const QString &key, const QVariant &value)
                         .arg(Profile::fallbackName()));
     }
     targetForWriting()->setValue(internalRepresentation(key), value);
-    checkForWriteError();
+    valuesChanged();
 }
 
 void Settings::remove(const QString &key)
 {
     targetForWriting()->remove(internalRepresentation(key));
-    checkForWriteError();
+    valuesChanged();
 }
 
 void Settings::clear()
 {
     targetForWriting()->clear();
-    checkForWriteError();
+    valuesChanged();
 }
 
 void Settings::sync()
 {
-    targetForWriting()->sync();
+    if (!m_snapshot)
+        targetForWriting()->sync();
 }
 
 QString Settings::defaultProfile() const
@@ -202,21 +211,25 @@ QString Settings::defaultProfile() const
 QStringList Settings::profiles() const
 {
     QStringList result;
-    if (m_scopeForWriting == UserScope) {
-        m_settings->beginGroup(StringConstants::profilesSettingsKey());
-        result = m_settings->childGroups();
-        m_settings->endGroup();
+    for (const Scope scope : {UserScope, SystemScope}) {
+        if (scope == UserScope && m_scopeForWriting != UserScope)
+            continue;
+        if (m_snapshot) {
+            result += m_snapshot->childGroups(StringConstants::profilesSettingsKey(), scope);
+        } else {
+            QSettings * const settings = settingsForScope(scope);
+            settings->beginGroup(StringConstants::profilesSettingsKey());
+            result += settings->childGroups();
+            settings->endGroup();
+        }
     }
-    m_systemSettings->beginGroup(StringConstants::profilesSettingsKey());
-    result += m_systemSettings->childGroups();
-    m_systemSettings->endGroup();
     result.removeDuplicates();
     return result;
 }
 
 QString Settings::fileName() const
 {
-    return targetForWriting()->fileName();
+    return m_scopeForWriting == UserScope ? m_settingsFilePath : m_systemSettingsFilePath;
 }
 
 QString Settings::internalRepresentation(const QString &externalKey) const
@@ -239,9 +252,39 @@ void Settings::fixupKeys(QStringList &keys) const
         key = externalRepresentation(key);
 }
 
+QVariant Settings::valueInScope(const QString &internalKey, Scope scope) const
+{
+    if (m_snapshot)
+        return m_snapshot->value(internalKey, scope);
+    return settingsForScope(scope)->value(internalKey);
+}
+
+QStringList Settings::allKeysInScope(const QString &internalGroup, Scope scope) const
+{
+    if (m_snapshot)
+        return m_snapshot->allKeys(internalGroup, scope);
+    QSettings * const settings = settingsForScope(scope);
+    settings->beginGroup(internalGroup);
+    const QStringList keys = settings->allKeys();
+    settings->endGroup();
+    return keys;
+}
+
 QSettings *Settings::settingsForScope(Settings::Scope scope) const
 {
-    return scope == UserScope ? m_settings : m_systemSettings;
+    if (scope == SystemScope) {
+        if (!m_systemSettings)
+            m_systemSettings.reset(new QSettings(m_systemSettingsFilePath, QSettings::IniFormat));
+        return m_systemSettings.get();
+    }
+    if (!m_settings) {
+        m_settings.reset(SettingsCreator(m_baseDir).getQSettings());
+
+        // Actual qbs settings are stored transparently within a group, because QSettings
+        // can see non-qbs fallback settings e.g. from QtProject that we're not interested in.
+        m_settings->beginGroup(QStringLiteral("org/qt-project/qbs"));
+    }
+    return m_settings.get();
 }
 
 QSettings *Settings::targetForWriting() const
@@ -260,4 +303,59 @@ void Settings::checkForWriteError()
     }
 }
 
+// The snapshot does not see changes, so from now on everything is read from the settings
+// files. It gets rebuilt by the next Settings object created after the changes were written.
+void Settings::valuesChanged()
+{
+    m_snapshot.reset();
+    checkForWriteError();
+}
+
+QString Settings::snapshotFilePath() const
+{
+    return m_settingsFilePath + QLatin1String(".cache");
+}
+
+QByteArray Settings::snapshotSourceState() const
+{
+    return SettingsSnapshot::sourceState(QStringList{m_settingsFilePath,
+                                                     m_systemSettingsFilePath});
+}
+
+void Settings::updateSnapshot()
+{
+    const QString filePath = snapshotFilePath();
+    if (!value(useSettingsCacheKey(), allScopes()).toBool()) {
+        if (QFile::exists(filePath))
+            QFile::remove(filePath);
+        return;
+    }
+
+    // The state is determined before the settings files are read, so that a change
+    // happening in between leaves us with an outdated snapshot rather than a wrong one.
+    const QByteArray sourceState = snapshotSourceState();
+
+    m_snapshot = SettingsSnapshot::create(settingsForScope(UserScope),
+                                          settingsForScope(SystemScope));
+
+    // Profile lookups are served from the snapshot, so the resolved values are exactly
+    // the ones that would be found by walking up the base profiles.
+    const QStringList profileNames = profiles();
+    for (const QString &profileName : profileNames) {
+        const Profile profile(profileName, this);
+        ErrorInfo error;
+        const QStringList keys = profile.allKeys(Profile::KeySelectionRecursive, &error);
+        if (error.hasError())
+            continue; // Reported when the profile gets used.
+        QVariantMap values;
+        for (const QString &key : keys)
+            values.insert(key, profile.value(key));
+        const QString baseProfile = profile.baseProfile();
+        if (!baseProfile.isEmpty())
+            values.insert(StringConstants::baseProfileProperty(), baseProfile);
+        m_snapshot->setFlattenedProfile(profileName, values);
+    }
+    m_snapshot->save(filePath, sourceState);
+}
+
 } // namespace qbs
@@ -45,12 +45,15 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 class QSettings;
 class QStringList;
 QT_END_NAMESPACE
 
 namespace qbs {
+namespace Internal { class SettingsSnapshot; }
 
 class QBS_EXPORT Settings
 {
@@ -85,15 +88,30 @@ public:
     QString baseDirectory() const { return m_baseDir; } // As passed into the constructor.
 
 private:
+    friend class Profile;
+
     QString internalRepresentation(const QString &externalKey) const;
     QString externalRepresentation(const QString &internalKey) const;
     void fixupKeys(QStringList &keys) const;
+    QVariant valueInScope(const QString &internalKey, Scope scope) const;
+    QStringList allKeysInScope(const QString &internalGroup, Scope scope) const;
     QSettings *settingsForScope(Scope scope) const;
     QSettings *targetForWriting() const;
     void checkForWriteError();
-
-    QSettings * const m_settings;
-    QSettings * const m_systemSettings;
+    void valuesChanged();
+
+    QString snapshotFilePath() const;
+    QByteArray snapshotSourceState() const;
+    void updateSnapshot();
+    const Internal::SettingsSnapshot *snapshot() const { return m_snapshot.get(); }
+
+    // The QSettings objects are only created when needed, that is, when writing or when
+    // the settings cannot be served from the snapshot.
+    mutable std::unique_ptr<QSettings> m_settings;
+    mutable std::unique_ptr<QSettings> m_systemSettings;
+    std::unique_ptr<Internal::SettingsSnapshot> m_snapshot;
+    const QString m_settingsFilePath;
+    const QString m_systemSettingsFilePath;
     const QString m_baseDir;
     Scope m_scopeForWriting = UserScope;
 };
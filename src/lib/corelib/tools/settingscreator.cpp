@@ -121,8 +121,16 @@ void SettingsCreator::migrate()
     }
 }
 
-void SettingsCreator::createQSettings()
+QString SettingsCreator::settingsFilePath()
 {
+    determineFilePaths();
+    return m_newSettingsFilePath;
+}
+
+void SettingsCreator::determineFilePaths()
+{
+    if (!m_newSettingsFilePath.isEmpty())
+        return;
     std::unique_ptr<QSettings> tmp(m_settingsBaseDir.isEmpty()
             ? new QSettings(format(), QSettings::UserScope, QLatin1String("QtProject"),
                             QLatin1String("qbs"))
@@ -132,7 +140,12 @@ void SettingsCreator::createQSettings()
     m_newSettingsDir = m_settingsBaseDir + QLatin1String("/qbs/") + m_qbsVersion.toString();
     m_settingsFileName = fi.fileName();
     m_newSettingsFilePath = m_newSettingsDir + QLatin1Char('/') + m_settingsFileName;
-    m_settings.reset(new QSettings(m_newSettingsFilePath, tmp->format()));
+}
+
+void SettingsCreator::createQSettings()
+{
+    determineFilePaths();
+    m_settings.reset(new QSettings(m_newSettingsFilePath, format()));
 }
 
 Version SettingsCreator::predecessor() const
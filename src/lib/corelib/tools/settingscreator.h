@@ -59,9 +59,11 @@ public:
     SettingsCreator(const QString &baseDir);
 
     QSettings *getQSettings();
+    QString settingsFilePath();
 
 private:
     void migrate();
+    void determineFilePaths();
     void createQSettings();
     Version predecessor() const;
 
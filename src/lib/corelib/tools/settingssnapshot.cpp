@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "settingssnapshot.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qsettings.h>
+
+#include <limits>
+
+namespace qbs {
+namespace Internal {
+
+static const quint32 snapshotMagic = 0x51425353;
+static const quint32 snapshotFormatVersion = 2;
+static const QDataStream::Version streamVersion = QDataStream::Qt_5_6;
+
+// Timestamps are too coarse on some file systems to detect a change that happens right after
+// the snapshot was created, so we look at the contents. The settings files are small, so that
+// is still much cheaper than parsing them.
+QByteArray SettingsSnapshot::sourceState(const QStringList &sourceFilePaths)
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(streamVersion);
+    for (const QString &filePath : sourceFilePaths) {
+        stream << filePath;
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            stream << qint64(-1) << QByteArray();
+            continue;
+        }
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        if (!hash.addData(&file))
+            return QByteArray(); // Unknown state, see load() and save().
+        stream << file.size() << hash.result();
+    }
+    return state;
+}
+
+static void readAllValues(QSettings *settings, QMap<QString, QVariant> &values)
+{
+    const QStringList keys = settings->allKeys();
+    for (const QString &key : keys)
+        values.insert(key, settings->value(key));
+}
+
+std::unique_ptr<SettingsSnapshot> SettingsSnapshot::create(QSettings *userSettings,
+                                                           QSettings *systemSettings)
+{
+    std::unique_ptr<SettingsSnapshot> snapshot(new SettingsSnapshot);
+    readAllValues(userSettings, snapshot->m_userValues);
+    readAllValues(systemSettings, snapshot->m_systemValues);
+    return snapshot;
+}
+
+std::unique_ptr<SettingsSnapshot> SettingsSnapshot::load(const QString &filePath,
+                                                         const QByteArray &expectedSourceState)
+{
+    if (expectedSourceState.isEmpty())
+        return nullptr;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+    const qint64 size = file.size();
+    const uchar * const data = size > 0 && size <= std::numeric_limits<int>::max()
+            ? file.map(0, size) : nullptr;
+    if (!data)
+        return nullptr;
+    QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char *>(data),
+                                               int(size)));
+    stream.setVersion(streamVersion);
+    quint32 magic;
+    quint32 formatVersion;
+    QByteArray state;
+    stream >> magic >> formatVersion;
+    if (magic != snapshotMagic || formatVersion != snapshotFormatVersion)
+        return nullptr;
+    stream >> state;
+    if (state != expectedSourceState)
+        return nullptr;
+    std::unique_ptr<SettingsSnapshot> snapshot(new SettingsSnapshot);
+    stream >> snapshot->m_userValues >> snapshot->m_systemValues
+           >> snapshot->m_flattenedProfiles;
+    if (stream.status() != QDataStream::Ok)
+        return nullptr;
+    return snapshot;
+}
+
+bool SettingsSnapshot::save(const QString &filePath, const QByteArray &sourceState) const
+{
+    if (sourceState.isEmpty())
+        return false;
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(streamVersion);
+    stream << snapshotMagic << snapshotFormatVersion << sourceState
+           << m_userValues << m_systemValues << m_flattenedProfiles;
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+const SettingsSnapshot::ValueMap &SettingsSnapshot::values(Settings::Scope scope) const
+{
+    return scope == Settings::UserScope ? m_userValues : m_systemValues;
+}
+
+template<typename Function>
+void SettingsSnapshot::forEachKeyInGroup(const QString &group, Settings::Scope scope,
+                                         const Function &function) const
+{
+    const ValueMap &map = values(scope);
+    const QString prefix = group.isEmpty() ? group : group + QLatin1Char('/');
+    for (auto it = map.lowerBound(prefix); it != map.cend() && it.key().startsWith(prefix); ++it)
+        function(it.key().mid(prefix.size()));
+}
+
+QVariant SettingsSnapshot::value(const QString &key, Settings::Scope scope) const
+{
+    return values(scope).value(key);
+}
+
+QStringList SettingsSnapshot::allKeys(const QString &group, Settings::Scope scope) const
+{
+    QStringList keys;
+    forEachKeyInGroup(group, scope, [&keys](const QString &relativeKey) {
+        keys << relativeKey;
+    });
+    return keys;
+}
+
+QStringList SettingsSnapshot::directChildren(const QString &group, Settings::Scope scope) const
+{
+    QStringList children;
+    forEachKeyInGroup(group, scope, [&children](const QString &relativeKey) {
+        children << relativeKey.left(relativeKey.indexOf(QLatin1Char('/')));
+    });
+    children.sort();
+    children.removeDuplicates();
+    return children;
+}
+
+QStringList SettingsSnapshot::childGroups(const QString &group, Settings::Scope scope) const
+{
+    QStringList groups;
+    forEachKeyInGroup(group, scope, [&groups](const QString &relativeKey) {
+        const int slashIndex = relativeKey.indexOf(QLatin1Char('/'));
+        if (slashIndex != -1)
+            groups << relativeKey.left(slashIndex);
+    });
+    groups.sort();
+    groups.removeDuplicates();
+    return groups;
+}
+
+void SettingsSnapshot::setFlattenedProfile(const QString &profileName, const QVariantMap &values)
+{
+    m_flattenedProfiles.insert(profileName, values);
+}
+
+const QVariantMap *SettingsSnapshot::flattenedProfile(const QString &profileName) const
+{
+    const auto it = m_flattenedProfiles.constFind(profileName);
+    return it != m_flattenedProfiles.constEnd() ? &it.value() : nullptr;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_SETTINGSSNAPSHOT_H
+#define QBS_SETTINGSSNAPSHOT_H
+
+#include "settings.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvariant.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QSettings;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// A read-only copy of the user and system settings that is stored in a binary file and can
+// be loaded much faster than the settings files can be parsed. The keys are sorted, so that
+// group queries do not need to look at all keys. In addition, the values of all profiles can
+// be stored with their inheritance chains already resolved.
+// The snapshot remembers the state of the settings files it was created from and is rejected
+// when loading it if any of them has changed since.
+class SettingsSnapshot
+{
+public:
+    static QByteArray sourceState(const QStringList &sourceFilePaths);
+
+    static std::unique_ptr<SettingsSnapshot> create(QSettings *userSettings,
+                                                    QSettings *systemSettings);
+    static std::unique_ptr<SettingsSnapshot> load(const QString &filePath,
+                                                  const QByteArray &expectedSourceState);
+    bool save(const QString &filePath, const QByteArray &sourceState) const;
+
+    QVariant value(const QString &key, Settings::Scope scope) const;
+    QStringList allKeys(const QString &group, Settings::Scope scope) const;
+    QStringList directChildren(const QString &group, Settings::Scope scope) const;
+    QStringList childGroups(const QString &group, Settings::Scope scope) const;
+
+    void setFlattenedProfile(const QString &profileName, const QVariantMap &values);
+    const QVariantMap *flattenedProfile(const QString &profileName) const;
+
+private:
+    using ValueMap = QMap<QString, QVariant>;
+
+    const ValueMap &values(Settings::Scope scope) const;
+    template<typename Function> void forEachKeyInGroup(const QString &group,
+                                                       Settings::Scope scope,
+                                                       const Function &function) const;
+
+    ValueMap m_userValues;
+    ValueMap m_systemValues;
+    QHash<QString, QVariantMap> m_flattenedProfiles;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
@@ -82,6 +82,7 @@ public:
     QStringList pluginPaths;
     QString libexecPath;
     QString settingsBaseDir;
+    QString fileSystemJournalFilePath;
     QVariantMap overriddenValues;
     QVariantMap buildConfiguration;
     mutable QVariantMap buildConfigurationTree;
@@ -509,6 +510,25 @@ void SetupProjectParameters::setWaitLockBuildGraph(bool wait)
     d->waitLockBuildGraph = wait;
 }
 
+/*!
+ * \brief Returns the file path of the journal written by a qbs-watch process.
+ */
+QString SetupProjectParameters::fileSystemJournalFilePath() const
+{
+    return d->fileSystemJournalFilePath;
+}
+
+/*!
+ * If a qbs-watch process is recording changes to the project's source tree into the given
+ * journal file, qbs will only check those files for changes that are mentioned in the journal,
+ * instead of querying the file system for every file known to the build graph.
+ * If the journal is incomplete or does not exist, all files are checked as usual.
+ */
+void SetupProjectParameters::setFileSystemJournalFilePath(const QString &filePath)
+{
+    d->fileSystemJournalFilePath = filePath;
+}
+
 /*!
  * \brief Gets the environment used while resolving the project.
  */
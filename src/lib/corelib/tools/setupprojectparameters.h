@@ -121,6 +121,9 @@ public:
     bool waitLockBuildGraph() const;
     void setWaitLockBuildGraph(bool wait);
 
+    QString fileSystemJournalFilePath() const;
+    void setFileSystemJournalFilePath(const QString &filePath);
+
     QProcessEnvironment environment() const;
     void setEnvironment(const QProcessEnvironment &env);
     QProcessEnvironment adjustedEnvironment() const;
@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "tooloutputcache.h"
+
+#include "settings.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qsavefile.h>
+
+namespace qbs {
+namespace Internal {
+
+static const int formatVersion = 1;
+
+static QString executableKey() { return QStringLiteral("executable"); }
+static QString argumentsKey() { return QStringLiteral("arguments"); }
+static QString canonicalPathKey() { return QStringLiteral("canonical-path"); }
+static QString lastModifiedKey() { return QStringLiteral("last-modified"); }
+static QString sizeKey() { return QStringLiteral("size"); }
+static QString outputKey() { return QStringLiteral("output"); }
+
+ToolOutputCache::ToolOutputCache(const QString &filePath) : m_filePath(filePath)
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value(QStringLiteral("version")).toInt() != formatVersion)
+        return;
+    const QJsonArray entries = root.value(QStringLiteral("entries")).toArray();
+    for (const QJsonValue &value : entries) {
+        const QJsonObject entryObject = value.toObject();
+        QStringList arguments;
+        const QJsonArray argumentsArray = entryObject.value(argumentsKey()).toArray();
+        for (const QJsonValue &argument : argumentsArray)
+            arguments << argument.toString();
+        Entry entry;
+        entry.canonicalFilePath = entryObject.value(canonicalPathKey()).toString();
+        entry.lastModified = qint64(entryObject.value(lastModifiedKey()).toDouble());
+        entry.size = qint64(entryObject.value(sizeKey()).toDouble());
+        entry.output = QByteArray::fromBase64(
+                    entryObject.value(outputKey()).toString().toLatin1());
+        m_entries.insert(key(entryObject.value(executableKey()).toString(), arguments), entry);
+    }
+}
+
+QString ToolOutputCache::filePathForSettings(const Settings *settings)
+{
+    return QFileInfo(settings->fileName()).absolutePath()
+            + QLatin1String("/tool-output-cache.json");
+}
+
+bool ToolOutputCache::lookup(const QString &executableFilePath, const QStringList &arguments,
+                             QByteArray *output) const
+{
+    Entry currentStamp;
+    if (!stamp(executableFilePath, &currentStamp))
+        return false;
+    const auto it = m_entries.constFind(key(executableFilePath, arguments));
+    if (it == m_entries.constEnd()
+            || it->canonicalFilePath != currentStamp.canonicalFilePath
+            || it->lastModified != currentStamp.lastModified
+            || it->size != currentStamp.size) {
+        return false;
+    }
+    *output = it->output;
+    return true;
+}
+
+void ToolOutputCache::insert(const QString &executableFilePath, const QStringList &arguments,
+                             const QByteArray &output)
+{
+    Entry entry;
+    if (!stamp(executableFilePath, &entry))
+        return;
+    entry.output = output;
+    m_entries.insert(key(executableFilePath, arguments), entry);
+    m_modified = true;
+}
+
+bool ToolOutputCache::save()
+{
+    if (!m_modified)
+        return true;
+    QJsonArray entries;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        QStringList keyParts = it.key().split(QLatin1Char('\n'));
+        QJsonObject entryObject;
+        entryObject.insert(executableKey(), keyParts.takeFirst());
+        entryObject.insert(argumentsKey(), QJsonArray::fromStringList(keyParts));
+        entryObject.insert(canonicalPathKey(), it->canonicalFilePath);
+        entryObject.insert(lastModifiedKey(), double(it->lastModified));
+        entryObject.insert(sizeKey(), double(it->size));
+        entryObject.insert(outputKey(), QString::fromLatin1(it->output.toBase64()));
+        entries.append(entryObject);
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), formatVersion);
+    root.insert(QStringLiteral("entries"), entries);
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    if (!file.commit())
+        return false;
+    m_modified = false;
+    return true;
+}
+
+QString ToolOutputCache::key(const QString &executableFilePath, const QStringList &arguments)
+{
+    QStringList parts(QDir::cleanPath(executableFilePath));
+    parts += arguments;
+    return parts.join(QLatin1Char('\n'));
+}
+
+bool ToolOutputCache::stamp(const QString &executableFilePath, Entry *entry)
+{
+    const QFileInfo fileInfo(executableFilePath);
+    if (!fileInfo.exists())
+        return false;
+    entry->canonicalFilePath = fileInfo.canonicalFilePath();
+    entry->lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry->size = fileInfo.size();
+    return true;
+}
+
+} // namespace Internal
+} // namespace qbs
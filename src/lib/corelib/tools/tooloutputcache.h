@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_TOOLOUTPUTCACHE_H
+#define QBS_TOOLOUTPUTCACHE_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+
+namespace qbs {
+class Settings;
+
+namespace Internal {
+
+// Remembers the output of tools such as "gcc -dumpmachine" or "qmake -query" across
+// invocations of the setup tools, so that unchanged toolchains and Qt installations do not
+// need to be queried again. An entry is valid as long as the executable's canonical path,
+// modification time and size stay the same.
+class QBS_EXPORT ToolOutputCache
+{
+public:
+    explicit ToolOutputCache(const QString &filePath);
+
+    // The cache lives next to the settings file.
+    static QString filePathForSettings(const Settings *settings);
+
+    bool lookup(const QString &executableFilePath, const QStringList &arguments,
+                QByteArray *output) const;
+    void insert(const QString &executableFilePath, const QStringList &arguments,
+                const QByteArray &output);
+
+    bool save();
+
+private:
+    class Entry
+    {
+    public:
+        QString canonicalFilePath;
+        qint64 lastModified = 0;
+        qint64 size = 0;
+        QByteArray output;
+    };
+
+    static QString key(const QString &executableFilePath, const QStringList &arguments);
+    static bool stamp(const QString &executableFilePath, Entry *entry);
+
+    const QString m_filePath;
+    QHash<QString, Entry> m_entries;
+    bool m_modified = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
@@ -12,10 +12,13 @@ HEADERS += \
     $$PWD/buildgraphlocker.h \
     $$PWD/codelocation.h \
     $$PWD/commandechomode.h \
+    $$PWD/commandoutputbuffer.h \
+    $$PWD/digest.h \
     $$PWD/dynamictypecheck.h \
     $$PWD/error.h \
     $$PWD/executablefinder.h \
     $$PWD/fileinfo.h \
+    $$PWD/filesystemjournal.h \
     $$PWD/filesaver.h \
     $$PWD/filetime.h \
     $$PWD/generateoptions.h \
@@ -25,7 +28,9 @@ HEADERS += \
     $$PWD/launcherinterface.h \
     $$PWD/launcherpackets.h \
     $$PWD/launchersocket.h \
+    $$PWD/metrics.h \
     $$PWD/msvcinfo.h \
+    $$PWD/parallelfor.h \
     $$PWD/persistence.h \
     $$PWD/scannerpluginmanager.h \
     $$PWD/scripttools.h \
@@ -48,8 +53,10 @@ HEADERS += \
     $$PWD/stlutils.h \
     $$PWD/stringutils.h \
     $$PWD/toolchains.h \
+    $$PWD/tooloutputcache.h \
     $$PWD/hostosinfo.h \
     $$PWD/buildoptions.h \
+    $$PWD/installmode.h \
     $$PWD/installoptions.h \
     $$PWD/cleanoptions.h \
     $$PWD/setupprojectparameters.h \
@@ -58,6 +65,7 @@ HEADERS += \
     $$PWD/qbsassert.h \
     $$PWD/qttools.h \
     $$PWD/settingscreator.h \
+    $$PWD/settingssnapshot.h \
     $$PWD/stringconstants.h \
     $$PWD/version.h \
     $$PWD/visualstudioversioninfo.h \
@@ -68,9 +76,12 @@ SOURCES += \
     $$PWD/buildgraphlocker.cpp \
     $$PWD/codelocation.cpp \
     $$PWD/commandechomode.cpp \
+    $$PWD/commandoutputbuffer.cpp \
+    $$PWD/digest.cpp \
     $$PWD/error.cpp \
     $$PWD/executablefinder.cpp \
     $$PWD/fileinfo.cpp \
+    $$PWD/filesystemjournal.cpp \
     $$PWD/filesaver.cpp \
     $$PWD/filetime.cpp \
     $$PWD/generateoptions.cpp \
@@ -79,6 +90,7 @@ SOURCES += \
     $$PWD/launcherinterface.cpp \
     $$PWD/launcherpackets.cpp \
     $$PWD/launchersocket.cpp \
+    $$PWD/metrics.cpp \
     $$PWD/msvcinfo.cpp \
     $$PWD/persistence.cpp \
     $$PWD/scannerpluginmanager.cpp \
@@ -97,13 +109,16 @@ SOURCES += \
     $$PWD/qbsprocess.cpp \
     $$PWD/shellutils.cpp \
     $$PWD/buildoptions.cpp \
+    $$PWD/installmode.cpp \
     $$PWD/installoptions.cpp \
     $$PWD/cleanoptions.cpp \
     $$PWD/setupprojectparameters.cpp \
     $$PWD/qbsassert.cpp \
     $$PWD/qttools.cpp \
     $$PWD/settingscreator.cpp \
+    $$PWD/settingssnapshot.cpp \
     $$PWD/toolchains.cpp \
+    $$PWD/tooloutputcache.cpp \
     $$PWD/version.cpp \
     $$PWD/visualstudioversioninfo.cpp \
     $$PWD/vsenvironmentdetector.cpp
@@ -123,6 +138,7 @@ osx {
         $$PWD/commandechomode.h \
         $$PWD/error.h \
         $$PWD/generateoptions.h \
+        $$PWD/installmode.h \
         $$PWD/installoptions.h \
         $$PWD/preferences.h \
         $$PWD/processresult.h \
@@ -42,6 +42,7 @@
 
 #include <logging/translator.h>
 #include <tools/error.h>
+#include <tools/parallelfor.h>
 #include <tools/profile.h>
 #include <tools/qttools.h>
 #include <tools/set.h>
@@ -49,12 +50,15 @@
 
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qthread.h>
 
 #include <algorithm>
 #include <functional>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace qbs {
 namespace Internal {
@@ -643,111 +647,130 @@ static QList<QByteArray> getPriFileContentsRecursively(const Profile &profile,
     return lines;
 }
 
-QList<QtModuleInfo> allQt5Modules(const Profile &profile, const QtEnvironment &qtEnvironment)
+static QString moduleFileNamePrefix() { return QStringLiteral("qt_lib_"); }
+static QString pluginFileNamePrefix() { return QStringLiteral("qt_plugin_"); }
+static QString moduleFileNameSuffix() { return QStringLiteral(".pri"); }
+
+static QtModuleInfo readModuleInfo(const Profile &profile, const QtEnvironment &qtEnvironment,
+                                   const QString &priFilePath)
 {
+    const QString fileName = QFileInfo(priFilePath).fileName();
+    QtModuleInfo moduleInfo;
+    moduleInfo.isPlugin = fileName.startsWith(pluginFileNamePrefix());
+    const QString fileNamePrefix
+            = moduleInfo.isPlugin ? pluginFileNamePrefix() : moduleFileNamePrefix();
+    moduleInfo.qbsName = fileName.mid(fileNamePrefix.size(),
+            fileName.size() - fileNamePrefix.size()
+            - moduleFileNameSuffix().size());
+    if (moduleInfo.isPlugin) {
+        moduleInfo.name = moduleInfo.qbsName;
+        moduleInfo.isStaticLibrary = true;
+    }
+    const QByteArray moduleKeyPrefix = QByteArray(moduleInfo.isPlugin ? "QT_PLUGIN" : "QT")
+            + '.' + moduleInfo.qbsName.toLatin1() + '.';
+    moduleInfo.qbsName.replace(QLatin1String("_private"), QLatin1String("-private"));
+    bool hasV2 = false;
+    bool hasModuleEntry = false;
+    const auto lines = getPriFileContentsRecursively(profile, priFilePath);
+    for (const QByteArray &line : lines) {
+        const QByteArray simplifiedLine = line.simplified();
+        const int firstEqualsOffset = simplifiedLine.indexOf('=');
+        if (firstEqualsOffset == -1)
+            continue;
+        const QByteArray key = simplifiedLine.left(firstEqualsOffset).trimmed();
+        const QByteArray value = simplifiedLine.mid(firstEqualsOffset + 1).trimmed();
+        if (!key.startsWith(moduleKeyPrefix) || value.isEmpty())
+            continue;
+        if (key.endsWith(".name")) {
+            moduleInfo.name = QString::fromLocal8Bit(value);
+        } else if (key.endsWith(".module")) {
+            hasModuleEntry = true;
+        } else if (key.endsWith(".depends")) {
+            moduleInfo.dependencies = QString::fromLocal8Bit(value).split(QLatin1Char(' '));
+            for (auto &dependency : moduleInfo.dependencies)
+                dependency.replace(QLatin1String("_private"), QLatin1String("-private"));
+        } else if (key.endsWith(".module_config")) {
+            const auto elems = value.split(' ');
+            for (const QByteArray &elem : elems) {
+                if (elem == "no_link")
+                    moduleInfo.hasLibrary = false;
+                else if (elem == "staticlib")
+                    moduleInfo.isStaticLibrary = true;
+                else if (elem == "internal_module")
+                    moduleInfo.isPrivate = true;
+                else if (elem == "v2")
+                    hasV2 = true;
+            }
+        } else if (key.endsWith(".includes")) {
+            moduleInfo.includePaths = QString::fromLocal8Bit(value).split(QLatin1Char(' '));
+            for (auto &includePath : moduleInfo.includePaths) {
+                includePath
+                        .replace(QLatin1String("$$QT_MODULE_INCLUDE_BASE"),
+                                 qtEnvironment.includePath)
+                        .replace(QLatin1String("$$QT_MODULE_LIB_BASE"),
+                                 qtEnvironment.libraryPath);
+            }
+        } else if (key.endsWith(".DEFINES")) {
+            moduleInfo.compilerDefines = QString::fromLocal8Bit(value)
+                    .split(QLatin1Char(' '), QString::SkipEmptyParts);
+        } else if (key.endsWith(".VERSION")) {
+            moduleInfo.version = QString::fromLocal8Bit(value);
+        } else if (key.endsWith(".plugin_types")) {
+            moduleInfo.supportedPluginTypes = makeList(value);
+        } else if (key.endsWith(".TYPE")) {
+            moduleInfo.pluginData.type = QString::fromLatin1(value);
+        } else if (key.endsWith(".EXTENDS")) {
+            moduleInfo.pluginData.extends = QString::fromLatin1(value);
+        } else if (key.endsWith(".CLASS_NAME")) {
+            moduleInfo.pluginData.className = QString::fromLatin1(value);
+        }
+    }
+    if (hasV2 && !hasModuleEntry)
+        moduleInfo.hasLibrary = false;
+
+    // Fix include paths for Apple frameworks.
+    // The qt_lib_XXX.pri files contain wrong values for versions < 5.6.
+    if (!hasV2 && moduleInfo.isFramework(qtEnvironment)) {
+        moduleInfo.includePaths.clear();
+        QString baseIncDir = moduleInfo.frameworkHeadersPath(qtEnvironment);
+        if (moduleInfo.isPrivate) {
+            baseIncDir += QLatin1Char('/') + moduleInfo.version;
+            moduleInfo.includePaths
+                    << baseIncDir
+                    << baseIncDir + QLatin1Char('/') + moduleInfo.name;
+        } else {
+            moduleInfo.includePaths << baseIncDir;
+        }
+    }
+
     Internal::Set<QString> nonExistingPrlFiles;
-    QList<QtModuleInfo> modules;
+    moduleInfo.setupLibraries(qtEnvironment, &nonExistingPrlFiles);
+    return moduleInfo;
+}
+
+QList<QtModuleInfo> allQt5Modules(const Profile &profile, const QtEnvironment &qtEnvironment)
+{
+    QStringList priFilePaths;
     QDirIterator dit(qtEnvironment.mkspecBasePath + QLatin1String("/modules"));
     while (dit.hasNext()) {
-        const QString moduleFileNamePrefix = QLatin1String("qt_lib_");
-        const QString pluginFileNamePrefix = QLatin1String("qt_plugin_");
-        const QString moduleFileNameSuffix = QLatin1String(".pri");
         dit.next();
-        const bool fileHasPluginPrefix = dit.fileName().startsWith(pluginFileNamePrefix);
-        if ((!fileHasPluginPrefix && !dit.fileName().startsWith(moduleFileNamePrefix))
-                || !dit.fileName().endsWith(moduleFileNameSuffix)) {
+        if ((!dit.fileName().startsWith(pluginFileNamePrefix())
+             && !dit.fileName().startsWith(moduleFileNamePrefix()))
+                || !dit.fileName().endsWith(moduleFileNameSuffix())) {
             continue;
         }
-        QtModuleInfo moduleInfo;
-        moduleInfo.isPlugin = fileHasPluginPrefix;
-        const QString fileNamePrefix
-                = moduleInfo.isPlugin ? pluginFileNamePrefix : moduleFileNamePrefix;
-        moduleInfo.qbsName = dit.fileName().mid(fileNamePrefix.size(),
-                dit.fileName().size() - fileNamePrefix.size()
-                - moduleFileNameSuffix.size());
-        if (moduleInfo.isPlugin) {
-            moduleInfo.name = moduleInfo.qbsName;
-            moduleInfo.isStaticLibrary = true;
-        }
-        const QByteArray moduleKeyPrefix = QByteArray(moduleInfo.isPlugin ? "QT_PLUGIN" : "QT")
-                + '.' + moduleInfo.qbsName.toLatin1() + '.';
-        moduleInfo.qbsName.replace(QLatin1String("_private"), QLatin1String("-private"));
-        bool hasV2 = false;
-        bool hasModuleEntry = false;
-        const auto lines = getPriFileContentsRecursively(profile, dit.filePath());
-        for (const QByteArray &line : lines) {
-            const QByteArray simplifiedLine = line.simplified();
-            const int firstEqualsOffset = simplifiedLine.indexOf('=');
-            if (firstEqualsOffset == -1)
-                continue;
-            const QByteArray key = simplifiedLine.left(firstEqualsOffset).trimmed();
-            const QByteArray value = simplifiedLine.mid(firstEqualsOffset + 1).trimmed();
-            if (!key.startsWith(moduleKeyPrefix) || value.isEmpty())
-                continue;
-            if (key.endsWith(".name")) {
-                moduleInfo.name = QString::fromLocal8Bit(value);
-            } else if (key.endsWith(".module")) {
-                hasModuleEntry = true;
-            } else if (key.endsWith(".depends")) {
-                moduleInfo.dependencies = QString::fromLocal8Bit(value).split(QLatin1Char(' '));
-                for (auto &dependency : moduleInfo.dependencies)
-                    dependency.replace(QLatin1String("_private"), QLatin1String("-private"));
-            } else if (key.endsWith(".module_config")) {
-                const auto elems = value.split(' ');
-                for (const QByteArray &elem : elems) {
-                    if (elem == "no_link")
-                        moduleInfo.hasLibrary = false;
-                    else if (elem == "staticlib")
-                        moduleInfo.isStaticLibrary = true;
-                    else if (elem == "internal_module")
-                        moduleInfo.isPrivate = true;
-                    else if (elem == "v2")
-                        hasV2 = true;
-                }
-            } else if (key.endsWith(".includes")) {
-                moduleInfo.includePaths = QString::fromLocal8Bit(value).split(QLatin1Char(' '));
-                for (auto &includePath : moduleInfo.includePaths) {
-                    includePath
-                            .replace(QLatin1String("$$QT_MODULE_INCLUDE_BASE"),
-                                     qtEnvironment.includePath)
-                            .replace(QLatin1String("$$QT_MODULE_LIB_BASE"),
-                                     qtEnvironment.libraryPath);
-                }
-            } else if (key.endsWith(".DEFINES")) {
-                moduleInfo.compilerDefines = QString::fromLocal8Bit(value)
-                        .split(QLatin1Char(' '), QString::SkipEmptyParts);
-            } else if (key.endsWith(".VERSION")) {
-                moduleInfo.version = QString::fromLocal8Bit(value);
-            } else if (key.endsWith(".plugin_types")) {
-                moduleInfo.supportedPluginTypes = makeList(value);
-            } else if (key.endsWith(".TYPE")) {
-                moduleInfo.pluginData.type = QString::fromLatin1(value);
-            } else if (key.endsWith(".EXTENDS")) {
-                moduleInfo.pluginData.extends = QString::fromLatin1(value);
-            } else if (key.endsWith(".CLASS_NAME")) {
-                moduleInfo.pluginData.className = QString::fromLatin1(value);
-            }
-        }
-        if (hasV2 && !hasModuleEntry)
-            moduleInfo.hasLibrary = false;
-
-        // Fix include paths for Apple frameworks.
-        // The qt_lib_XXX.pri files contain wrong values for versions < 5.6.
-        if (!hasV2 && moduleInfo.isFramework(qtEnvironment)) {
-            moduleInfo.includePaths.clear();
-            QString baseIncDir = moduleInfo.frameworkHeadersPath(qtEnvironment);
-            if (moduleInfo.isPrivate) {
-                baseIncDir += QLatin1Char('/') + moduleInfo.version;
-                moduleInfo.includePaths
-                        << baseIncDir
-                        << baseIncDir + QLatin1Char('/') + moduleInfo.name;
-            } else {
-                moduleInfo.includePaths << baseIncDir;
-            }
-        }
+        priFilePaths << dit.filePath();
+    }
 
-        moduleInfo.setupLibraries(qtEnvironment, &nonExistingPrlFiles);
+    // There are a few hundred module files, and reading them and the associated prl files
+    // is independent of the other modules.
+    std::vector<QtModuleInfo> moduleInfos(priFilePaths.size());
+    parallelFor(moduleInfos.size(), QThread::idealThreadCount(), [&](std::size_t i) {
+        moduleInfos[i] = readModuleInfo(profile, qtEnvironment, priFilePaths.at(int(i)));
+    });
 
+    QList<QtModuleInfo> modules;
+    for (const QtModuleInfo &moduleInfo : moduleInfos) {
         modules.push_back(moduleInfo);
         if (moduleInfo.qbsName == QLatin1String("testlib"))
             addTestModule(modules);
@@ -0,0 +1,571 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "launcherprocess.h"
+
+#include "launcherlogging.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qvector.h>
+
+#if defined(Q_OS_UNIX)
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qstandardpaths.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+#else
+#include <QtCore/qt_windows.h>
+#include <psapi.h>
+#endif
+
+namespace qbs {
+namespace Internal {
+
+#if defined(Q_OS_UNIX)
+
+namespace {
+
+bool setFdFlag(int fd, int getCommand, int setCommand, int flag)
+{
+    const int flags = fcntl(fd, getCommand);
+    return flags != -1 && fcntl(fd, setCommand, flags | flag) != -1;
+}
+
+bool createPipe(int fds[2], bool nonBlocking)
+{
+    if (pipe(fds) != 0)
+        return false;
+    for (int i = 0; i < 2; ++i) {
+        if (!setFdFlag(fds[i], F_GETFD, F_SETFD, FD_CLOEXEC)
+                || (nonBlocking && !setFdFlag(fds[i], F_GETFL, F_SETFL, O_NONBLOCK))) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+    }
+    return true;
+}
+
+void closePipe(int fds[2])
+{
+    for (int i = 0; i < 2; ++i) {
+        if (fds[i] != -1)
+            close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+QString errnoString(int errorNumber)
+{
+    return QString::fromLocal8Bit(strerror(errorNumber));
+}
+
+qint64 toMilliseconds(const struct timeval &time)
+{
+    return qint64(time.tv_sec) * 1000 + time.tv_usec / 1000;
+}
+
+int sigchldPipe[2] = { -1, -1 };
+struct sigaction oldSigchldAction;
+
+void sigchldHandler(int signalNumber, siginfo_t *info, void *context)
+{
+    const int savedErrno = errno;
+    const char c = 0;
+    const ssize_t written = write(sigchldPipe[1], &c, 1);
+    Q_UNUSED(written); // If the pipe is full, a notification is pending anyway.
+    if (oldSigchldAction.sa_flags & SA_SIGINFO) {
+        if (oldSigchldAction.sa_sigaction)
+            oldSigchldAction.sa_sigaction(signalNumber, info, context);
+    } else if (oldSigchldAction.sa_handler != SIG_DFL && oldSigchldAction.sa_handler != SIG_IGN) {
+        oldSigchldAction.sa_handler(signalNumber);
+    }
+    errno = savedErrno;
+}
+
+// Turns SIGCHLD into an event loop notification and lets the running processes check whether
+// they are the one that exited. We never call wait() for arbitrary children, so this cannot
+// interfere with anyone else's process handling.
+class ChildReaper
+{
+public:
+    static ChildReaper &instance()
+    {
+        static ChildReaper reaper;
+        return reaper;
+    }
+
+    void add(LauncherProcess *process) { m_processes << process; }
+    void remove(LauncherProcess *process) { m_processes.removeOne(process); }
+
+private:
+    ChildReaper()
+    {
+        if (!createPipe(sigchldPipe, true)) {
+            logError(QString::fromLatin1("cannot create pipe: %1").arg(errnoString(errno)));
+            return;
+        }
+        m_notifier.reset(new QSocketNotifier(sigchldPipe[0], QSocketNotifier::Read));
+        QObject::connect(m_notifier.get(), &QSocketNotifier::activated, [this] { reap(); });
+        struct sigaction action;
+        memset(&action, 0, sizeof action);
+        action.sa_sigaction = sigchldHandler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART | SA_NOCLDSTOP;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGCHLD, &action, &oldSigchldAction);
+    }
+
+    void reap()
+    {
+        char buffer[64];
+        while (read(sigchldPipe[0], buffer, sizeof buffer) > 0)
+            ;
+        const QVector<LauncherProcess *> processes = m_processes;
+        for (LauncherProcess * const process : processes) {
+            if (m_processes.contains(process))
+                process->tryToReap();
+        }
+    }
+
+    QVector<LauncherProcess *> m_processes;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+};
+
+} // namespace
+
+void LauncherProcess::OutputChannel::open(int fd, LauncherProcess *process,
+                                          void (LauncherProcess::*readyReadSignal)())
+{
+    this->fd = fd;
+    data.clear();
+    notifier.reset(new QSocketNotifier(fd, QSocketNotifier::Read));
+    QObject::connect(notifier.get(), &QSocketNotifier::activated, process,
+                     [this, process, readyReadSignal] {
+        if (readAvailableData())
+            emit (process->*readyReadSignal)();
+    });
+}
+
+bool LauncherProcess::OutputChannel::readAvailableData()
+{
+    bool hasNewData = false;
+    while (fd != -1) {
+        char buffer[16 * 1024];
+        const ssize_t count = read(fd, buffer, sizeof buffer);
+        if (count > 0) {
+            data.append(buffer, int(count));
+            hasNewData = true;
+        } else if (count == -1 && errno == EINTR) {
+            continue;
+        } else {
+            if (count == 0 || errno != EAGAIN)
+                close();
+            break;
+        }
+    }
+    return hasNewData;
+}
+
+void LauncherProcess::OutputChannel::close()
+{
+    if (notifier) {
+        // We might be called from the notifier's signal.
+        notifier->setEnabled(false);
+        notifier.release()->deleteLater();
+    }
+    if (fd != -1)
+        ::close(fd);
+    fd = -1;
+}
+
+LauncherProcess::LauncherProcess(QObject *parent) : QObject(parent)
+{
+}
+
+LauncherProcess::~LauncherProcess()
+{
+    if (m_state == QProcess::NotRunning)
+        return;
+    ChildReaper::instance().remove(this);
+    ::kill(pid_t(m_pid), SIGKILL);
+    while (waitpid(pid_t(m_pid), nullptr, 0) == -1 && errno == EINTR)
+        ;
+    m_stdout.close();
+    m_stderr.close();
+}
+
+void LauncherProcess::setEnvironment(const QStringList &environment)
+{
+    m_environment = environment;
+}
+
+void LauncherProcess::setWorkingDirectory(const QString &workingDir)
+{
+    m_workingDirectory = workingDir;
+}
+
+void LauncherProcess::start(const QString &program, const QStringList &arguments)
+{
+    if (m_state != QProcess::NotRunning)
+        return;
+    m_error = QProcess::UnknownError;
+    m_errorString.clear();
+    m_exitCode = 0;
+    m_exitStatus = QProcess::NormalExit;
+    m_resourceUsage = ProcessResourceUsage();
+    m_stdout.data.clear();
+    m_stderr.data.clear();
+
+    const QString executable = findExecutable(program);
+    if (executable.isEmpty()) {
+        failToStart(errnoString(ENOENT));
+        return;
+    }
+
+    // Everything the child needs must be prepared before forking.
+    const QByteArray encodedExecutable = QFile::encodeName(executable);
+    const QByteArray encodedWorkingDir = QFile::encodeName(m_workingDirectory);
+    QList<QByteArray> argumentData{encodedExecutable};
+    for (const QString &arg : arguments)
+        argumentData << arg.toLocal8Bit();
+    QList<QByteArray> environmentData;
+    const QStringList environment = m_environment.isEmpty()
+            ? QProcessEnvironment::systemEnvironment().toStringList() : m_environment;
+    for (const QString &entry : environment)
+        environmentData << entry.toLocal8Bit();
+    std::vector<char *> argv;
+    for (QByteArray &arg : argumentData)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    std::vector<char *> envp;
+    for (QByteArray &entry : environmentData)
+        envp.push_back(entry.data());
+    envp.push_back(nullptr);
+
+    int stdoutPipe[2] = { -1, -1 };
+    int stderrPipe[2] = { -1, -1 };
+    int errorPipe[2] = { -1, -1 };
+    const int devNull = open("/dev/null", O_RDONLY);
+    if (devNull == -1 || !createPipe(stdoutPipe, false) || !createPipe(stderrPipe, false)
+            || !createPipe(errorPipe, false)) {
+        const int savedErrno = errno;
+        if (devNull != -1)
+            close(devNull);
+        closePipe(stdoutPipe);
+        closePipe(stderrPipe);
+        failToStart(errnoString(savedErrno));
+        return;
+    }
+
+    ChildReaper &reaper = ChildReaper::instance();
+    m_state = QProcess::Starting;
+    m_timer.start();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        // Child. Only async-signal-safe functions from here on.
+        dup2(devNull, STDIN_FILENO);
+        dup2(stdoutPipe[1], STDOUT_FILENO);
+        dup2(stderrPipe[1], STDERR_FILENO);
+        signal(SIGPIPE, SIG_DFL);
+        if (encodedWorkingDir.isEmpty() || chdir(encodedWorkingDir.constData()) == 0)
+            execve(argv.front(), argv.data(), envp.data());
+        const int errorNumber = errno;
+        const ssize_t written = write(errorPipe[1], &errorNumber, sizeof errorNumber);
+        Q_UNUSED(written);
+        _exit(127);
+    }
+
+    const int forkErrno = errno;
+    close(devNull);
+    close(stdoutPipe[1]);
+    close(stderrPipe[1]);
+    close(errorPipe[1]);
+    if (pid == -1) {
+        close(stdoutPipe[0]);
+        close(stderrPipe[0]);
+        close(errorPipe[0]);
+        failToStart(errnoString(forkErrno));
+        return;
+    }
+
+    // The error pipe gets closed on a successful exec, so this does not block for long.
+    int childErrno = 0;
+    ssize_t count;
+    while ((count = read(errorPipe[0], &childErrno, sizeof childErrno)) == -1 && errno == EINTR)
+        ;
+    close(errorPipe[0]);
+    if (count == sizeof childErrno) {
+        while (waitpid(pid, nullptr, 0) == -1 && errno == EINTR)
+            ;
+        close(stdoutPipe[0]);
+        close(stderrPipe[0]);
+        failToStart(errnoString(childErrno));
+        return;
+    }
+
+    m_pid = pid;
+    m_state = QProcess::Running;
+    setFdFlag(stdoutPipe[0], F_GETFL, F_SETFL, O_NONBLOCK);
+    setFdFlag(stderrPipe[0], F_GETFL, F_SETFL, O_NONBLOCK);
+    m_stdout.open(stdoutPipe[0], this, &LauncherProcess::readyReadStandardOutput);
+    m_stderr.open(stderrPipe[0], this, &LauncherProcess::readyReadStandardError);
+    reaper.add(this);
+
+    // The child might have exited before we registered it.
+    tryToReap();
+}
+
+void LauncherProcess::terminate()
+{
+    if (m_state == QProcess::Running)
+        ::kill(pid_t(m_pid), SIGTERM);
+}
+
+void LauncherProcess::kill()
+{
+    if (m_state == QProcess::Running)
+        ::kill(pid_t(m_pid), SIGKILL);
+}
+
+QProcess::ProcessState LauncherProcess::state() const { return m_state; }
+QProcess::ProcessError LauncherProcess::error() const { return m_error; }
+QString LauncherProcess::errorString() const { return m_errorString; }
+int LauncherProcess::exitCode() const { return m_exitCode; }
+QProcess::ExitStatus LauncherProcess::exitStatus() const { return m_exitStatus; }
+ProcessResourceUsage LauncherProcess::resourceUsage() const { return m_resourceUsage; }
+
+QByteArray LauncherProcess::readAllStandardOutput()
+{
+    QByteArray data;
+    data.swap(m_stdout.data);
+    return data;
+}
+
+QByteArray LauncherProcess::readAllStandardError()
+{
+    QByteArray data;
+    data.swap(m_stderr.data);
+    return data;
+}
+
+void LauncherProcess::tryToReap()
+{
+    if (m_state != QProcess::Running)
+        return;
+    int status;
+    struct rusage usage;
+    pid_t result;
+    while ((result = wait4(pid_t(m_pid), &status, WNOHANG, &usage)) == -1 && errno == EINTR)
+        ;
+    if (result == pid_t(m_pid)) {
+        finish(status, usage);
+    } else if (result == -1) {
+        logWarn(QString::fromLatin1("wait4() failed: %1").arg(errnoString(errno)));
+        struct rusage noUsage;
+        memset(&noUsage, 0, sizeof noUsage);
+        finish(0, noUsage);
+    }
+}
+
+void LauncherProcess::finish(int status, const struct rusage &usage)
+{
+    ChildReaper::instance().remove(this);
+    m_resourceUsage.wallTime = m_timer.elapsed();
+    m_resourceUsage.userTime = toMilliseconds(usage.ru_utime);
+    m_resourceUsage.systemTime = toMilliseconds(usage.ru_stime);
+#if defined(Q_OS_DARWIN)
+    m_resourceUsage.peakResidentSetSize = qint64(usage.ru_maxrss);
+#else
+    m_resourceUsage.peakResidentSetSize = qint64(usage.ru_maxrss) * 1024;
+#endif
+
+    // Get whatever the child wrote right before exiting. Do not wait for EOF, as the pipes
+    // might have been inherited by a grandchild that lives on.
+    m_stdout.readAvailableData();
+    m_stderr.readAvailableData();
+    m_stdout.close();
+    m_stderr.close();
+
+    m_state = QProcess::NotRunning;
+    if (WIFEXITED(status)) {
+        m_exitCode = WEXITSTATUS(status);
+        m_exitStatus = QProcess::NormalExit;
+    } else {
+        m_exitCode = WIFSIGNALED(status) ? WTERMSIG(status) : -1;
+        m_exitStatus = QProcess::CrashExit;
+        m_error = QProcess::Crashed;
+        m_errorString = tr("Process crashed.");
+        emit errorOccurred(m_error);
+    }
+    emit finished(m_exitCode);
+}
+
+QString LauncherProcess::findExecutable(const QString &program) const
+{
+    if (program.contains(QLatin1Char('/')))
+        return program;
+    QString path;
+    if (m_environment.isEmpty()) {
+        path = QString::fromLocal8Bit(qgetenv("PATH"));
+    } else {
+        for (const QString &entry : m_environment) {
+            if (entry.startsWith(QLatin1String("PATH="))) {
+                path = entry.mid(5);
+                break;
+            }
+        }
+    }
+    const QStringList searchPaths = path.split(QLatin1Char(':'), QString::SkipEmptyParts);
+    if (searchPaths.isEmpty())
+        return QString();
+    return QStandardPaths::findExecutable(program, searchPaths);
+}
+
+void LauncherProcess::failToStart(const QString &errorString)
+{
+    m_state = QProcess::NotRunning;
+    m_error = QProcess::FailedToStart;
+    m_errorString = errorString;
+    emit errorOccurred(m_error);
+}
+
+#else // Q_OS_UNIX
+
+namespace {
+
+qint64 toMilliseconds(const FILETIME &time)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return qint64(value.QuadPart / 10000); // FILETIME has a resolution of 100ns.
+}
+
+} // namespace
+
+LauncherProcess::LauncherProcess(QObject *parent)
+    : QObject(parent), m_process(new QProcess(this))
+{
+    connect(m_process, &QProcess::started, this, [this] {
+        closeProcessHandle();
+        m_processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE,
+                                      DWORD(m_process->processId()));
+        if (!m_processHandle) {
+            logWarn(QString::fromLatin1("cannot open process handle: error %1")
+                    .arg(GetLastError()));
+        }
+    });
+    connect(m_process, &QProcess::errorOccurred, this, &LauncherProcess::errorOccurred);
+    connect(m_process, &QProcess::readyReadStandardOutput,
+            this, &LauncherProcess::readyReadStandardOutput);
+    connect(m_process, &QProcess::readyReadStandardError,
+            this, &LauncherProcess::readyReadStandardError);
+    connect(m_process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(
+                &QProcess::finished), this, [this](int exitCode) { emit finished(exitCode); });
+}
+
+LauncherProcess::~LauncherProcess()
+{
+    closeProcessHandle();
+}
+
+void LauncherProcess::setEnvironment(const QStringList &environment)
+{
+    m_process->setEnvironment(environment);
+}
+
+void LauncherProcess::setWorkingDirectory(const QString &workingDir)
+{
+    m_process->setWorkingDirectory(workingDir);
+}
+
+void LauncherProcess::start(const QString &program, const QStringList &arguments)
+{
+    closeProcessHandle();
+    m_process->start(program, arguments);
+}
+
+void LauncherProcess::terminate() { m_process->terminate(); }
+void LauncherProcess::kill() { m_process->kill(); }
+QProcess::ProcessState LauncherProcess::state() const { return m_process->state(); }
+QProcess::ProcessError LauncherProcess::error() const { return m_process->error(); }
+QString LauncherProcess::errorString() const { return m_process->errorString(); }
+int LauncherProcess::exitCode() const { return m_process->exitCode(); }
+QProcess::ExitStatus LauncherProcess::exitStatus() const { return m_process->exitStatus(); }
+QByteArray LauncherProcess::readAllStandardOutput() { return m_process->readAllStandardOutput(); }
+QByteArray LauncherProcess::readAllStandardError() { return m_process->readAllStandardError(); }
+
+ProcessResourceUsage LauncherProcess::resourceUsage() const
+{
+    ProcessResourceUsage usage;
+    if (!m_processHandle)
+        return usage;
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(m_processHandle, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        usage.wallTime = toMilliseconds(exitTime) - toMilliseconds(creationTime);
+        usage.userTime = toMilliseconds(userTime);
+        usage.systemTime = toMilliseconds(kernelTime);
+    }
+    PROCESS_MEMORY_COUNTERS memoryCounters;
+    if (GetProcessMemoryInfo(m_processHandle, &memoryCounters, sizeof memoryCounters))
+        usage.peakResidentSetSize = qint64(memoryCounters.PeakWorkingSetSize);
+    return usage;
+}
+
+void LauncherProcess::closeProcessHandle()
+{
+    if (m_processHandle)
+        CloseHandle(m_processHandle);
+    m_processHandle = nullptr;
+}
+
+#endif // Q_OS_UNIX
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_LAUNCHERPROCESS_H
+#define QBS_LAUNCHERPROCESS_H
+
+#include <launcherpackets.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+struct rusage;
+
+namespace qbs {
+namespace Internal {
+
+// Runs one process on behalf of the launcher. On Unix, this is a minimal replacement for QProcess
+// that reaps the child itself via wait4(), which is the only way to learn about its CPU time and
+// peak memory usage; QProcess does the reaping internally and throws that information away.
+// It implements just what the launcher needs: The child's stdin is /dev/null, and stdout
+// and stderr are collected separately.
+class LauncherProcess : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LauncherProcess(QObject *parent = nullptr);
+    ~LauncherProcess();
+
+    void setEnvironment(const QStringList &environment);
+    void setWorkingDirectory(const QString &workingDir);
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+    void kill();
+
+    QProcess::ProcessState state() const;
+    QProcess::ProcessError error() const;
+    QString errorString() const;
+    int exitCode() const;
+    QProcess::ExitStatus exitStatus() const;
+    QByteArray readAllStandardOutput();
+    QByteArray readAllStandardError();
+    ProcessResourceUsage resourceUsage() const;
+
+#if defined(Q_OS_UNIX)
+    // Called by the SIGCHLD handling code.
+    void tryToReap();
+#endif
+
+signals:
+    void errorOccurred(QProcess::ProcessError error);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
+    void finished(int exitCode);
+
+private:
+#if defined(Q_OS_UNIX)
+    class OutputChannel
+    {
+    public:
+        void open(int fd, LauncherProcess *process, void (LauncherProcess::*readyReadSignal)());
+        bool readAvailableData();
+        void close();
+
+        int fd = -1;
+        QByteArray data;
+        std::unique_ptr<QSocketNotifier> notifier;
+    };
+
+    QString findExecutable(const QString &program) const;
+    void failToStart(const QString &errorString);
+    void finish(int status, const struct rusage &usage);
+
+    QStringList m_environment;
+    QString m_workingDirectory;
+    QProcess::ProcessState m_state = QProcess::NotRunning;
+    QProcess::ProcessError m_error = QProcess::UnknownError;
+    QString m_errorString;
+    int m_exitCode = 0;
+    QProcess::ExitStatus m_exitStatus = QProcess::NormalExit;
+    ProcessResourceUsage m_resourceUsage;
+    QElapsedTimer m_timer;
+    OutputChannel m_stdout;
+    OutputChannel m_stderr;
+    qint64 m_pid = 0;
+#else
+    void closeProcessHandle();
+
+    QProcess * const m_process;
+    void *m_processHandle = nullptr;
+#endif
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
@@ -40,6 +40,7 @@
 #include "launchersockethandler.h"
 
 #include "launcherlogging.h"
+#include "launcherprocess.h"
 
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qprocess.h>
@@ -49,12 +50,12 @@
 namespace qbs {
 namespace Internal {
 
-class Process : public QProcess
+class Process : public LauncherProcess
 {
     Q_OBJECT
 public:
     Process(quintptr token, QObject *parent = nullptr) :
-        QProcess(parent), m_token(token), m_stopTimer(new QTimer(this))
+        LauncherProcess(parent), m_token(token), m_stopTimer(new QTimer(this))
     {
         m_stopTimer->setSingleShot(true);
         connect(m_stopTimer, &QTimer::timeout, this, &Process::cancel);
@@ -188,6 +189,16 @@ void LauncherSocketHandler::handleProcessError()
     sendPacket(packet);
 }
 
+void LauncherSocketHandler::handleProcessOutput()
+{
+    Process * proc = senderProcess();
+    ProcessOutputPacket packet(proc->token());
+    packet.stdOut = proc->readAllStandardOutput();
+    packet.stdErr = proc->readAllStandardError();
+    if (!packet.stdOut.isEmpty() || !packet.stdErr.isEmpty())
+        sendPacket(packet);
+}
+
 void LauncherSocketHandler::handleProcessFinished()
 {
     Process * proc = senderProcess();
@@ -199,6 +210,7 @@ void LauncherSocketHandler::handleProcessFinished()
     packet.exitStatus = proc->exitStatus();
     packet.stdErr = proc->readAllStandardError();
     packet.stdOut = proc->readAllStandardOutput();
+    packet.resourceUsage = proc->resourceUsage();
     sendPacket(packet);
 }
 
@@ -273,9 +285,12 @@ void LauncherSocketHandler::sendPacket(const LauncherPacket &packet)
 Process *LauncherSocketHandler::setupProcess(quintptr token)
 {
     const auto p = new Process(token, this);
-    connect(p, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
-            this, &LauncherSocketHandler::handleProcessError);
-    connect(p, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
+    connect(p, &LauncherProcess::errorOccurred, this, &LauncherSocketHandler::handleProcessError);
+    connect(p, &LauncherProcess::readyReadStandardOutput,
+            this, &LauncherSocketHandler::handleProcessOutput);
+    connect(p, &LauncherProcess::readyReadStandardError,
+            this, &LauncherSocketHandler::handleProcessOutput);
+    connect(p, &LauncherProcess::finished,
             this, &LauncherSocketHandler::handleProcessFinished);
     connect(p, &Process::failedToStop, this, &LauncherSocketHandler::handleStopFailure);
     return p;
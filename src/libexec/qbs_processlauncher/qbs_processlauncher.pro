@@ -9,13 +9,17 @@ TOOLS_DIR = $$PWD/../../lib/corelib/tools
 
 INCLUDEPATH += $$TOOLS_DIR
 
+win32: LIBS += -lpsapi
+
 HEADERS += \
     launcherlogging.h \
+    launcherprocess.h \
     launchersockethandler.h \
     $$TOOLS_DIR/launcherpackets.h
 
 SOURCES += \
     launcherlogging.cpp \
+    launcherprocess.cpp \
     launchersockethandler.cpp \
     processlauncher-main.cpp \
     $$TOOLS_DIR/launcherpackets.cpp
@@ -40,6 +40,7 @@
 #include "clangcompilationdbgenerator.h"
 
 #include <api/projectdata.h>
+#include <api/transformerdata.h>
 #include <logging/logger.h>
 #include <logging/translator.h>
 #include <tools/error.h>
@@ -48,6 +49,7 @@
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qbytearray.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonobject.h>
@@ -70,35 +72,43 @@ QString ClangCompilationDatabaseGenerator::generatorName() const
 void ClangCompilationDatabaseGenerator::generate()
 {
     for (const Project &theProject : project().projects.values()) {
-        QJsonArray database;
         const ProjectData projectData = theProject.projectData();
         const QString buildDir = projectData.buildDirectory();
-
-        for (const ProductData &productData : projectData.allProducts()) {
-            for (const GroupData &groupData : productData.groups()) {
-                for (const ArtifactData &sourceArtifact : groupData.allSourceArtifacts()) {
-                    if (!hasValidInputFileTag(sourceArtifact.fileTags()))
+        const QString dbFilePath = QDir(buildDir).filePath(DefaultDatabaseFileName);
+
+        // Retrieve the compiler commands of all products in one go instead of asking
+        // for each source file separately.
+        ErrorInfo errorInfo;
+        const ProjectTransformerData transformerData
+                = theProject.transformerData(QStringList(QStringLiteral("obj")), &errorInfo);
+        if (errorInfo.hasError())
+            throw errorInfo;
+
+        // The database can get huge for big projects, so we write it entry by entry
+        // rather than assembling it in memory first.
+        QFile databaseFile(dbFilePath);
+        if (!databaseFile.open(QFile::WriteOnly))
+            throw ErrorInfo(Tr::tr("Cannot open '%1' for writing: %2")
+                            .arg(dbFilePath, databaseFile.errorString()));
+        bool isFirstEntry = true;
+        writeToDatabase(databaseFile, "[");
+        for (const auto &productTransformers : transformerData) {
+            for (const TransformerData &transformer : productTransformers.second) {
+                for (const ArtifactData &input : transformer.inputs()) {
+                    if (input.isGenerated() || !hasValidInputFileTag(input.fileTags()))
                         continue;
-
-                    const QString filePath = sourceArtifact.filePath();
-                    ErrorInfo errorInfo;
-                    const RuleCommandList rules = theProject.ruleCommands(productData, filePath,
-                                                                       QStringLiteral("obj"),
-                                                                       &errorInfo);
-
-                    if (errorInfo.hasError())
-                        throw errorInfo;
-
-                    for (const RuleCommand &rule : rules) {
+                    for (const RuleCommand &rule : transformer.commands()) {
                         if (rule.type() != RuleCommand::ProcessCommandType)
                             continue;
-                        database.push_back(createEntry(filePath, buildDir, rule));
+                        writeToDatabase(databaseFile, isFirstEntry ? "\n" : ",\n");
+                        writeToDatabase(databaseFile, QJsonDocument(createEntry(
+                                input.filePath(), buildDir, rule)).toJson(QJsonDocument::Compact));
+                        isFirstEntry = false;
                     }
                 }
             }
         }
-
-        writeProjectDatabase(QDir(buildDir).filePath(DefaultDatabaseFileName), database);
+        writeToDatabase(databaseFile, "\n]\n");
     }
 }
 
@@ -122,21 +132,12 @@ QJsonObject ClangCompilationDatabaseGenerator::createEntry(const QString &filePa
     return object;
 }
 
-void ClangCompilationDatabaseGenerator::writeProjectDatabase(const QString &filePath,
-                                                             const QJsonArray &entries)
+void ClangCompilationDatabaseGenerator::writeToDatabase(QFile &databaseFile,
+                                                        const QByteArray &data)
 {
-    const QJsonDocument database(entries);
-    QFile databaseFile(filePath);
-
-    if (!databaseFile.open(QFile::WriteOnly))
-        throw ErrorInfo(Tr::tr("Cannot open '%1' for writing: %2")
-                        .arg(filePath)
-                        .arg(databaseFile.errorString()));
-
-    if (databaseFile.write(database.toJson()) == -1)
+    if (databaseFile.write(data) == -1)
         throw ErrorInfo(Tr::tr("Error while writing '%1': %2")
-                        .arg(filePath)
-                        .arg(databaseFile.errorString()));
+                        .arg(databaseFile.fileName(), databaseFile.errorString()));
 }
 
 bool ClangCompilationDatabaseGenerator::hasValidInputFileTag(const QStringList &fileTags) const
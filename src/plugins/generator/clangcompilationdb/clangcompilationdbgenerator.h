@@ -42,6 +42,11 @@
 
 #include <generators/generator.h>
 
+QT_BEGIN_NAMESPACE
+class QByteArray;
+class QFile;
+QT_END_NAMESPACE
+
 namespace qbs {
 
 class SourceArtifact;
@@ -58,7 +63,7 @@ private:
     static const QString DefaultDatabaseFileName;
     QJsonObject createEntry(const QString &filePath, const QString &buildDir,
                             const RuleCommand &ruleCommand);
-    void writeProjectDatabase(const QString &filePath, const QJsonArray &entries);
+    void writeToDatabase(QFile &databaseFile, const QByteArray &data);
     bool hasValidInputFileTag(const QStringList &fileTags) const;
 };
 
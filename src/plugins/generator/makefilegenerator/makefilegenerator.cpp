@@ -43,7 +43,9 @@
 #include <logging/logger.h>
 #include <logging/translator.h>
 #include <tools/error.h>
+#include <tools/filesaver.h>
 #include <tools/hostosinfo.h>
+#include <tools/parallelfor.h>
 #include <tools/shellutils.h>
 #include <tools/stringconstants.h>
 #include <tools/set.h>
@@ -51,8 +53,10 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qregularexpression.h>
 #include <QtCore/qtextstream.h>
+#include <QtCore/qthread.h>
 
 #include <utility>
 #include <vector>
@@ -154,27 +158,197 @@ static QString removeCommand()
     return HostOsInfo::isWindowsHost() ? QStringLiteral("del") : QStringLiteral("rm -f");
 }
 
+namespace {
+class MakefileContext
+{
+public:
+    MakefileContext(const QString &srcDir, const QString &buildDir, const QString &installRoot)
+        : srcDir(srcDir), buildDir(buildDir), installRoot(installRoot),
+          m_srcDirPrefixSpecs{std::make_pair(srcDir, QStringLiteral("SRCDIR"))},
+          m_buildRootPrefixSpecs{std::make_pair(buildDir, QStringLiteral("BUILD_ROOT"))},
+          m_installRootPrefixSpecs{std::make_pair(installRoot, QStringLiteral("INSTALL_ROOT"))}
+    {
+    }
+
+    QString prefixifiedSrcDirPath(const QString &path) const
+    {
+        return replacePrefix(path, m_srcDirPrefixSpecs);
+    }
+
+    QString prefixifiedBuildDirPath(const QString &path) const
+    {
+        return replacePrefix(path, m_buildRootPrefixSpecs);
+    }
+
+    QString prefixifiedInstallDirPath(const QString &path) const
+    {
+        if (installRoot.isEmpty())
+            return path;
+        return replacePrefix(path, m_installRootPrefixSpecs);
+    }
+
+    QString transformedOutputFilePath(const ArtifactData &output) const
+    {
+        return makeValidTargetName(prefixifiedBuildDirPath(output.filePath()), TargetType::Path);
+    }
+
+    QString transformedInputFilePath(const ArtifactData &input) const
+    {
+        return makeValidTargetName(prefixifiedSrcDirPath(input.filePath()), TargetType::Path);
+    }
+
+    QString transformedArtifactFilePath(const ArtifactData &artifact) const
+    {
+        return artifact.isGenerated() ? transformedOutputFilePath(artifact)
+                                      : transformedInputFilePath(artifact);
+    }
+
+    const QString srcDir;
+    const QString buildDir;
+    const QString installRoot;
+
+private:
+    const std::vector<PrefixSpec> m_srcDirPrefixSpecs;
+    const std::vector<PrefixSpec> m_buildRootPrefixSpecs;
+    const std::vector<PrefixSpec> m_installRootPrefixSpecs;
+};
+
+// The part of the Makefile that belongs to one product. These are independent of each other,
+// so we can create them concurrently.
+struct ProductMakefile
+{
+    QString target;
+    QString filePath;
+    bool builtByDefault = false;
+    bool jsCommandsEncountered = false;
+    QStringList filesCreatedByJsCommands;
+    QStringList warnings;
+};
+} // namespace
+
+static QString subMakefilesDir(const QString &buildDir)
+{
+    return buildDir + QLatin1String("/makefiles");
+}
+
+static void writeMakefile(const QString &filePath, const QString &contents)
+{
+    FileSaver saver(filePath.toStdString()); // Does not touch the file if nothing changed.
+    if (!saver.open() || !saver.write(contents.toStdString()) || !saver.commit())
+        throw ErrorInfo(Tr::tr("Failed to write '%1'.").arg(filePath));
+}
+
+static void generateProductMakefile(const ProductData &productData,
+                                    const ProductTransformerData &productTransformerData,
+                                    const MakefileContext &context, ProductMakefile &makefile)
+{
+    QString contents;
+    QTextStream stream(&contents);
+    const QString &productTarget = makefile.target;
+    stream << "# This file was generated by qbs" << "\n\n";
+    stream << productTarget << ':';
+    for (const ArtifactData &ta : productData.targetArtifacts())
+        stream << ' ' << context.transformedOutputFilePath(ta);
+    stream << '\n';
+    for (const TransformerData &transformerData : productTransformerData) {
+        stream << context.transformedOutputFilePath(transformerData.outputs().first()) << ":";
+        for (const ArtifactData &input : transformerData.inputs())
+            stream << ' ' << context.transformedArtifactFilePath(input);
+        stream << '\n';
+        Set<QString> createdDirs;
+        for (const ArtifactData &output : transformerData.outputs()) {
+            const QString outputDir = QFileInfo(output.filePath()).path();
+            if (createdDirs.insert(outputDir).second)
+                stream << "\t" << mkdirCmdLine(QDir::toNativeSeparators(
+                                                   context.prefixifiedBuildDirPath(outputDir)))
+                       << '\n';
+        }
+        bool processCommandEncountered = false;
+        for (const RuleCommand &command : transformerData.commands()) {
+            if (command.type() == RuleCommand::JavaScriptCommandType) {
+                makefile.jsCommandsEncountered = true;
+                continue;
+            }
+            processCommandEncountered = true;
+            stream << '\t' << QDir::toNativeSeparators(
+                          quote(bruteForcePathReplace(command.executable(), context.srcDir,
+                                                      context.buildDir, context.installRoot)));
+            // TODO: Optionally use environment?
+            for (const QString &arg : command.arguments()) {
+                stream << ' ' << quote(bruteForcePathReplace(arg, context.srcDir,
+                                                             context.buildDir,
+                                                             context.installRoot));
+            }
+            stream << '\n';
+        }
+        for (int i = 1; i < transformerData.outputs().size(); ++i) {
+            stream << context.transformedOutputFilePath(transformerData.outputs().at(i)) << ": "
+                   << context.transformedOutputFilePath(transformerData.outputs().at(i-1))
+                   << '\n';
+        }
+        if (!processCommandEncountered && makefile.builtByDefault) {
+            for (const ArtifactData &output : transformerData.outputs())
+                makefile.filesCreatedByJsCommands.push_back(output.filePath());
+        }
+    }
+    stream << "install-" << productTarget << ": " << productTarget << '\n';
+    Set<QString> createdDirs;
+    for (const ArtifactData &artifact : productData.installableArtifacts()) {
+        const QString &outputDir = artifact.installData().localInstallDir();
+        if (outputDir.contains(QLatin1Char(' '))) {
+            makefile.warnings << Tr::tr("Skipping installation of '%1', because "
+                    "target directory '%2' contains spaces.")
+                                 .arg(artifact.filePath(), outputDir);
+            continue;
+        }
+        if (createdDirs.insert(outputDir).second)
+            stream << "\t" << mkdirCmdLine(QDir::toNativeSeparators(
+                                               context.prefixifiedInstallDirPath(outputDir)))
+                   << '\n';
+        const QFileInfo fileInfo(artifact.filePath());
+        const QString transformedInputFilePath
+                = QDir::toNativeSeparators((artifact.isGenerated()
+                                            ? context.prefixifiedBuildDirPath(fileInfo.path())
+                                            : context.prefixifiedSrcDirPath(fileInfo.path()))
+                                           + QLatin1Char('/') + quote(fileInfo.fileName()));
+        const QString transformedOutputDir
+                = QDir::toNativeSeparators(context.prefixifiedInstallDirPath(
+                                               artifact.installData().localInstallDir()));
+        stream << "\t"
+               << (artifact.isExecutable() ? "$(INSTALL_PROGRAM) " : "$(INSTALL_FILE) ")
+               << transformedInputFilePath << ' ' << transformedOutputDir << '\n';
+    }
+    stream << "clean-" << productTarget << ":\n";
+    for (const ArtifactData &artifact : productData.generatedArtifacts()) {
+        const QFileInfo fileInfo(artifact.filePath());
+        const QString transformedFilePath = QDir::toNativeSeparators(
+                    context.prefixifiedBuildDirPath(fileInfo.path())
+                    + QLatin1Char('/') + quote(fileInfo.fileName()));
+        stream << '\t';
+        if (HostOsInfo::isWindowsHost())
+            stream << '-';
+        stream << "$(RM) " << transformedFilePath << '\n';
+    }
+    stream.flush();
+    writeMakefile(makefile.filePath, contents);
+}
+
 void qbs::MakefileGenerator::generate()
 {
     for (const Project &theProject : project().projects.values()) {
-        const QString makefileFilePath = theProject.projectData().buildDirectory()
-                + QLatin1String("/Makefile");
-        QFile makefile(makefileFilePath);
-        if (!makefile.open(QIODevice::WriteOnly)) {
-            throw ErrorInfo(Tr::tr("Failed to create '%1': %2")
-                            .arg(makefileFilePath, makefile.errorString()));
-        }
-        QTextStream stream(&makefile);
+        const ProjectData projectData = theProject.projectData();
+        const QString makefileFilePath = projectData.buildDirectory() + QLatin1String("/Makefile");
         ErrorInfo error;
-        ProjectTransformerData projectTransformerData = theProject.transformerData(&error);
+        const ProjectTransformerData projectTransformerData = theProject.transformerData(&error);
         if (error.hasError())
             throw error;
+        QString contents;
+        QTextStream stream(&contents);
         stream << "# This file was generated by qbs" << "\n\n";
         stream << "INSTALL_FILE = " << installFileCommand() << '\n';
         stream << "INSTALL_PROGRAM = " << installProgramCommand() << '\n';
         stream << "RM = " << removeCommand() << '\n';
         stream << '\n';
-        const ProjectData projectData = theProject.projectData();
         const QString srcDir = QFileInfo(projectData.location().filePath()).path();
         if (srcDir.contains(QLatin1Char(' '))) {
             throw ErrorInfo(Tr::tr("The project directory '%1' contains space characters, which"
@@ -187,10 +361,17 @@ void qbs::MakefileGenerator::generate()
                                    "is not supported by this generator.").arg(buildDir));
         }
         stream << "BUILD_ROOT = " << QDir::toNativeSeparators(buildDir) << '\n';
+
+        // All installable artifacts share the install root, so the first one we find will do.
         QString installRoot;
-        const QList<ArtifactData> allInstallables = projectData.installableArtifacts();
-        if (!allInstallables.empty()) {
-            installRoot = allInstallables.first().installData().installRoot();
+        for (const ProductData &product : projectData.allProducts()) {
+            const QList<ArtifactData> installables = product.installableArtifacts();
+            if (!installables.empty()) {
+                installRoot = installables.first().installData().installRoot();
+                break;
+            }
+        }
+        if (!installRoot.isEmpty()) {
             if (installRoot.contains(QLatin1Char(' '))) {
                 throw ErrorInfo(Tr::tr("The install root '%1' contains space characters, which"
                                        "is not supported by this generator.").arg(installRoot));
@@ -198,128 +379,56 @@ void qbs::MakefileGenerator::generate()
             stream << "INSTALL_ROOT = " << QDir::toNativeSeparators(installRoot) << '\n';
         }
         stream << "\nall:\n";
-        const std::vector<PrefixSpec> srcDirPrefixSpecs{std::make_pair(srcDir,
-                                                                       QStringLiteral("SRCDIR"))};
-        const auto prefixifiedSrcDirPath = [&srcDirPrefixSpecs](const QString &path) {
-            return replacePrefix(path, srcDirPrefixSpecs);
-        };
-        const std::vector<PrefixSpec> buildRootPrefixSpecs{
-            std::make_pair(buildDir, QStringLiteral("BUILD_ROOT"))};
-        const auto prefixifiedBuildDirPath = [&buildRootPrefixSpecs](const QString &path) {
-            return replacePrefix(path, buildRootPrefixSpecs);
-        };
-        const std::vector<PrefixSpec> installRootPrefixSpecs{
-            std::make_pair(installRoot, QStringLiteral("INSTALL_ROOT"))};
-        const auto prefixifiedInstallDirPath
-                = [&installRoot, &installRootPrefixSpecs](const QString &path) {
-            if (installRoot.isEmpty())
-                return path;
-            return replacePrefix(path, installRootPrefixSpecs);
-        };
-        const auto transformedOutputFilePath = [=](const ArtifactData &output) {
-            return makeValidTargetName(prefixifiedBuildDirPath(output.filePath()),
-                                       TargetType::Path);
-        };
-        const auto transformedInputFilePath = [=](const ArtifactData &input) {
-            return makeValidTargetName(prefixifiedSrcDirPath(input.filePath()), TargetType::Path);
-        };
-        const auto transformedArtifactFilePath = [=](const ArtifactData &artifact) {
-            return artifact.isGenerated() ? transformedOutputFilePath(artifact)
-                                          : transformedInputFilePath(artifact);
-        };
+
+        const QString makefilesDir = subMakefilesDir(buildDir);
+        if (!QDir().mkpath(makefilesDir))
+            throw ErrorInfo(Tr::tr("Failed to create directory '%1'.").arg(makefilesDir));
+        const MakefileContext context(srcDir, buildDir, installRoot);
+        std::vector<ProductMakefile> productMakefiles(projectTransformerData.size());
+        QHash<QString, QStringList> targetsByProductName;
+        for (int i = 0; i < projectTransformerData.size(); ++i) {
+            const ProductData &productData = projectTransformerData.at(i).first;
+            ProductMakefile &makefile = productMakefiles.at(i);
+            makefile.target = makeValidTargetName(productData);
+            makefile.filePath = makefilesDir + QLatin1Char('/') + makefile.target
+                    + QLatin1String(".mk");
+            makefile.builtByDefault = productData.properties().value(
+                        StringConstants::builtByDefaultProperty()).toBool();
+            targetsByProductName[productData.name()] << makefile.target;
+        }
+        parallelFor(productMakefiles.size(), QThread::idealThreadCount(), [&](std::size_t i) {
+            const auto &d = projectTransformerData.at(static_cast<int>(i));
+            generateProductMakefile(d.first, d.second, context, productMakefiles.at(i));
+        });
+
         QStringList allTargets;
         QStringList allDefaultTargets;
         QStringList filesCreatedByJsCommands;
+        Set<QString> subMakefileNames;
         bool jsCommandsEncountered = false;
-        for (const auto &d : projectTransformerData) {
-            const ProductData productData = d.first;
-            const QString productTarget = makeValidTargetName(productData);
-            const ProductTransformerData productTransformerData = d.second;
-            const bool builtByDefault = productData.properties().value(
-                        StringConstants::builtByDefaultProperty()).toBool();
-            if (builtByDefault)
-                allDefaultTargets.push_back(productTarget);
-            allTargets.push_back(productTarget);
-            stream << productTarget << ':';
-            for (const ArtifactData &ta : productData.targetArtifacts())
-                stream << ' ' << transformedOutputFilePath(ta);
-            stream << '\n';
-            for (const TransformerData &transformerData : productTransformerData) {
-                stream << transformedOutputFilePath(transformerData.outputs().first()) << ":";
-                for (const ArtifactData &input : transformerData.inputs())
-                    stream << ' ' << transformedArtifactFilePath(input);
-                stream << '\n';
-                Set<QString> createdDirs;
-                for (const ArtifactData &output : transformerData.outputs()) {
-                    const QString outputDir = QFileInfo(output.filePath()).path();
-                    if (createdDirs.insert(outputDir).second)
-                        stream << "\t" << mkdirCmdLine(QDir::toNativeSeparators(
-                                                           prefixifiedBuildDirPath(outputDir)))
-                               << '\n';
-                }
-                bool processCommandEncountered = false;
-                for (const RuleCommand &command : transformerData.commands()) {
-                    if (command.type() == RuleCommand::JavaScriptCommandType) {
-                        jsCommandsEncountered = true;
-                        continue;
-                    }
-                    processCommandEncountered = true;
-                    stream << '\t' << QDir::toNativeSeparators(
-                                  quote(bruteForcePathReplace(command.executable(), srcDir,
-                                                              buildDir, installRoot)));
-                    // TODO: Optionally use environment?
-                    for (const QString &arg : command.arguments()) {
-                        stream << ' '
-                               << quote(bruteForcePathReplace(arg, srcDir, buildDir, installRoot));
-                    }
-                    stream << '\n';
-                }
-                for (int i = 1; i < transformerData.outputs().size(); ++i) {
-                    stream << transformedOutputFilePath(transformerData.outputs().at(i)) << ": "
-                           << transformedOutputFilePath(transformerData.outputs().at(i-1)) << '\n';
-                }
-                if (!processCommandEncountered && builtByDefault) {
-                    for (const ArtifactData &output : transformerData.outputs())
-                        filesCreatedByJsCommands.push_back(output.filePath());
-                }
-            }
-            stream << "install-" << productTarget << ": " << productTarget << '\n';
-            Set<QString> createdDirs;
-            for (const ArtifactData &artifact : productData.installableArtifacts()) {
-                const QString &outputDir = artifact.installData().localInstallDir();
-                if (outputDir.contains(QLatin1Char(' '))) {
-                    logger().qbsWarning() << Tr::tr("Skipping installation of '%1', because "
-                            "target directory '%2' contains spaces.")
-                                             .arg(artifact.filePath(), outputDir);
-                    continue;
-                }
-                if (createdDirs.insert(outputDir).second)
-                    stream << "\t" << mkdirCmdLine(QDir::toNativeSeparators(
-                                                       prefixifiedInstallDirPath(outputDir)))
-                           << '\n';
-                const QFileInfo fileInfo(artifact.filePath());
-                const QString transformedInputFilePath
-                        = QDir::toNativeSeparators((artifact.isGenerated()
-                                                    ? prefixifiedBuildDirPath(fileInfo.path())
-                                                    : prefixifiedSrcDirPath(fileInfo.path()))
-                                                   + QLatin1Char('/') + quote(fileInfo.fileName()));
-                const QString transformedOutputDir
-                        = QDir::toNativeSeparators(prefixifiedInstallDirPath(
-                                                       artifact.installData().localInstallDir()));
-                stream << "\t"
-                       << (artifact.isExecutable() ? "$(INSTALL_PROGRAM) " : "$(INSTALL_FILE) ")
-                       << transformedInputFilePath << ' ' << transformedOutputDir << '\n';
-            }
-            stream << "clean-" << productTarget << ":\n";
-            for (const ArtifactData &artifact : productData.generatedArtifacts()) {
-                const QFileInfo fileInfo(artifact.filePath());
-                const QString transformedFilePath = QDir::toNativeSeparators(
-                            prefixifiedBuildDirPath(fileInfo.path())
-                            + QLatin1Char('/') + quote(fileInfo.fileName()));
-                stream << '\t';
-                if (HostOsInfo::isWindowsHost())
-                    stream << '-';
-                stream << "$(RM) " << transformedFilePath << '\n';
+        stream << '\n';
+        for (int i = 0; i < projectTransformerData.size(); ++i) {
+            const ProductMakefile &makefile = productMakefiles.at(i);
+            for (const QString &warning : makefile.warnings)
+                logger().qbsWarning() << warning;
+            jsCommandsEncountered = jsCommandsEncountered || makefile.jsCommandsEncountered;
+            filesCreatedByJsCommands << makefile.filesCreatedByJsCommands;
+            if (makefile.builtByDefault)
+                allDefaultTargets.push_back(makefile.target);
+            allTargets.push_back(makefile.target);
+            subMakefileNames.insert(QFileInfo(makefile.filePath).fileName());
+            stream << "include " << QDir::toNativeSeparators(context.prefixifiedBuildDirPath(
+                                                                 makefile.filePath))
+                   << '\n';
+        }
+        stream << '\n';
+        for (int i = 0; i < projectTransformerData.size(); ++i) {
+            QStringList dependencyTargets;
+            for (const QString &dependency : projectTransformerData.at(i).first.dependencies())
+                dependencyTargets << targetsByProductName.value(dependency);
+            if (!dependencyTargets.empty()) {
+                stream << productMakefiles.at(i).target << ": "
+                       << dependencyTargets.join(QLatin1Char(' ')) << '\n';
             }
         }
 
@@ -335,6 +444,17 @@ void qbs::MakefileGenerator::generate()
         for (const QString &target : allTargets)
             stream << ' ' << "clean-" << target;
         stream << '\n';
+        stream.flush();
+        writeMakefile(makefileFilePath, contents);
+
+        // Sub-makefiles of products that no longer exist must not be picked up by accident.
+        const QStringList existingSubMakefiles = QDir(makefilesDir).entryList(
+                    QStringList(QStringLiteral("*.mk")), QDir::Files);
+        for (const QString &fileName : existingSubMakefiles) {
+            if (!subMakefileNames.contains(fileName))
+                QFile::remove(makefilesDir + QLatin1Char('/') + fileName);
+        }
+
         if (!filesCreatedByJsCommands.empty()) {
             logger().qbsWarning() << Tr::tr("Some rules used by this project are not "
                 "Makefile-compatible, because they depend entirely on JavaScriptCommands. "
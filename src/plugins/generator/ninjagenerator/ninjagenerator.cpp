@@ -0,0 +1,344 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "ninjagenerator.h"
+
+#include <api/projectdata.h>
+#include <api/transformerdata.h>
+#include <logging/logger.h>
+#include <logging/translator.h>
+#include <tools/error.h>
+#include <tools/filesaver.h>
+#include <tools/hostosinfo.h>
+#include <tools/shellutils.h>
+#include <tools/stringconstants.h>
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qregularexpression.h>
+#include <QtCore/qset.h>
+#include <QtCore/qtextstream.h>
+
+#include <algorithm>
+
+namespace qbs {
+using namespace Internal;
+
+QString NinjaGenerator::generatorName() const
+{
+    return QStringLiteral("ninja");
+}
+
+// Paths and other values in build statements: Spaces, colons and dollar signs are special.
+static QString escapePath(const QString &path)
+{
+    QString escaped = path;
+    escaped.replace(QLatin1Char('$'), QStringLiteral("$$"));
+    escaped.replace(QLatin1Char(' '), QStringLiteral("$ "));
+    escaped.replace(QLatin1Char(':'), QStringLiteral("$:"));
+    return escaped;
+}
+
+// Values of variable bindings: Only dollar signs are special.
+static QString escapeValue(const QString &value)
+{
+    QString escaped = value;
+    escaped.replace(QLatin1Char('$'), QStringLiteral("$$"));
+    escaped.replace(QLatin1Char('\n'), QLatin1Char(' '));
+    return escaped;
+}
+
+static QString makeValidTargetName(const ProductData &product)
+{
+    static const QRegularExpression illegalChar(QStringLiteral("[^_.0-9A-Za-z]"));
+    QString name = product.name();
+    name.replace(illegalChar, QStringLiteral("_"));
+    if (!product.multiplexConfigurationId().isEmpty())
+        name.append(QLatin1Char('_')).append(product.multiplexConfigurationId());
+    return name;
+}
+
+static QString commandLine(const RuleCommand &command)
+{
+    QString cmdLine = shellQuote(QDir::toNativeSeparators(command.executable()),
+                                 command.arguments());
+    if (!command.workingDirectory().isEmpty()) {
+        const QString dir = shellQuote(QDir::toNativeSeparators(command.workingDirectory()));
+        cmdLine.prepend((HostOsInfo::isWindowsHost() ? QStringLiteral("cd /d ")
+                                                     : QStringLiteral("cd "))
+                        + dir + QStringLiteral(" && "));
+    }
+    if (!command.stdoutFilePath().isEmpty()) {
+        cmdLine += QStringLiteral(" > ")
+                + shellQuote(QDir::toNativeSeparators(command.stdoutFilePath()));
+    }
+    if (!command.stderrFilePath().isEmpty()) {
+        cmdLine += QStringLiteral(" 2> ")
+                + shellQuote(QDir::toNativeSeparators(command.stderrFilePath()));
+    }
+    return cmdLine;
+}
+
+// Commands that cannot be expressed as plain command lines. For simplicity, that includes
+// commands that set up additional environment variables. Output filters and tolerated
+// non-zero exit codes have no shell equivalent either.
+static bool commandNeedsFallback(const RuleCommand &command)
+{
+    return command.type() == RuleCommand::JavaScriptCommandType
+            || !command.environment().isEmpty()
+            || !command.stdoutFilterFunction().isEmpty()
+            || !command.stderrFilterFunction().isEmpty()
+            || command.maxExitCode() != 0;
+}
+
+// Compilers can report the headers they read, in which case ninja does not need to be told
+// about them upfront.
+enum class DepsType { None, Gcc, Msvc };
+static DepsType depsType(const RuleCommand &command, QString *depFile)
+{
+    const QStringList args = command.arguments();
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (arg == QLatin1String("-MF") && i + 1 < args.size()) {
+            *depFile = args.at(i + 1);
+            return DepsType::Gcc;
+        }
+        if (arg.startsWith(QLatin1String("-MF"))) {
+            *depFile = arg.mid(3);
+            return DepsType::Gcc;
+        }
+        if (arg.compare(QLatin1String("/showIncludes"), Qt::CaseInsensitive) == 0
+                || arg.compare(QLatin1String("-showIncludes"), Qt::CaseInsensitive) == 0) {
+            return DepsType::Msvc;
+        }
+    }
+    return DepsType::None;
+}
+
+// Products with commands that cannot be expressed as command lines are built by qbs itself.
+// qbs does not touch outputs that are already up to date, hence "restat".
+static QString fallbackCommandLine(const GeneratableProject &project, const QString &qbsFilePath,
+                                   const QString &settingsDir, const QString &configurationName,
+                                   const ProductData &product)
+{
+    QStringList args{QStringLiteral("build")};
+    if (!settingsDir.isEmpty())
+        args << QStringLiteral("--settings-dir") << settingsDir;
+    args << QStringLiteral("-f") << project.filePath().absoluteFilePath()
+         << QStringLiteral("-d") << project.baseBuildDirectory().absolutePath()
+         << QStringLiteral("-p") << product.name()
+         << QStringLiteral("--wait-lock")
+         << project.commandLines.value(configurationName);
+    return shellQuote(QDir::toNativeSeparators(qbsFilePath), args);
+}
+
+static void writeRules(QTextStream &stream)
+{
+    const QString shellPrefix = HostOsInfo::isWindowsHost() ? QStringLiteral("cmd /c ")
+                                                            : QString();
+    stream << "ninja_required_version = 1.5\n\n";
+    stream << "pool qbs_fallback\n"
+           << "  depth = 1\n\n";
+    stream << "rule qbs_command\n"
+           << "  command = " << shellPrefix << "$cmd\n"
+           << "  description = $desc\n\n";
+    stream << "rule qbs_command_gcc_deps\n"
+           << "  command = " << shellPrefix << "$cmd\n"
+           << "  description = $desc\n"
+           << "  depfile = $depfile\n"
+           << "  deps = gcc\n\n";
+    stream << "rule qbs_command_msvc_deps\n"
+           << "  command = " << shellPrefix << "$cmd\n"
+           << "  description = $desc\n"
+           << "  deps = msvc\n\n";
+    stream << "rule qbs_fallback\n"
+           << "  command = $cmd\n"
+           << "  description = $desc\n"
+           << "  restat = 1\n"
+           << "  pool = qbs_fallback\n\n";
+}
+
+static bool productNeedsFallback(const ProductTransformerData &productTransformerData)
+{
+    for (const TransformerData &transformerData : productTransformerData) {
+        const RuleCommandList commands = transformerData.commands();
+        if (std::any_of(commands.cbegin(), commands.cend(), commandNeedsFallback))
+            return true;
+    }
+    return false;
+}
+
+// qbs builds the whole product, so there must be exactly one edge for it. Otherwise, ninja
+// would run several builds of the same product in parallel.
+static void writeFallbackEdge(QTextStream &stream,
+                              const ProductTransformerData &productTransformerData,
+                              const QString &cmdLine, const QString &productName)
+{
+    QStringList outputs;
+    QSet<QString> outputSet;
+    for (const TransformerData &transformerData : productTransformerData) {
+        for (const ArtifactData &output : transformerData.outputs()) {
+            outputs << output.filePath();
+            outputSet << output.filePath();
+        }
+    }
+    QStringList inputs;
+    QSet<QString> inputSet;
+    for (const TransformerData &transformerData : productTransformerData) {
+        for (const ArtifactData &input : transformerData.inputs()) {
+            const QString &filePath = input.filePath();
+            if (outputSet.contains(filePath) || inputSet.contains(filePath))
+                continue;
+            inputs << filePath;
+            inputSet << filePath;
+        }
+    }
+    stream << "build";
+    for (const QString &output : qAsConst(outputs))
+        stream << ' ' << escapePath(output);
+    stream << ": qbs_fallback";
+    for (const QString &input : qAsConst(inputs))
+        stream << ' ' << escapePath(input);
+    stream << '\n';
+    stream << "  cmd = " << escapeValue(cmdLine) << '\n';
+    stream << "  desc = " << escapeValue(Tr::tr("Building product '%1' with qbs")
+                                         .arg(productName)) << '\n';
+}
+
+static void writeCommandEdge(QTextStream &stream, const TransformerData &transformerData)
+{
+    QStringList commandLines;
+    QStringList descriptions;
+    QString depFile;
+    DepsType deps = DepsType::None;
+    for (const RuleCommand &command : transformerData.commands()) {
+        if (!command.description().isEmpty())
+            descriptions << command.description();
+        commandLines << commandLine(command);
+        if (deps == DepsType::None)
+            deps = depsType(command, &depFile);
+    }
+    QString rule;
+    if (deps == DepsType::Gcc)
+        rule = QStringLiteral("qbs_command_gcc_deps");
+    else if (deps == DepsType::Msvc)
+        rule = QStringLiteral("qbs_command_msvc_deps");
+    else
+        rule = QStringLiteral("qbs_command");
+    stream << "build";
+    for (const ArtifactData &output : transformerData.outputs())
+        stream << ' ' << escapePath(output.filePath());
+    stream << ": " << rule;
+    for (const ArtifactData &input : transformerData.inputs())
+        stream << ' ' << escapePath(input.filePath());
+    stream << '\n';
+    stream << "  cmd = " << escapeValue(commandLines.join(QStringLiteral(" && "))) << '\n';
+    stream << "  desc = " << escapeValue(descriptions.join(QStringLiteral(", "))) << '\n';
+    if (deps == DepsType::Gcc)
+        stream << "  depfile = " << escapeValue(depFile) << '\n';
+}
+
+void NinjaGenerator::generate()
+{
+    const GeneratableProject theProject = project();
+    const QString qbsFilePath = qbsExecutableFilePath().absoluteFilePath();
+    for (auto it = theProject.projects.cbegin(); it != theProject.projects.cend(); ++it) {
+        const QString &configurationName = it.key();
+        const Project &buildProject = it.value();
+        const ProjectData projectData = buildProject.projectData();
+        const QString ninjaFilePath = projectData.buildDirectory() + QLatin1String("/build.ninja");
+        ErrorInfo error;
+        const ProjectTransformerData projectTransformerData
+                = buildProject.transformerData(&error);
+        if (error.hasError())
+            throw error;
+
+        QString contents;
+        QTextStream stream(&contents);
+        stream << "# This file was generated by qbs\n\n";
+        writeRules(stream);
+
+        QStringList defaultTargets;
+        int fallbackCount = 0;
+        for (const auto &d : projectTransformerData) {
+            const ProductData &productData = d.first;
+            const ProductTransformerData &productTransformerData = d.second;
+            stream << "# Product '" << productData.fullDisplayName() << "'\n";
+            if (productNeedsFallback(productTransformerData)) {
+                ++fallbackCount;
+                writeFallbackEdge(stream, productTransformerData,
+                                  fallbackCommandLine(theProject, qbsFilePath, qbsSettingsDir(),
+                                                      configurationName, productData),
+                                  productData.fullDisplayName());
+            } else {
+                for (const TransformerData &transformerData : productTransformerData)
+                    writeCommandEdge(stream, transformerData);
+            }
+
+            const QString productTarget = makeValidTargetName(productData);
+            stream << "build " << productTarget << ": phony";
+            for (const ArtifactData &ta : productData.targetArtifacts())
+                stream << ' ' << escapePath(ta.filePath());
+            stream << "\n\n";
+            if (productData.properties().value(
+                        StringConstants::builtByDefaultProperty()).toBool()) {
+                defaultTargets << productTarget;
+            }
+        }
+        stream << "build all: phony " << defaultTargets.join(QLatin1Char(' ')) << '\n';
+        stream << "default all\n";
+        stream.flush();
+
+        // Ninja re-reads its manifest only if it changed.
+        FileSaver saver(ninjaFilePath.toStdString());
+        if (!saver.open() || !saver.write(contents.toStdString()) || !saver.commit())
+            throw ErrorInfo(Tr::tr("Failed to write '%1'.").arg(ninjaFilePath));
+
+        if (fallbackCount > 0) {
+            logger().qbsInfo() << Tr::tr("%n product(s) have commands that cannot be expressed "
+                                         "as command lines and will be built by calling "
+                                         "back into qbs.", nullptr, fallbackCount);
+        }
+        logger().qbsInfo() << Tr::tr("Ninja build file successfully generated at '%1'.")
+                              .arg(ninjaFilePath);
+    }
+}
+
+} // namespace qbs
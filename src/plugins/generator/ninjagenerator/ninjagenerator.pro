@@ -0,0 +1,12 @@
+include(../../plugins.pri)
+
+TARGET = ninjagenerator
+
+QT = core
+
+HEADERS += \
+    $$PWD/ninjagenerator.h
+
+SOURCES += \
+    $$PWD/ninjagenerator.cpp \
+    $$PWD/ninjageneratorplugin.cpp
@@ -41,10 +41,36 @@
 #include "../msbuild/msbuildproperty.h"
 #include "../msbuild/msbuildpropertygroup.h"
 
+#include <QtCore/qiodevice.h>
 #include <QtCore/qxmlstream.h>
 
+#include <memory>
+#include <ostream>
+
 namespace qbs {
 
+// Lets the XML writer stream into the output device rather than into a buffer of its own.
+class OStreamDevice : public QIODevice
+{
+public:
+    explicit OStreamDevice(std::ostream *stream) : m_stream(stream)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        m_stream->write(data, size);
+        return m_stream->good() ? size : -1;
+    }
+
+private:
+    std::ostream * const m_stream;
+};
+
 static const QString kMSBuildSchemaURI =
         QStringLiteral("http://schemas.microsoft.com/developer/msbuild/2003");
 
@@ -52,7 +78,7 @@ class MSBuildProjectWriterPrivate : public IMSBuildNodeVisitor
 {
 public:
     std::ostream *device;
-    QByteArray buffer;
+    std::unique_ptr<OStreamDevice> outputDevice;
     std::unique_ptr<QXmlStreamWriter> writer;
 
     void visitStart(const MSBuildImport *import) override;
@@ -87,7 +113,8 @@ MSBuildProjectWriter::MSBuildProjectWriter(std::ostream *device)
     : d(new MSBuildProjectWriterPrivate)
 {
     d->device = device;
-    d->writer.reset(new QXmlStreamWriter(&d->buffer));
+    d->outputDevice.reset(new OStreamDevice(device));
+    d->writer.reset(new QXmlStreamWriter(d->outputDevice.get()));
     d->writer->setAutoFormatting(true);
 }
 
@@ -98,14 +125,10 @@ MSBuildProjectWriter::~MSBuildProjectWriter()
 
 bool MSBuildProjectWriter::write(const MSBuildProject *project)
 {
-    d->buffer.clear();
     d->writer->writeStartDocument();
     project->accept(d);
     d->writer->writeEndDocument();
-    if (d->writer->hasError())
-        return false;
-    d->device->write(&*std::begin(d->buffer), d->buffer.size());
-    return d->device->good();
+    return !d->writer->hasError() && d->device->good();
 }
 
 void MSBuildProjectWriterPrivate::visitStart(const MSBuildImport *import)
@@ -52,6 +52,7 @@
 #include <logging/logger.h>
 #include <logging/translator.h>
 #include <tools/filesaver.h>
+#include <tools/parallelfor.h>
 #include <tools/qbsassert.h>
 #include <tools/shellutils.h>
 #include <tools/visualstudioversioninfo.h>
@@ -60,6 +61,10 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qthread.h>
+#include <QtCore/quuid.h>
+
+#include <vector>
 
 namespace qbs {
 
@@ -82,6 +87,15 @@ public:
     QMap<GeneratableProjectData::Id, VisualStudioSolutionFolderProject *> solutionFolders;
     QList<std::pair<QString, bool>> propertySheetNames;
 
+    // The product project files make up the bulk of the output. They are independent
+    // of each other, so we create and write them concurrently after the solution is set up.
+    struct ProductProject {
+        QString filePath;
+        GeneratableProductData productData;
+        QUuid guid;
+    };
+    std::vector<ProductProject> productProjects;
+
     void reset();
 };
 
@@ -94,6 +108,7 @@ void VisualStudioGeneratorPrivate::reset()
     solutionProjects.clear();
     solutionFolders.clear();
     propertySheetNames.clear();
+    productProjects.clear();
 }
 
 class SolutionDependenciesVisitor : public IGeneratableProjectVisitor
@@ -187,10 +202,9 @@ void VisualStudioGenerator::addPropertySheets(const GeneratableProject &project)
     }
 }
 
-void VisualStudioGenerator::addPropertySheets(
-        const std::shared_ptr<MSBuildTargetProject> &targetProject)
+void VisualStudioGenerator::addPropertySheets(MSBuildTargetProject *targetProject)
 {
-    for (const auto &pair : d->propertySheetNames) {
+    for (const auto &pair : qAsConst(d->propertySheetNames)) {
         targetProject->appendPropertySheet(
                     QStringLiteral("$(SolutionDir)\\") + pair.first, pair.second);
     }
@@ -243,21 +257,24 @@ static void addDefaultGlobalSections(const GeneratableProject &topLevelProject,
                                          QStringLiteral("FALSE"));
 }
 
+static void writeProjectFile(const QString &projectFilePath, const MSBuildProject *project)
+{
+    Internal::FileSaver file(projectFilePath.toStdString());
+    if (!file.open())
+        throw ErrorInfo(Tr::tr("Cannot open %1 for writing").arg(projectFilePath));
+
+    MSBuildProjectWriter writer(file.device());
+    if (!(writer.write(project) && file.commit()))
+        throw ErrorInfo(Tr::tr("Failed to generate %1").arg(projectFilePath));
+}
+
 static void writeProjectFiles(const QMap<QString, std::shared_ptr<MSBuildProject>> &projects)
 {
     // Write out all the MSBuild project files to disk
     QMapIterator<QString, std::shared_ptr<MSBuildProject>> it(projects);
     while (it.hasNext()) {
         it.next();
-        const auto projectFilePath = it.key();
-        Internal::FileSaver file(projectFilePath.toStdString());
-        if (!file.open())
-            throw ErrorInfo(Tr::tr("Cannot open %s for writing").arg(projectFilePath));
-
-        std::shared_ptr<MSBuildProject> project = it.value();
-        MSBuildProjectWriter writer(file.device());
-        if (!(writer.write(project.get()) && file.commit()))
-            throw ErrorInfo(Tr::tr("Failed to generate %1").arg(projectFilePath));
+        writeProjectFile(it.key(), it.value().get());
     }
 }
 
@@ -279,21 +296,40 @@ static void writeSolution(const std::shared_ptr<VisualStudioSolution> &solution,
 
 void VisualStudioGenerator::generate()
 {
-    GeneratableProjectIterator it(project());
+    const GeneratableProject theProject = project();
+    GeneratableProjectIterator it(theProject);
     it.accept(this);
 
-    addDefaultGlobalSections(project(), d->solution.get());
+    addDefaultGlobalSections(theProject, d->solution.get());
 
     // Second pass: connection solution project interdependencies and project nesting hierarchy
     SolutionDependenciesVisitor solutionDependenciesVisitor(this);
     it.accept(&solutionDependenciesVisitor);
 
     writeProjectFiles(d->msbuildProjects);
+    writeProductProjectFiles(theProject);
     writeSolution(d->solution, d->solutionFilePath, logger());
 
     d->reset();
 }
 
+// Each product's project is created, written and destroyed in one go, so only a few of them
+// exist at any time.
+void VisualStudioGenerator::writeProductProjectFiles(const GeneratableProject &project)
+{
+    parallelFor(d->productProjects.size(), QThread::idealThreadCount(), [&](std::size_t i) {
+        const VisualStudioGeneratorPrivate::ProductProject &productProject
+                = d->productProjects.at(i);
+        MSBuildQbsProductProject targetProject(project, productProject.productData,
+                                               d->versionInfo);
+        targetProject.setGuid(productProject.guid);
+        addPropertySheets(&targetProject);
+        writeProjectFile(productProject.filePath, &targetProject);
+        const MSBuildFiltersProject filtersProject(productProject.productData);
+        writeProjectFile(productProject.filePath + QStringLiteral(".filters"), &filtersProject);
+    });
+}
+
 void VisualStudioGenerator::visitProject(const GeneratableProject &project)
 {
     addPropertySheets(project);
@@ -316,7 +352,7 @@ void VisualStudioGenerator::visitProject(const GeneratableProject &project)
     targetProject->setGuid(d->guidPool->drawProductGuid(relativeProjectFilePath.toStdString()));
     d->msbuildProjects.insert(projectFilePath, targetProject);
 
-    addPropertySheets(targetProject);
+    addPropertySheets(targetProject.get());
 
     auto solutionProject = new VisualStudioSolutionFileProject(
                 targetFilePath(qbsGenerate, project.baseBuildDirectory().absolutePath()),
@@ -346,20 +382,13 @@ void VisualStudioGenerator::visitProduct(const GeneratableProject &project,
                                                 project.baseBuildDirectory().absolutePath());
     const auto relativeProjectFilePath = QFileInfo(d->solutionFilePath)
             .dir().relativeFilePath(projectFilePath);
-    auto targetProject = std::make_shared<MSBuildQbsProductProject>(project, productData,
-                                                                          d->versionInfo);
-    targetProject->setGuid(d->guidPool->drawProductGuid(relativeProjectFilePath.toStdString()));
-
-    addPropertySheets(targetProject);
-
-    d->msbuildProjects.insert(projectFilePath, targetProject);
-    d->msbuildProjects.insert(projectFilePath + QStringLiteral(".filters"),
-                          std::make_shared<MSBuildFiltersProject>(productData));
+    const QUuid guid = d->guidPool->drawProductGuid(relativeProjectFilePath.toStdString());
+    d->productProjects.push_back({ projectFilePath, productData, guid });
 
     auto solutionProject = new VisualStudioSolutionFileProject(
                 targetFilePath(productData, project.baseBuildDirectory().absolutePath()),
                 d->solution.get());
-    solutionProject->setGuid(targetProject->guid());
+    solutionProject->setGuid(guid);
     d->solution->appendProject(solutionProject);
     d->solutionProjects.insert(productData.name(), solutionProject);
 }
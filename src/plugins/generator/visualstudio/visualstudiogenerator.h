@@ -70,7 +70,8 @@ private:
                               const GeneratableProductData &productData) override;
 
     void addPropertySheets(const GeneratableProject &project);
-    void addPropertySheets(const std::shared_ptr<MSBuildTargetProject> &targetProject);
+    void addPropertySheets(MSBuildTargetProject *targetProject);
+    void writeProductProjectFiles(const GeneratableProject &project);
 
     std::unique_ptr<VisualStudioGeneratorPrivate> d;
 };
@@ -36,6 +36,7 @@
 #include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include <json.h>
 
@@ -48,6 +49,7 @@ class VisualStudioGuidPoolPrivate
 public:
     std::string storeFilePath;
     std::map<std::string, QUuid> productGuids;
+    std::mutex mutex;
 };
 
 VisualStudioGuidPool::VisualStudioGuidPool(const std::string &storeFilePath)
@@ -85,9 +87,13 @@ VisualStudioGuidPool::~VisualStudioGuidPool()
 
 QUuid VisualStudioGuidPool::drawProductGuid(const std::string &productName)
 {
-    if (d->productGuids.find(productName) == d->productGuids.cend())
-        d->productGuids.insert({ productName, QUuid::createUuid() });
-    return d->productGuids.at(productName);
+    std::lock_guard<std::mutex> lock(d->mutex);
+    const auto it = d->productGuids.find(productName);
+    if (it != d->productGuids.cend())
+        return it->second;
+    const QUuid guid = QUuid::createUuid();
+    d->productGuids.insert({ productName, guid });
+    return guid;
 }
 
 } // namespace qbs
@@ -44,6 +44,7 @@ class VisualStudioGuidPoolPrivate;
  * These are stored on disk separately from project files and so allow projects to be
  * regenerated while retaining the same GUIDs. This helps avoid unnecessary project
  * reloads in Visual Studio, and helps ease source control usage.
+ * GUIDs can be drawn from several threads at once.
  */
 class VisualStudioGuidPool
 {
@@ -977,6 +977,73 @@ void TestApi::changeDependentLib()
     VERIFY_NO_ERROR(errorInfo);
 }
 
+static QStringList productNames(const QList<qbs::ProductData> &products)
+{
+    QStringList names;
+    for (const qbs::ProductData &p : products)
+        names << p.name();
+    return names;
+}
+
+void TestApi::changedProducts()
+{
+    const qbs::SetupProjectParameters setupParams = defaultSetupParameters("changed-products");
+    std::unique_ptr<qbs::SetupProjectJob> setupJob(qbs::Project().setupProject(setupParams,
+                                                                              m_logSink, 0));
+    waitForFinished(setupJob.get());
+    QVERIFY2(!setupJob->error().hasError(), qPrintable(setupJob->error().toString()));
+    qbs::Project project = setupJob->project();
+    QVERIFY(project.isValid());
+    const quint64 initialGeneration = project.buildGraphGeneration();
+    QVERIFY(project.changedProducts(initialGeneration).empty());
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("b.qbs", "\"original\"", "\"changed\"");
+    setupJob.reset(project.setupProject(setupParams, m_logSink, 0));
+    waitForFinished(setupJob.get());
+    QVERIFY2(!setupJob->error().hasError(), qPrintable(setupJob->error().toString()));
+    project = setupJob->project();
+    QVERIFY(project.isValid());
+    const quint64 generationAfterChange = project.buildGraphGeneration();
+    QVERIFY(generationAfterChange > initialGeneration);
+    QStringList removedProducts;
+    qbs::ErrorInfo error;
+    QCOMPARE(productNames(project.changedProducts(initialGeneration, &removedProducts, &error)),
+             QStringList("b"));
+    VERIFY_NO_ERROR(error);
+    QVERIFY(removedProducts.empty());
+    const qbs::ProductData changedProduct
+            = project.changedProducts(initialGeneration).front();
+    QCOMPARE(changedProduct.properties().value("someProperty").toString(),
+             QString("changed"));
+    QCOMPARE(changedProduct.groups().size(), 1);
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("changed-products.qbs", ", \"c.qbs\"", "");
+    setupJob.reset(project.setupProject(setupParams, m_logSink, 0));
+    waitForFinished(setupJob.get());
+    QVERIFY2(!setupJob->error().hasError(), qPrintable(setupJob->error().toString()));
+    project = setupJob->project();
+    QVERIFY(project.isValid());
+    QVERIFY(!productNames(project.changedProducts(generationAfterChange, &removedProducts))
+            .contains("c"));
+    QCOMPARE(removedProducts, QStringList("c"));
+    removedProducts.clear();
+    QVERIFY(productNames(project.changedProducts(initialGeneration, &removedProducts))
+            .contains("b"));
+    QCOMPARE(removedProducts, QStringList("c"));
+    QVERIFY(project.changedProducts(project.buildGraphGeneration()).empty());
+
+    // Product data handed out earlier stays as it is, even after the project is gone.
+    const qbs::ProductData productOfGoneProject = project.projectData().products.front();
+    const QList<qbs::GroupData> groupsOfGoneProject = productOfGoneProject.groups();
+    QVERIFY(!groupsOfGoneProject.empty());
+    setupJob.reset();
+    project = qbs::Project();
+    QVERIFY(productOfGoneProject.isValid());
+    QCOMPARE(productOfGoneProject.groups(), groupsOfGoneProject);
+}
+
 void TestApi::enableAndDisableProduct()
 {
     BuildDescriptionReceiver bdr;
@@ -2200,6 +2267,39 @@ void TestApi::projectDataAfterProductInvalidation()
             != productAfterBulding.generatedArtifacts());
 }
 
+void TestApi::processResourceUsage()
+{
+    ProcessResultReceiver resultReceiver;
+    const qbs::ErrorInfo errorInfo = doBuildProject("process-resource-usage", nullptr,
+                                                    &resultReceiver);
+    VERIFY_NO_ERROR(errorInfo);
+    std::vector<qbs::ProcessResult> workerResults;
+    std::copy_if(resultReceiver.results.cbegin(), resultReceiver.results.cend(),
+                 std::back_inserter(workerResults), [](const qbs::ProcessResult &result) {
+        return result.executableFilePath().contains("worker");
+    });
+
+    // The four worker processes run concurrently, so this also covers reaping several
+    // children at once.
+    QCOMPARE(int(workerResults.size()), 4);
+    for (const qbs::ProcessResult &result : workerResults) {
+        QVERIFY(result.success());
+        QVERIFY2(result.elapsedTime() >= 300, qPrintable(QString::number(result.elapsedTime())));
+        QVERIFY2(result.elapsedTime() < 60000, qPrintable(QString::number(result.elapsedTime())));
+        QVERIFY2(result.userCpuTime() > 0, qPrintable(QString::number(result.userCpuTime())));
+        QVERIFY2(result.systemCpuTime() >= 0, qPrintable(QString::number(result.systemCpuTime())));
+
+        // Allow for the granularity of the clocks involved.
+        QVERIFY2(result.userCpuTime() + result.systemCpuTime() <= result.elapsedTime() + 100,
+                 qPrintable(QString::fromLatin1("%1 + %2 > %3").arg(result.userCpuTime())
+                            .arg(result.systemCpuTime()).arg(result.elapsedTime())));
+        QVERIFY2(result.peakResidentSetSize() >= 64 * 1024 * 1024,
+                 qPrintable(QString::number(result.peakResidentSetSize())));
+        QVERIFY2(result.peakResidentSetSize() < qint64(1024) * 1024 * 1024,
+                 qPrintable(QString::number(result.peakResidentSetSize())));
+    }
+}
+
 void TestApi::processResult()
 {
     // On Windows, even closed files seem to sometimes block the removal of their parent directories
@@ -2857,6 +2957,18 @@ void TestApi::transformerData()
     }
     QVERIFY(firstTransformerFound);
     QVERIFY(secondTransformerFound);
+
+    const qbs::ProjectTransformerData filteredTData
+            = project.transformerData(QStringList("theType"), &error);
+    QVERIFY2(!error.hasError(), qPrintable(error.toString()));
+    QCOMPARE(filteredTData.size(), 1);
+    QCOMPARE(filteredTData.first().second.size(), 1);
+    const qbs::TransformerData &filteredTransformer = filteredTData.first().second.first();
+    QCOMPARE(filteredTransformer.outputs().size(), 1);
+    QCOMPARE(QFileInfo(filteredTransformer.outputs().first().filePath()).fileName(),
+             QString("artifact2"));
+    QVERIFY(project.transformerData(QStringList("noSuchTag"), &error).empty());
+    QVERIFY2(!error.hasError(), qPrintable(error.toString()));
 }
 
 void TestApi::transformers()
@@ -72,6 +72,7 @@ private slots:
     void changeContent();
 #endif
     void changeDependentLib();
+    void changedProducts();
     void checkOutputs();
     void checkOutputs_data();
     void commandExtraction();
@@ -114,6 +115,7 @@ private slots:
     void nonexistingProjectPropertyFromProduct();
     void objC();
     void projectDataAfterProductInvalidation();
+    void processResourceUsage();
     void processResult();
     void processResult_data();
     void projectInvalidation();
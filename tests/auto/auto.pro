@@ -3,6 +3,7 @@ TEMPLATE=subdirs
 qbs_enable_unit_tests {
     SUBDIRS += \
         buildgraph \
+        corelibbenchmarks \
         language \
         tools \
 }
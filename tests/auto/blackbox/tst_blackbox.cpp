@@ -40,7 +40,9 @@
 #include <tools/stlutils.h>
 #include <tools/version.h>
 
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonobject.h>
@@ -50,10 +52,17 @@
 #include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
 
+#include <cstring>
 #include <functional>
 #include <regex>
 #include <utility>
 
+#ifdef Q_OS_UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 #define WAIT_FOR_NEW_TIMESTAMP() waitForNewTimestamp(testDataDir)
 
 using qbs::Internal::HostOsInfo;
@@ -687,6 +696,65 @@ void TestBlackbox::buildGraphVersions()
     QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
 }
 
+void TestBlackbox::buildServer()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("The build server is only supported on Unix");
+#else
+    QDir::setCurrent(testDataDir + "/build-server");
+
+    // Socket file paths are rather limited in length, so we cannot use the test directory.
+    QTemporaryDir socketDir;
+    QVERIFY(socketDir.isValid());
+    const QString socketFilePath = socketDir.path() + "/socket";
+    QProcess server;
+    server.start(qbsExecutableFilePath,
+                 QStringList{"serve", "--server-socket", socketFilePath});
+    QVERIFY(server.waitForStarted());
+    QTRY_VERIFY(QFileInfo(socketFilePath).exists());
+
+    // The output of the server arrives at the client.
+    const QbsRunParameters serverParams("build", QStringList{"--server-socket", socketFilePath});
+    QCOMPARE(runQbs(serverParams), 0);
+    QVERIFY2(m_qbsStdout.contains("creating output.txt"), m_qbsStdout.constData());
+    QVERIFY(regularFileExists(relativeProductBuildDir("build-server") + "/output.txt"));
+
+    // The server holds the build graph lock, so the work cannot have been done locally.
+    QbsRunParameters localParams;
+    localParams.expectFailure = true;
+    QVERIFY(runQbs(localParams) != 0);
+    QVERIFY2(m_qbsStderr.contains("Cannot lock build graph file"), m_qbsStderr.constData());
+
+    // A malformed request must not take the server down.
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    QVERIFY(fd != -1);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof address);
+    address.sun_family = AF_UNIX;
+    const QByteArray encodedSocketFilePath = QFile::encodeName(socketFilePath);
+    std::memcpy(address.sun_path, encodedSocketFilePath.constData(),
+                encodedSocketFilePath.size());
+    QVERIFY(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof address) == 0);
+    const char garbage[] = "garbage";
+    QCOMPARE(::write(fd, garbage, sizeof garbage), ssize_t(sizeof garbage));
+    char c;
+    while (::read(fd, &c, 1) > 0)
+        ;
+    ::close(fd);
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("input.txt", "old", "new");
+    QCOMPARE(runQbs(serverParams), 0);
+    QVERIFY2(m_qbsStdout.contains("creating output.txt"), m_qbsStdout.constData());
+    QFile output(relativeProductBuildDir("build-server") + "/output.txt");
+    QVERIFY2(output.open(QIODevice::ReadOnly), qPrintable(output.errorString()));
+    QCOMPARE(output.readAll().trimmed(), QByteArray("new"));
+    QCOMPARE(server.state(), QProcess::Running);
+    server.terminate();
+    QVERIFY(server.waitForFinished());
+#endif
+}
+
 void TestBlackbox::changedFiles_data()
 {
     QTest::addColumn<bool>("useChangedFilesForInitialBuild");
@@ -2222,6 +2290,32 @@ void TestBlackbox::referenceErrorInExport()
         "referenceErrorInExport.qbs:15:12 ReferenceError: Can't find variable: includePaths"));
 }
 
+void TestBlackbox::removeInBackground()
+{
+    QDir::setCurrent(testDataDir + "/remove-in-background");
+    QCOMPARE(runQbs(), 0);
+    const QString productBuildDir = relativeProductBuildDir("p");
+    QVERIFY(regularFileExists(productBuildDir + "/output.txt"));
+    QVERIFY(regularFileExists(productBuildDir + "/not-an-artifact.txt"));
+
+    // Leftovers from an earlier run get removed as well.
+    const QString trashDir = relativeBuildDir() + "/.trash";
+    QVERIFY(QDir::root().mkpath(QFileInfo(trashDir + "/leftover").absoluteFilePath()));
+    QbsRunParameters params("clean", QStringList("--remove-in-background"));
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY(!directoryExists(productBuildDir));
+
+    // The removal happens in a detached process, so we cannot know when it is finished.
+    QElapsedTimer timer;
+    timer.start();
+    while (directoryExists(trashDir) && timer.elapsed() < 30000)
+        QTest::qWait(100);
+    QVERIFY(!directoryExists(trashDir));
+
+    QCOMPARE(runQbs(), 0);
+    QVERIFY(regularFileExists(productBuildDir + "/output.txt"));
+}
+
 void TestBlackbox::reproducibleBuild()
 {
     const SettingsPtr s = settings();
@@ -2390,6 +2484,45 @@ void TestBlackbox::setupRunEnvironment()
              m_qbsStdout.constData());
 }
 
+void TestBlackbox::skipUnchangedOutputs()
+{
+    QDir::setCurrent(testDataDir + "/skip-unchanged-outputs");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("creating final.txt"), m_qbsStdout.constData());
+
+    // The generator runs, but its output stays the same, so the final artifact is up to date.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("input.txt", "line 2", "# comment\nline 2");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("creating final.txt"), m_qbsStdout.constData());
+
+    // The generator does not need to run again, even though its output is older than its input.
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("creating final.txt"), m_qbsStdout.constData());
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("input.txt", "line 2", "line 3");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("creating final.txt"), m_qbsStdout.constData());
+    QFile finalFile(relativeProductBuildDir("skip-unchanged-outputs") + "/final.txt");
+    QVERIFY2(finalFile.open(QIODevice::ReadOnly), qPrintable(finalFile.fileName()));
+    QCOMPARE(finalFile.readAll().trimmed().split('\n').last().trimmed(), QByteArray("line 3"));
+
+    // An output that one command keeps unchanged, but a later command rewrites, has changed.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("input2.txt", "first", "second");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated2.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("creating final2.txt"), m_qbsStdout.constData());
+    QFile final2File(relativeProductBuildDir("skip-unchanged-outputs") + "/final2.txt");
+    QVERIFY2(final2File.open(QIODevice::ReadOnly), qPrintable(final2File.fileName()));
+    QCOMPARE(final2File.readAll().trimmed(), QByteArray("second"));
+}
+
 void TestBlackbox::smartRelinking()
 {
     QDir::setCurrent(testDataDir + "/smart-relinking");
@@ -3500,6 +3633,49 @@ void TestBlackbox::fileDependencies()
     QVERIFY(!m_qbsStdout.contains("compiling zort.cpp"));
 }
 
+void TestBlackbox::fileSystemJournal()
+{
+    QDir::setCurrent(testDataDir + "/fs-journal");
+    const QString journalFilePath = QDir::currentPath() + "/journal";
+    QFile journal(journalFilePath);
+    QVERIFY(journal.open(QIODevice::WriteOnly));
+    journal.write("qbs-fs-journal 1 session\nroot " + QDir::currentPath().toUtf8()
+                  + "\nevents\n");
+    journal.close();
+    const auto appendToJournal = [&journal](const QString &fileName) {
+        QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+        journal.write("c " + QDir::currentPath().toUtf8() + '/' + fileName.toUtf8() + '\n');
+        journal.close();
+    };
+    const QStringList journalArgs{"--fs-journal", journalFilePath};
+
+    QCOMPARE(runQbs(QbsRunParameters(journalArgs)), 0);
+    QVERIFY2(m_qbsStdout.contains("copying a.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("copying b.txt"), m_qbsStdout.constData());
+
+    // A change to a product that is not built must not get lost.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("b.txt", "b", "bb");
+    appendToJournal("b.txt");
+    QCOMPARE(runQbs(QbsRunParameters(QStringList(journalArgs) << "-p" << "a")), 0);
+    QVERIFY2(!m_qbsStdout.contains("copying"), m_qbsStdout.constData());
+    QCOMPARE(runQbs(QbsRunParameters(journalArgs)), 0);
+    QVERIFY2(!m_qbsStdout.contains("copying a.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("copying b.txt"), m_qbsStdout.constData());
+
+    // Neither must a change that was only seen by a resolve.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("a.txt", "a", "aa");
+    appendToJournal("a.txt");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", journalArgs)), 0);
+    QCOMPARE(runQbs(QbsRunParameters(journalArgs)), 0);
+    QVERIFY2(m_qbsStdout.contains("copying a.txt"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("copying b.txt"), m_qbsStdout.constData());
+
+    QCOMPARE(runQbs(QbsRunParameters(journalArgs)), 0);
+    QVERIFY2(!m_qbsStdout.contains("copying"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::fileTagsFilterMerging()
 {
     QDir::setCurrent(testDataDir + "/filetagsfilter-merging");
@@ -3937,6 +4113,16 @@ void TestBlackbox::jsExtensionsTextFile()
     QCOMPARE(lines.at(3).trimmed().constData(), "Third line.");
     QCOMPARE(lines.at(4).trimmed().constData(), qPrintable(QDir::currentPath() + "/file1.txt"));
     QCOMPARE(lines.at(5).trimmed().constData(), "true");
+    QFile file4("file4.txt");
+    QVERIFY(file4.exists());
+    QVERIFY(file4.open(QIODevice::ReadOnly));
+    const QList<QByteArray> lines4 = file4.readAll().trimmed().split('\n');
+    QCOMPARE(lines4.size(), 5);
+    QCOMPARE(lines4.at(0).trimmed().constData(), "3");
+    QCOMPARE(lines4.at(1).trimmed().constData(), "one 1");
+    QCOMPARE(lines4.at(2).trimmed().constData(), "two 2 1");
+    QCOMPARE(lines4.at(3).trimmed().constData(), "three ${C} ${toString}");
+    QCOMPARE(lines4.at(4).trimmed().constData(), "a+b+c");
 }
 
 void TestBlackbox::jsExtensionsBinaryFile()
@@ -3961,6 +4147,14 @@ void TestBlackbox::jsExtensionsBinaryFile()
     QCOMPARE(data.at(5), char(0x05));
     QCOMPARE(data.at(6), char(0x06));
     QCOMPARE(data.at(7), char(0xFF));
+    QFile buffer("buffer.dat");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const QByteArray expectedBufferData = QByteArray::fromHex("100203040506");
+    QCOMPARE(buffer.readAll(), expectedBufferData + QByteArray::fromHex("080307ff")
+             + QCryptographicHash::hash(expectedBufferData, QCryptographicHash::Sha256).toHex());
+    QFile padded("padded.dat");
+    QVERIFY(padded.open(QIODevice::ReadOnly));
+    QCOMPARE(padded.readAll(), QByteArray::fromHex("07000000"));
 }
 
 void TestBlackbox::ld()
@@ -4315,6 +4509,64 @@ void TestBlackbox::newOutputArtifact()
     QVERIFY(regularFileExists(the100thArtifact));
 }
 
+void TestBlackbox::ninjaGenerator()
+{
+    QDir::setCurrent(testDataDir + "/ninja-generator");
+    const QbsRunParameters params("generate", QStringList{"-g", "ninja"});
+    QCOMPARE(runQbs(params), 0);
+    const QString ninjaFilePath = relativeBuildDir() + "/build.ninja";
+    QFile ninjaFile(ninjaFilePath);
+    QVERIFY2(ninjaFile.open(QIODevice::ReadOnly), qPrintable(ninjaFile.errorString()));
+    const QByteArray content = ninjaFile.readAll();
+    ninjaFile.close();
+    QVERIFY2(content.contains("build the_app: phony"), content.constData());
+    QCOMPARE(content.count(": qbs_fallback"), 2);
+    QByteArray fallbackOutputs;
+    for (int fallbackEdgeEnd = content.indexOf(": qbs_fallback"); fallbackEdgeEnd != -1;
+         fallbackEdgeEnd = content.indexOf(": qbs_fallback", fallbackEdgeEnd + 1)) {
+        const int fallbackEdgeStart = content.lastIndexOf('\n', fallbackEdgeEnd);
+        const QByteArray outputs
+                = content.mid(fallbackEdgeStart, fallbackEdgeEnd - fallbackEdgeStart);
+        if (outputs.contains("output2.txt"))
+            fallbackOutputs = outputs;
+    }
+    QVERIFY2(fallbackOutputs.contains("output.txt"), content.constData());
+    QVERIFY2(fallbackOutputs.contains("output2.txt"), content.constData());
+    QVERIFY2(content.contains("app-output.txt: qbs_command"), content.constData());
+    QVERIFY2(content.contains("filtered-app-output.txt: qbs_fallback"), content.constData());
+    QVERIFY2(content.contains(" > "), content.constData());
+    QVERIFY2(content.contains("default all"), content.constData());
+    const QDateTime timestamp = QFileInfo(ninjaFilePath).lastModified();
+    WAIT_FOR_NEW_TIMESTAMP();
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(QFileInfo(ninjaFilePath).lastModified(), timestamp);
+
+    const QString ninja = findExecutable(QStringList("ninja"));
+    if (ninja.isEmpty())
+        QSKIP("ninja not found");
+    QProcess ninjaProcess;
+    ninjaProcess.setWorkingDirectory(QDir::currentPath() + '/' + relativeBuildDir());
+    ninjaProcess.start(ninja, QStringList());
+    QVERIFY(waitForProcessSuccess(ninjaProcess));
+    QVERIFY(QFile::exists(relativeExecutableFilePath("the app")));
+    ninjaProcess.start(ninja, QStringList("generated_text"));
+    QVERIFY(waitForProcessSuccess(ninjaProcess));
+    QVERIFY(QFile::exists(relativeProductBuildDir("generated text") + "/output2.txt"));
+    ninjaProcess.start(ninja, QStringList("app_output"));
+    QVERIFY(waitForProcessSuccess(ninjaProcess));
+    QFile appOutput(relativeProductBuildDir("app output") + "/app-output.txt");
+    QVERIFY2(appOutput.open(QIODevice::ReadOnly), qPrintable(appOutput.errorString()));
+    QVERIFY2(appOutput.readAll().contains("Hello, World!"), qPrintable(appOutput.fileName()));
+    ninjaProcess.start(ninja, QStringList("filtered_app_output"));
+    QVERIFY(waitForProcessSuccess(ninjaProcess));
+    QFile filteredAppOutput(relativeProductBuildDir("filtered app output")
+                            + "/filtered-app-output.txt");
+    QVERIFY2(filteredAppOutput.open(QIODevice::ReadOnly),
+             qPrintable(filteredAppOutput.errorString()));
+    QVERIFY2(filteredAppOutput.readAll().contains("HELLO, WORLD!"),
+             qPrintable(filteredAppOutput.fileName()));
+}
+
 void TestBlackbox::noProfile()
 {
     QDir::setCurrent(testDataDir + "/no-profile");
@@ -5822,6 +6074,12 @@ void TestBlackbox::makefileGenerator()
     QDir::setCurrent(testDataDir + "/makefile-generator");
     const QbsRunParameters params("generate", QStringList{"-g", "makefile"});
     QCOMPARE(runQbs(params), 0);
+    const QString productMakefile = relativeBuildDir() + "/makefiles/the_app.mk";
+    QVERIFY2(QFile::exists(productMakefile), qPrintable(productMakefile));
+    const QDateTime productMakefileTimestamp = QFileInfo(productMakefile).lastModified();
+    WAIT_FOR_NEW_TIMESTAMP();
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(QFileInfo(productMakefile).lastModified(), productMakefileTimestamp);
     if (HostOsInfo::isWindowsHost())
         return;
     QProcess make;
@@ -57,6 +57,7 @@ private slots:
     void buildDirectories();
     void buildEnvChange();
     void buildGraphVersions();
+    void buildServer();
     void changedFiles_data();
     void changedFiles();
     void changedRuleInputs();
@@ -113,6 +114,7 @@ private slots:
     void exportsQbs();
     void externalLibs();
     void fileDependencies();
+    void fileSystemJournal();
     void fileTagsFilterMerging();
     void generatedArtifactAsInputToDynamicRule();
     void generator();
@@ -182,6 +184,7 @@ private slots:
     void nestedGroups();
     void nestedProperties();
     void newOutputArtifact();
+    void ninjaGenerator();
     void noProfile();
     void nodejs();
     void nonBrokenFilesInBrokenProduct();
@@ -222,6 +225,7 @@ private slots:
     void recursiveRenaming();
     void recursiveWildcards();
     void referenceErrorInExport();
+    void removeInBackground();
     void reproducibleBuild();
     void reproducibleBuild_data();
     void require();
@@ -234,6 +238,7 @@ private slots:
     void ruleWithNonRequiredInputs();
     void setupBuildEnvironment();
     void setupRunEnvironment();
+    void skipUnchangedOutputs();
     void smartRelinking();
     void smartRelinking_data();
     void soVersion();
@@ -31,6 +31,7 @@
 #include <tools/buildoptions.h>
 #include <tools/error.h>
 #include <tools/hostosinfo.h>
+#include <tools/installoptions.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qregexp.h>
@@ -65,6 +66,7 @@ private slots:
         args << "--changed-files" << "foo,bar" << m_fileArgs;
         args << "--check-timestamps";
         args << "--check-outputs";
+        args << "--stream-output";
         CommandLineParser parser;
 
         QVERIFY(parser.parseCommandLine(args));
@@ -75,6 +77,7 @@ private slots:
         QVERIFY(parser.buildOptions(QString()).keepGoing());
         QVERIFY(parser.forceTimestampCheck());
         QVERIFY(parser.forceOutputCheck());
+        QVERIFY(parser.buildOptions(QString()).streamCommandOutput());
         QVERIFY(!parser.logTime());
         QCOMPARE(parser.buildConfigurations().size(), 1);
 
@@ -173,6 +176,23 @@ private slots:
 
         QVERIFY(parser.parseCommandLine(QStringList{"run", "--setup-run-env-config", "x,y,z"}));
         QCOMPARE(parser.runEnvConfig(), QStringList({"x", "y", "z"}));
+
+        // Build server
+        const QString socketFilePath = QDir::current().absoluteFilePath("qbs.sock");
+        QVERIFY(parser.parseCommandLine(QStringList{"serve", "--server-socket", "qbs.sock"}));
+        QCOMPARE(parser.command(), ServeCommandType);
+        QCOMPARE(parser.serverSocketFilePath(), socketFilePath);
+        QVERIFY(parser.parseCommandLine(QStringList(m_fileArgs) << "--server-socket" << "qbs.sock"));
+        QCOMPARE(parser.command(), BuildCommandType);
+        QCOMPARE(parser.serverSocketFilePath(), socketFilePath);
+
+        // Install mode
+        QVERIFY(parser.parseCommandLine(QStringList(m_fileArgs)));
+        QCOMPARE(parser.installOptions(QString()).installMode(), InstallModeCopy);
+        QVERIFY(parser.parseCommandLine(QStringList("install") << m_fileArgs << "--install-mode"
+                                        << "hardlink"));
+        QCOMPARE(parser.buildOptions(QString()).installMode(), InstallModeHardLink);
+        QCOMPARE(parser.installOptions(QString()).installMode(), InstallModeHardLink);
     }
 
     void testInvalidCommandLine()
@@ -206,6 +226,11 @@ private slots:
                 << (QStringList("update-timestamps") << "profile:x");
         QTest::newRow("Argument for show-version")
                 << (QStringList("show-version") << "config:debug");
+        QTest::newRow("Missing socket for serve") << QStringList("serve");
+        QTest::newRow("Property assignment for serve")
+                << (QStringList("serve") << "--server-socket" << "qbs.sock" << "config:debug");
+        QTest::newRow("Invalid install mode")
+                << (QStringList() << m_fileArgs << "--install-mode" << "symlink");
     }
 
 private:
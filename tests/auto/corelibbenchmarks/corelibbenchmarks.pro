@@ -0,0 +1,6 @@
+TARGET = tst_corelibbenchmarks
+
+SOURCES = tst_corelibbenchmarks.cpp
+HEADERS = tst_corelibbenchmarks.h
+
+include(../auto.pri)
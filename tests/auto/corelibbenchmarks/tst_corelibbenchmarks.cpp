@@ -0,0 +1,502 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#undef QT_NO_CAST_FROM_ASCII // I am qmake, and I approve this hack.
+
+#include "tst_corelibbenchmarks.h"
+
+#include <buildgraph/artifact.h>
+#include <buildgraph/nodeset.h>
+#include <language/filetags.h>
+#include <language/propertymapinternal.h>
+#include <logging/logger.h>
+#include <tools/fileinfo.h>
+#include <tools/filetime.h>
+#include <tools/id.h>
+#include <tools/persistence.h>
+#include <tools/set.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+
+#include <QtTest/qtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+using namespace qbs::Internal;
+
+// Counts the calls to the global operator new, which covers our own containers as well as the
+// standard library ones. Qt containers allocate via malloc() and are not included.
+static std::atomic<qint64> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void * const p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+// Keeps the compiler from optimizing away the code under test.
+static volatile qint64 sink;
+
+static const qint64 minimumMeasurementDuration = 100 * 1000 * 1000; // ns
+
+// Runs the function repeatedly for at least minimumMeasurementDuration and reports the time per
+// iteration as the benchmark result. Throughput and allocations per iteration are logged.
+template<typename Function> static void measure(qint64 itemsPerIteration, const Function &f)
+{
+    f(); // Warm-up.
+    const qint64 allocationsBefore = allocationCount;
+    QElapsedTimer timer;
+    timer.start();
+    qint64 iterations = 0;
+    do {
+        f();
+        ++iterations;
+    } while (timer.nsecsElapsed() < minimumMeasurementDuration);
+    const qint64 elapsed = timer.nsecsElapsed();
+    const double allocationsPerIteration = double(allocationCount - allocationsBefore)
+            / iterations;
+    QTest::setBenchmarkResult(double(elapsed) / iterations / 1e6,
+                              QTest::WalltimeMilliseconds);
+    qInfo("%.0f items/s, %.1f allocations per iteration (%lld iterations)",
+          double(itemsPerIteration) * iterations * 1e9 / elapsed, allocationsPerIteration,
+          iterations);
+}
+
+static void addSizeRows(const QList<int> &sizes = QList<int>{10, 100, 1000, 10000})
+{
+    QTest::addColumn<int>("size");
+    for (const int size : sizes)
+        QTest::newRow(qPrintable(QString::number(size))) << size;
+}
+
+static std::mt19937 &randomGenerator()
+{
+    static std::mt19937 generator(4711);
+    return generator;
+}
+
+template<typename Container> static void shuffle(Container &c)
+{
+    std::shuffle(c.begin(), c.end(), randomGenerator());
+}
+
+static QStringList filePaths(int count, const QString &prefix = QStringLiteral("src"))
+{
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths << QStringLiteral("/home/user/project/%1/module%2/file%3.cpp")
+                 .arg(prefix).arg(i % 37).arg(i);
+    }
+    shuffle(paths);
+    return paths;
+}
+
+static const QStringList &fileTagVocabulary()
+{
+    static const QStringList tags{
+        "application", "c", "cpp", "hpp", "obj", "staticlibrary", "dynamiclibrary",
+        "dynamiclibrary_symlink", "dynamiclibrary_import", "qrc", "qt.core.resource_data",
+        "moc_cpp", "moc_hpp", "ui", "installable", "linkerscript", "infoplist", "asm",
+        "objcpp", "def"
+    };
+    return tags;
+}
+
+static QList<QStringList> fileTagLists(int count)
+{
+    const QStringList &vocabulary = fileTagVocabulary();
+    std::uniform_int_distribution<int> tagCount(1, 4);
+    std::uniform_int_distribution<int> tagIndex(0, vocabulary.size() - 1);
+    QList<QStringList> lists;
+    for (int i = 0; i < count; ++i) {
+        QStringList list;
+        for (int j = tagCount(randomGenerator()); --j >= 0;)
+            list << vocabulary.at(tagIndex(randomGenerator()));
+        lists << list;
+    }
+    return lists;
+}
+
+static std::vector<std::unique_ptr<Artifact>> createArtifacts(int count)
+{
+    std::vector<std::unique_ptr<Artifact>> artifacts;
+    const FileTime timestamp = FileTime::currentTime();
+    const QStringList paths = filePaths(count, QStringLiteral("build"));
+    for (int i = 0; i < count; ++i) {
+        std::unique_ptr<Artifact> artifact(new Artifact);
+        artifact->setFilePath(paths.at(i));
+        artifact->setFileTags(FileTags{"obj"});
+        artifact->setTimestamp(timestamp);
+        artifact->artifactType = Artifact::Generated;
+
+        // A tree with each node having up to two children, as a rough approximation
+        // of a real build graph.
+        if (i > 0) {
+            Artifact * const parent = artifacts.at((i - 1) / 2).get();
+            parent->children.insert(artifact.get());
+            artifact->parents.insert(parent);
+        }
+        artifacts.push_back(std::move(artifact));
+    }
+    return artifacts;
+}
+
+static std::vector<Artifact *> rawPointers(const std::vector<std::unique_ptr<Artifact>> &v)
+{
+    std::vector<Artifact *> result;
+    result.reserve(v.size());
+    for (const auto &p : v)
+        result.push_back(p.get());
+    return result;
+}
+
+TestCorelibBenchmarks::TestCorelibBenchmarks()
+{
+}
+
+void TestCorelibBenchmarks::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+}
+
+void TestCorelibBenchmarks::fileInfoLastModified()
+{
+    QFETCH(int, size);
+    QStringList paths;
+    for (int i = 0; i < size; ++i) {
+        const QString filePath = m_tempDir.path() + QStringLiteral("/lastmodified%1.txt").arg(i);
+        QFile f(filePath);
+        QVERIFY2(f.open(QIODevice::WriteOnly), qPrintable(f.errorString()));
+        paths << filePath;
+    }
+    measure(size, [&paths] {
+        for (const QString &p : qAsConst(paths))
+            sink += FileInfo(p).lastModified().isValid();
+    });
+}
+
+void TestCorelibBenchmarks::fileInfoLastModified_data()
+{
+    addSizeRows({10, 100, 1000});
+}
+
+void TestCorelibBenchmarks::fileInfoPathOperations()
+{
+    QFETCH(int, size);
+    const QStringList paths = filePaths(size);
+    const QString baseDir = QStringLiteral("/home/user/project/build");
+    measure(size, [&paths, &baseDir] {
+        for (const QString &p : paths) {
+            sink += FileInfo::fileName(p).size();
+            sink += FileInfo::path(p).size();
+            sink += FileInfo::completeBaseName(p).size();
+            sink += FileInfo::resolvePath(baseDir, FileInfo::fileName(p)).size();
+        }
+    });
+}
+
+void TestCorelibBenchmarks::fileInfoPathOperations_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::fileTagsFromStringList()
+{
+    QFETCH(int, size);
+    const QList<QStringList> lists = fileTagLists(size);
+    measure(size, [&lists] {
+        for (const QStringList &l : lists)
+            sink += FileTags::fromStringList(l).size();
+    });
+}
+
+void TestCorelibBenchmarks::fileTagsFromStringList_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::fileTagsIntersects()
+{
+    QFETCH(int, size);
+    std::vector<FileTags> tags;
+    for (const QStringList &l : fileTagLists(2 * size))
+        tags.push_back(FileTags::fromStringList(l));
+    measure(size, [&tags] {
+        for (std::size_t i = 0; i < tags.size(); i += 2)
+            sink += tags.at(i).intersects(tags.at(i + 1));
+    });
+}
+
+void TestCorelibBenchmarks::fileTagsIntersects_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::fileTimeCompare()
+{
+    QFETCH(int, size);
+    std::vector<FileTime> times;
+    for (int i = 0; i < size; ++i)
+        times.push_back(FileTime::currentTime());
+    shuffle(times);
+    measure(size, [&times] {
+        std::vector<FileTime> sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+        sink += sorted.front() < sorted.back();
+    });
+}
+
+void TestCorelibBenchmarks::fileTimeCompare_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::idFromName()
+{
+    QFETCH(int, size);
+    std::vector<QByteArray> names;
+    for (int i = 0; i < size; ++i) {
+        names.push_back("benchmark.tag" + QByteArray::number(i));
+        sink += Id(names.back()).uniqueIdentifier(); // Register, so we measure the lookup.
+    }
+    measure(size, [&names] {
+        for (const QByteArray &name : names)
+            sink += Id(name).uniqueIdentifier();
+    });
+}
+
+void TestCorelibBenchmarks::idFromName_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::idName()
+{
+    QFETCH(int, size);
+    std::vector<Id> ids;
+    for (int i = 0; i < size; ++i)
+        ids.push_back(Id("benchmark.tag" + QByteArray::number(i)));
+    measure(size, [&ids] {
+        for (const Id id : ids)
+            sink += id.name().size();
+    });
+}
+
+void TestCorelibBenchmarks::idName_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::moduleProperty()
+{
+    QFETCH(int, size);
+    const int propertiesPerModule = 50;
+    QVariantMap modules;
+    std::vector<std::pair<QString, QString>> lookups;
+    for (int m = 0; m < size; ++m) {
+        const QString moduleName = QStringLiteral("module%1").arg(m);
+        QVariantMap properties;
+        for (int p = 0; p < propertiesPerModule; ++p) {
+            const QString key = QStringLiteral("property%1").arg(p);
+            properties.insert(key, QStringList{moduleName, key});
+            lookups.push_back(std::make_pair(moduleName, key));
+        }
+        lookups.push_back(std::make_pair(moduleName, QStringLiteral("undeclared")));
+        modules.insert(moduleName, properties);
+    }
+    shuffle(lookups);
+    const PropertyMapPtr map = PropertyMapInternal::create();
+    map->setValue(modules);
+    measure(lookups.size(), [&map, &lookups] {
+        for (const auto &lookup : lookups)
+            sink += map->moduleProperty(lookup.first, lookup.second).isValid();
+    });
+}
+
+void TestCorelibBenchmarks::moduleProperty_data()
+{
+    addSizeRows({10, 100});
+}
+
+void TestCorelibBenchmarks::nodeSetInsertRemove()
+{
+    QFETCH(int, size);
+    const auto artifacts = createArtifacts(size);
+    std::vector<Artifact *> nodes = rawPointers(artifacts);
+    shuffle(nodes);
+    measure(2 * size, [&nodes] {
+        NodeSet set;
+        for (Artifact * const a : nodes)
+            set.insert(a);
+        sink += set.size();
+        for (Artifact * const a : nodes)
+            set.remove(a);
+    });
+}
+
+void TestCorelibBenchmarks::nodeSetInsertRemove_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::persistentPoolLoadArtifacts()
+{
+    QFETCH(int, size);
+    const QString filePath = m_tempDir.path() + QStringLiteral("/load%1.bg").arg(size);
+    Logger logger;
+    {
+        const auto artifacts = createArtifacts(size);
+        PersistentPool pool(logger);
+        pool.setHeadData(PersistentPool::HeadData());
+        pool.setupWriteStream(filePath);
+        pool.store(rawPointers(artifacts));
+        pool.finalizeWriteStream();
+    }
+    measure(size, [&logger, &filePath] {
+        std::vector<Artifact *> loaded;
+        {
+            PersistentPool pool(logger);
+            pool.load(filePath);
+            pool.load(loaded);
+        }
+        sink += loaded.size();
+        qDeleteAll(loaded);
+    });
+}
+
+void TestCorelibBenchmarks::persistentPoolLoadArtifacts_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::persistentPoolStoreArtifacts()
+{
+    QFETCH(int, size);
+    const QString filePath = m_tempDir.path() + QStringLiteral("/store%1.bg").arg(size);
+    const auto artifacts = createArtifacts(size);
+    const std::vector<Artifact *> nodes = rawPointers(artifacts);
+    Logger logger;
+    measure(size, [&logger, &filePath, &nodes] {
+        PersistentPool pool(logger);
+        pool.setHeadData(PersistentPool::HeadData());
+        pool.setupWriteStream(filePath);
+        pool.store(nodes);
+        pool.finalizeWriteStream();
+    });
+}
+
+void TestCorelibBenchmarks::persistentPoolStoreArtifacts_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::setContains()
+{
+    QFETCH(int, size);
+    const QStringList present = filePaths(size);
+    QStringList lookups = present + filePaths(size, QStringLiteral("absent"));
+    shuffle(lookups);
+    const Set<QString> set = Set<QString>::fromList(present);
+    measure(lookups.size(), [&set, &lookups] {
+        for (const QString &s : qAsConst(lookups))
+            sink += set.contains(s);
+    });
+}
+
+void TestCorelibBenchmarks::setContains_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::setInsert()
+{
+    QFETCH(int, size);
+    const QStringList strings = filePaths(size);
+    measure(size, [&strings] {
+        Set<QString> set;
+        for (const QString &s : strings)
+            set.insert(s);
+        sink += set.size();
+    });
+}
+
+void TestCorelibBenchmarks::setInsert_data()
+{
+    addSizeRows();
+}
+
+void TestCorelibBenchmarks::setUnite()
+{
+    QFETCH(int, size);
+    const QStringList strings = filePaths(size + size / 2);
+    const Set<QString> set1 = Set<QString>::fromList(strings.mid(0, size));
+    const Set<QString> set2 = Set<QString>::fromList(strings.mid(size / 2));
+    measure(2 * size, [&set1, &set2] {
+        Set<QString> united = set1;
+        united.unite(set2);
+        sink += united.size();
+    });
+}
+
+void TestCorelibBenchmarks::setUnite_data()
+{
+    addSizeRows();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    TestCorelibBenchmarks tcb;
+    return QTest::qExec(&tcb, argc, argv);
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef TST_CORELIBBENCHMARKS_H
+#define TST_CORELIBBENCHMARKS_H
+
+#include <QtCore/qobject.h>
+#include <QtCore/qtemporarydir.h>
+
+class TestCorelibBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    TestCorelibBenchmarks();
+
+private slots:
+    void initTestCase();
+
+    void fileInfoLastModified();
+    void fileInfoLastModified_data();
+    void fileInfoPathOperations();
+    void fileInfoPathOperations_data();
+    void fileTagsFromStringList();
+    void fileTagsFromStringList_data();
+    void fileTagsIntersects();
+    void fileTagsIntersects_data();
+    void fileTimeCompare();
+    void fileTimeCompare_data();
+    void idFromName();
+    void idFromName_data();
+    void idName();
+    void idName_data();
+    void moduleProperty();
+    void moduleProperty_data();
+    void nodeSetInsertRemove();
+    void nodeSetInsertRemove_data();
+    void persistentPoolLoadArtifacts();
+    void persistentPoolLoadArtifacts_data();
+    void persistentPoolStoreArtifacts();
+    void persistentPoolStoreArtifacts_data();
+    void setContains();
+    void setContains_data();
+    void setInsert();
+    void setInsert_data();
+    void setUnite();
+    void setUnite_data();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+#endif // TST_CORELIBBENCHMARKS_H
@@ -43,28 +43,41 @@
 
 #include "../shared.h"
 
+#include <logging/ilogsink.h>
 #include <tools/buildoptions.h>
+#include <tools/commandoutputbuffer.h>
+#include <tools/digest.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/filesaver.h>
+#include <tools/filesystemjournal.h>
 #include <tools/hostosinfo.h>
+#include <tools/metrics.h>
+#include <tools/parallelfor.h>
 #include <tools/processutils.h>
 #include <tools/profile.h>
 #include <tools/set.h>
 #include <tools/settings.h>
 #include <tools/setupprojectparameters.h>
 #include <tools/stringutils.h>
+#include <tools/tooloutputcache.h>
 #include <tools/version.h>
 
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
 
 #include <QtTest/qtest.h>
 
+#include <vector>
+
 using namespace qbs;
 using namespace qbs::Internal;
 
@@ -292,6 +305,87 @@ void TestTools::testProfiles()
     QVERIFY(errorInfo.hasError());
 }
 
+void TestTools::testSettingsCache()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString baseDir = tmpDir.path() + QLatin1String("/user");
+    const QString systemBaseDir = tmpDir.path() + QLatin1String("/system");
+    QString cacheFilePath;
+    {
+        Settings settings(baseDir, systemBaseDir);
+        cacheFilePath = settings.fileName() + QLatin1String(".cache");
+        settings.setValue(QLatin1String("preferences.useSettingsCache"), true);
+        settings.setValue(QLatin1String("profiles.base.qbs.architecture"), "x86_64");
+        settings.setValue(QLatin1String("profiles.base.cpp.compilerName"), "gcc");
+        settings.setValue(QLatin1String("profiles.derived.baseProfile"), "base");
+        settings.setValue(QLatin1String("profiles.derived.cpp.compilerName"), "clang");
+        settings.setValue(QLatin1String("profiles.cyclic.baseProfile"), "cyclic");
+        settings.setValue(QLatin1String("other.x"), 1);
+        settings.setValue(QLatin1String("other.x-y"), 2);
+        settings.setValue(QLatin1String("other.x.z"), 3);
+    }
+    QVERIFY(!QFileInfo(cacheFilePath).exists());
+
+    // The first round creates the cache, the second one uses it.
+    for (int i = 0; i < 2; ++i) {
+        Settings settings(baseDir, systemBaseDir);
+        QVERIFY(QFileInfo(cacheFilePath).exists());
+        QCOMPARE(settings.value(QLatin1String("profiles.base.qbs.architecture"),
+                                Settings::allScopes()).toString(), QLatin1String("x86_64"));
+        QCOMPARE(settings.allKeysWithPrefix(QLatin1String("profiles.derived"),
+                                            Settings::allScopes()),
+                 QStringList({QLatin1String("baseProfile"), QLatin1String("cpp.compilerName")}));
+        QCOMPARE(settings.directChildren(QLatin1String("profiles.base"), Settings::UserScope),
+                 QStringList({QLatin1String("cpp"), QLatin1String("qbs")}));
+        QCOMPARE(settings.directChildren(QLatin1String("other"), Settings::UserScope),
+                 QStringList({QLatin1String("x"), QLatin1String("x-y")}));
+        QCOMPARE(settings.profiles(), QStringList({QLatin1String("base"), QLatin1String("cyclic"),
+                                                   QLatin1String("derived")}));
+        const Profile derivedProfile(QLatin1String("derived"), &settings);
+        QCOMPARE(derivedProfile.value(QLatin1String("cpp.compilerName")).toString(),
+                 QLatin1String("clang"));
+        QCOMPARE(derivedProfile.value(QLatin1String("qbs.architecture")).toString(),
+                 QLatin1String("x86_64"));
+        QCOMPARE(derivedProfile.baseProfile(), QLatin1String("base"));
+        QCOMPARE(derivedProfile.value(QLatin1String("qbs.targetOS"), "none").toString(),
+                 QLatin1String("none"));
+        QCOMPARE(derivedProfile.allKeys(Profile::KeySelectionRecursive),
+                 QStringList({QLatin1String("cpp.compilerName"),
+                              QLatin1String("qbs.architecture")}));
+        ErrorInfo errorInfo;
+        Profile(QLatin1String("cyclic"), &settings).value(QLatin1String("qbs.architecture"),
+                                                          QVariant(), &errorInfo);
+        QVERIFY(errorInfo.hasError());
+    }
+
+    // Changes are visible right away and invalidate the cache.
+    {
+        Settings settings(baseDir, systemBaseDir);
+        settings.setValue(QLatin1String("profiles.base.qbs.architecture"), "arm");
+        QCOMPARE(Profile(QLatin1String("derived"), &settings)
+                 .value(QLatin1String("qbs.architecture")).toString(), QLatin1String("arm"));
+    }
+    {
+        Settings settings(baseDir, systemBaseDir);
+        QCOMPARE(Profile(QLatin1String("derived"), &settings)
+                 .value(QLatin1String("qbs.architecture")).toString(), QLatin1String("arm"));
+
+        // Neither the file size nor, most likely, the timestamp change here.
+        settings.setValue(QLatin1String("profiles.base.qbs.architecture"), "x86");
+    }
+    {
+        Settings settings(baseDir, systemBaseDir);
+        QCOMPARE(Profile(QLatin1String("derived"), &settings)
+                 .value(QLatin1String("qbs.architecture")).toString(), QLatin1String("x86"));
+        settings.setValue(QLatin1String("preferences.useSettingsCache"), false);
+    }
+    Settings settings(baseDir, systemBaseDir);
+    QVERIFY(!QFileInfo(cacheFilePath).exists());
+    QCOMPARE(Profile(QLatin1String("derived"), &settings)
+             .value(QLatin1String("qbs.architecture")).toString(), QLatin1String("x86"));
+}
+
 void TestTools::testSettingsMigration()
 {
     QFETCH(QString, baseDir);
@@ -383,6 +477,57 @@ QString TestTools::setupSettingsDir3()
     return baseDir->path();
 }
 
+class RecordingLogSink : public ILogSink
+{
+public:
+    ~RecordingLogSink() { setAsynchronous(false); }
+
+    std::vector<QString> messages;
+    int flushCount = 0;
+
+private:
+    void doPrintMessage(LoggerLevel, const QString &message, const QString &) override
+    {
+        messages.push_back(message);
+    }
+    void doFlush() override { ++flushCount; }
+};
+
+void TestTools::testAsynchronousLogSink()
+{
+    RecordingLogSink sink;
+    sink.setAsynchronous(true);
+    QVERIFY(sink.isAsynchronous());
+    const int threadCount = 8;
+    const int messagesPerThread = 1000;
+    parallelFor(threadCount, threadCount, [&sink](std::size_t thread) {
+        for (int i = 0; i < messagesPerThread; ++i)
+            sink.printMessage(LoggerInfo, QString::number(thread) + QLatin1Char(':')
+                              + QString::number(i));
+    });
+    sink.flush();
+    QCOMPARE(int(sink.messages.size()), threadCount * messagesPerThread);
+    std::vector<int> nextIndex(threadCount, 0);
+    for (const QString &message : sink.messages) {
+        const QStringList parts = message.split(QLatin1Char(':'));
+        const int thread = parts.front().toInt();
+        QCOMPARE(parts.back().toInt(), nextIndex[thread]++);
+    }
+    QVERIFY(sink.flushCount > 0);
+    QVERIFY(sink.flushCount <= int(sink.messages.size()));
+
+    // Errors are written before printMessage() returns.
+    sink.printMessage(LoggerError, QLatin1String("error"));
+    QCOMPARE(sink.messages.back(), QLatin1String("error"));
+
+    sink.printMessage(LoggerInfo, QLatin1String("last"));
+    sink.setAsynchronous(false);
+    QVERIFY(!sink.isAsynchronous());
+    QCOMPARE(sink.messages.back(), QLatin1String("last"));
+    sink.printMessage(LoggerInfo, QLatin1String("synchronous"));
+    QCOMPARE(sink.messages.back(), QLatin1String("synchronous"));
+}
+
 void TestTools::testBuildConfigMerging()
 {
     TemporaryProfile tp(QLatin1String("tst_tools_profile"), m_settings);
@@ -420,11 +565,313 @@ void TestTools::testBuildConfigMerging()
     QCOMPARE(finalCppMap.value(QLatin1String("treatWarningsAsErrors")).toBool(), true);
 }
 
+void TestTools::testCommandOutputBuffer()
+{
+    CommandOutputBuffer unlimitedBuffer;
+    unlimitedBuffer.append("abc");
+    unlimitedBuffer.append("def");
+    QCOMPARE(unlimitedBuffer.size(), qint64(6));
+    QVERIFY(unlimitedBuffer.isComplete());
+    QCOMPARE(unlimitedBuffer.readAll(), QByteArray("abcdef"));
+    QCOMPARE(unlimitedBuffer.tail(), QByteArray("abcdef"));
+
+    CommandOutputBuffer buffer(10);
+    QByteArray expectedContent;
+    for (int i = 0; i < 100; ++i) {
+        const QByteArray line = QByteArray::number(i) + '\n';
+        buffer.append(line);
+        expectedContent += line;
+        QCOMPARE(buffer.size(), qint64(expectedContent.size()));
+        QCOMPARE(buffer.tail(), expectedContent.right(10));
+    }
+    QVERIFY(buffer.isComplete());
+    QCOMPARE(buffer.readAll(), expectedContent);
+    buffer.append("more");
+    expectedContent += "more";
+    QCOMPARE(buffer.readAll(), expectedContent);
+
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.path() + QLatin1String("/output");
+    QVERIFY(buffer.saveToFile(filePath));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expectedContent);
+
+    buffer.reset(10);
+    QCOMPARE(buffer.size(), qint64(0));
+    QVERIFY(buffer.tail().isEmpty());
+    QVERIFY(buffer.readAll().isEmpty());
+}
+
+void TestTools::testCopyFileInstallModes()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString srcFilePath = tmpDir.path() + QLatin1String("/source");
+    QFile srcFile(srcFilePath);
+    QVERIFY(srcFile.open(QIODevice::WriteOnly));
+    const QByteArray content("some content\n");
+    QCOMPARE(srcFile.write(content), qint64(content.size()));
+    srcFile.close();
+    const QFile::Permissions permissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner
+            | QFile::ReadUser | QFile::WriteUser | QFile::ExeUser;
+    QVERIFY(srcFile.setPermissions(permissions));
+
+    for (int i = 0; i < InstallModeInvalid; ++i) {
+        const auto mode = static_cast<InstallMode>(i);
+        const QString tgtFilePath = tmpDir.path() + QLatin1Char('/') + installModeName(mode)
+                + QLatin1String("/target");
+        QString errorMessage;
+        QVERIFY2(copyFileRecursion(srcFilePath, tgtFilePath, true, false, &errorMessage, mode),
+                 qPrintable(errorMessage));
+        QFile tgtFile(tgtFilePath);
+        QVERIFY2(tgtFile.open(QIODevice::ReadOnly), qPrintable(installModeName(mode)));
+        QCOMPARE(tgtFile.readAll(), content);
+        if (!HostOsInfo::isWindowsHost())
+            QCOMPARE(tgtFile.permissions() & permissions, permissions);
+
+        // Installing again leaves the up-to-date target alone.
+        tgtFile.close();
+        QVERIFY2(copyFileRecursion(srcFilePath, tgtFilePath, true, false, &errorMessage, mode),
+                 qPrintable(errorMessage));
+        QVERIFY(tgtFile.open(QIODevice::ReadOnly));
+        QCOMPARE(tgtFile.readAll(), content);
+    }
+}
+
+void TestTools::testDigest()
+{
+    const QString xxhash = QLatin1String("xxhash64");
+    QCOMPARE(Digest::dataDigest(QByteArray(), xxhash), QByteArray("ef46db3751d8e999"));
+    QCOMPARE(Digest::dataDigest("a", xxhash), QByteArray("d24ec4f1a98c6e5b"));
+    QCOMPARE(Digest::dataDigest("abc", xxhash), QByteArray("44bc2cf5ad770999"));
+    QCOMPARE(Digest::dataDigest("The quick brown fox jumps over the lazy dog", xxhash),
+             QByteArray("0b242d361fda71bc"));
+
+    QByteArray data;
+    for (int i = 0; i < 5; ++i) {
+        for (int c = 0; c < 256; ++c)
+            data += char(c);
+    }
+    QCOMPARE(Digest::dataDigest(data, xxhash), QByteArray("afc184ad7938a354"));
+    QCOMPARE(Digest::dataDigest(data, QLatin1String("sha256")),
+             QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex());
+
+    // Feeding the data in odd-sized pieces must not make a difference.
+    for (const QString &algorithm : Digest::supportedAlgorithms()) {
+        Digest digest(algorithm);
+        for (int offset = 0; offset < data.size(); offset += 7)
+            digest.addData(data.mid(offset, 7));
+        QCOMPARE(digest.result(), Digest::dataDigest(data, algorithm));
+    }
+    QVERIFY(!Digest::isSupportedAlgorithm(QLatin1String("crc32")));
+
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.path() + QLatin1String("/data");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), qint64(data.size()));
+    file.close();
+    QString errorMessage;
+    QCOMPARE(Digest::fileDigest(filePath, xxhash, &errorMessage), QByteArray("afc184ad7938a354"));
+    QVERIFY2(errorMessage.isEmpty(), qPrintable(errorMessage));
+    QVERIFY(Digest::fileDigest(filePath + QLatin1String("-missing"), xxhash,
+                               &errorMessage).isNull());
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestTools::testFileSystemJournal()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString journalFilePath = tmpDir.path() + QLatin1String("/journal");
+    QFile journalFile(journalFilePath);
+    const auto append = [&journalFile](const QByteArray &data) {
+        QVERIFY(journalFile.open(QIODevice::WriteOnly | QIODevice::Append));
+        QCOMPARE(journalFile.write(data), qint64(data.size()));
+        journalFile.close();
+    };
+
+    // No journal: Everything may have changed.
+    FileSystemJournal journal = FileSystemJournal::read(journalFilePath, {});
+    QVERIFY(!journal.isComplete());
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/main.cpp")));
+
+    // A new session is never complete, but the reader learns where to continue.
+    append(FileSystemJournal::header(QLatin1String("s1"), QLatin1String("/src"),
+                                     QStringList(QLatin1String("/src/build"))));
+    append(FileSystemJournal::changedPathEntry(QLatin1String("/src/old.cpp")));
+    journal = FileSystemJournal::read(journalFilePath, {});
+    QVERIFY(!journal.isComplete());
+    const FileSystemJournal::State state = journal.state();
+    QCOMPARE(state.session, QLatin1String("s1"));
+    QCOMPARE(state.offset, journalFile.size());
+
+    // Only the changes since the last state count.
+    append(FileSystemJournal::changedPathEntry(QLatin1String("/src/lib/a.cpp")));
+    append(FileSystemJournal::changedTreeEntry(QLatin1String("/src/moved")));
+    journal = FileSystemJournal::read(journalFilePath, state);
+    QVERIFY(journal.isComplete());
+    QVERIFY(!journal.mayHaveChanged(QLatin1String("/src/old.cpp")));
+    QVERIFY(!journal.mayHaveChanged(QLatin1String("/src/lib/b.cpp")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/lib/a.cpp")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/lib")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src")));
+    QVERIFY(!journal.mayHaveChanged(QLatin1String("/src/li")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/moved")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/moved/sub/c.cpp")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/build/x.o")));
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/other/main.cpp")));
+
+    // An incomplete last line gets picked up next time.
+    const FileSystemJournal::State state2 = journal.state();
+    append("c /src/half");
+    journal = FileSystemJournal::read(journalFilePath, state2);
+    QVERIFY(journal.isComplete());
+    QCOMPARE(journal.state().offset, state2.offset);
+    QVERIFY(!journal.mayHaveChanged(QLatin1String("/src/half.cpp")));
+    append(".cpp\n");
+    journal = FileSystemJournal::read(journalFilePath, state2);
+    QVERIFY(journal.isComplete());
+    QVERIFY(journal.mayHaveChanged(QLatin1String("/src/half.cpp")));
+
+    // The watcher missed events.
+    append(FileSystemJournal::overflowEntry());
+    journal = FileSystemJournal::read(journalFilePath, state2);
+    QVERIFY(!journal.isComplete());
+    QCOMPARE(journal.state().offset, journalFile.size());
+    journal = FileSystemJournal::read(journalFilePath, journal.state());
+    QVERIFY(journal.isComplete());
+
+    // The watcher started over.
+    const FileSystemJournal::State state3 = journal.state();
+    QVERIFY(journalFile.remove());
+    append(FileSystemJournal::header(QLatin1String("s2"), QLatin1String("/src"), {}));
+    journal = FileSystemJournal::read(journalFilePath, state3);
+    QVERIFY(!journal.isComplete());
+    QCOMPARE(journal.state().session, QLatin1String("s2"));
+}
+
+void TestTools::testMetrics()
+{
+    Metrics::reset();
+    Metrics::setEnabled(false);
+    Metrics::add(MetricsCounter::StatCalls);
+    Metrics::record(MetricsHistogram::CommandDuration, 5);
+    QCOMPARE(Metrics::counterValue(MetricsCounter::StatCalls), qint64(0));
+    QCOMPARE(Metrics::histogramCount(MetricsHistogram::CommandDuration), qint64(0));
+
+    Metrics::setEnabled(true);
+    parallelFor(1000, 4, [](std::size_t) { Metrics::add(MetricsCounter::StatCalls); });
+    Metrics::add(MetricsCounter::CommandOutputBytes, 42);
+    Metrics::changeGauge(MetricsGauge::RunningCommands, 2);
+    Metrics::changeGauge(MetricsGauge::RunningCommands, -1);
+    Metrics::record(MetricsHistogram::CommandDuration, 1);
+    Metrics::record(MetricsHistogram::CommandDuration, 3);
+    Metrics::record(MetricsHistogram::CommandDuration, 4);
+    Metrics::recordPhase(QLatin1String("Resolving"), 10);
+    Metrics::recordPhase(QLatin1String("Resolving"), 5);
+    Metrics::setEnabled(false);
+    QCOMPARE(Metrics::counterValue(MetricsCounter::StatCalls), qint64(1000));
+    QCOMPARE(Metrics::gaugeValue(MetricsGauge::RunningCommands), qint64(1));
+    QCOMPARE(Metrics::gaugePeakValue(MetricsGauge::RunningCommands), qint64(2));
+
+    const QJsonObject metrics = QJsonDocument::fromJson(Metrics::toJson()).object();
+    QCOMPARE(metrics.value(QLatin1String("counters")).toObject()
+             .value(QLatin1String("command-output-bytes")).toInt(), 42);
+    const QJsonObject histogram = metrics.value(QLatin1String("histograms")).toObject()
+            .value(QLatin1String("command-duration")).toObject();
+    QCOMPARE(histogram.value(QLatin1String("count")).toInt(), 3);
+    QCOMPARE(histogram.value(QLatin1String("sum")).toInt(), 8);
+    QCOMPARE(histogram.value(QLatin1String("min")).toInt(), 1);
+    QCOMPARE(histogram.value(QLatin1String("max")).toInt(), 4);
+    const QJsonArray buckets = histogram.value(QLatin1String("buckets")).toArray();
+    QCOMPARE(buckets.size(), 2);
+    QCOMPARE(buckets.at(0).toObject().value(QLatin1String("upper-bound")).toInt(), 1);
+    QCOMPARE(buckets.at(0).toObject().value(QLatin1String("count")).toInt(), 1);
+    QCOMPARE(buckets.at(1).toObject().value(QLatin1String("upper-bound")).toInt(), 4);
+    QCOMPARE(buckets.at(1).toObject().value(QLatin1String("count")).toInt(), 2);
+    const QJsonObject phase = metrics.value(QLatin1String("phases")).toObject()
+            .value(QLatin1String("Resolving")).toObject();
+    QCOMPARE(phase.value(QLatin1String("count")).toInt(), 2);
+    QCOMPARE(phase.value(QLatin1String("elapsed-ms")).toInt(), 15);
+
+    Metrics::reset();
+    QCOMPARE(Metrics::counterValue(MetricsCounter::StatCalls), qint64(0));
+}
+
+void TestTools::testParallelFor()
+{
+    std::vector<int> results(1000);
+    parallelFor(results.size(), 4, [&results](std::size_t i) { results[i] = int(i) * 2; });
+    for (std::size_t i = 0; i < results.size(); ++i)
+        QCOMPARE(results.at(i), int(i) * 2);
+
+    bool called = false;
+    parallelFor(0, 4, [&called](std::size_t) { called = true; });
+    QVERIFY(!called);
+
+    bool exceptionCaught = false;
+    try {
+        parallelFor(100, 4, [](std::size_t i) {
+            if (i == 42)
+                throw ErrorInfo(QLatin1String("42"));
+        });
+    } catch (const ErrorInfo &e) {
+        exceptionCaught = true;
+        QCOMPARE(e.toString(), QLatin1String("42"));
+    }
+    QVERIFY(exceptionCaught);
+}
+
 void TestTools::testProcessNameByPid()
 {
     QCOMPARE(qAppName(), processNameByPid(QCoreApplication::applicationPid()));
 }
 
+void TestTools::testRemoveFilesConcurrently()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QStringList filePaths;
+    for (int i = 0; i < 100; ++i) {
+        const QString filePath = tmpDir.path() + QLatin1String("/file") + QString::number(i);
+        if (i % 2 == 0) {
+            QFile file(filePath);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+        filePaths << filePath;
+    }
+    const QString subDir = tmpDir.path() + QLatin1String("/subdir");
+    QVERIFY(QDir().mkpath(subDir + QLatin1String("/nested")));
+    filePaths << subDir;
+
+    std::vector<FileRemovalResult> results = removeFilesConcurrently(filePaths, DryRunRemoval);
+    QCOMPARE(results.size(), std::size_t(filePaths.size()));
+    for (int i = 0; i < filePaths.size(); ++i) {
+        QCOMPARE(results.at(i).existed, i % 2 == 0 || i == 100);
+        QVERIFY(results.at(i).errorMessage.isEmpty());
+    }
+    QVERIFY(QFileInfo::exists(filePaths.first()));
+
+    results = removeFilesConcurrently(filePaths);
+    QCOMPARE(results.size(), std::size_t(filePaths.size()));
+    for (int i = 0; i < filePaths.size(); ++i) {
+        QCOMPARE(results.at(i).existed, i % 2 == 0 || i == 100);
+        QCOMPARE(results.at(i).errorMessage.isEmpty(), i != 100);
+        QCOMPARE(QFileInfo::exists(filePaths.at(i)), i == 100);
+    }
+
+    results = removeFilesConcurrently(filePaths, RemoveRecursively);
+    QCOMPARE(results.size(), std::size_t(filePaths.size()));
+    for (int i = 0; i < filePaths.size(); ++i) {
+        QCOMPARE(results.at(i).existed, i == 100);
+        QVERIFY2(results.at(i).errorMessage.isEmpty(), qPrintable(results.at(i).errorMessage));
+        QVERIFY(!QFileInfo::exists(filePaths.at(i)));
+    }
+}
 
 int toNumber(const QString &str)
 {
@@ -434,6 +881,44 @@ int toNumber(const QString &str)
     return res;
 }
 
+void TestTools::testToolOutputCache()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString toolFilePath = tmpDir.path() + QLatin1String("/tool");
+    QFile toolFile(toolFilePath);
+    QVERIFY(toolFile.open(QIODevice::WriteOnly));
+    toolFile.write("version 1");
+    toolFile.close();
+    const QString cacheFilePath = tmpDir.path() + QLatin1String("/cache.json");
+    const QStringList arguments(QLatin1String("-dumpmachine"));
+
+    QByteArray output;
+    {
+        ToolOutputCache cache(cacheFilePath);
+        QVERIFY(!cache.lookup(toolFilePath, arguments, &output));
+        cache.insert(toolFilePath, arguments, "x86_64-linux-gnu\n");
+        QVERIFY(cache.lookup(toolFilePath, arguments, &output));
+        QCOMPARE(output, QByteArray("x86_64-linux-gnu\n"));
+        QVERIFY(!cache.lookup(toolFilePath, QStringList(QLatin1String("-v")), &output));
+        QVERIFY(cache.save());
+    }
+
+    {
+        ToolOutputCache cache(cacheFilePath);
+        output.clear();
+        QVERIFY(cache.lookup(toolFilePath, arguments, &output));
+        QCOMPARE(output, QByteArray("x86_64-linux-gnu\n"));
+    }
+
+    // A changed tool invalidates the entry.
+    QVERIFY(toolFile.open(QIODevice::Append));
+    toolFile.write(".1");
+    toolFile.close();
+    ToolOutputCache cache(cacheFilePath);
+    QVERIFY(!cache.lookup(toolFilePath, arguments, &output));
+}
+
 void TestTools::set_operator_eq()
 {
     {
@@ -1087,6 +1572,18 @@ void TestTools::set_intersects()
     QVERIFY(s1.intersects(s3));
 }
 
+void TestTools::set_fromSortedStdVector()
+{
+    const std::vector<int> sorted{1, 2, 3, 5, 8};
+    const Set<int> set = Set<int>::fromSortedStdVector(sorted);
+    QCOMPARE(set.size(), size_t { 5 });
+    QCOMPARE(set, Set<int>::fromStdVector(sorted));
+    QVERIFY(set.contains(5));
+    QVERIFY(!set.contains(4));
+
+    QVERIFY(Set<int>::fromSortedStdVector(std::vector<int>()).empty());
+}
+
 void TestTools::stringutils_join()
 {
     QFETCH(std::vector<std::string>, input);
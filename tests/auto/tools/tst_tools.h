@@ -63,12 +63,22 @@ private slots:
     void fileSaver();
 
     void fileCaseCheck();
+    void testAsynchronousLogSink();
     void testBuildConfigMerging();
+    void testCommandOutputBuffer();
+    void testCopyFileInstallModes();
+    void testDigest();
     void testFileInfo();
+    void testFileSystemJournal();
+    void testMetrics();
+    void testParallelFor();
     void testProcessNameByPid();
     void testProfiles();
+    void testRemoveFilesConcurrently();
+    void testSettingsCache();
     void testSettingsMigration();
     void testSettingsMigration_data();
+    void testToolOutputCache();
 
     void set_operator_eq();
     void set_swap();
@@ -89,6 +99,7 @@ private slots:
     void set_makeSureTheComfortFunctionsCompile();
     void set_initializerList();
     void set_intersects();
+    void set_fromSortedStdVector();
 
     void stringutils_join();
     void stringutils_join_data();
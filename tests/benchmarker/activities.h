@@ -29,13 +29,50 @@
 #define QBS_BENCHMARKER_ACTIVITY_H
 
 #include <QtCore/qflags.h>
+#include <QtCore/qstring.h>
 
 namespace qbsBenchmarker {
 
-enum Activity { ActivityResolving = 1, ActivityRuleExecution = 2, ActivityNullBuild = 4 };
+enum Activity {
+    ActivityResolving = 1, ActivityRuleExecution = 2, ActivityNullBuild = 4,
+    ActivityIncrementalBuild = 8, ActivityBuildGraphLoadStore = 16, ActivityInstallation = 32,
+    ActivityGenerator = 64
+};
 Q_DECLARE_FLAGS(Activities, Activity)
 Q_DECLARE_OPERATORS_FOR_FLAGS(Activities)
 
+enum class BenchmarkMode { Valgrind, Timing };
+
+const Activities valgrindActivities = Activities(ActivityResolving) | ActivityRuleExecution
+        | ActivityNullBuild;
+
+// The activities in the order in which they are run and reported.
+const Activity allActivitiesList[] = {
+    ActivityResolving, ActivityRuleExecution, ActivityNullBuild, ActivityIncrementalBuild,
+    ActivityBuildGraphLoadStore, ActivityInstallation, ActivityGenerator
+};
+
+inline QString activityName(Activity activity)
+{
+    switch (activity) {
+    case ActivityResolving:
+        return QStringLiteral("resolving");
+    case ActivityRuleExecution:
+        return QStringLiteral("rule-execution");
+    case ActivityNullBuild:
+        return QStringLiteral("null-build");
+    case ActivityIncrementalBuild:
+        return QStringLiteral("incremental-build");
+    case ActivityBuildGraphLoadStore:
+        return QStringLiteral("build-graph-load-store");
+    case ActivityInstallation:
+        return QStringLiteral("installation");
+    case ActivityGenerator:
+        return QStringLiteral("generator");
+    }
+    return QString();
+}
+
 } // namespace qbsBenchmarker
 
 #endif // Include guard.
@@ -31,6 +31,10 @@
 #include "exception.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
 
 #include <cstdlib>
 #include <iostream>
@@ -41,7 +45,7 @@ static bool hasRegression = false;
 
 static int relativeChange(qint64 oldVal, qint64 newVal)
 {
-    return newVal == 0 ? 0 : newVal * 100 / oldVal - 100;
+    return oldVal == 0 || newVal == 0 ? 0 : newVal * 100 / oldVal - 100;
 }
 
 static QByteArray relativeChangeString(int change)
@@ -53,22 +57,32 @@ static QByteArray relativeChangeString(int change)
     return changeString;
 }
 
-static void printResults(Activity activity, const BenchmarkResults &results,
-                         int regressionThreshold)
+static const char *activityDisplayName(Activity activity)
 {
-    std::cout << "========== Performance data for ";
     switch (activity) {
     case ActivityResolving:
-        std::cout << "Resolving";
-        break;
+        return "Resolving";
     case ActivityRuleExecution:
-        std::cout << "Rule Execution";
-        break;
+        return "Rule Execution";
     case ActivityNullBuild:
-        std::cout << "Null Build";
-        break;
+        return "Null Build";
+    case ActivityIncrementalBuild:
+        return "Incremental Build";
+    case ActivityBuildGraphLoadStore:
+        return "Build Graph Load/Store";
+    case ActivityInstallation:
+        return "Installation";
+    case ActivityGenerator:
+        return "Generator";
     }
-    std::cout << " ==========" << std::endl;
+    return "";
+}
+
+static void printResults(Activity activity, const BenchmarkResults &results,
+                         int regressionThreshold)
+{
+    std::cout << "========== Performance data for " << activityDisplayName(activity)
+              << " ==========" << std::endl;
     const BenchmarkResult result = results.value(activity);
     const char * const indent = "    ";
     std::cout << indent << "Old instruction count: " << result.oldInstructionCount << std::endl;
@@ -94,12 +108,134 @@ static void printResults(Activity activity, const BenchmarkResults &results,
 static void printResults(Activities activities, const BenchmarkResults &results,
                          int regressionThreshold)
 {
-    if (activities & ActivityResolving)
-        printResults(ActivityResolving, results, regressionThreshold);
-    if (activities & ActivityRuleExecution)
-        printResults(ActivityRuleExecution, results, regressionThreshold);
-    if (activities & ActivityNullBuild)
-        printResults(ActivityNullBuild, results, regressionThreshold);
+    for (const Activity activity : allActivitiesList) {
+        if (activities & activity)
+            printResults(activity, results, regressionThreshold);
+    }
+}
+
+static void printStatistics(const char *label, const char *unit,
+                            const TimingStatistics &oldStats, const TimingStatistics &newStats,
+                            int regressionThreshold)
+{
+    const char * const indent = "    ";
+    const auto printOne = [indent, label, unit](const char *age, const TimingStatistics &stats) {
+        std::cout << indent << age << ' ' << label << ": median " << stats.median << ' ' << unit
+                  << " (min " << stats.min << ", max " << stats.max << ", mean " << stats.mean
+                  << ", standard deviation " << stats.standardDeviation << ')' << std::endl;
+    };
+    printOne("Old", oldStats);
+    printOne("New", newStats);
+    const int change = relativeChange(oldStats.median, newStats.median);
+    if (change > regressionThreshold)
+        hasRegression = true;
+    std::cout << indent << "Relative change: " << relativeChangeString(change).constData()
+              << std::endl;
+}
+
+static void printTimingResults(const TimingComparisons &results, int regressionThreshold)
+{
+    for (const TimingComparison &comparison : results) {
+        std::cout << "========== Timing data for "
+                  << activityDisplayName(comparison.oldResult.activity);
+        if (comparison.oldResult.jobs > 0)
+            std::cout << " (" << comparison.oldResult.jobs << " jobs)";
+        std::cout << " ==========" << std::endl;
+        printStatistics("wall-clock time", "ms", comparison.oldResult.wallTimeStatistics(),
+                        comparison.newResult.wallTimeStatistics(), regressionThreshold);
+        printStatistics("CPU time", "ms", comparison.oldResult.cpuTimeStatistics(),
+                        comparison.newResult.cpuTimeStatistics(), regressionThreshold);
+        printStatistics("peak RSS", "Bytes", comparison.oldResult.peakRssStatistics(),
+                        comparison.newResult.peakRssStatistics(), regressionThreshold);
+    }
+}
+
+static QJsonObject toJson(const TimingStatistics &stats)
+{
+    return QJsonObject{
+        {"min", stats.min},
+        {"max", stats.max},
+        {"median", stats.median},
+        {"mean", stats.mean},
+        {"standardDeviation", stats.standardDeviation}
+    };
+}
+
+static QJsonObject toJson(const TimingResult &result)
+{
+    QJsonArray samples;
+    for (const TimingSample &sample : result.samples) {
+        samples << QJsonObject{
+            {"wallTime", sample.wallTime},
+            {"cpuTime", sample.cpuTime},
+            {"peakRss", sample.peakRss}
+        };
+    }
+    return QJsonObject{
+        {"wallTime", toJson(result.wallTimeStatistics())},
+        {"cpuTime", toJson(result.cpuTimeStatistics())},
+        {"peakRss", toJson(result.peakRssStatistics())},
+        {"samples", samples}
+    };
+}
+
+static void writeJsonResults(const CommandLineParser &clParser, const Benchmarker &benchmarker)
+{
+    QJsonObject root{
+        {"oldCommit", clParser.oldCommit()},
+        {"newCommit", clParser.newCommit()},
+        {"testProject", benchmarker.testProject()},
+        {"regressionThreshold", clParser.regressionThreshold()},
+        {"regression", hasRegression}
+    };
+    if (clParser.hasSyntheticProject())
+        root.insert("syntheticProject", clParser.syntheticProjectSpecification());
+    QJsonArray results;
+    switch (clParser.mode()) {
+    case BenchmarkMode::Valgrind: {
+        root.insert("mode", "valgrind");
+        root.insert("units", QJsonObject{{"peakMemoryUsage", "bytes"}});
+        const BenchmarkResults valgrindResults = benchmarker.results();
+        for (const Activity activity : allActivitiesList) {
+            if (!(clParser.activies() & activity))
+                continue;
+            const BenchmarkResult result = valgrindResults.value(activity);
+            results << QJsonObject{
+                {"activity", activityName(activity)},
+                {"old", QJsonObject{{"instructionCount", result.oldInstructionCount},
+                                    {"peakMemoryUsage", result.oldPeakMemoryUsage}}},
+                {"new", QJsonObject{{"instructionCount", result.newInstructionCount},
+                                    {"peakMemoryUsage", result.newPeakMemoryUsage}}}
+            };
+        }
+        break;
+    }
+    case BenchmarkMode::Timing:
+        root.insert("mode", "timing");
+        root.insert("units", QJsonObject{{"wallTime", "ms"}, {"cpuTime", "ms"},
+                                         {"peakRss", "bytes"}});
+        root.insert("repetitions", clParser.timingParameters().repetitions);
+        for (const TimingComparison &comparison : benchmarker.timingResults()) {
+            QJsonObject result{
+                {"activity", activityName(comparison.oldResult.activity)},
+                {"old", toJson(comparison.oldResult)},
+                {"new", toJson(comparison.newResult)}
+            };
+            if (comparison.oldResult.jobs > 0)
+                result.insert("jobs", comparison.oldResult.jobs);
+            results << result;
+        }
+        break;
+    }
+    root.insert("results", results);
+
+    const QString filePath = clParser.jsonOutputFilePath();
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(root).toJson()) == -1) {
+        throw Exception(QString::fromLatin1("Failed to write file '%1': %2")
+                        .arg(filePath, file.errorString()));
+    }
 }
 
 int main(int argc, char *argv[])
@@ -108,10 +244,23 @@ int main(int argc, char *argv[])
         QCoreApplication app(argc, argv);
         CommandLineParser clParser;
         clParser.parse();
-        Benchmarker benchmarker(clParser.activies(), clParser.oldCommit(), clParser.newCommit(),
-                                clParser.testProjectFilePath(), clParser.qbsRepoDirPath());
+        Benchmarker benchmarker(clParser.mode(), clParser.activies(), clParser.oldCommit(),
+                                clParser.newCommit(), clParser.testProjectFilePath(),
+                                clParser.qbsRepoDirPath(), clParser.timingParameters());
+        if (clParser.hasSyntheticProject())
+            benchmarker.setSyntheticProject(clParser.syntheticProjectParameters());
         benchmarker.benchmark();
-        printResults(clParser.activies(), benchmarker.results(), clParser.regressionThreshold());
+        switch (clParser.mode()) {
+        case BenchmarkMode::Valgrind:
+            printResults(clParser.activies(), benchmarker.results(),
+                         clParser.regressionThreshold());
+            break;
+        case BenchmarkMode::Timing:
+            printTimingResults(benchmarker.timingResults(), clParser.regressionThreshold());
+            break;
+        }
+        if (!clParser.jsonOutputFilePath().isEmpty())
+            writeJsonResults(clParser, benchmarker);
         if (hasRegression) {
             benchmarker.keepRawData();
             std::cout << "Performance regression detected. Raw benchmarking data available "
@@ -29,6 +29,7 @@
 
 #include "exception.h"
 #include "runsupport.h"
+#include "timingrunner.h"
 #include "valgrindrunner.h"
 
 #include <QtConcurrent/qtconcurrentrun.h>
@@ -37,13 +38,16 @@
 
 namespace qbsBenchmarker {
 
-Benchmarker::Benchmarker(Activities activities, const QString &oldCommit, const QString &newCommit,
-                         const QString &testProject, const QString &qbsRepo)
-    : m_activities(activities)
+Benchmarker::Benchmarker(BenchmarkMode mode, Activities activities, const QString &oldCommit,
+                         const QString &newCommit, const QString &testProject,
+                         const QString &qbsRepo, const TimingParameters &timingParameters)
+    : m_mode(mode)
+    , m_activities(activities)
     , m_oldCommit(oldCommit)
     , m_newCommit(newCommit)
     , m_testProject(testProject)
     , m_qbsRepo(qbsRepo)
+    , m_timingParameters(timingParameters)
 {
 }
 
@@ -59,8 +63,17 @@ Benchmarker::~Benchmarker()
     }
 }
 
+void Benchmarker::setSyntheticProject(
+        const qbsProjectGenerator::ProjectGeneratorParameters &parameters)
+{
+    m_hasSyntheticProject = true;
+    m_syntheticProjectParameters = parameters;
+}
+
 void Benchmarker::benchmark()
 {
+    if (m_hasSyntheticProject)
+        generateSyntheticProject();
     rememberCurrentRepoState();
     runProcess(QStringList() << "git" << "checkout" << m_oldCommit, m_qbsRepo);
     const QString oldQbsBuildDir = m_baseOutputDir.path() + "/qbs-build." + m_oldCommit;
@@ -70,6 +83,19 @@ void Benchmarker::benchmark()
     const QString newQbsBuildDir = m_baseOutputDir.path() + "/qbs-build." + m_newCommit;
     std::cout << "Building from new repo state..." << std::endl;
     buildQbs(newQbsBuildDir);
+    switch (m_mode) {
+    case BenchmarkMode::Valgrind:
+        runValgrind(oldQbsBuildDir, newQbsBuildDir);
+        break;
+    case BenchmarkMode::Timing:
+        runTiming(oldQbsBuildDir, newQbsBuildDir);
+        break;
+    }
+    std::cout << "Done!" << std::endl;
+}
+
+void Benchmarker::runValgrind(const QString &oldQbsBuildDir, const QString &newQbsBuildDir)
+{
     std::cout << "Now running valgrind. This can take a while." << std::endl;
 
     ValgrindRunner oldDataRetriever(m_activities, m_testProject, oldQbsBuildDir,
@@ -92,7 +118,39 @@ void Benchmarker::benchmark()
         benchmarkResult.newInstructionCount = valgrindResult.instructionCount;
         benchmarkResult.newPeakMemoryUsage = valgrindResult.peakMemoryUsage;
     }
-    std::cout << "Done!" << std::endl;
+}
+
+void Benchmarker::runTiming(const QString &oldQbsBuildDir, const QString &newQbsBuildDir)
+{
+    std::cout << "Now taking timings. This can take a while." << std::endl;
+
+    // The two runs must not overlap, as they would compete for the CPU cores.
+    TimingRunner oldTimingRunner(m_activities, m_timingParameters, m_testProject,
+                                 oldQbsBuildDir,
+                                 m_baseOutputDir.path() + "/timing-data." + m_oldCommit);
+    oldTimingRunner.run();
+    TimingRunner newTimingRunner(m_activities, m_timingParameters, m_testProject,
+                                 newQbsBuildDir,
+                                 m_baseOutputDir.path() + "/timing-data." + m_newCommit);
+    newTimingRunner.run();
+    const QList<TimingResult> oldResults = oldTimingRunner.results();
+    const QList<TimingResult> newResults = newTimingRunner.results();
+    for (int i = 0; i < oldResults.size(); ++i)
+        m_timingResults << TimingComparison{oldResults.at(i), newResults.at(i)};
+}
+
+void Benchmarker::generateSyntheticProject()
+{
+    std::cout << "Generating synthetic project..." << std::endl;
+    try {
+        qbsProjectGenerator::ProjectGenerator generator(m_syntheticProjectParameters);
+        generator.generate(m_baseOutputDir.path() + "/synthetic-project");
+        m_testProject = generator.projectFilePath();
+        if (m_timingParameters.touchedFile.isEmpty())
+            m_timingParameters.touchedFile = generator.representativeSourceFilePath();
+    } catch (const qbsProjectGenerator::ProjectGeneratorError &e) {
+        throw Exception(e.errorMessage);
+    }
 }
 
 void Benchmarker::rememberCurrentRepoState()
@@ -29,8 +29,12 @@
 #define QBS_BENCHMARKER_BENCHMARKER_H
 
 #include "activities.h"
+#include "timingrunner.h"
+
+#include "../projectgenerator/projectgenerator.h"
 
 #include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qtemporarydir.h>
 
@@ -50,31 +54,51 @@ public:
 };
 typedef QHash<Activity, BenchmarkResult> BenchmarkResults;
 
+class TimingComparison
+{
+public:
+    TimingResult oldResult;
+    TimingResult newResult;
+};
+typedef QList<TimingComparison> TimingComparisons;
+
 class Benchmarker
 {
 public:
-    Benchmarker(Activities activities, const QString &oldCommit, const QString &newCommit,
-                const QString &testProject, const QString &qbsRepo);
+    Benchmarker(BenchmarkMode mode, Activities activities, const QString &oldCommit,
+                const QString &newCommit, const QString &testProject, const QString &qbsRepo,
+                const TimingParameters &timingParameters = TimingParameters());
     ~Benchmarker();
 
     void benchmark();
+    void setSyntheticProject(const qbsProjectGenerator::ProjectGeneratorParameters &parameters);
     void keepRawData() { m_baseOutputDir.setAutoRemove(false ); }
 
     BenchmarkResults results() const { return m_results; }
+    TimingComparisons timingResults() const { return m_timingResults; }
+    QString testProject() const { return m_testProject; }
     QString rawDataBaseDir() const { return m_baseOutputDir.path(); }
 
 private:
+    void generateSyntheticProject();
     void rememberCurrentRepoState();
     void buildQbs(const QString &buildDir) const;
+    void runValgrind(const QString &oldQbsBuildDir, const QString &newQbsBuildDir);
+    void runTiming(const QString &oldQbsBuildDir, const QString &newQbsBuildDir);
 
+    const BenchmarkMode m_mode;
     const Activities m_activities;
     const QString m_oldCommit;
     const QString m_newCommit;
-    const QString m_testProject;
+    QString m_testProject;
     const QString m_qbsRepo;
+    TimingParameters m_timingParameters;
+    bool m_hasSyntheticProject = false;
+    qbsProjectGenerator::ProjectGeneratorParameters m_syntheticProjectParameters;
     QString m_commitToRestore;
     QTemporaryDir m_baseOutputDir;
     BenchmarkResults m_results;
+    TimingComparisons m_timingResults;
 };
 
 } // namespace qbsBenchmarker
@@ -9,7 +9,9 @@ SOURCES = \
     benchmarker.cpp \
     commandlineparser.cpp \
     runsupport.cpp \
-    valgrindrunner.cpp
+    timingrunner.cpp \
+    valgrindrunner.cpp \
+    ../projectgenerator/projectgenerator.cpp
 
 HEADERS = \
     activities.h \
@@ -17,4 +19,6 @@ HEADERS = \
     commandlineparser.h \
     exception.h \
     runsupport.h \
-    valgrindrunner.h
+    timingrunner.h \
+    valgrindrunner.h \
+    ../projectgenerator/projectgenerator.h
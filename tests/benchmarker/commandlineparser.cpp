@@ -34,12 +34,14 @@
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qfileinfo.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace qbsBenchmarker {
 
-static QString resolveActivity() { return "resolving"; }
-static QString ruleExecutionActivity() { return "rule-execution"; }
-static QString nullBuildActivity() { return "null-build"; }
 static QString allActivities() { return "all"; }
+static QString valgrindMode() { return "valgrind"; }
+static QString timingMode() { return "timing"; }
 
 CommandLineParser::CommandLineParser()
 {
@@ -49,7 +51,8 @@ void CommandLineParser::parse()
 {
     QCommandLineParser parser;
     parser.setApplicationDescription("This tool aims to detect qbs performance regressions "
-                                     "using valgrind.");
+                                     "using valgrind or by measuring wall-clock time, CPU time "
+                                     "and memory usage.");
     parser.addHelpOption();
     QCommandLineOption oldCommitOption(QStringList{"old-commit", "o"}, "The old qbs commit.",
                                        "old commit");
@@ -60,22 +63,78 @@ void CommandLineParser::parse()
     QCommandLineOption testProjectOption(QStringList{"test-project", "p"},
             "The example project to use for the benchmark.", "project file path");
     parser.addOption(testProjectOption);
+    QStringList syntheticParameterNames;
+    for (const auto &info : qbsProjectGenerator::projectGeneratorParameterInfos())
+        syntheticParameterNames << info.name;
+    QCommandLineOption syntheticProjectOption(QStringList{"synthetic-project", "s"},
+            QString::fromLatin1("Generate a synthetic project to use for the benchmark instead "
+                                "of passing a test project. The specification has the form "
+                                "name1=value1,name2=value2,... with these possible names: %1. "
+                                "See qbs_projectgenerator for details.")
+                    .arg(syntheticParameterNames.join(", ")), "specification");
+    parser.addOption(syntheticProjectOption);
     QCommandLineOption qbsRepoOption(QStringList{"qbs-repo", "r"}, "The qbs repository.",
                                      "repo path");
     parser.addOption(qbsRepoOption);
+    QCommandLineOption modeOption(QStringList{"mode", "m"},
+            QString::fromLatin1("The benchmark mode. Possible values: %1 (instruction count and "
+                                "peak memory usage), %2 (wall-clock time, CPU time and peak "
+                                "resident set size over repeated runs).")
+                    .arg(valgrindMode(), timingMode()), "mode", valgrindMode());
+    parser.addOption(modeOption);
+    QStringList activityNames;
+    for (const Activity activity : allActivitiesList)
+        activityNames << activityName(activity);
+    activityNames << allActivities();
     QCommandLineOption activitiesOption(QStringList{"activities", "a"},
-            QString::fromLatin1("The activities to benchmark. Possible values (CSV): %1,%2,%3,%4")
-                    .arg(resolveActivity(), ruleExecutionActivity(), nullBuildActivity(),
-                         allActivities()), "activities", allActivities());
+            QString::fromLatin1("The activities to benchmark. Possible values (CSV): %1. "
+                                "Only %2, %3 and %4 are available in %5 mode. In %6 mode, '%7' "
+                                "includes %8 only if a touched file is given or the project "
+                                "is synthetic.")
+                    .arg(activityNames.join(','), activityName(ActivityResolving),
+                         activityName(ActivityRuleExecution), activityName(ActivityNullBuild),
+                         valgrindMode(), timingMode(), allActivities(),
+                         activityName(ActivityIncrementalBuild)),
+            "activities", allActivities());
     parser.addOption(activitiesOption);
+    QCommandLineOption repetitionsOption(QStringList{"repetitions", "R"},
+            "The number of measured runs per activity in timing mode.", "count", "5");
+    parser.addOption(repetitionsOption);
+    QCommandLineOption jobsOption(QStringList{"jobs", "j"},
+            "The job counts to measure the build activities with in timing mode, "
+            "yielding a scaling curve. Default: qbs' default job count.", "counts (CSV)");
+    parser.addOption(jobsOption);
+    QCommandLineOption touchedFileOption(QStringList{"touched-file"},
+            QString::fromLatin1("The file to touch before each run of the %1 activity.")
+                    .arg(activityName(ActivityIncrementalBuild)), "file path");
+    parser.addOption(touchedFileOption);
+    QCommandLineOption generatorOption(QStringList{"generator", "g"},
+            QString::fromLatin1("The generator to run for the %1 activity.")
+                    .arg(activityName(ActivityGenerator)), "generator", "makefile");
+    parser.addOption(generatorOption);
+    QCommandLineOption jsonOutputOption(QStringList{"json-output"},
+            "Also write the results to the given file in JSON format.", "file path");
+    parser.addOption(jsonOutputOption);
     QCommandLineOption thresholdOption(QStringList{"regression-threshold", "t"},
             "A relative increase higher than this is considered a performance regression. "
             "All temporary data from running the benchmarks will be kept if that happens.",
             "value in per cent");
     parser.addOption(thresholdOption);
     parser.process(*QCoreApplication::instance());
-    const QList<QCommandLineOption> mandatoryOptions = QList<QCommandLineOption>()
-            << oldCommitOption << newCommitOption << testProjectOption << qbsRepoOption;
+    QList<QCommandLineOption> mandatoryOptions = QList<QCommandLineOption>()
+            << oldCommitOption << newCommitOption << qbsRepoOption;
+    if (parser.isSet(syntheticProjectOption)) {
+        m_syntheticProjectSpecification = parser.value(syntheticProjectOption);
+        try {
+            m_syntheticProjectParameters.parse(m_syntheticProjectSpecification);
+        } catch (const qbsProjectGenerator::ProjectGeneratorError &e) {
+            throwException(syntheticProjectOption.names().front(),
+                           m_syntheticProjectSpecification,
+                           e.errorMessage + '\n' + parser.helpText());
+        }
+    } else {
+        mandatoryOptions << testProjectOption;
+    }
     for (const QCommandLineOption &o : mandatoryOptions) {
         if (!parser.isSet(o))
             throwException(o.names().front(), parser.helpText());
@@ -86,22 +145,63 @@ void CommandLineParser::parse()
     m_newCommit = parser.value(newCommitOption);
     m_testProjectFilePath = parser.value(testProjectOption);
     m_qbsRepoDirPath = parser.value(qbsRepoOption);
+    const QString modeString = parser.value(modeOption);
+    if (modeString == valgrindMode())
+        m_mode = BenchmarkMode::Valgrind;
+    else if (modeString == timingMode())
+        m_mode = BenchmarkMode::Timing;
+    else
+        throwException(modeOption.names().front(), modeString, parser.helpText());
+    m_timingParameters.touchedFile = parser.value(touchedFileOption);
+
+    // For synthetic projects, the touched file defaults to a source file of a leaf library.
+    const bool hasTouchedFile = !m_timingParameters.touchedFile.isEmpty()
+            || hasSyntheticProject();
+    m_timingParameters.generator = parser.value(generatorOption);
     const QStringList activitiesList = parser.value(activitiesOption).split(',');
     m_activities = 0;
     for (const QString &activityString : activitiesList) {
         if (activityString == allActivities()) {
-            m_activities = ActivityResolving | ActivityRuleExecution | ActivityNullBuild;
+            if (m_mode == BenchmarkMode::Valgrind) {
+                m_activities = valgrindActivities;
+            } else {
+                for (const Activity activity : allActivitiesList)
+                    m_activities |= activity;
+                if (!hasTouchedFile)
+                    m_activities &= ~ActivityIncrementalBuild;
+            }
             break;
-        } else if (activityString == resolveActivity()) {
-            m_activities = ActivityResolving;
-        } else if (activityString == ruleExecutionActivity()) {
-            m_activities |= ActivityRuleExecution;
-        } else if (activityString == nullBuildActivity()) {
-            m_activities |= ActivityNullBuild;
-        } else {
+        }
+        const Activity * const activity = std::find_if(std::begin(allActivitiesList),
+                std::end(allActivitiesList), [&activityString](Activity a) {
+            return activityName(a) == activityString;
+        });
+        if (activity == std::end(allActivitiesList)
+                || (m_mode == BenchmarkMode::Valgrind && !(valgrindActivities & *activity))) {
             throwException(activitiesOption.names().front(), activityString, parser.helpText());
         }
+        if (*activity == ActivityIncrementalBuild && !hasTouchedFile)
+            throwException(touchedFileOption.names().front(), parser.helpText());
+        m_activities |= *activity;
+    }
+    const QString rawRepetitionsValue = parser.value(repetitionsOption);
+    bool repetitionsOk;
+    m_timingParameters.repetitions = rawRepetitionsValue.toInt(&repetitionsOk);
+    if (!repetitionsOk || m_timingParameters.repetitions < 1) {
+        throwException(repetitionsOption.names().front(), rawRepetitionsValue,
+                       parser.helpText());
+    }
+    if (parser.isSet(jobsOption)) {
+        const QStringList jobCounts = parser.value(jobsOption).split(',');
+        for (const QString &jobCountString : jobCounts) {
+            bool ok;
+            const int jobCount = jobCountString.toInt(&ok);
+            if (!ok || jobCount < 1)
+                throwException(jobsOption.names().front(), jobCountString, parser.helpText());
+            m_timingParameters.jobCounts << jobCount;
+        }
     }
+    m_jsonOutputFilePath = parser.value(jsonOutputOption);
     m_regressionThreshold = 5;
     if (parser.isSet(thresholdOption)) {
         bool ok = true;
@@ -29,6 +29,9 @@
 #define QBS_BENCHMARKER_COMMANDLINEPARSER_H
 
 #include "activities.h"
+#include "timingrunner.h"
+
+#include "../projectgenerator/projectgenerator.h"
 
 #include <QtCore/qstringlist.h>
 
@@ -41,24 +44,38 @@ public:
 
     void parse();
 
+    BenchmarkMode mode() const { return m_mode; }
     Activities activies() const { return m_activities; }
     QString oldCommit() const { return m_oldCommit; }
     QString newCommit() const { return m_newCommit; }
     QString testProjectFilePath() const { return m_testProjectFilePath; }
+    bool hasSyntheticProject() const { return !m_syntheticProjectSpecification.isEmpty(); }
+    QString syntheticProjectSpecification() const { return m_syntheticProjectSpecification; }
+    qbsProjectGenerator::ProjectGeneratorParameters syntheticProjectParameters() const
+    {
+        return m_syntheticProjectParameters;
+    }
     QString qbsRepoDirPath() const { return m_qbsRepoDirPath; }
     int regressionThreshold() const { return m_regressionThreshold; }
+    TimingParameters timingParameters() const { return m_timingParameters; }
+    QString jsonOutputFilePath() const { return m_jsonOutputFilePath; }
 
 private:
     [[noreturn]] void throwException(const QString &optionName, const QString &illegalValue,
                                    const QString &helpText);
     [[noreturn]] void throwException(const QString &missingOption, const QString &helpText);
 
+    BenchmarkMode m_mode;
     Activities m_activities;
     QString m_oldCommit;
     QString m_newCommit;
     QString m_testProjectFilePath;
+    QString m_syntheticProjectSpecification;
+    qbsProjectGenerator::ProjectGeneratorParameters m_syntheticProjectParameters;
     QString m_qbsRepoDirPath;
     int m_regressionThreshold;
+    TimingParameters m_timingParameters;
+    QString m_jsonOutputFilePath;
 };
 
 } // namespace qbsBenchmarker
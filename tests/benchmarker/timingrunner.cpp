@@ -0,0 +1,326 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "timingrunner.h"
+
+#include "exception.h"
+#include "runsupport.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qstringlist.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace qbsBenchmarker {
+
+TimingStatistics TimingStatistics::fromValues(QVector<qint64> values)
+{
+    TimingStatistics stats;
+    if (values.empty())
+        return stats;
+    std::sort(values.begin(), values.end());
+    const int count = values.size();
+    stats.min = values.front();
+    stats.max = values.back();
+    stats.median = count % 2 == 1 ? values.at(count / 2)
+                                   : (values.at(count / 2 - 1) + values.at(count / 2)) / 2;
+    double sum = 0;
+    for (const qint64 v : qAsConst(values))
+        sum += v;
+    stats.mean = sum / count;
+    if (count > 1) {
+        double squaredDeviations = 0;
+        for (const qint64 v : qAsConst(values))
+            squaredDeviations += (v - stats.mean) * (v - stats.mean);
+        stats.standardDeviation = std::sqrt(squaredDeviations / (count - 1));
+    }
+    return stats;
+}
+
+template<typename Getter>
+static TimingStatistics statistics(const QVector<TimingSample> &samples, const Getter &getter)
+{
+    QVector<qint64> values;
+    values.reserve(samples.size());
+    for (const TimingSample &s : samples)
+        values << getter(s);
+    return TimingStatistics::fromValues(values);
+}
+
+TimingStatistics TimingResult::wallTimeStatistics() const
+{
+    return statistics(samples, [](const TimingSample &s) { return s.wallTime; });
+}
+
+TimingStatistics TimingResult::cpuTimeStatistics() const
+{
+    return statistics(samples, [](const TimingSample &s) { return s.cpuTime; });
+}
+
+TimingStatistics TimingResult::peakRssStatistics() const
+{
+    return statistics(samples, [](const TimingSample &s) { return s.peakRss; });
+}
+
+#ifdef Q_OS_UNIX
+static qint64 toMilliseconds(const timeval &tv)
+{
+    return qint64(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+#endif
+
+// QProcess does not give us the resource usage of the child, so we do the fork/wait ourselves.
+// The values reported by wait4() include all processes the child has waited for, that is,
+// the compilers and other tools started by qbs.
+static TimingSample runMeasuredProcess(const QStringList &commandLine, const QString &workingDir)
+{
+#ifdef Q_OS_UNIX
+    std::vector<QByteArray> encodedArgs;
+    for (const QString &arg : commandLine)
+        encodedArgs.push_back(QFile::encodeName(arg));
+    std::vector<char *> argv;
+    for (QByteArray &arg : encodedArgs)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    const QByteArray encodedWorkingDir = QFile::encodeName(workingDir);
+
+    QElapsedTimer timer;
+    timer.start();
+    const pid_t pid = fork();
+    if (pid == -1) {
+        throw Exception(QString::fromLatin1("Failed to fork: %1")
+                        .arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+    if (pid == 0) {
+        // Only async-signal-safe functions from here on.
+        if (chdir(encodedWorkingDir.constData()) != 0)
+            _exit(127);
+        const int devNull = open("/dev/null", O_WRONLY);
+        if (devNull != -1) {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+        execv(argv.front(), argv.data());
+        _exit(127);
+    }
+
+    int status;
+    rusage usage;
+    pid_t waitResult;
+    do {
+        waitResult = wait4(pid, &status, 0, &usage);
+    } while (waitResult == -1 && errno == EINTR);
+    const qint64 wallTime = timer.elapsed();
+    const QString command = commandLine.front();
+    if (waitResult == -1) {
+        throw Exception(QString::fromLatin1("Failed to wait for '%1': %2")
+                        .arg(command, QString::fromLocal8Bit(std::strerror(errno))));
+    }
+    if (!WIFEXITED(status))
+        throw Exception(QString::fromLatin1("Process '%1' crashed.").arg(command));
+    if (WEXITSTATUS(status) != 0) {
+        throw Exception(QString::fromLatin1("Command '%1' finished with exit code %2.")
+                        .arg(commandLine.join(QLatin1Char(' '))).arg(WEXITSTATUS(status)));
+    }
+
+    TimingSample sample;
+    sample.wallTime = wallTime;
+    sample.cpuTime = toMilliseconds(usage.ru_utime) + toMilliseconds(usage.ru_stime);
+#ifdef Q_OS_DARWIN
+    sample.peakRss = usage.ru_maxrss;
+#else
+    sample.peakRss = qint64(usage.ru_maxrss) * 1024;
+#endif
+    return sample;
+#else
+    Q_UNUSED(commandLine);
+    Q_UNUSED(workingDir);
+    throw Exception(QString::fromLatin1("Timing mode is only supported on Unix hosts."));
+#endif
+}
+
+TimingRunner::TimingRunner(Activities activities, const TimingParameters &parameters,
+                           const QString &testProject, const QString &qbsBuildDir,
+                           const QString &baseOutputDir)
+    : m_activities(activities)
+    , m_parameters(parameters)
+    , m_testProject(QFileInfo(testProject).absoluteFilePath())
+    , m_qbsBinary(qbsBuildDir + "/bin/qbs")
+    , m_baseOutputDir(baseOutputDir)
+{
+    if (!QDir::root().mkpath(m_baseOutputDir))
+        throw Exception(QString::fromLatin1("Failed to create directory '%1'.").arg(baseOutputDir));
+}
+
+void TimingRunner::run()
+{
+    const QList<int> jobCounts = m_parameters.jobCounts.empty() ? QList<int>{0}
+                                                                : m_parameters.jobCounts;
+    if (m_activities & ActivityResolving)
+        timeResolving();
+    for (const int jobs : jobCounts) {
+        if (m_activities & ActivityRuleExecution)
+            timeRuleExecution(jobs);
+        if (m_activities & ActivityNullBuild)
+            timeNullBuild(jobs);
+        if (m_activities & ActivityIncrementalBuild)
+            timeIncrementalBuild(jobs);
+    }
+    if (m_activities & ActivityBuildGraphLoadStore)
+        timeBuildGraphLoadStore();
+    if (m_activities & ActivityInstallation)
+        timeInstallation();
+    if (m_activities & ActivityGenerator)
+        timeGenerator();
+}
+
+void TimingRunner::timeResolving()
+{
+    const QString dir = buildDir(ActivityResolving);
+    const auto removeBuildDir = [dir] { QDir(dir).removeRecursively(); };
+    m_results << TimingResult(ActivityResolving, 0,
+                              sample(qbsCommandLine("resolve", dir), removeBuildDir));
+}
+
+void TimingRunner::timeRuleExecution(int jobs)
+{
+    const QString dir = buildDir(ActivityRuleExecution, jobs);
+    runProcess(qbsCommandLine("resolve", dir));
+    m_results << TimingResult(ActivityRuleExecution, jobs,
+            sample(qbsCommandLine("build", dir, QStringList("--dry-run") + jobsArgs(jobs))));
+}
+
+void TimingRunner::timeNullBuild(int jobs)
+{
+    const QString dir = buildDir(ActivityNullBuild, jobs);
+    runProcess(qbsCommandLine("build", dir, jobsArgs(jobs)));
+    m_results << TimingResult(ActivityNullBuild, jobs,
+                              sample(qbsCommandLine("build", dir, jobsArgs(jobs))));
+}
+
+void TimingRunner::timeIncrementalBuild(int jobs)
+{
+    const QString dir = buildDir(ActivityIncrementalBuild, jobs);
+    runProcess(qbsCommandLine("build", dir, jobsArgs(jobs)));
+    const QString touchedFile = m_parameters.touchedFile;
+    m_results << TimingResult(ActivityIncrementalBuild, jobs,
+                              sample(qbsCommandLine("build", dir, jobsArgs(jobs)),
+                                     [this, touchedFile] { touchFile(touchedFile); }));
+}
+
+void TimingRunner::timeBuildGraphLoadStore()
+{
+    // "update-timestamps" loads the build graph, marks all artifacts as changed and
+    // stores it again, which makes it the closest thing to a pure load/store cycle.
+    const QString dir = buildDir(ActivityBuildGraphLoadStore);
+    runProcess(qbsCommandLine("build", dir));
+    m_results << TimingResult(ActivityBuildGraphLoadStore, 0,
+            sample(QStringList{m_qbsBinary, "update-timestamps", "-qq", "-d", dir}));
+}
+
+void TimingRunner::timeInstallation()
+{
+    const QString dir = buildDir(ActivityInstallation);
+    runProcess(qbsCommandLine("build", dir, QStringList("--no-install")));
+    m_results << TimingResult(ActivityInstallation, 0, sample(qbsCommandLine("install", dir,
+            QStringList{"--no-build", "--clean-install-root"})));
+}
+
+void TimingRunner::timeGenerator()
+{
+    const QString dir = buildDir(ActivityGenerator);
+    runProcess(qbsCommandLine("resolve", dir));
+    m_results << TimingResult(ActivityGenerator, 0, sample(qbsCommandLine("generate", dir,
+            QStringList{"-g", m_parameters.generator})));
+}
+
+QString TimingRunner::buildDir(Activity activity, int jobs) const
+{
+    QString dir = m_baseOutputDir + "/build-dir." + activityName(activity);
+    if (jobs > 0)
+        dir += ".j" + QString::number(jobs);
+    return dir;
+}
+
+QStringList TimingRunner::qbsCommandLine(const QString &command, const QString &buildDir,
+                                         const QStringList &extraArgs) const
+{
+    return QStringList{m_qbsBinary, command, "-qq", "-d", buildDir, "-f", m_testProject}
+            + extraArgs;
+}
+
+QStringList TimingRunner::jobsArgs(int jobs)
+{
+    return jobs > 0 ? QStringList{"-j", QString::number(jobs)} : QStringList();
+}
+
+void TimingRunner::touchFile(const QString &filePath) const
+{
+#ifdef Q_OS_UNIX
+    if (utime(QFile::encodeName(filePath).constData(), nullptr) == 0)
+        return;
+#endif
+    throw Exception(QString::fromLatin1("Failed to touch file '%1'.").arg(filePath));
+}
+
+QVector<TimingSample> TimingRunner::sample(const QStringList &commandLine,
+                                           const std::function<void()> &prepare) const
+{
+    const QString workingDir = QFileInfo(m_testProject).absolutePath();
+
+    // The first run warms up the file system caches and is not taken into account.
+    if (prepare)
+        prepare();
+    runMeasuredProcess(commandLine, workingDir);
+
+    QVector<TimingSample> samples;
+    for (int i = 0; i < m_parameters.repetitions; ++i) {
+        if (prepare)
+            prepare();
+        samples << runMeasuredProcess(commandLine, workingDir);
+    }
+    return samples;
+}
+
+} // namespace qbsBenchmarker
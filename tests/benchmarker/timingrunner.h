@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_BENCHMARKER_TIMINGRUNNER_H
+#define QBS_BENCHMARKER_TIMINGRUNNER_H
+
+#include "activities.h"
+
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QStringList;
+QT_END_NAMESPACE
+
+namespace qbsBenchmarker {
+
+class TimingSample
+{
+public:
+    qint64 wallTime = 0; // milliseconds
+    qint64 cpuTime = 0; // milliseconds, user plus system
+    qint64 peakRss = 0; // bytes
+};
+
+class TimingStatistics
+{
+public:
+    static TimingStatistics fromValues(QVector<qint64> values);
+
+    qint64 min = 0;
+    qint64 max = 0;
+    qint64 median = 0;
+    double mean = 0;
+    double standardDeviation = 0;
+};
+
+class TimingResult
+{
+public:
+    TimingResult(Activity a, int j, const QVector<TimingSample> &s)
+        : activity(a), jobs(j), samples(s) {}
+
+    TimingStatistics wallTimeStatistics() const;
+    TimingStatistics cpuTimeStatistics() const;
+    TimingStatistics peakRssStatistics() const;
+
+    Activity activity;
+    int jobs; // 0 if the activity does not depend on the number of jobs
+    QVector<TimingSample> samples;
+};
+
+class TimingParameters
+{
+public:
+    int repetitions = 5;
+    QList<int> jobCounts;
+    QString touchedFile;
+    QString generator = QStringLiteral("makefile");
+};
+
+// Unlike the ValgrindRunner, this class runs everything sequentially, as concurrent
+// processes would distort the measurements.
+class TimingRunner
+{
+public:
+    TimingRunner(Activities activities, const TimingParameters &parameters,
+                 const QString &testProject, const QString &qbsBuildDir,
+                 const QString &baseOutputDir);
+
+    void run();
+    QList<TimingResult> results() const { return m_results; }
+
+private:
+    void timeResolving();
+    void timeRuleExecution(int jobs);
+    void timeNullBuild(int jobs);
+    void timeIncrementalBuild(int jobs);
+    void timeBuildGraphLoadStore();
+    void timeInstallation();
+    void timeGenerator();
+
+    QString buildDir(Activity activity, int jobs = 0) const;
+    QStringList qbsCommandLine(const QString &command, const QString &buildDir,
+                               const QStringList &extraArgs = QStringList()) const;
+    static QStringList jobsArgs(int jobs);
+    void touchFile(const QString &filePath) const;
+    QVector<TimingSample> sample(const QStringList &commandLine,
+                                 const std::function<void()> &prepare = {}) const;
+
+    const Activities m_activities;
+    const TimingParameters m_parameters;
+    const QString m_testProject;
+    const QString m_qbsBinary;
+    const QString m_baseOutputDir;
+    QList<TimingResult> m_results;
+};
+
+} // namespace qbsBenchmarker
+
+#endif // Include guard.
@@ -114,6 +114,8 @@ void ValgrindRunner::traceActivity(Activity activity, const QString &buildDirCal
         qbsCommand = "build";
         dryRun = false;
         break;
+    default:
+        Q_UNREACHABLE(); // Only available in timing mode.
     }
 
     const QString outFileCallgrind = m_baseOutputDir + "/outfile." + activityString + ".callgrind";
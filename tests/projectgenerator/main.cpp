@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "projectgenerator.h"
+
+#include <QtCore/qcommandlineoption.h>
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace qbsProjectGenerator;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a synthetic qbs project of the given size and "
+                                     "shape for scalability testing.");
+    parser.addHelpOption();
+    const ProjectGeneratorParameters defaults;
+    std::vector<QCommandLineOption> options;
+    for (const ProjectGeneratorParameterInfo &info : projectGeneratorParameterInfos()) {
+        options.emplace_back(info.name, info.description, "count",
+                             QString::number(defaults.*(info.value)));
+        parser.addOption(options.back());
+    }
+    parser.addPositionalArgument("output-dir", "The directory to create the project in. "
+                                 "It must not exist or be empty.");
+    parser.process(app);
+    const QStringList positionalArgs = parser.positionalArguments();
+    if (positionalArgs.size() != 1) {
+        std::cerr << "Expected exactly one output directory." << std::endl
+                  << qPrintable(parser.helpText()) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        ProjectGeneratorParameters parameters;
+        const auto &infos = projectGeneratorParameterInfos();
+        for (int i = 0; i < infos.size(); ++i) {
+            bool ok;
+            const QString rawValue = parser.value(options.at(i));
+            parameters.*(infos.at(i).value) = rawValue.toInt(&ok);
+            if (!ok) {
+                throw ProjectGeneratorError(QString::fromLatin1("Invalid value '%1' for option "
+                                                                "'--%2'.")
+                                            .arg(rawValue, infos.at(i).name));
+            }
+        }
+        ProjectGenerator generator(parameters);
+        generator.generate(positionalArgs.front());
+        std::cout << "Project file: " << qPrintable(generator.projectFilePath()) << std::endl;
+    } catch (const ProjectGeneratorError &e) {
+        std::cerr << qPrintable(e.errorMessage) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
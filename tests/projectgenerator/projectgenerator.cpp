@@ -0,0 +1,378 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "projectgenerator.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qstringlist.h>
+
+#include <algorithm>
+
+namespace qbsProjectGenerator {
+
+const QList<ProjectGeneratorParameterInfo> &projectGeneratorParameterInfos()
+{
+    static const QList<ProjectGeneratorParameterInfo> infos{
+        {"products", "The number of products.", &ProjectGeneratorParameters::productCount},
+        {"sources-per-product", "The number of source files per product. There is one header "
+         "per source file.", &ProjectGeneratorParameters::sourcesPerProduct},
+        {"header-fan-in", "The number of headers each source file includes.",
+         &ProjectGeneratorParameters::headerFanIn},
+        {"dependency-depth", "The length of the longest chain of product dependencies.",
+         &ProjectGeneratorParameters::dependencyDepth},
+        {"dependencies-per-product", "The number of products each non-leaf product depends on.",
+         &ProjectGeneratorParameters::dependenciesPerProduct},
+        {"moc-headers-per-product", "The number of headers per product containing a Q_OBJECT "
+         "class. Requires a profile with Qt.", &ProjectGeneratorParameters::mocHeadersPerProduct},
+        {"wildcard-groups-per-product", "The number of groups per product that pull in their "
+         "files via wildcards.", &ProjectGeneratorParameters::wildcardGroupsPerProduct},
+        {"js-rules-per-product", "The number of JavaScript rules applied in each product, "
+         "each with its own input file.", &ProjectGeneratorParameters::jsRulesPerProduct},
+    };
+    return infos;
+}
+
+void ProjectGeneratorParameters::parse(const QString &specification)
+{
+    const QStringList assignments = specification.split(',', QString::SkipEmptyParts);
+    for (const QString &assignment : assignments) {
+        const int equalsPos = assignment.indexOf('=');
+        const QString name = assignment.left(equalsPos).trimmed();
+        const auto &infos = projectGeneratorParameterInfos();
+        const auto info = std::find_if(infos.cbegin(), infos.cend(),
+                                       [&name](const ProjectGeneratorParameterInfo &i) {
+            return i.name == name;
+        });
+        if (equalsPos == -1 || info == infos.cend()) {
+            throw ProjectGeneratorError(QString::fromLatin1("Invalid project specification "
+                                                            "entry '%1'.").arg(assignment));
+        }
+        bool ok;
+        const int value = assignment.mid(equalsPos + 1).trimmed().toInt(&ok);
+        if (!ok) {
+            throw ProjectGeneratorError(QString::fromLatin1("Invalid value in project "
+                                                            "specification entry '%1'.")
+                                        .arg(assignment));
+        }
+        this->*(info->value) = value;
+    }
+    validate();
+}
+
+void ProjectGeneratorParameters::validate() const
+{
+    for (const ProjectGeneratorParameterInfo &info : projectGeneratorParameterInfos()) {
+        if (this->*(info.value) < 0) {
+            throw ProjectGeneratorError(QString::fromLatin1("Value for '%1' must not be "
+                                                            "negative.").arg(info.name));
+        }
+    }
+    if (productCount == 0 || sourcesPerProduct == 0) {
+        throw ProjectGeneratorError(QString::fromLatin1("A project needs at least one product "
+                                                        "with at least one source file."));
+    }
+}
+
+ProjectGenerator::ProjectGenerator(const ProjectGeneratorParameters &parameters)
+    : m_parameters(parameters)
+{
+    m_parameters.validate();
+}
+
+void ProjectGenerator::generate(const QString &outputDir)
+{
+    QDir dir(outputDir);
+    if (dir.exists() && !dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot).empty()) {
+        throw ProjectGeneratorError(QString::fromLatin1("Output directory '%1' is not empty.")
+                                    .arg(outputDir));
+    }
+    if (!QDir::root().mkpath(dir.absolutePath())) {
+        throw ProjectGeneratorError(QString::fromLatin1("Failed to create directory '%1'.")
+                                    .arg(outputDir));
+    }
+    m_outputDir = dir.absolutePath();
+    m_projectFilePath = m_outputDir + "/synthetic.qbs";
+    generateTopLevelProject();
+    if (m_parameters.jsRulesPerProduct > 0)
+        generateRulesModule();
+    for (int product = 0; product < m_parameters.productCount; ++product)
+        generateProduct(product);
+}
+
+QString ProjectGenerator::representativeSourceFilePath() const
+{
+    const int product = std::min(m_parameters.dependencyDepth, m_parameters.productCount - 1);
+    return m_outputDir + '/' + sourceFilePath(product, 0);
+}
+
+int ProjectGenerator::layer(int product) const
+{
+    return product % (m_parameters.dependencyDepth + 1);
+}
+
+std::vector<int> ProjectGenerator::dependencies(int product) const
+{
+    std::vector<int> result;
+    const int layerCount = m_parameters.dependencyDepth + 1;
+    const int nextLayer = layer(product) + 1;
+    if (nextLayer == layerCount || nextLayer >= m_parameters.productCount)
+        return result;
+    const int nextLayerSize = (m_parameters.productCount - nextLayer + layerCount - 1)
+            / layerCount;
+    const int count = std::min(m_parameters.dependenciesPerProduct, nextLayerSize);
+    for (int i = 0; i < count; ++i)
+        result.push_back(((product / layerCount + i) % nextLayerSize) * layerCount + nextLayer);
+    return result;
+}
+
+int ProjectGenerator::wildcardGroup(int index) const
+{
+    // Every (wildcardGroupsPerProduct + 1)th file is listed explicitly, the others are
+    // distributed over the wildcard groups.
+    const int slot = index % (m_parameters.wildcardGroupsPerProduct + 1);
+    return slot - 1;
+}
+
+QString ProjectGenerator::productDir(int product) const
+{
+    return "p" + QString::number(product);
+}
+
+QString ProjectGenerator::fileDir(int product, int index) const
+{
+    const int group = wildcardGroup(index);
+    return group == -1 ? productDir(product)
+                       : productDir(product) + "/g" + QString::number(group);
+}
+
+QString ProjectGenerator::headerFilePath(int product, int index) const
+{
+    return fileDir(product, index) + "/h" + QString::number(index) + ".h";
+}
+
+QString ProjectGenerator::sourceFilePath(int product, int index) const
+{
+    return fileDir(product, index) + "/s" + QString::number(index) + ".cpp";
+}
+
+void ProjectGenerator::writeFile(const QString &relativeFilePath, const QByteArray &content)
+{
+    const QString filePath = m_outputDir + '/' + relativeFilePath;
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        throw ProjectGeneratorError(QString::fromLatin1("Failed to write file '%1': %2")
+                                    .arg(filePath, file.errorString()));
+    }
+}
+
+void ProjectGenerator::generateTopLevelProject()
+{
+    QByteArray content = "import qbs\n\nProject {\n    name: \"synthetic\"\n";
+    if (m_parameters.jsRulesPerProduct > 0)
+        content += "    qbsSearchPaths: \".\"\n";
+    content += "    references: [\n";
+    for (int product = 0; product < m_parameters.productCount; ++product) {
+        const QByteArray dir = productDir(product).toLatin1();
+        content += "        \"" + dir + '/' + dir + ".qbs\",\n";
+    }
+    content += "    ]\n}\n";
+    writeFile("synthetic.qbs", content);
+}
+
+void ProjectGenerator::generateRulesModule()
+{
+    if (!QDir(m_outputDir).mkpath("modules/syntheticrules")) {
+        throw ProjectGeneratorError(QString::fromLatin1("Failed to create module directory "
+                                                        "in '%1'.").arg(m_outputDir));
+    }
+    QByteArray content = "import qbs\nimport qbs.TextFile\n\nModule {\n"
+                         "    additionalProductTypes: [\"synthetic.output\"]\n";
+    for (int i = 0; i < m_parameters.jsRulesPerProduct; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        content += "\n    FileTagger {\n"
+                   "        patterns: [\"*.synthetic" + n + "\"]\n"
+                   "        fileTags: [\"synthetic.input" + n + "\"]\n"
+                   "    }\n"
+                   "    Rule {\n"
+                   "        inputs: [\"synthetic.input" + n + "\"]\n"
+                   "        Artifact {\n"
+                   "            filePath: input.completeBaseName + \".out" + n + "\"\n"
+                   "            fileTags: [\"synthetic.output\"]\n"
+                   "        }\n"
+                   "        prepare: {\n"
+                   "            var cmd = new JavaScriptCommand();\n"
+                   "            cmd.silent = true;\n"
+                   "            cmd.sourceCode = function() {\n"
+                   "                var inFile = new TextFile(input.filePath);\n"
+                   "                var content = inFile.readAll();\n"
+                   "                inFile.close();\n"
+                   "                var outFile = new TextFile(output.filePath, "
+                   "TextFile.WriteOnly);\n"
+                   "                outFile.write(content.toUpperCase());\n"
+                   "                outFile.close();\n"
+                   "            };\n"
+                   "            return [cmd];\n"
+                   "        }\n"
+                   "    }\n";
+    }
+    content += "}\n";
+    writeFile("modules/syntheticrules/syntheticrules.qbs", content);
+}
+
+void ProjectGenerator::generateProduct(int product)
+{
+    const QString dir = productDir(product);
+    if (!QDir(m_outputDir).mkpath(dir)) {
+        throw ProjectGeneratorError(QString::fromLatin1("Failed to create directory '%1'.")
+                                    .arg(m_outputDir + '/' + dir));
+    }
+    for (int group = 0; group < m_parameters.wildcardGroupsPerProduct; ++group) {
+        if (!QDir(m_outputDir).mkpath(dir + "/g" + QString::number(group))) {
+            throw ProjectGeneratorError(QString::fromLatin1("Failed to create group "
+                                                            "directory in '%1'.")
+                                        .arg(m_outputDir + '/' + dir));
+        }
+    }
+
+    const bool isApplication = layer(product) == 0;
+    const std::vector<int> deps = dependencies(product);
+    QByteArray content = "import qbs\n\n";
+    content += isApplication ? "CppApplication {\n" : "StaticLibrary {\n";
+    content += "    name: \"" + dir.toLatin1() + "\"\n";
+    if (isApplication)
+        content += "    install: true\n";
+    else
+        content += "    Depends { name: \"cpp\" }\n";
+    content += "    cpp.includePaths: [\"..\"]\n";
+    if (m_parameters.mocHeadersPerProduct > 0)
+        content += "    Depends { name: \"Qt.core\" }\n";
+    if (m_parameters.jsRulesPerProduct > 0)
+        content += "    Depends { name: \"syntheticrules\" }\n";
+    for (const int dep : deps)
+        content += "    Depends { name: \"" + productDir(dep).toLatin1() + "\" }\n";
+    content += "    files: [\n";
+    if (isApplication)
+        content += "        \"main.cpp\",\n";
+    for (int i = 0; i < m_parameters.sourcesPerProduct; ++i) {
+        if (wildcardGroup(i) != -1)
+            continue;
+        content += "        \"h" + QByteArray::number(i) + ".h\",\n";
+        content += "        \"s" + QByteArray::number(i) + ".cpp\",\n";
+    }
+    for (int i = 0; i < m_parameters.jsRulesPerProduct; ++i)
+        content += "        \"r" + QByteArray::number(i) + ".synthetic" + QByteArray::number(i)
+                + "\",\n";
+    content += "    ]\n";
+    for (int group = 0; group < m_parameters.wildcardGroupsPerProduct; ++group) {
+        const QByteArray n = QByteArray::number(group);
+        content += "    Group {\n"
+                   "        name: \"wildcards " + n + "\"\n"
+                   "        prefix: \"g" + n + "/\"\n"
+                   "        files: [\"*.h\", \"*.cpp\"]\n"
+                   "    }\n";
+    }
+    content += "}\n";
+    writeFile(dir + '/' + dir + ".qbs", content);
+
+    for (int i = 0; i < m_parameters.sourcesPerProduct; ++i) {
+        generateHeader(product, i);
+        generateSource(product, i, deps);
+    }
+    if (isApplication)
+        generateMain(product);
+    generateRuleInputs(product);
+}
+
+void ProjectGenerator::generateHeader(int product, int index)
+{
+    const QByteArray p = QByteArray::number(product);
+    const QByteArray i = QByteArray::number(index);
+    const QByteArray guard = "SYNTHETIC_P" + p + "_H" + i + "_H";
+    QByteArray content = "#ifndef " + guard + "\n#define " + guard + "\n\n";
+    const bool hasQObject = index < m_parameters.mocHeadersPerProduct;
+    if (hasQObject)
+        content += "#include <QtCore/qobject.h>\n\n";
+    content += "int p" + p + "_f" + i + "();\n";
+    if (hasQObject) {
+        content += "\nclass P" + p + "C" + i + " : public QObject\n{\n"
+                   "    Q_OBJECT\n"
+                   "public:\n"
+                   "    void trigger() { emit triggered(); }\n"
+                   "signals:\n"
+                   "    void triggered();\n"
+                   "};\n";
+    }
+    content += "\n#endif\n";
+    writeFile(headerFilePath(product, index), content);
+}
+
+void ProjectGenerator::generateSource(int product, int index,
+                                      const std::vector<int> &dependencies)
+{
+    const int headerCount = m_parameters.sourcesPerProduct;
+    QByteArray includes = "#include \"" + headerFilePath(product, index).toLatin1() + "\"\n";
+    QByteArray calls;
+
+    // Alternate between the product's own headers and those of its dependencies.
+    // Only functions from dependencies get called, so there are no cycles.
+    for (int k = 1; k < m_parameters.headerFanIn; ++k) {
+        const int otherIndex = (index + k) % headerCount;
+        if (k % 2 == 1 && !dependencies.empty()) {
+            const int dep = dependencies.at((k / 2) % dependencies.size());
+            includes += "#include \"" + headerFilePath(dep, otherIndex).toLatin1() + "\"\n";
+            calls += " + p" + QByteArray::number(dep) + "_f" + QByteArray::number(otherIndex)
+                    + "()";
+        } else {
+            includes += "#include \"" + headerFilePath(product, otherIndex).toLatin1() + "\"\n";
+        }
+    }
+    const QByteArray content = includes + "\nint p" + QByteArray::number(product) + "_f"
+            + QByteArray::number(index) + "()\n{\n    return " + QByteArray::number(index)
+            + calls + ";\n}\n";
+    writeFile(sourceFilePath(product, index), content);
+}
+
+void ProjectGenerator::generateMain(int product)
+{
+    const QByteArray content = "#include \"" + headerFilePath(product, 0).toLatin1()
+            + "\"\n\nint main()\n{\n    return p" + QByteArray::number(product)
+            + "_f0() >= 0 ? 0 : 1;\n}\n";
+    writeFile(productDir(product) + "/main.cpp", content);
+}
+
+void ProjectGenerator::generateRuleInputs(int product)
+{
+    for (int i = 0; i < m_parameters.jsRulesPerProduct; ++i) {
+        const QString filePath = productDir(product) + "/r" + QString::number(i) + ".synthetic"
+                + QString::number(i);
+        writeFile(filePath, "input " + QByteArray::number(i) + " of product "
+                  + QByteArray::number(product) + '\n');
+    }
+}
+
+} // namespace qbsProjectGenerator
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_PROJECTGENERATOR_PROJECTGENERATOR_H
+#define QBS_PROJECTGENERATOR_PROJECTGENERATOR_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+#include <vector>
+
+namespace qbsProjectGenerator {
+
+class ProjectGeneratorError
+{
+public:
+    ProjectGeneratorError(const QString &error) : errorMessage(error) { }
+
+    QString errorMessage;
+};
+
+class ProjectGeneratorParameters
+{
+public:
+    // Parses a specification of the form "name1=value1,name2=value2,...".
+    void parse(const QString &specification);
+    void validate() const;
+
+    int productCount = 10;
+    int sourcesPerProduct = 10;
+    int headerFanIn = 3;
+    int dependencyDepth = 3;
+    int dependenciesPerProduct = 2;
+    int mocHeadersPerProduct = 0;
+    int wildcardGroupsPerProduct = 0;
+    int jsRulesPerProduct = 0;
+};
+
+class ProjectGeneratorParameterInfo
+{
+public:
+    QString name;
+    QString description;
+    int ProjectGeneratorParameters::*value;
+};
+const QList<ProjectGeneratorParameterInfo> &projectGeneratorParameterInfos();
+
+// Generates a synthetic qbs project with the given shape. The products are arranged in
+// dependencyDepth + 1 layers; layer 0 consists of applications, all other layers of static
+// libraries, and each product depends on products from the next layer.
+class ProjectGenerator
+{
+public:
+    ProjectGenerator(const ProjectGeneratorParameters &parameters);
+
+    // The output directory must not exist yet or be empty.
+    void generate(const QString &outputDir);
+
+    QString projectFilePath() const { return m_projectFilePath; }
+
+    // A source file of a library in the deepest layer, i.e. one that many products depend on.
+    QString representativeSourceFilePath() const;
+
+private:
+    int layer(int product) const;
+    std::vector<int> dependencies(int product) const;
+    int wildcardGroup(int index) const;
+    QString productDir(int product) const;
+    QString fileDir(int product, int index) const;
+    QString headerFilePath(int product, int index) const;
+    QString sourceFilePath(int product, int index) const;
+
+    void writeFile(const QString &relativeFilePath, const QByteArray &content);
+    void generateTopLevelProject();
+    void generateRulesModule();
+    void generateProduct(int product);
+    void generateHeader(int product, int index);
+    void generateSource(int product, int index, const std::vector<int> &dependencies);
+    void generateMain(int product);
+    void generateRuleInputs(int product);
+
+    const ProjectGeneratorParameters m_parameters;
+    QString m_outputDir;
+    QString m_projectFilePath;
+};
+
+} // namespace qbsProjectGenerator
+
+#endif // Include guard.
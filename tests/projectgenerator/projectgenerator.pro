@@ -0,0 +1,11 @@
+TARGET = qbs_projectgenerator
+DESTDIR = ../../bin
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++14
+SOURCES = \
+    main.cpp \
+    projectgenerator.cpp
+
+HEADERS = \
+    projectgenerator.h
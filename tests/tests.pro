@@ -1,4 +1,4 @@
 TEMPLATE = subdirs
-SUBDIRS = auto fuzzy-test
+SUBDIRS = auto fuzzy-test projectgenerator
 
 qtHaveModule(concurrent): SUBDIRS += benchmarker